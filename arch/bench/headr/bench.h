@@ -0,0 +1,94 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ *
+ * @struct: LatencyStats -> summary of a set of per request latencies (seconds)
+ *
+ */
+struct LatencyStats
+{
+    size_t count = 0;
+    double mean = 0.0;
+    double p50 = 0.0;
+    double p95 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+};
+
+/**
+ *
+ * @brief: nearest rank percentiles, mean and max of the samples
+ *
+ * @param: samples -> type: std::vector<double>, latencies (taken by value, it gets sorted)
+ * @return: LatencyStats -> the summary, all zero for no samples
+ *
+ */
+LatencyStats summarizeLatencies(std::vector<double> samples);
+
+/**
+ *
+ * @brief: peak resident set size of the process in bytes, 0 when unavailable
+ *
+ */
+size_t peakRssBytes() noexcept;
+
+/**
+ *
+ * @brief: a flat metric map, e.g. {"closed.p99_ms": 0.12, "closed.throughput_per_sec": 8000}
+ *
+ */
+using BenchMetrics = std::map<std::string, double>;
+
+/**
+ *
+ * @brief: writes / reads a flat JSON object of name -> number, the baseline file format
+ *
+ */
+void writeMetricsJson(const std::string& path, const BenchMetrics& metrics);
+BenchMetrics readMetricsJson(const std::string& path);
+
+/**
+ *
+ * @struct: Regression -> one metric that got worse than the baseline allows
+ *
+ */
+struct Regression
+{
+    std::string metric;
+    double baseline = 0.0;
+    double current = 0.0;
+    double change = 0.0;
+};
+
+/**
+ *
+ * @brief: direction of a metric, by name suffix
+ *
+ * @param: name -> type: const std::string&, metric name
+ * @return: bool -> true for throughput and the accuracy / fraction metrics of the early exit heads, false
+ *                  for everything else (latency, rss, steps)
+ *
+ */
+bool higherIsBetter(const std::string& name) noexcept;
+
+/**
+ *
+ * @brief: compares a run against its baseline
+ *
+ * @param: current -> type: const BenchMetrics&, this run
+ * @param: baseline -> type: const BenchMetrics&, the stored baseline
+ * @param: tolerance -> type: double, allowed relative change, e.g. 0.1 for 10%
+ * @return: std::vector<Regression> -> the metrics that regressed, empty when the run passes
+ *
+ * @note: higherIsBetter picks the direction of every metric. Metrics missing from either side are ignored
+ *
+ */
+std::vector<Regression> compareToBaseline(const BenchMetrics& current, const BenchMetrics& baseline, double tolerance);
+
+#endif
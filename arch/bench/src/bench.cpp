@@ -0,0 +1,205 @@
+#include "../headr/bench.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <sys/resource.h>
+
+/**
+ *
+ * @brief: nearest rank percentiles, mean and max of the samples
+ *
+ * @param: samples .
+ * type: std::vector<double>, latencies (taken by value, it gets sorted)
+ * @return: LatencyStats .
+ * the summary, all zero for no samples
+ *
+ */
+LatencyStats summarizeLatencies(std::vector<double> samples)
+{
+    LatencyStats stats;
+    if (samples.empty())
+    {
+        return stats;
+    }
+    std::sort(samples.begin(), samples.end());
+    auto rank = [&](double q)
+    {
+        size_t index = static_cast<size_t>(std::ceil(q * static_cast<double>(samples.size())));
+        return samples[std::min(samples.size(), std::max<size_t>(index, 1)) - 1];
+    };
+    stats.count = samples.size();
+    stats.mean = std::accumulate(samples.begin(), samples.end(), 0.0) / static_cast<double>(samples.size());
+    stats.p50 = rank(0.50);
+    stats.p95 = rank(0.95);
+    stats.p99 = rank(0.99);
+    stats.max = samples.back();
+    return stats;
+}
+
+/**
+ *
+ * @brief: peak resident set size of the process in bytes, 0 when unavailable
+ *
+ */
+size_t peakRssBytes() noexcept
+{
+    struct rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+    {
+        return 0;
+    }
+#ifdef __APPLE__
+    // bytes on macOS
+    return static_cast<size_t>(usage.ru_maxrss);
+#else
+    // kilobytes on linux
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+}
+
+/**
+ *
+ * @brief: writes a flat JSON object of name -> number
+ *
+ */
+void writeMetricsJson(const std::string& path, const BenchMetrics& metrics)
+{
+    std::ofstream file(path);
+    if (!file)
+    {
+        throw std::invalid_argument("Could not open metrics file: " + path);
+    }
+    file << "{\n" << std::setprecision(10);
+    size_t written = 0;
+    for (const auto& [name, val] : metrics)
+    {
+        file << "  \"" << name << "\": " << val << (++written < metrics.size() ? ",\n" : "\n");
+    }
+    file << "}\n";
+}
+
+/**
+ *
+ * @brief: reads a flat JSON object of name -> number, anything nested is rejected
+ *
+ */
+BenchMetrics readMetricsJson(const std::string& path)
+{
+    std::ifstream file(path);
+    if (!file)
+    {
+        throw std::invalid_argument("Could not open metrics file: " + path);
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    std::string text = buffer.str();
+
+    BenchMetrics metrics;
+    size_t pos = text.find('{');
+    if (pos == std::string::npos)
+    {
+        throw std::invalid_argument("Metrics file is not a JSON object: " + path);
+    }
+    while (true)
+    {
+        size_t keyStart = text.find('"', pos);
+        if (keyStart == std::string::npos)
+        {
+            break;
+        }
+        size_t keyEnd = text.find('"', keyStart + 1);
+        size_t colon = text.find(':', keyEnd);
+        if (keyEnd == std::string::npos || colon == std::string::npos)
+        {
+            throw std::invalid_argument("Malformed metrics file: " + path);
+        }
+        const char* numberStart = text.c_str() + colon + 1;
+        char* numberEnd = nullptr;
+        double val = std::strtod(numberStart, &numberEnd);
+        if (numberEnd == numberStart)
+        {
+            throw std::invalid_argument("Metric is not a number: " + text.substr(keyStart, keyEnd - keyStart + 1));
+        }
+        metrics[text.substr(keyStart + 1, keyEnd - keyStart - 1)] = val;
+        pos = static_cast<size_t>(numberEnd - text.c_str());
+    }
+    return metrics;
+}
+
+namespace
+{
+    // name suffixes of the higher-is-better metrics, a new one of those registers its suffix here
+    const std::string_view higherSuffixes[] = {
+        "_per_sec",
+        // early exit: accuracy of every head and of the full classifier, share of tracks a head answered
+        "accuracy",
+        ".fraction",
+        // result cache: share of lookups served from the cache
+        "hit_rate",
+        // distillation: student over teacher speed, agreement with the teacher, teacher over student size
+        "distill.speedup",
+        ".agreement",
+        ".param_ratio",
+        // cells: LSTM over GRU layer step time
+        "gru_speedup",
+        // hogwild: all workers over one worker samples per second
+        "hogwild.speedup",
+        "refresh8_speedup",
+    };
+}
+
+/**
+ *
+ * @brief: direction of a metric, by name suffix
+ *
+ * @param: name .
+ * type: const std::string&, metric name
+ * @return: bool .
+ * true when a larger value is an improvement
+ *
+ */
+bool higherIsBetter(const std::string& name) noexcept
+{
+    std::string_view view(name);
+    return std::any_of(std::begin(higherSuffixes), std::end(higherSuffixes),
+                       [&](std::string_view suffix) { return view.ends_with(suffix); });
+}
+
+/**
+ *
+ * @brief: compares a run against its baseline
+ *
+ * @param: current .
+ * type: const BenchMetrics&, this run
+ * @param: baseline .
+ * type: const BenchMetrics&, the stored baseline
+ * @param: tolerance .
+ * type: double, allowed relative change, e.g. 0.1 for 10%
+ * @return: std::vector<Regression> .
+ * the metrics that regressed, empty when the run passes
+ *
+ */
+std::vector<Regression> compareToBaseline(const BenchMetrics& current, const BenchMetrics& baseline, double tolerance)
+{
+    std::vector<Regression> regressions;
+    for (const auto& [name, base] : baseline)
+    {
+        auto it = current.find(name);
+        if (it == current.end() || base == 0.0)
+        {
+            continue;
+        }
+        double change = (it->second - base) / std::abs(base);
+        bool regressed = higherIsBetter(name) ? change < -tolerance : change > tolerance;
+        if (regressed)
+        {
+            regressions.push_back(Regression{name, base, it->second, change});
+        }
+    }
+    return regressions;
+}
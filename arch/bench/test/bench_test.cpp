@@ -0,0 +1,72 @@
+#include "../headr/bench.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+
+class BenchTest : public ::testing::Test{};
+
+/**
+ * @brief: Tests for the latency summary
+ */
+TEST_F(BenchTest, Percentiles)
+{
+    std::vector<double> samples;
+    for (int i = 100; i >= 1; i--)
+    {
+        samples.push_back(i);
+    }
+
+    // Test 1: nearest rank percentiles on 1..100
+    LatencyStats stats = summarizeLatencies(samples);
+    EXPECT_EQ(stats.count, 100) << "Sample count mismatch";
+    EXPECT_DOUBLE_EQ(stats.p50, 50.0) << "p50 mismatch";
+    EXPECT_DOUBLE_EQ(stats.p95, 95.0) << "p95 mismatch";
+    EXPECT_DOUBLE_EQ(stats.p99, 99.0) << "p99 mismatch";
+    EXPECT_DOUBLE_EQ(stats.max, 100.0) << "max mismatch";
+    EXPECT_DOUBLE_EQ(stats.mean, 50.5) << "mean mismatch";
+
+    // Test 2: empty input
+    EXPECT_EQ(summarizeLatencies({}).count, 0) << "Empty summary not zero";
+
+    // Test 3: the process has a resident set
+    EXPECT_GT(peakRssBytes(), 0) << "Peak RSS unavailable";
+}
+
+/**
+ * @brief: Tests for the baseline file round trip and the regression check
+ */
+TEST_F(BenchTest, BaselineCompare)
+{
+    BenchMetrics baseline = {{"closed.p99_ms", 2.0}, {"closed.throughput_per_sec", 1000.0}, {"peak_rss_mb", 50.0}};
+
+    // Test 1: JSON round trip
+    std::string path = ::testing::TempDir() + "bench_baseline.json";
+    writeMetricsJson(path, baseline);
+    EXPECT_EQ(readMetricsJson(path), baseline) << "Baseline round trip mismatch";
+    std::remove(path.c_str());
+
+    // Test 2: changes inside the tolerance pass, in either direction
+    BenchMetrics current = {{"closed.p99_ms", 2.1}, {"closed.throughput_per_sec", 950.0}, {"peak_rss_mb", 40.0}};
+    EXPECT_TRUE(compareToBaseline(current, baseline, 0.1).empty()) << "Run inside tolerance flagged";
+
+    // Test 3: slower latency and lower throughput regress
+    current = {{"closed.p99_ms", 2.5}, {"closed.throughput_per_sec", 800.0}, {"peak_rss_mb", 50.0}};
+    std::vector<Regression> regressions = compareToBaseline(current, baseline, 0.1);
+    ASSERT_EQ(regressions.size(), 2) << "Regressions not detected";
+    EXPECT_EQ(regressions[0].metric, "closed.p99_ms") << "Latency regression not reported";
+    EXPECT_EQ(regressions[1].metric, "closed.throughput_per_sec") << "Throughput regression not reported";
+
+    // Test 4: the registered higher-is-better metrics regress when they fall, an improvement passes
+    for (std::string name : {"closed.throughput_per_sec", "early_exit.accuracy", "early_exit.full_accuracy",
+                             "early_exit.step3.accuracy", "early_exit.step3.fraction", "cached.hit_rate",
+                             "distill.speedup", "distill.agreement", "distill.param_ratio",
+                             "cell.gru_speedup", "hogwild.speedup", "hogwild.refresh8_speedup"})
+    {
+        EXPECT_TRUE(higherIsBetter(name)) << name << " judged lower-is-better";
+        EXPECT_EQ(compareToBaseline({{name, 0.7}}, {{name, 0.9}}, 0.1).size(), 1) << name << " drop not flagged";
+        EXPECT_TRUE(compareToBaseline({{name, 0.99}}, {{name, 0.9}}, 0.05).empty()) << name << " gain flagged";
+    }
+    for (std::string name : {"closed.p99_ms", "peak_rss_mb", "early_exit.mean_steps", "distill.mean_abs_diff"})
+    {
+        EXPECT_FALSE(higherIsBetter(name)) << name << " judged higher-is-better";
+    }
+}
@@ -0,0 +1,81 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+/**
+ *
+ * @struct: PackedBatch -> variable length sequences packed step by step with no padding
+ *
+ * @values:
+ *     numFeatures -> type: size_t, values per timestep
+ *     data -> type: vector<double>, rows of numFeatures, all rows of step 0 then all rows of step 1 ...
+ *     batchSizes -> type: vector<size_t>, sequences still running at every step (never increases)
+ *     stepOffsets -> type: vector<size_t>, first row of every step inside data
+ *     lengths -> type: vector<size_t>, sequence lengths, longest first
+ *     order -> type: vector<size_t>, order[k] = index in the caller's list of the k-th longest sequence
+ *
+ * @note: sequences are sorted longest first, so at step t the running sequences are always rows
+ *          [0, batchSizes[t]) and a finished sequence simply drops off the end of the batch
+ *
+ */
+struct PackedBatch
+{
+    size_t numFeatures = 0;
+    std::vector<double> data;
+    std::vector<size_t> batchSizes;
+    std::vector<size_t> stepOffsets;
+    std::vector<size_t> lengths;
+    std::vector<size_t> order;
+
+    size_t numSteps() const noexcept { return batchSizes.size(); }
+    size_t numSequences() const noexcept { return lengths.size(); }
+    size_t rows() const noexcept { return numFeatures == 0 ? 0 : data.size() / numFeatures; }
+
+    /**
+     *
+     * @brief: the running rows of one step
+     *
+     * @param: t -> type: size_t, timestep
+     * @return: std::span<const double> -> batchSizes[t] rows of numFeatures values
+     *
+     */
+    std::span<const double> step(size_t t) const noexcept
+    {
+        return {data.data() + stepOffsets[t] * numFeatures, batchSizes[t] * numFeatures};
+    }
+
+    /**
+     *
+     * @brief: row of sequence k (in sorted order) at step t inside any packed per-row array
+     *
+     */
+    size_t rowOf(size_t k, size_t t) const noexcept { return stepOffsets[t] + k; }
+};
+
+/**
+ *
+ * @brief: packs sequences of any length, longest first
+ *
+ * @param: sequences -> type: const std::vector<std::vector<double>>&, every sequence is its timesteps
+ *                          back to back, numFeatures values each
+ * @param: numFeatures -> type: size_t, values per timestep
+ * @return: PackedBatch -> the packed layout, empty sequences are kept but never run
+ *
+ */
+PackedBatch packSequences(const std::vector<std::vector<double>>& sequences, size_t numFeatures);
+
+/**
+ *
+ * @brief: scatters one value per packed row back to the caller's sequences
+ *
+ * @param: batch -> type: const PackedBatch&, the layout the values were produced in
+ * @param: packed -> type: std::span<const double>, batch.rows() values
+ * @return: std::vector<std::vector<double>> -> one vector per sequence, in the caller's order
+ *
+ */
+std::vector<std::vector<double>> unpackSequences(const PackedBatch& batch, std::span<const double> packed);
+
+#endif
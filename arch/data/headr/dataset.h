@@ -0,0 +1,69 @@
+#ifndef DATASET_H
+#define DATASET_H
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+/**
+ *
+ * @struct: Dataset -> read-only table of samples shared by every trainer in a process
+ *
+ * @values:
+ *     numFeatures -> type: size_t, number of features per row (e.g. one frequency per second)
+ *     features -> type: vector<double>, row major feature table
+ *     labels -> type: vector<double>, one target per row (consonance class or preference score)
+ *
+ * @note: hand it around as std::shared_ptr<const Dataset> so workers share one copy
+ *
+ */
+struct Dataset
+{
+    size_t numFeatures = 0;
+    std::vector<double> features;
+    std::vector<double> labels;
+
+    size_t size() const noexcept { return labels.size(); }
+
+    std::span<const double> row(size_t index) const noexcept
+    {
+        return {features.data() + index * numFeatures, numFeatures};
+    }
+};
+
+/**
+ *
+ * @struct: Fold -> row indices of one cross-validation split
+ *
+ */
+struct Fold
+{
+    std::vector<size_t> train;
+    std::vector<size_t> validation;
+};
+
+/**
+ *
+ * @brief: loads a CSV file where every line is the features followed by the label
+ *
+ * @param: path -> type: const std::string&, file to read
+ * @return: std::shared_ptr<const Dataset> -> the loaded table
+ *
+ */
+std::shared_ptr<const Dataset> loadCsv(const std::string& path);
+
+/**
+ *
+ * @brief: shuffled k-fold split, every row is in exactly one validation set
+ *
+ * @param: numRows -> type: size_t, number of rows in the dataset
+ * @param: k -> type: size_t, number of folds, k < 2 gives one fold that trains on everything
+ * @param: seed -> type: unsigned, shuffle seed so every worker sees the same folds
+ * @return: std::vector<Fold> -> k folds
+ *
+ */
+std::vector<Fold> kFoldSplits(size_t numRows, size_t k, unsigned seed);
+
+#endif
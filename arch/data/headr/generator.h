@@ -0,0 +1,67 @@
+#ifndef GENERATOR_H
+#define GENERATOR_H
+
+#include <array>
+#include <random>
+#include <utility>
+#include <vector>
+
+/**
+ *
+ * @class: MusicDataGenerator -> C++ port of data/dEngineer.py
+ *
+ * @note: generates frequency sequences with a preference score based on consonance / dissonance so the
+ *          benchmarks and tests can drive the model without the python preprocessing step
+ *
+ */
+class MusicDataGenerator
+{
+    public:
+        // base frequencies for octave 4 (middle C to B)
+        static constexpr std::array<double, 12> baseFrequencies = {
+                261.63, 277.18, 293.66, 311.13, 329.63, 349.23,
+                369.99, 392.00, 415.30, 440.00, 466.16, 493.88};
+
+        // unison, octave, perfect fifth, perfect fourth, major third, minor third, major sixth
+        static constexpr std::array<double, 7> consonantRatios = {
+                1.0 / 1.0, 2.0 / 1.0, 3.0 / 2.0, 4.0 / 3.0, 5.0 / 4.0, 6.0 / 5.0, 5.0 / 3.0};
+
+        // minor second, major seventh, tritone
+        static constexpr std::array<double, 3> dissonantRatios = {16.0 / 15.0, 15.0 / 8.0, 45.0 / 32.0};
+
+        explicit MusicDataGenerator(unsigned seed = 0) : gen(seed) {}
+
+        /**
+         *
+         * @brief: same pairwise score as calculate_consonance_score
+         *
+         * @param: frequencies -> type: const std::vector<double>&, frequencies in Hz
+         * @return: double -> 0 (most dissonant) to 1 (most consonant)
+         *
+         */
+        static double consonanceScore(const std::vector<double>& frequencies) noexcept;
+
+        /**
+         *
+         * @brief: sequence with consonantChance of a consonant interval at every step
+         *
+         * @param: length -> type: size_t, number of frequencies (one per second)
+         * @param: consonantChance -> type: double, 0.7 for classical, 0.4 for jazz
+         * @return: std::vector<double> -> the frequencies, kept in [200, 1000] Hz
+         *
+         */
+        std::vector<double> sequence(size_t length, double consonantChance);
+
+        /**
+         *
+         * @brief: classical (consonant biased) and jazz (dissonance tolerant) sequences with their scores
+         *
+         */
+        std::pair<std::vector<double>, double> classical(size_t length = 10);
+        std::pair<std::vector<double>, double> jazz(size_t length = 10);
+
+    private:
+        std::mt19937 gen;
+};
+
+#endif
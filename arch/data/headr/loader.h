@@ -0,0 +1,266 @@
+#ifndef LOADER_H
+#define LOADER_H
+
+#include "dataset.h"
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ *
+ * PREFETCHING LOADER:
+ *  - a background thread reads samples from a SampleSource, shuffles them through a fixed size shuffle
+ *      buffer and assembles them into batches, while the trainer works on the batch it already has
+ *  - batches live in a bounded ring of preallocated buffers, the loader runs at most `prefetch` batches
+ *      ahead and blocks when the ring is full, nothing is allocated once the loader is running
+ *  - the time the trainer spends waiting in next() is reported as stalled time, if it grows the input
+ *      pipeline is the bottleneck
+ *
+ */
+
+/**
+ *
+ * @class: SampleSource -> sequential reader of (features, label) rows, called from the loader thread only
+ *
+ */
+class SampleSource
+{
+    public:
+        virtual ~SampleSource() = default;
+
+        virtual size_t numFeatures() const noexcept = 0;
+
+        /**
+         *
+         * @brief: reads the next row
+         *
+         * @param: features -> type: span<double>, numFeatures() values to fill
+         * @param: label -> type: double&, receives the target
+         * @return: bool -> false once the pass is over
+         *
+         */
+        virtual bool next(std::span<double> features, double& label) = 0;
+
+        /**
+         *
+         * @brief: starts a new pass from the first row
+         *
+         */
+        virtual void rewind() = 0;
+};
+
+/**
+ *
+ * @class: DatasetSource -> rows of an in memory Dataset
+ *
+ */
+class DatasetSource final : public SampleSource
+{
+    public:
+        explicit DatasetSource(std::shared_ptr<const Dataset> data);
+
+        size_t numFeatures() const noexcept override { return data->numFeatures; }
+        bool next(std::span<double> features, double& label) override;
+        void rewind() override { cursor = 0; }
+
+    private:
+        std::shared_ptr<const Dataset> data;
+        size_t cursor = 0;
+};
+
+/**
+ *
+ * @class: CsvSource -> streams rows from a CSV file in the loadCsv format, the file is never held in memory
+ *
+ */
+class CsvSource final : public SampleSource
+{
+    public:
+        /**
+         *
+         * @brief: opens the file and reads the first row to find the number of features
+         *
+         * @param: path -> type: const std::string&, features followed by the label on every line
+         *
+         */
+        explicit CsvSource(const std::string& path);
+
+        size_t numFeatures() const noexcept override { return features; }
+        bool next(std::span<double> out, double& label) override;
+        void rewind() override;
+
+    private:
+        bool readRow();
+
+        std::string path;
+        std::ifstream file;
+        std::string line;
+        std::vector<double> row;
+        size_t features = 0;
+};
+
+/**
+ *
+ * @struct: LoaderPosition -> how far the trainer got, batches taken in the current epoch
+ *
+ */
+struct LoaderPosition
+{
+    size_t epoch = 0;
+    size_t batches = 0;
+};
+
+/**
+ *
+ * @struct: LoaderConfig -> batching, shuffling and read ahead of a PrefetchLoader
+ *
+ * @values:
+ *     batchSize -> type: size_t, rows per batch, the last batch of a pass may be smaller
+ *     prefetch -> type: size_t, batches the loader may assemble ahead of the trainer
+ *     shuffleBuffer -> type: size_t, rows held for the streaming shuffle, 1 keeps the source order
+ *     epochs -> type: size_t, passes over the source before the loader stops
+ *     seed -> type: unsigned, shuffle seed
+ *     start -> type: LoaderPosition, resume point, the batches before it are assembled with the same shuffle
+ *                  and dropped, so the trainer sees exactly the batches it would have seen next
+ *
+ */
+struct LoaderConfig
+{
+    size_t batchSize = 32;
+    size_t prefetch = 2;
+    size_t shuffleBuffer = 1024;
+    size_t epochs = 1;
+    unsigned seed = 0;
+    LoaderPosition start;
+};
+
+/**
+ *
+ * @struct: LoaderBatch -> one assembled batch, row major features and one label per row
+ *
+ */
+struct LoaderBatch
+{
+    size_t rows = 0;
+    size_t numFeatures = 0;
+    size_t epoch = 0;
+    std::vector<double> features;
+    std::vector<double> labels;
+
+    std::span<const double> row(size_t index) const noexcept
+    {
+        return {features.data() + index * numFeatures, numFeatures};
+    }
+};
+
+/**
+ *
+ * @struct: LoaderStats -> where the time between loader and trainer goes
+ *
+ * @values:
+ *     stalledSeconds -> type: double, trainer time spent waiting in next() for a batch ("stalled on data")
+ *     stalls -> type: size_t, calls to next() that had to wait
+ *     loaderIdleSeconds -> type: double, loader time spent waiting for a free buffer (trainer bound)
+ *     batches -> type: size_t, batches handed to the trainer
+ *
+ */
+struct LoaderStats
+{
+    double stalledSeconds = 0.0;
+    size_t stalls = 0;
+    double loaderIdleSeconds = 0.0;
+    size_t batches = 0;
+};
+
+/**
+ *
+ * @class: PrefetchLoader -> double buffered background batch assembly
+ *
+ * @note: a single trainer thread calls next(), the batch it returns stays valid until the following call
+ *
+ */
+class PrefetchLoader
+{
+    public:
+        /**
+         *
+         * @brief: preallocates the ring and the shuffle buffer and starts the loader thread
+         *
+         * @param: source -> type: std::unique_ptr<SampleSource>, owned by the loader from now on
+         * @param: config -> type: LoaderConfig, batch size, read ahead, shuffle and epochs
+         *
+         */
+        PrefetchLoader(std::unique_ptr<SampleSource> source, LoaderConfig config = {});
+        ~PrefetchLoader();
+
+        PrefetchLoader(const PrefetchLoader&) = delete;
+        PrefetchLoader& operator=(const PrefetchLoader&) = delete;
+
+        /**
+         *
+         * @brief: hands the previous batch back to the loader and waits for the next one
+         *
+         * @return: const LoaderBatch* -> nullptr at the end of every epoch and once the last epoch is over,
+         *              rethrows anything the loader thread threw
+         *
+         */
+        const LoaderBatch* next();
+
+        LoaderStats stats() const;
+        const LoaderConfig& getConfig() const noexcept { return config; }
+
+        /**
+         *
+         * @brief: batches the trainer has taken so far, the start of a loader resumed at this point
+         *
+         */
+        LoaderPosition position() const;
+
+    private:
+        void run();
+        void produce();
+
+        // waits for a free slot, false when the loader is stopping
+        bool acquire(LoaderBatch*& slot);
+        void publish();
+
+        std::unique_ptr<SampleSource> source;
+        LoaderConfig config;
+        size_t numFeatures;
+
+        // ring of prefetch + 1 slots, the trainer holds one while the loader fills up to prefetch others.
+        // filled / taken / released count slots since the start, slot = count % ring.size()
+        std::vector<LoaderBatch> ring;
+        size_t filled = 0;
+        size_t taken = 0;
+        size_t released = 0;
+        bool holding = false;
+        bool finished = false;
+        bool stopping = false;
+        std::exception_ptr error;
+        LoaderPosition consumed;
+
+        // batches before config.start are assembled here and never published
+        LoaderBatch discard;
+
+        // streaming shuffle buffer, rows are drawn at random once it is full
+        std::vector<double> shuffleFeatures;
+        std::vector<double> shuffleLabels;
+        std::mt19937 gen;
+
+        mutable std::mutex lock;
+        std::condition_variable ready;
+        std::condition_variable freed;
+        LoaderStats counters;
+        std::thread worker;
+};
+
+#endif
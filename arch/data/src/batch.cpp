@@ -0,0 +1,101 @@
+#include "../headr/batch.h"
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+/**
+ *
+ * @brief: packs sequences of any length, longest first
+ *
+ * @param: sequences .
+ * type: const std::vector<std::vector<double>>&, every sequence is its timesteps back to back
+ * @param: numFeatures .
+ * type: size_t, values per timestep
+ * @return: PackedBatch .
+ * the packed layout, empty sequences are kept but never run
+ *
+ */
+PackedBatch packSequences(const std::vector<std::vector<double>>& sequences, size_t numFeatures)
+{
+    if (numFeatures == 0)
+    {
+        throw std::invalid_argument("Packed sequences need at least one feature");
+    }
+    PackedBatch batch;
+    batch.numFeatures = numFeatures;
+    size_t totalRows = 0;
+    for (const std::vector<double>& seq : sequences)
+    {
+        if (seq.size() % numFeatures != 0)
+        {
+            throw std::invalid_argument("Sequence size is not a whole number of timesteps");
+        }
+        totalRows += seq.size() / numFeatures;
+    }
+
+    // stable so equal lengths keep the caller's order
+    batch.order.resize(sequences.size());
+    std::iota(batch.order.begin(), batch.order.end(), 0);
+    std::stable_sort(batch.order.begin(), batch.order.end(), [&](size_t a, size_t b)
+    {
+        return sequences[a].size() > sequences[b].size();
+    });
+    batch.lengths.reserve(sequences.size());
+    for (size_t index : batch.order)
+    {
+        batch.lengths.push_back(sequences[index].size() / numFeatures);
+    }
+
+    size_t maxLen = batch.lengths.empty() ? 0 : batch.lengths.front();
+    batch.batchSizes.resize(maxLen);
+    batch.stepOffsets.resize(maxLen);
+    batch.data.resize(totalRows * numFeatures);
+    size_t running = batch.lengths.size();
+    size_t row = 0;
+    for (size_t t = 0; t < maxLen; ++t)
+    {
+        while (batch.lengths[running - 1] <= t)
+        {
+            --running;
+        }
+        batch.batchSizes[t] = running;
+        batch.stepOffsets[t] = row;
+        for (size_t k = 0; k < running; ++k, ++row)
+        {
+            const double* src = sequences[batch.order[k]].data() + t * numFeatures;
+            std::copy(src, src + numFeatures, batch.data.begin() + row * numFeatures);
+        }
+    }
+    return batch;
+}
+
+/**
+ *
+ * @brief: scatters one value per packed row back to the caller's sequences
+ *
+ * @param: batch .
+ * type: const PackedBatch&, the layout the values were produced in
+ * @param: packed .
+ * type: std::span<const double>, batch.rows() values
+ * @return: std::vector<std::vector<double>> .
+ * one vector per sequence, in the caller's order
+ *
+ */
+std::vector<std::vector<double>> unpackSequences(const PackedBatch& batch, std::span<const double> packed)
+{
+    if (packed.size() != batch.rows())
+    {
+        throw std::invalid_argument("Packed values do not match the batch layout");
+    }
+    std::vector<std::vector<double>> sequences(batch.numSequences());
+    for (size_t k = 0; k < batch.numSequences(); ++k)
+    {
+        std::vector<double>& seq = sequences[batch.order[k]];
+        seq.resize(batch.lengths[k]);
+        for (size_t t = 0; t < batch.lengths[k]; ++t)
+        {
+            seq[t] = packed[batch.rowOf(k, t)];
+        }
+    }
+    return sequences;
+}
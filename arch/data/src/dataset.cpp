@@ -0,0 +1,103 @@
+#include "../headr/dataset.h"
+#include <algorithm>
+#include <fstream>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+/**
+ *
+ * @brief: loads a CSV file where every line is the features followed by the label
+ *
+ * @param: path .
+ * type: const std::string&, file to read
+ * @return: std::shared_ptr<const Dataset> .
+ * the loaded table
+ *
+ */
+std::shared_ptr<const Dataset> loadCsv(const std::string& path)
+{
+    std::ifstream file(path);
+    if (!file)
+    {
+        throw std::invalid_argument("Could not open dataset file: " + path);
+    }
+
+    auto data = std::make_shared<Dataset>();
+    std::string line;
+    std::vector<double> values;
+    while (std::getline(file, line))
+    {
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+        values.clear();
+        std::stringstream fields(line);
+        std::string field;
+        while (std::getline(fields, field, ','))
+        {
+            values.push_back(std::stod(field));
+        }
+        if (values.size() < 2)
+        {
+            throw std::invalid_argument("Dataset row needs at least one feature and a label");
+        }
+        if (data->numFeatures == 0)
+        {
+            data->numFeatures = values.size() - 1;
+        }
+        if (values.size() - 1 != data->numFeatures)
+        {
+            throw std::invalid_argument("Dataset rows have different lengths");
+        }
+        data->features.insert(data->features.end(), values.begin(), values.end() - 1);
+        data->labels.push_back(values.back());
+    }
+    return data;
+}
+
+/**
+ *
+ * @brief: shuffled k-fold split, every row is in exactly one validation set
+ *
+ * @param: numRows .
+ * type: size_t, number of rows in the dataset
+ * @param: k .
+ * type: size_t, number of folds, k < 2 gives one fold that trains on everything
+ * @param: seed .
+ * type: unsigned, shuffle seed so every worker sees the same folds
+ * @return: std::vector<Fold> .
+ * k folds
+ *
+ */
+std::vector<Fold> kFoldSplits(size_t numRows, size_t k, unsigned seed)
+{
+    std::vector<size_t> order(numRows);
+    std::iota(order.begin(), order.end(), 0);
+    if (k < 2)
+    {
+        return {Fold{order, {}}};
+    }
+    if (k > numRows)
+    {
+        throw std::invalid_argument("More folds than rows");
+    }
+
+    std::mt19937 gen(seed);
+    std::shuffle(order.begin(), order.end(), gen);
+
+    std::vector<Fold> folds(k);
+    for (size_t f = 0; f < k; ++f)
+    {
+        // the first numRows % k folds take one extra row
+        size_t begin = f * (numRows / k) + std::min(f, numRows % k);
+        size_t end = begin + numRows / k + (f < numRows % k ? 1 : 0);
+        for (size_t i = 0; i < numRows; ++i)
+        {
+            (i >= begin && i < end ? folds[f].validation : folds[f].train).push_back(order[i]);
+        }
+    }
+    return folds;
+}
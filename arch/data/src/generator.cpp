@@ -0,0 +1,89 @@
+#include "../headr/generator.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+/**
+ *
+ * @brief: same pairwise score as calculate_consonance_score
+ *
+ * @param: frequencies .
+ * type: const std::vector<double>&, frequencies in Hz
+ * @return: double .
+ * 0 (most dissonant) to 1 (most consonant)
+ *
+ */
+double MusicDataGenerator::consonanceScore(const std::vector<double>& frequencies) noexcept
+{
+    double score = 0.0;
+    size_t comparisons = 0;
+    for (size_t i = 0; i < frequencies.size(); ++i)
+    {
+        for (size_t j = i + 1; j < frequencies.size(); ++j)
+        {
+            double ratio = std::max(frequencies[i], frequencies[j]) / std::min(frequencies[i], frequencies[j]);
+            double minDiff = std::numeric_limits<double>::infinity();
+            for (double consonant : consonantRatios)
+            {
+                minDiff = std::min(minDiff, std::abs(ratio - consonant));
+            }
+            score += 1.0 / (1.0 + 10.0 * minDiff);
+            comparisons++;
+        }
+    }
+    return comparisons > 0 ? score / static_cast<double>(comparisons) : 0.0;
+}
+
+/**
+ *
+ * @brief: sequence with consonantChance of a consonant interval at every step
+ *
+ */
+std::vector<double> MusicDataGenerator::sequence(size_t length, double consonantChance)
+{
+    std::uniform_real_distribution<> unit(0.0, 1.0);
+    std::uniform_int_distribution<size_t> pickBase(0, baseFrequencies.size() - 1);
+    std::uniform_int_distribution<size_t> pickConsonant(0, consonantRatios.size() - 1);
+    std::uniform_int_distribution<size_t> pickDissonant(0, dissonantRatios.size() - 1);
+
+    std::vector<double> frequencies;
+    frequencies.reserve(length);
+    if (length == 0)
+    {
+        return frequencies;
+    }
+    frequencies.push_back(baseFrequencies[pickBase(gen)]);
+    while (frequencies.size() < length)
+    {
+        double ratio = unit(gen) < consonantChance ? consonantRatios[pickConsonant(gen)]
+                                                   : dissonantRatios[pickDissonant(gen)];
+        double next = frequencies.back() * ratio;
+        // range check for frequency
+        while (next > 1000.0)
+        {
+            next /= 2.0;
+        }
+        while (next < 200.0)
+        {
+            next *= 2.0;
+        }
+        frequencies.push_back(next);
+    }
+    return frequencies;
+}
+
+std::pair<std::vector<double>, double> MusicDataGenerator::classical(size_t length)
+{
+    std::vector<double> frequencies = sequence(length, 0.7);
+    // classical music bias
+    double preference = 0.8 * consonanceScore(frequencies) + 0.2;
+    return {std::move(frequencies), preference};
+}
+
+std::pair<std::vector<double>, double> MusicDataGenerator::jazz(size_t length)
+{
+    std::vector<double> frequencies = sequence(length, 0.4);
+    // more accepting of dissonance
+    double preference = 0.5 * consonanceScore(frequencies) + 0.5;
+    return {std::move(frequencies), preference};
+}
@@ -0,0 +1,406 @@
+#include "../headr/loader.h"
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double secondsSince(Clock::time_point start) noexcept
+    {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+}
+
+/**
+ *
+ * @brief: constructor
+ *
+ * @param: data .
+ * type: std::shared_ptr<const Dataset>, table to read, shared with the caller
+ *
+ */
+DatasetSource::DatasetSource(std::shared_ptr<const Dataset> data)
+        : data(std::move(data))
+{
+    if (!this->data)
+    {
+        throw std::invalid_argument("DatasetSource needs a dataset");
+    }
+}
+
+/**
+ *
+ * @brief: copies the next row of the table
+ *
+ */
+bool DatasetSource::next(std::span<double> features, double& label)
+{
+    if (cursor >= data->size())
+    {
+        return false;
+    }
+    std::span<const double> row = data->row(cursor);
+    std::copy(row.begin(), row.end(), features.begin());
+    label = data->labels[cursor];
+    ++cursor;
+    return true;
+}
+
+/**
+ *
+ * @brief: opens the file and reads the first row to find the number of features
+ *
+ * @param: path .
+ * type: const std::string&, features followed by the label on every line
+ *
+ */
+CsvSource::CsvSource(const std::string& path)
+        : path(path), file(path)
+{
+    if (!file)
+    {
+        throw std::invalid_argument("Could not open dataset file: " + path);
+    }
+    if (!readRow())
+    {
+        throw std::invalid_argument("Dataset file has no rows: " + path);
+    }
+    features = row.size() - 1;
+    rewind();
+}
+
+/**
+ *
+ * @brief: parses the next non comment line into row, false at the end of the file
+ *
+ */
+bool CsvSource::readRow()
+{
+    while (std::getline(file, line))
+    {
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+        row.clear();
+        std::stringstream fields(line);
+        std::string field;
+        while (std::getline(fields, field, ','))
+        {
+            row.push_back(std::stod(field));
+        }
+        if (row.size() < 2)
+        {
+            throw std::invalid_argument("Dataset row needs at least one feature and a label");
+        }
+        if (features != 0 && row.size() - 1 != features)
+        {
+            throw std::invalid_argument("Dataset rows have different lengths");
+        }
+        return true;
+    }
+    return false;
+}
+
+bool CsvSource::next(std::span<double> out, double& label)
+{
+    if (!readRow())
+    {
+        return false;
+    }
+    std::copy(row.begin(), row.end() - 1, out.begin());
+    label = row.back();
+    return true;
+}
+
+void CsvSource::rewind()
+{
+    file.clear();
+    file.seekg(0);
+}
+
+/**
+ *
+ * @brief: preallocates the ring and the shuffle buffer and starts the loader thread
+ *
+ * @param: source .
+ * type: std::unique_ptr<SampleSource>, owned by the loader from now on
+ * @param: config .
+ * type: LoaderConfig, batch size, read ahead, shuffle and epochs
+ *
+ */
+PrefetchLoader::PrefetchLoader(std::unique_ptr<SampleSource> source, LoaderConfig config)
+        : source(std::move(source)), config(config), numFeatures(0), consumed(config.start), gen(config.seed)
+{
+    if (!this->source)
+    {
+        throw std::invalid_argument("PrefetchLoader needs a sample source");
+    }
+    if (config.batchSize == 0 || config.prefetch == 0)
+    {
+        throw std::invalid_argument("Batch size and prefetch depth must be positive");
+    }
+    this->config.shuffleBuffer = std::max<size_t>(config.shuffleBuffer, 1);
+    numFeatures = this->source->numFeatures();
+
+    ring.resize(config.prefetch + 1);
+    for (LoaderBatch& slot : ring)
+    {
+        slot.numFeatures = numFeatures;
+        slot.features.resize(config.batchSize * numFeatures);
+        slot.labels.resize(config.batchSize);
+    }
+    if (config.start.epoch > 0 || config.start.batches > 0)
+    {
+        discard.numFeatures = numFeatures;
+        discard.features.resize(config.batchSize * numFeatures);
+        discard.labels.resize(config.batchSize);
+    }
+    shuffleFeatures.resize(this->config.shuffleBuffer * numFeatures);
+    shuffleLabels.resize(this->config.shuffleBuffer);
+    worker = std::thread(&PrefetchLoader::run, this);
+}
+
+PrefetchLoader::~PrefetchLoader()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    freed.notify_all();
+    worker.join();
+}
+
+/**
+ *
+ * @brief: hands the previous batch back to the loader and waits for the next one
+ *
+ * @return: const LoaderBatch* .
+ * nullptr at the end of every epoch and once the last epoch is over
+ *
+ */
+const LoaderBatch* PrefetchLoader::next()
+{
+    std::unique_lock<std::mutex> guard(lock);
+    if (holding)
+    {
+        ++released;
+        holding = false;
+        freed.notify_one();
+    }
+    if (filled == taken && !finished && !error)
+    {
+        Clock::time_point start = Clock::now();
+        ready.wait(guard, [&] { return filled > taken || finished || error; });
+        counters.stalledSeconds += secondsSince(start);
+        ++counters.stalls;
+    }
+    if (filled == taken)
+    {
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+        return nullptr;
+    }
+    LoaderBatch& slot = ring[taken % ring.size()];
+    ++taken;
+    holding = true;
+    if (slot.rows == 0)
+    {
+        // end of epoch marker
+        consumed = {slot.epoch + 1, 0};
+        return nullptr;
+    }
+    consumed = {slot.epoch, consumed.epoch == slot.epoch ? consumed.batches + 1 : 1};
+    ++counters.batches;
+    return &slot;
+}
+
+LoaderStats PrefetchLoader::stats() const
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return counters;
+}
+
+LoaderPosition PrefetchLoader::position() const
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return consumed;
+}
+
+void PrefetchLoader::run()
+{
+    try
+    {
+        produce();
+    }
+    catch (...)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        error = std::current_exception();
+    }
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        finished = true;
+    }
+    ready.notify_all();
+}
+
+/**
+ *
+ * @brief: waits for a free slot, false when the loader is stopping
+ *
+ */
+bool PrefetchLoader::acquire(LoaderBatch*& slot)
+{
+    std::unique_lock<std::mutex> guard(lock);
+    if (filled - released >= ring.size() && !stopping)
+    {
+        Clock::time_point start = Clock::now();
+        freed.wait(guard, [&] { return filled - released < ring.size() || stopping; });
+        counters.loaderIdleSeconds += secondsSince(start);
+    }
+    if (stopping)
+    {
+        return false;
+    }
+    slot = &ring[filled % ring.size()];
+    return true;
+}
+
+void PrefetchLoader::publish()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        ++filled;
+    }
+    ready.notify_one();
+}
+
+/**
+ *
+ * @brief: the loader thread, every epoch streams the source through the shuffle buffer into batches
+ *
+ * @note: the shuffle buffer is filled first, then every new row replaces a random held row which goes
+ *          to the batch, at the end of the pass the held rows are drained in random order. Rows only
+ *          move inside preallocated buffers. Batches before config.start go through the same shuffle
+ *          into the discard slot, so the generator is where an uninterrupted run would have left it
+ *
+ */
+void PrefetchLoader::produce()
+{
+    size_t capacity = config.shuffleBuffer;
+    for (size_t epoch = 0; epoch < config.epochs; ++epoch)
+    {
+        source->rewind();
+        size_t held = 0;
+        size_t batches = 0;
+        bool sourceDone = false;
+        LoaderBatch* slot = nullptr;
+        auto skipped = [&]
+        {
+            return epoch < config.start.epoch || (epoch == config.start.epoch && batches < config.start.batches);
+        };
+        auto close = [&]
+        {
+            if (slot != &discard)
+            {
+                publish();
+            }
+            slot = nullptr;
+            ++batches;
+        };
+
+        // emits held row index into the open batch, publishing the batch once it is full
+        auto emit = [&](size_t index) -> bool
+        {
+            if (!slot)
+            {
+                if (skipped())
+                {
+                    slot = &discard;
+                }
+                else if (!acquire(slot))
+                {
+                    return false;
+                }
+                slot->rows = 0;
+                slot->epoch = epoch;
+            }
+            std::copy_n(shuffleFeatures.begin() + static_cast<long>(index * numFeatures), numFeatures,
+                        slot->features.begin() + static_cast<long>(slot->rows * numFeatures));
+            slot->labels[slot->rows] = shuffleLabels[index];
+            if (++slot->rows == config.batchSize)
+            {
+                close();
+            }
+            return true;
+        };
+
+        while (!sourceDone)
+        {
+            if (held < capacity)
+            {
+                std::span<double> dest(shuffleFeatures.data() + held * numFeatures, numFeatures);
+                if (source->next(dest, shuffleLabels[held]))
+                {
+                    ++held;
+                    continue;
+                }
+                sourceDone = true;
+                break;
+            }
+            // buffer full, a random held row leaves and the next source row takes its place
+            size_t pick = std::uniform_int_distribution<size_t>(0, held - 1)(gen);
+            if (!emit(pick))
+            {
+                return;
+            }
+            std::span<double> dest(shuffleFeatures.data() + pick * numFeatures, numFeatures);
+            if (!source->next(dest, shuffleLabels[pick]))
+            {
+                // the picked row already left, close the gap with the last held row
+                --held;
+                std::copy_n(shuffleFeatures.begin() + static_cast<long>(held * numFeatures), numFeatures,
+                            shuffleFeatures.begin() + static_cast<long>(pick * numFeatures));
+                shuffleLabels[pick] = shuffleLabels[held];
+                sourceDone = true;
+            }
+        }
+
+        // drain the rest in random order
+        while (held > 0)
+        {
+            size_t pick = std::uniform_int_distribution<size_t>(0, held - 1)(gen);
+            if (!emit(pick))
+            {
+                return;
+            }
+            --held;
+            std::copy_n(shuffleFeatures.begin() + static_cast<long>(held * numFeatures), numFeatures,
+                        shuffleFeatures.begin() + static_cast<long>(pick * numFeatures));
+            shuffleLabels[pick] = shuffleLabels[held];
+        }
+        if (slot)
+        {
+            close();
+        }
+
+        // empty slot marks the end of the epoch
+        if (epoch < config.start.epoch)
+        {
+            continue;
+        }
+        if (!acquire(slot))
+        {
+            return;
+        }
+        slot->rows = 0;
+        slot->epoch = epoch;
+        publish();
+    }
+}
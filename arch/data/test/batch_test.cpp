@@ -0,0 +1,52 @@
+#include "../headr/batch.h"
+#include <gtest/gtest.h>
+
+class BatchTest : public ::testing::Test{};
+
+/**
+ * @brief: Tests for packing variable length sequences
+ */
+TEST_F(BatchTest, Pack)
+{
+    // Test 1: longest first, batch shrinks as sequences finish, no padded rows
+    std::vector<std::vector<double>> sequences = {
+        {1, 10, 2, 20},
+        {3, 30, 4, 40, 5, 50},
+        {},
+        {6, 60}
+    };
+    PackedBatch batch = packSequences(sequences, 2);
+    EXPECT_EQ(batch.numSequences(), 4) << "Sequence count mismatch";
+    EXPECT_EQ(batch.rows(), 6) << "Padding rows were packed";
+    EXPECT_EQ(batch.order, (std::vector<size_t>{1, 0, 3, 2})) << "Sequences not sorted by length";
+    EXPECT_EQ(batch.batchSizes, (std::vector<size_t>{3, 2, 1})) << "Batch sizes mismatch";
+    EXPECT_EQ(batch.stepOffsets, (std::vector<size_t>{0, 3, 5})) << "Step offsets mismatch";
+
+    // Test 2: every step holds the running sequences in sorted order
+    std::span<const double> first = batch.step(0);
+    EXPECT_EQ(first.size(), 6) << "Step size mismatch";
+    EXPECT_EQ(first[0], 3) << "Longest sequence not first";
+    EXPECT_EQ(first[2], 1) << "Second sequence misplaced";
+    EXPECT_EQ(first[5], 60) << "Shortest sequence misplaced";
+    EXPECT_EQ(batch.step(2)[1], 50) << "Last step mismatch";
+
+    // Test 3: malformed sequences are rejected
+    EXPECT_THROW(packSequences({{1, 2, 3}}, 2), std::invalid_argument) << "Partial timestep accepted";
+}
+
+/**
+ * @brief: Tests for unpacking per row values
+ */
+TEST_F(BatchTest, Unpack)
+{
+    // Test 1: values return to the caller's order and lengths
+    PackedBatch batch = packSequences({{1, 2}, {3, 4, 5}, {6}}, 1);
+    std::vector<double> packed(batch.data.begin(), batch.data.end());
+    std::vector<std::vector<double>> sequences = unpackSequences(batch, packed);
+    EXPECT_EQ(sequences[0], (std::vector<double>{1, 2})) << "First sequence mismatch";
+    EXPECT_EQ(sequences[1], (std::vector<double>{3, 4, 5})) << "Second sequence mismatch";
+    EXPECT_EQ(sequences[2], (std::vector<double>{6})) << "Third sequence mismatch";
+
+    // Test 2: size mismatch is rejected
+    EXPECT_THROW(unpackSequences(batch, std::vector<double>(2)), std::invalid_argument) << "Wrong size accepted";
+}
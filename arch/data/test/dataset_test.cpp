@@ -0,0 +1,65 @@
+#include "../headr/dataset.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <set>
+
+class DatasetTest : public ::testing::Test{};
+
+/**
+ * @brief: Tests for the CSV loader
+ */
+TEST_F(DatasetTest, LoadCsv)
+{
+    std::string path = ::testing::TempDir() + "dataset_test.csv";
+    {
+        std::ofstream file(path);
+        file << "# freq1,freq2,freq3,score\n";
+        file << "261.63,392.0,523.25,0.9\n";
+        file << "261.63,277.18,370.0,0.3\n";
+    }
+
+    // Test 1: shape
+    std::shared_ptr<const Dataset> data = loadCsv(path);
+    EXPECT_EQ(data->size(), 2) << "Row count mismatch";
+    EXPECT_EQ(data->numFeatures, 3) << "Feature count mismatch";
+
+    // Test 2: values
+    EXPECT_DOUBLE_EQ(data->row(1)[1], 277.18) << "Feature value mismatch";
+    EXPECT_DOUBLE_EQ(data->labels[0], 0.9) << "Label value mismatch";
+
+    // Test 3: missing file
+    EXPECT_THROW(loadCsv(path + ".missing"), std::invalid_argument) << "Missing file did not throw";
+    std::remove(path.c_str());
+}
+
+/**
+ * @brief: Tests for the k-fold splits
+ */
+TEST_F(DatasetTest, KFoldSplits)
+{
+    // Test 1: every row is validated exactly once and never trains in its own fold
+    std::vector<Fold> folds = kFoldSplits(23, 5, 7);
+    ASSERT_EQ(folds.size(), 5) << "Fold count mismatch";
+    std::multiset<size_t> seen;
+    for (const Fold& fold : folds)
+    {
+        EXPECT_EQ(fold.train.size() + fold.validation.size(), 23) << "Fold does not cover every row";
+        std::set<size_t> train(fold.train.begin(), fold.train.end());
+        for (size_t row : fold.validation)
+        {
+            EXPECT_EQ(train.count(row), 0) << "Validation row also in training set";
+            seen.insert(row);
+        }
+    }
+    EXPECT_EQ(seen.size(), 23) << "Rows missing from the validation sets";
+    EXPECT_EQ(std::set<size_t>(seen.begin(), seen.end()).size(), 23) << "Row validated twice";
+
+    // Test 2: same seed gives the same folds
+    EXPECT_EQ(kFoldSplits(23, 5, 7)[2].validation, folds[2].validation) << "Folds not reproducible";
+
+    // Test 3: k < 2 trains on everything
+    std::vector<Fold> single = kFoldSplits(4, 1, 0);
+    EXPECT_EQ(single.size(), 1) << "Single fold count mismatch";
+    EXPECT_EQ(single[0].train.size(), 4) << "Single fold should train on every row";
+}
@@ -0,0 +1,30 @@
+#include "../headr/generator.h"
+#include <gtest/gtest.h>
+
+class GeneratorTest : public ::testing::Test{};
+
+/**
+ * @brief: Tests for the C++ port of the python data generator
+ */
+TEST_F(GeneratorTest, Sequences)
+{
+    MusicDataGenerator generator(3);
+
+    // Test 1: length and frequency range
+    auto [frequencies, preference] = generator.classical(10);
+    ASSERT_EQ(frequencies.size(), 10) << "Sequence length mismatch";
+    for (double freq : frequencies)
+    {
+        EXPECT_GE(freq, 200.0) << "Frequency below range";
+        EXPECT_LE(freq, 1000.0) << "Frequency above range";
+    }
+    EXPECT_GE(preference, 0.2) << "Classical preference below its floor";
+
+    // Test 2: consonance score of pure octaves is 1, of a minor second is low
+    EXPECT_NEAR(MusicDataGenerator::consonanceScore({220.0, 440.0}), 1.0, 1e-12) << "Octave not fully consonant";
+    EXPECT_LT(MusicDataGenerator::consonanceScore({440.0, 440.0 * 16.0 / 15.0}), 0.7) << "Minor second too consonant";
+
+    // Test 3: same seed, same sequence
+    MusicDataGenerator again(3);
+    EXPECT_EQ(again.classical(10).first, frequencies) << "Generator not reproducible";
+}
@@ -0,0 +1,213 @@
+#include "../headr/loader.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <set>
+#include <stdexcept>
+#include <thread>
+
+class LoaderTest : public ::testing::Test{};
+
+namespace
+{
+    // rows 0..n-1, the feature and the label are both the row index
+    std::shared_ptr<const Dataset> indexDataset(size_t rows)
+    {
+        auto data = std::make_shared<Dataset>();
+        data->numFeatures = 2;
+        for (size_t i = 0; i < rows; ++i)
+        {
+            data->features.push_back(static_cast<double>(i));
+            data->features.push_back(-static_cast<double>(i));
+            data->labels.push_back(static_cast<double>(i));
+        }
+        return data;
+    }
+
+    // dataset source that takes a while per row, stands in for slow storage
+    class SlowSource final : public SampleSource
+    {
+        public:
+            explicit SlowSource(size_t rows) : rows(rows) {}
+
+            size_t numFeatures() const noexcept override { return 1; }
+
+            bool next(std::span<double> features, double& label) override
+            {
+                if (cursor == rows)
+                {
+                    return false;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                features[0] = label = static_cast<double>(cursor++);
+                return true;
+            }
+
+            void rewind() override { cursor = 0; }
+
+        private:
+            size_t rows;
+            size_t cursor = 0;
+    };
+
+    // every label of one epoch, checks the batch shapes on the way
+    std::vector<double> drainEpoch(PrefetchLoader& loader, size_t batchSize)
+    {
+        std::vector<double> labels;
+        while (const LoaderBatch* batch = loader.next())
+        {
+            EXPECT_LE(batch->rows, batchSize) << "Batch larger than configured";
+            for (size_t r = 0; r < batch->rows; ++r)
+            {
+                EXPECT_DOUBLE_EQ(batch->row(r)[0], batch->labels[r]) << "Row and label split up";
+                EXPECT_DOUBLE_EQ(batch->row(r)[1], -batch->labels[r]) << "Row features split up";
+                labels.push_back(batch->labels[r]);
+            }
+        }
+        return labels;
+    }
+}
+
+/**
+ * @brief: Tests for batching and the streaming shuffle
+ */
+TEST_F(LoaderTest, Batching)
+{
+    // Test 1: every epoch sees every row exactly once, shuffled, in batches of the configured size
+    LoaderConfig config;
+    config.batchSize = 10;
+    config.shuffleBuffer = 16;
+    config.epochs = 2;
+    config.seed = 7;
+    PrefetchLoader loader(std::make_unique<DatasetSource>(indexDataset(103)), config);
+    std::vector<double> first = drainEpoch(loader, 10);
+    std::vector<double> second = drainEpoch(loader, 10);
+    ASSERT_EQ(first.size(), 103) << "Rows lost in the first epoch";
+    ASSERT_EQ(second.size(), 103) << "Rows lost in the second epoch";
+    EXPECT_EQ(std::set<double>(first.begin(), first.end()).size(), 103) << "Rows repeated";
+    EXPECT_NE(first, second) << "Epochs share one order";
+    bool shuffled = false;
+    for (size_t i = 0; i < first.size(); ++i)
+    {
+        shuffled = shuffled || first[i] != static_cast<double>(i);
+    }
+    EXPECT_TRUE(shuffled) << "Rows not shuffled";
+    EXPECT_EQ(loader.next(), nullptr) << "Batches after the last epoch";
+    EXPECT_EQ(loader.stats().batches, 22) << "Batch count mismatch";
+
+    // Test 2: the same seed gives the same order, a one row buffer keeps the source order
+    PrefetchLoader again(std::make_unique<DatasetSource>(indexDataset(103)), config);
+    EXPECT_EQ(drainEpoch(again, 10), first) << "Shuffle not reproducible";
+    config.shuffleBuffer = 1;
+    config.epochs = 1;
+    PrefetchLoader ordered(std::make_unique<DatasetSource>(indexDataset(25)), config);
+    std::vector<double> inOrder = drainEpoch(ordered, 10);
+    for (size_t i = 0; i < inOrder.size(); ++i)
+    {
+        EXPECT_EQ(inOrder[i], static_cast<double>(i)) << "Source order changed at " << i;
+    }
+
+    // Test 3: a loader destroyed with batches still queued shuts down
+    config.prefetch = 1;
+    PrefetchLoader abandoned(std::make_unique<DatasetSource>(indexDataset(100)), config);
+    EXPECT_NE(abandoned.next(), nullptr) << "No first batch";
+}
+
+/**
+ * @brief: Tests for file streaming and error reporting
+ */
+TEST_F(LoaderTest, CsvStreaming)
+{
+    std::string path = ::testing::TempDir() + "loader_test.csv";
+    {
+        std::ofstream file(path);
+        file << "# feature,negated,label\n";
+        for (int i = 0; i < 40; ++i)
+        {
+            file << i << "," << -i << "," << i << "\n";
+        }
+    }
+
+    // Test 1: the file is streamed once per epoch
+    LoaderConfig config;
+    config.batchSize = 8;
+    config.shuffleBuffer = 5;
+    config.epochs = 2;
+    PrefetchLoader loader(std::make_unique<CsvSource>(path), config);
+    for (int epoch = 0; epoch < 2; ++epoch)
+    {
+        std::vector<double> labels = drainEpoch(loader, 8);
+        EXPECT_EQ(std::set<double>(labels.begin(), labels.end()).size(), 40) << "CSV rows lost in epoch " << epoch;
+    }
+
+    // Test 2: a bad row surfaces in the trainer thread
+    {
+        std::ofstream file(path, std::ios::app);
+        file << "1,2\n";
+    }
+    config.epochs = 1;
+    PrefetchLoader broken(std::make_unique<CsvSource>(path), config);
+    EXPECT_THROW(drainEpoch(broken, 8), std::invalid_argument) << "Loader error swallowed";
+    std::remove(path.c_str());
+}
+
+/**
+ * @brief: Tests for the stall accounting
+ */
+TEST_F(LoaderTest, Stalls)
+{
+    // Test 1: a slow source stalls the trainer
+    LoaderConfig config;
+    config.batchSize = 4;
+    config.shuffleBuffer = 1;
+    PrefetchLoader slow(std::make_unique<SlowSource>(24), config);
+    while (slow.next())
+    {
+    }
+    LoaderStats io = slow.stats();
+    EXPECT_GT(io.stalls, 0) << "Slow source never stalled the trainer";
+    EXPECT_GT(io.stalledSeconds, 0.0) << "No stalled time recorded";
+
+    // Test 2: a slow trainer leaves the loader waiting on a full ring instead
+    config.prefetch = 2;
+    PrefetchLoader fast(std::make_unique<DatasetSource>(indexDataset(64)), config);
+    while (fast.next())
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    EXPECT_GT(fast.stats().loaderIdleSeconds, 0.0) << "Loader never waited on the trainer";
+}
+
+/**
+ * @brief: Tests for resuming a loader at a saved position
+ */
+TEST_F(LoaderTest, Resume)
+{
+    // Test 1: the position counts the batches taken in the current epoch
+    LoaderConfig config;
+    config.batchSize = 8;
+    config.shuffleBuffer = 12;
+    config.epochs = 3;
+    config.seed = 11;
+    PrefetchLoader full(std::make_unique<DatasetSource>(indexDataset(50)), config);
+    std::vector<double> before = drainEpoch(full, 8);
+    for (int b = 0; b < 3; ++b)
+    {
+        ASSERT_NE(full.next(), nullptr) << "Second epoch ended early";
+    }
+    LoaderPosition saved = full.position();
+    EXPECT_EQ(saved.epoch, 1) << "Epoch position mismatch";
+    EXPECT_EQ(saved.batches, 3) << "Batch position mismatch";
+    std::vector<double> rest = drainEpoch(full, 8);
+    std::vector<double> last = drainEpoch(full, 8);
+    EXPECT_EQ(full.position().epoch, 3) << "Position not moved past the last epoch";
+
+    // Test 2: a loader started at the saved position hands out exactly the batches that followed
+    config.start = saved;
+    PrefetchLoader resumed(std::make_unique<DatasetSource>(indexDataset(50)), config);
+    EXPECT_EQ(drainEpoch(resumed, 8), rest) << "Resumed epoch differs";
+    EXPECT_EQ(drainEpoch(resumed, 8), last) << "Epoch after the resume differs";
+    EXPECT_EQ(resumed.next(), nullptr) << "Batches after the last epoch";
+    EXPECT_EQ(resumed.stats().batches, 4 + 7) << "Skipped batches reached the trainer";
+}
@@ -0,0 +1,115 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ *
+ * @class: ThreadPool -> work stealing pool for fork / join loops
+ *
+ * @note: every worker owns a deque, it pops its own work from the back and steals from the front of the
+ *          others when it runs dry. The thread calling parallelFor helps until its loop is done, so a
+ *          pool of N workers runs loops on N + 1 threads. Idle workers spin briefly before sleeping to keep
+ *          the wake up latency of back to back layers low
+ *
+ */
+class ThreadPool
+{
+    public:
+        /**
+         *
+         * @brief: constructor
+         *
+         * @param: workers -> type: size_t, background threads, 0 picks hardware_concurrency - 1
+         *
+         */
+        explicit ThreadPool(std::size_t workers = 0);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /**
+         *
+         * @brief: runs body(chunk, begin, end) over [0, count) split into chunks, blocks until all finished
+         *
+         * @param: count -> type: size_t, number of items
+         * @param: chunks -> type: size_t, number of pieces to split into (at most count)
+         * @param: body -> type: callable(size_t chunk, size_t begin, size_t end)
+         *
+         * @note: the first exception thrown by body is rethrown here once every chunk has finished
+         *
+         */
+        template <typename Body>
+        void parallelFor(std::size_t count, std::size_t chunks, Body&& body)
+        {
+            if (count == 0)
+            {
+                return;
+            }
+            chunks = std::max<std::size_t>(1, std::min(chunks, count));
+            Job job;
+            job.count = count;
+            job.chunks = chunks;
+            job.body = &body;
+            job.invoke = [](const void* fn, std::size_t chunk, std::size_t begin, std::size_t end)
+            {
+                (*static_cast<std::remove_reference_t<Body>*>(const_cast<void*>(fn)))(chunk, begin, end);
+            };
+            run(job);
+        }
+
+        // threads that execute a loop: the workers plus the caller
+        std::size_t size() const noexcept { return queues.size() + 1; }
+
+    private:
+        struct Job
+        {
+            void (*invoke)(const void*, std::size_t, std::size_t, std::size_t) = nullptr;
+            const void* body = nullptr;
+            std::size_t count = 0;
+            std::size_t chunks = 0;
+            std::atomic<std::size_t> remaining{0};
+            std::mutex errorLock;
+            std::exception_ptr error;
+        };
+
+        struct Task
+        {
+            Job* job;
+            std::size_t chunk;
+        };
+
+        // one per worker, padded so neighbouring queues never share a cache line
+        struct alignas(64) Queue
+        {
+            std::mutex lock;
+            std::deque<Task> tasks;
+        };
+
+        void run(Job& job);
+        void execute(const Task& task) noexcept;
+        bool popLocal(std::size_t self, Task& task);
+        bool steal(std::size_t self, Task& task);
+        void workerLoop(std::size_t self);
+
+        std::vector<std::unique_ptr<Queue>> queues;
+        std::vector<std::thread> threads;
+        std::atomic<std::size_t> pending{0};
+        std::atomic<bool> stopping{false};
+        std::atomic<std::size_t> nextQueue{0};
+        std::mutex sleepLock;
+        std::condition_variable wake;
+};
+
+#endif
@@ -0,0 +1,126 @@
+#ifndef REDUCE_H
+#define REDUCE_H
+
+#include "pool.h"
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+/**
+ *
+ * REDUCTION MODES:
+ *  - Fast lets every kernel sum in whatever order is quickest: Eigen picks its peeling from the data
+ *      alignment and its GEMM blocking from the detected cache sizes, and parallel partial sums are kept
+ *      per pool chunk, so their number and order follow the thread count
+ *  - Deterministic runs every dot product and sum of the node and layer kernels through fixedDot /
+ *      fixedSum, whose order depends on the length only, and splits parallel reductions into fixed leaves
+ *      combined by a fixed pairwise tree. The result then depends on the data only, the same bits on 1
+ *      or 64 threads
+ *  - the guarantee is per build: another compiler, -ffast-math, -ffp-contract or target ISA may still
+ *      change the last bits
+ *
+ */
+
+enum class ReductionMode
+{
+    Fast,
+    Deterministic
+};
+
+/**
+ *
+ * @brief: process wide mode, read by the kernels on every call, set it before training starts
+ *
+ */
+void setReductionMode(ReductionMode mode) noexcept;
+ReductionMode getReductionMode() noexcept;
+
+inline bool deterministicReductions() noexcept
+{
+    return getReductionMode() == ReductionMode::Deterministic;
+}
+
+// terms per leaf of a deterministic parallel sum
+constexpr std::size_t reductionLeaf = 256;
+
+/**
+ *
+ * @brief: dot product / sum in a fixed order, term i always goes to lane i % 4 and the lanes are added
+ *          pairwise, so the result does not depend on where the arrays sit in memory
+ *
+ */
+double fixedDot(const double* a, const double* b, std::size_t n) noexcept;
+double fixedSum(const double* a, std::size_t n) noexcept;
+
+/**
+ *
+ * @brief: adds leaves rows of width values pairwise, row i + stride into row i for stride 1, 2, 4 ...,
+ *          the total ends up in row 0
+ *
+ * @param: pool -> type: ThreadPool*, splits every level over pairs and columns, nullptr runs serially
+ * @param: partials -> type: span<double>, leaves * width values, row major, overwritten
+ * @param: leaves -> type: size_t, number of rows
+ * @param: width -> type: size_t, values per row
+ *
+ * @note: the tree depends on leaves only, the pool just runs the independent pairs of a level together
+ *
+ */
+void treeCombine(ThreadPool* pool, std::span<double> partials, std::size_t leaves, std::size_t width);
+
+/**
+ *
+ * @brief: sum of term(i) over [0, count), in parallel when a pool is given
+ *
+ * @param: pool -> type: ThreadPool*, nullptr sums on the calling thread
+ * @param: count -> type: size_t, number of terms
+ * @param: term -> type: callable(size_t) -> double, safe to call from any thread
+ * @param: leaf -> type: size_t, terms per leaf in the deterministic mode
+ * @return: double -> the sum, bit identical for any pool in the deterministic mode
+ *
+ */
+template <typename Term>
+double reduceSum(ThreadPool* pool, std::size_t count, Term&& term, std::size_t leaf = reductionLeaf)
+{
+    if (count == 0)
+    {
+        return 0.0;
+    }
+    bool fixed = deterministicReductions();
+    std::size_t parts = fixed ? (count + leaf - 1) / leaf : (pool ? pool->size() : 1);
+    std::size_t length = fixed ? leaf : (count + parts - 1) / parts;
+    std::vector<double> sums(parts, 0.0);
+    auto body = [&](std::size_t, std::size_t begin, std::size_t end)
+    {
+        for (std::size_t part = begin; part < end; ++part)
+        {
+            double sum = 0.0;
+            for (std::size_t i = part * length; i < std::min(count, (part + 1) * length); ++i)
+            {
+                sum += term(i);
+            }
+            sums[part] = sum;
+        }
+    };
+    if (pool == nullptr || parts == 1)
+    {
+        body(0, 0, parts);
+    }
+    else
+    {
+        pool->parallelFor(parts, fixed ? 2 * pool->size() : parts, body);
+    }
+    if (fixed)
+    {
+        treeCombine(nullptr, sums, parts, 1);
+        return sums[0];
+    }
+    double total = 0.0;
+    for (double sum : sums)
+    {
+        total += sum;
+    }
+    return total;
+}
+
+#endif
@@ -0,0 +1,199 @@
+#include "../headr/pool.h"
+#include <algorithm>
+
+namespace
+{
+    // idle iterations before a worker goes to sleep
+    constexpr int spinLimit = 2000;
+}
+
+/**
+ *
+ * @brief: constructor
+ *
+ * @param: workers .
+ * type: size_t, background threads, 0 picks hardware_concurrency - 1
+ *
+ */
+ThreadPool::ThreadPool(std::size_t workers)
+{
+    if (workers == 0)
+    {
+        unsigned hw = std::thread::hardware_concurrency();
+        workers = hw > 1 ? hw - 1 : 1;
+    }
+    for (std::size_t i = 0; i < workers; ++i)
+    {
+        queues.push_back(std::make_unique<Queue>());
+    }
+    threads.reserve(workers);
+    for (std::size_t i = 0; i < workers; ++i)
+    {
+        threads.emplace_back([this, i] { workerLoop(i); });
+    }
+}
+
+/**
+ *
+ * @brief: destructor, drains nothing, every parallelFor has already joined its work
+ *
+ */
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> guard(sleepLock);
+        stopping.store(true);
+    }
+    wake.notify_all();
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+/**
+ *
+ * @brief: spreads the chunks of a job over the worker queues and helps until the job is finished
+ *
+ */
+void ThreadPool::run(Job& job)
+{
+    job.remaining.store(job.chunks);
+    // the caller keeps chunk 0 for itself, the rest are dealt round robin starting at a rotating queue
+    std::size_t start = nextQueue.fetch_add(1, std::memory_order_relaxed);
+    for (std::size_t chunk = 1; chunk < job.chunks; ++chunk)
+    {
+        Queue& queue = *queues[(start + chunk) % queues.size()];
+        std::lock_guard<std::mutex> guard(queue.lock);
+        queue.tasks.push_back({&job, chunk});
+    }
+    if (job.chunks > 1)
+    {
+        pending.fetch_add(job.chunks - 1);
+        {
+            std::lock_guard<std::mutex> guard(sleepLock);
+        }
+        wake.notify_all();
+    }
+
+    execute({&job, 0});
+    Task task;
+    while (job.remaining.load(std::memory_order_acquire) != 0)
+    {
+        if (steal(queues.size(), task))
+        {
+            execute(task);
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+    if (job.error)
+    {
+        std::rethrow_exception(job.error);
+    }
+}
+
+/**
+ *
+ * @brief: runs one chunk, chunk boundaries are an even split of the job's range
+ *
+ */
+void ThreadPool::execute(const Task& task) noexcept
+{
+    Job& job = *task.job;
+    std::size_t begin = job.count * task.chunk / job.chunks;
+    std::size_t end = job.count * (task.chunk + 1) / job.chunks;
+    try
+    {
+        job.invoke(job.body, task.chunk, begin, end);
+    } catch (...)
+    {
+        std::lock_guard<std::mutex> guard(job.errorLock);
+        if (!job.error)
+        {
+            job.error = std::current_exception();
+        }
+    }
+    job.remaining.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+/**
+ *
+ * @brief: newest task of the worker's own queue
+ *
+ */
+bool ThreadPool::popLocal(std::size_t self, Task& task)
+{
+    Queue& queue = *queues[self];
+    std::lock_guard<std::mutex> guard(queue.lock);
+    if (queue.tasks.empty())
+    {
+        return false;
+    }
+    task = queue.tasks.back();
+    queue.tasks.pop_back();
+    pending.fetch_sub(1);
+    return true;
+}
+
+/**
+ *
+ * @brief: oldest task of any other queue, self == size() for the calling thread
+ *
+ */
+bool ThreadPool::steal(std::size_t self, Task& task)
+{
+    for (std::size_t offset = 1; offset <= queues.size(); ++offset)
+    {
+        std::size_t victim = (self + offset) % (queues.size() + 1);
+        if (victim == queues.size() || victim == self)
+        {
+            continue;
+        }
+        Queue& queue = *queues[victim];
+        std::unique_lock<std::mutex> guard(queue.lock, std::try_to_lock);
+        if (!guard.owns_lock() || queue.tasks.empty())
+        {
+            continue;
+        }
+        task = queue.tasks.front();
+        queue.tasks.pop_front();
+        pending.fetch_sub(1);
+        return true;
+    }
+    return false;
+}
+
+/**
+ *
+ * @brief: worker body, own queue first, then steal, then spin, then sleep
+ *
+ */
+void ThreadPool::workerLoop(std::size_t self)
+{
+    Task task;
+    int idle = 0;
+    while (true)
+    {
+        if (popLocal(self, task) || steal(self, task))
+        {
+            execute(task);
+            idle = 0;
+            continue;
+        }
+        if (++idle < spinLimit)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        std::unique_lock<std::mutex> guard(sleepLock);
+        wake.wait(guard, [this] { return stopping.load() || pending.load() > 0; });
+        if (stopping.load() && pending.load() == 0)
+        {
+            return;
+        }
+        idle = 0;
+    }
+}
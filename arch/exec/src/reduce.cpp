@@ -0,0 +1,112 @@
+#include "../headr/reduce.h"
+#include <algorithm>
+#include <atomic>
+
+namespace
+{
+    std::atomic<ReductionMode> mode{ReductionMode::Fast};
+
+    // columns per task of one tree level, 4KB of each row
+    constexpr std::size_t columnBlock = 512;
+}
+
+void setReductionMode(ReductionMode next) noexcept
+{
+    mode.store(next, std::memory_order_relaxed);
+}
+
+ReductionMode getReductionMode() noexcept
+{
+    return mode.load(std::memory_order_relaxed);
+}
+
+/**
+ *
+ * @brief: dot product in a fixed order, term i always goes to lane i % 4 and the lanes are added pairwise
+ *
+ * @note: the four lanes map onto one AVX register (two SSE ones), so the loop still vectorizes without
+ *          reassociating anything
+ *
+ */
+double fixedDot(const double* a, const double* b, std::size_t n) noexcept
+{
+    double lane[4] = {0.0, 0.0, 0.0, 0.0};
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        for (std::size_t k = 0; k < 4; ++k)
+        {
+            lane[k] += a[i + k] * b[i + k];
+        }
+    }
+    for (; i < n; ++i)
+    {
+        lane[i % 4] += a[i] * b[i];
+    }
+    return (lane[0] + lane[1]) + (lane[2] + lane[3]);
+}
+
+double fixedSum(const double* a, std::size_t n) noexcept
+{
+    double lane[4] = {0.0, 0.0, 0.0, 0.0};
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        for (std::size_t k = 0; k < 4; ++k)
+        {
+            lane[k] += a[i + k];
+        }
+    }
+    for (; i < n; ++i)
+    {
+        lane[i % 4] += a[i];
+    }
+    return (lane[0] + lane[1]) + (lane[2] + lane[3]);
+}
+
+/**
+ *
+ * @brief: adds leaves rows of width values pairwise, the total ends up in row 0
+ *
+ * @param: pool .
+ * type: ThreadPool*, splits every level over pairs and columns, nullptr runs serially
+ * @param: partials .
+ * type: span<double>, leaves * width values, row major, overwritten
+ * @param: leaves .
+ * type: size_t, number of rows
+ * @param: width .
+ * type: size_t, values per row
+ *
+ */
+void treeCombine(ThreadPool* pool, std::span<double> partials, std::size_t leaves, std::size_t width)
+{
+    std::size_t blocks = (width + columnBlock - 1) / columnBlock;
+    for (std::size_t stride = 1; stride < leaves; stride *= 2)
+    {
+        std::size_t pairs = (leaves - stride + 2 * stride - 1) / (2 * stride);
+        auto body = [&](std::size_t, std::size_t begin, std::size_t end)
+        {
+            for (std::size_t task = begin; task < end; ++task)
+            {
+                std::size_t row = (task / blocks) * 2 * stride;
+                std::size_t first = (task % blocks) * columnBlock;
+                std::size_t last = std::min(width, first + columnBlock);
+                double* into = partials.data() + row * width;
+                const double* from = partials.data() + (row + stride) * width;
+                for (std::size_t c = first; c < last; ++c)
+                {
+                    into[c] += from[c];
+                }
+            }
+        };
+        std::size_t tasks = pairs * blocks;
+        if (pool == nullptr || tasks == 1)
+        {
+            body(0, 0, tasks);
+        }
+        else
+        {
+            pool->parallelFor(tasks, 2 * pool->size(), body);
+        }
+    }
+}
@@ -0,0 +1,50 @@
+#include "../headr/pool.h"
+#include <gtest/gtest.h>
+#include <numeric>
+#include <stdexcept>
+
+class PoolTest : public ::testing::Test{};
+
+/**
+ * @brief: Tests for the work stealing parallel for
+ */
+TEST_F(PoolTest, ParallelFor)
+{
+    ThreadPool pool(3);
+    EXPECT_EQ(pool.size(), 4) << "Caller not counted as a thread";
+
+    // Test 1: every item is visited exactly once, chunks cover the range without gaps
+    std::vector<int> hits(10007, 0);
+    pool.parallelFor(hits.size(), 16, [&](size_t, size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            hits[i] += 1;
+        }
+    });
+    EXPECT_EQ(std::accumulate(hits.begin(), hits.end(), 0), 10007) << "Items missed or repeated";
+    EXPECT_EQ(*std::min_element(hits.begin(), hits.end()), 1) << "Item skipped";
+
+    // Test 2: back to back loops and more chunks than items
+    for (int round = 0; round < 200; ++round)
+    {
+        std::atomic<size_t> sum{0};
+        pool.parallelFor(5, 64, [&](size_t, size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                sum += i;
+            }
+        });
+        ASSERT_EQ(sum.load(), 10) << "Loop " << round << " lost work";
+    }
+
+    // Test 3: exceptions reach the caller after the loop has joined
+    EXPECT_THROW(pool.parallelFor(100, 8, [](size_t chunk, size_t, size_t)
+    {
+        if (chunk == 5)
+        {
+            throw std::runtime_error("chunk failed");
+        }
+    }), std::runtime_error) << "Exception swallowed";
+}
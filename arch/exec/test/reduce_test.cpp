@@ -0,0 +1,73 @@
+#include "../headr/reduce.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+
+class ReduceTest : public ::testing::Test{};
+
+/**
+ * @brief: Tests for the fixed order kernels
+ */
+TEST_F(ReduceTest, FixedKernels)
+{
+    // Test 1: the result depends on the values only, not on where they sit in memory
+    const size_t n = 1003;
+    std::vector<double> a(n + 8);
+    std::vector<double> b(n + 8);
+    double naive = 0.0;
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        a[i] = std::sin(0.37 * static_cast<double>(i)) * 1e3;
+        b[i] = std::cos(1.1 * static_cast<double>(i)) * 1e-3;
+        naive += a[i] * b[i];
+        sum += a[i];
+    }
+    double dot = fixedDot(a.data(), b.data(), n);
+    for (size_t shift = 1; shift < 4; ++shift)
+    {
+        std::vector<double> x(n + shift);
+        std::vector<double> y(n + shift);
+        std::copy_n(a.begin(), n, x.begin() + static_cast<long>(shift));
+        std::copy_n(b.begin(), n, y.begin() + static_cast<long>(shift));
+        EXPECT_EQ(fixedDot(x.data() + shift, y.data() + shift, n), dot) << "Dot depends on the offset " << shift;
+        EXPECT_EQ(fixedSum(x.data() + shift, n), fixedSum(a.data(), n)) << "Sum depends on the offset " << shift;
+    }
+    EXPECT_NEAR(dot, naive, 1e-9) << "Fixed dot mismatch";
+    EXPECT_NEAR(fixedSum(a.data(), n), sum, 1e-9) << "Fixed sum mismatch";
+    EXPECT_EQ(fixedDot(a.data(), b.data(), 0), 0.0) << "Empty dot not zero";
+    EXPECT_DOUBLE_EQ(fixedSum(a.data(), 3), a[0] + a[1] + a[2]) << "Tail sum mismatch";
+}
+
+/**
+ * @brief: Tests for the pairwise tree and the parallel sum
+ */
+TEST_F(ReduceTest, Tree)
+{
+    // Test 1: every row ends up in row 0, also for a leaf count that is not a power of two
+    ThreadPool pool(3);
+    const size_t leaves = 5;
+    const size_t width = 1100;
+    std::vector<double> partials(leaves * width);
+    for (size_t i = 0; i < partials.size(); ++i)
+    {
+        partials[i] = static_cast<double>(i % width) + static_cast<double>(i / width) * 1e4;
+    }
+    treeCombine(&pool, partials, leaves, width);
+    EXPECT_DOUBLE_EQ(partials[0], 1e5) << "First column mismatch";
+    EXPECT_DOUBLE_EQ(partials[width - 1], 5.0 * static_cast<double>(width - 1) + 1e5) << "Last column mismatch";
+
+    // Test 2: the deterministic sum is the same bits for every pool, fast mode agrees to rounding
+    auto term = [](size_t i) { return 1.0 / (1.0 + static_cast<double>(i)) * (i % 3 == 0 ? -1.0 : 1.0); };
+    ThreadPool one(1);
+    ThreadPool seven(7);
+    double fast = reduceSum(&seven, 100000, term);
+    setReductionMode(ReductionMode::Deterministic);
+    double serial = reduceSum(nullptr, 100000, term);
+    EXPECT_EQ(reduceSum(&one, 100000, term), serial) << "Two threads changed the sum";
+    EXPECT_EQ(reduceSum(&pool, 100000, term), serial) << "Four threads changed the sum";
+    EXPECT_EQ(reduceSum(&seven, 100000, term), serial) << "Eight threads changed the sum";
+    EXPECT_EQ(reduceSum(&seven, 0, term), 0.0) << "Empty sum not zero";
+    setReductionMode(ReductionMode::Fast);
+    EXPECT_NEAR(fast, serial, 1e-9) << "Fast and deterministic sums disagree";
+}
@@ -0,0 +1,170 @@
+#ifndef HARMONIC_H
+#define HARMONIC_H
+
+#include <cstddef>
+#include <functional>
+#include <span>
+#include <string>
+#include <vector>
+
+/**
+ *
+ * HARMONIC FRONTEND:
+ *  - the raw audio side of the classifier, the README's "harmonic frequency at each second" computed
+ *      in process instead of by an external preprocessing script
+ *  - a WAV file is streamed one window (one second by default) at a time, every window is Hann weighted,
+ *      zero padded to a power of two and run through a real FFT
+ *  - the dominant harmonic frequency is the fundamental of the strongest harmonic series, found with a
+ *      harmonic product spectrum and refined between bins by parabolic interpolation
+ *
+ */
+
+/**
+ *
+ * @class: RealFft -> radix 2 FFT of real input, split real / imaginary arrays
+ *
+ * @note: the N real samples are packed into an N / 2 point complex transform. Twiddles are precomputed
+ *          per stage and contiguous, and the butterflies walk plain double arrays, so the inner loops
+ *          vectorise
+ *
+ */
+class RealFft
+{
+    public:
+        /**
+         *
+         * @brief: constructor
+         *
+         * @param: size -> type: size_t, transform length, a power of two of at least 4
+         *
+         */
+        explicit RealFft(size_t size);
+
+        /**
+         *
+         * @brief: power spectrum of input
+         *
+         * @param: input -> type: span<const double>, size() samples
+         * @param: power -> type: span<double>, size() / 2 + 1 bins of |X_k|^2
+         *
+         */
+        void powerSpectrum(std::span<const double> input, std::span<double> power);
+
+        size_t size() const noexcept { return length; }
+
+    private:
+        // in place complex FFT of half = length / 2 points held in re / im
+        void complexFft();
+
+        size_t length;
+        size_t half;
+        std::vector<size_t> bitReverse;
+        std::vector<double> stageCos;
+        std::vector<double> stageSin;
+        std::vector<double> splitCos;
+        std::vector<double> splitSin;
+        std::vector<double> re;
+        std::vector<double> im;
+};
+
+/**
+ *
+ * @struct: HarmonicConfig -> window and search range of the harmonic frontend
+ *
+ * @values:
+ *     windowSeconds -> type: double, seconds per output frequency (one per second for the classifier)
+ *     harmonics -> type: size_t, harmonics multiplied into the product spectrum, 1 picks the loudest bin
+ *     minFrequency -> type: double, lowest fundamental searched in Hz
+ *     maxFrequency -> type: double, highest fundamental searched in Hz
+ *     silenceRms -> type: double, windows quieter than this repeat the previous frequency
+ *
+ */
+struct HarmonicConfig
+{
+    double windowSeconds = 1.0;
+    size_t harmonics = 3;
+    double minFrequency = 60.0;
+    double maxFrequency = 2000.0;
+    double silenceRms = 1e-3;
+};
+
+/**
+ *
+ * @class: HarmonicExtractor -> dominant harmonic frequency of fixed length windows
+ *
+ */
+class HarmonicExtractor
+{
+    public:
+        /**
+         *
+         * @brief: sizes the window, FFT and spectrum buffers for a sample rate
+         *
+         * @param: sampleRate -> type: double, samples per second of the audio
+         * @param: config -> type: HarmonicConfig, window and search range
+         *
+         */
+        HarmonicExtractor(double sampleRate, HarmonicConfig config = {});
+
+        /**
+         *
+         * @brief: dominant frequency of one window
+         *
+         * @param: window -> type: span<const double>, windowSize() mono samples
+         * @return: double -> frequency in Hz, 0 for a silent window
+         *
+         */
+        double dominantFrequency(std::span<const double> window);
+
+        size_t windowSize() const noexcept { return window; }
+        size_t fftSize() const noexcept { return fft.size(); }
+        const HarmonicConfig& getConfig() const noexcept { return config; }
+
+    private:
+        HarmonicConfig config;
+        double sampleRate;
+        size_t window;
+        RealFft fft;
+        std::vector<double> hann;
+        std::vector<double> padded;
+        std::vector<double> power;
+        std::vector<double> logMagnitude;
+};
+
+/**
+ *
+ * @brief: streams a WAV file window by window, calling onWindow with every dominant frequency
+ *
+ * @param: path -> type: const std::string&, WAV file
+ * @param: onWindow -> type: std::function<void(double)>, called once per full window in order
+ * @param: config -> type: HarmonicConfig, window and search range
+ * @return: size_t -> number of windows, a trailing partial window is dropped
+ *
+ * @note: silent windows repeat the last frequency, leading silence is skipped so every emitted value
+ *          is a real pitch
+ *
+ */
+size_t streamFrequencies(const std::string& path, const std::function<void(double)>& onWindow,
+                         HarmonicConfig config = {});
+
+/**
+ *
+ * @brief: one dominant frequency per window of a WAV file
+ *
+ */
+std::vector<double> extractFrequencies(const std::string& path, HarmonicConfig config = {});
+
+/**
+ *
+ * @brief: cuts a frequency track into consecutive rows for NetworkLayer::setInputLayer / the classifier
+ *
+ * @param: frequencies -> type: span<const double>, one frequency per window
+ * @param: rowLength -> type: size_t, frequencies per row (the classifier's numInputs)
+ * @param: stride -> type: size_t, windows between row starts, 0 uses rowLength (no overlap)
+ * @return: std::vector<std::vector<double>> -> every full row, a short tail is dropped
+ *
+ */
+std::vector<std::vector<double>> frequencyRows(std::span<const double> frequencies, size_t rowLength,
+                                               size_t stride = 0);
+
+#endif
@@ -0,0 +1,155 @@
+#ifndef INTERVAL_H
+#define INTERVAL_H
+
+#include <array>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+/**
+ *
+ * INTERVAL ENTROPY:
+ *  - the information entropy idea from layer.h made concrete: a listener used to jazz chords gets more
+ *      information out of a track whose intervals are spread over many classes than one that only moves
+ *      in fifths
+ *  - every new frequency is classified against the consonant / dissonant ratio tables of dEngineer.py and
+ *      the histogram, its Shannon entropy and the consonance statistics are updated in O(1)
+ *  - the all pairs consonance score of calculate_consonance_score is kept as well, against a one cent
+ *      pitch class histogram, so each note costs a fixed 1200 multiply adds instead of a pass over the
+ *      whole sequence
+ *
+ */
+
+/**
+ *
+ * @class: IntervalTracker -> streaming interval histogram and consonance statistics of one sequence
+ *
+ */
+class IntervalTracker
+{
+    public:
+        // normalised entropy, consonant fraction, interval consonance, pitch consonance
+        static constexpr size_t numChannels = 4;
+        // pitch class bins per octave
+        static constexpr size_t pitchBins = 1200;
+
+        enum class Interval
+        {
+            Unison, MinorSecond, MinorThird, MajorThird, PerfectFourth, Tritone, PerfectFifth, MajorSixth,
+            MajorSeventh, Octave, Other
+        };
+        static constexpr size_t numClasses = 11;
+
+        IntervalTracker();
+
+        /**
+         *
+         * @brief: adds the next frequency of the sequence
+         *
+         * @param: freq -> type: double, frequency in Hz, a non positive (silent / unvoiced) or non finite frame
+         *                  is skipped, holding the previous pitch
+         *
+         */
+        void push(double freq) noexcept;
+
+        /**
+         *
+         * @brief: forgets the sequence, the next push starts a new one
+         *
+         */
+        void reset() noexcept;
+
+        /**
+         *
+         * @brief: Shannon entropy of the interval histogram in nats, 0 before the first interval
+         *
+         */
+        double entropy() const noexcept;
+
+        /**
+         *
+         * @brief: entropy divided by its maximum log(numClasses), in [0, 1]
+         *
+         */
+        double normalizedEntropy() const noexcept;
+
+        /**
+         *
+         * @brief: fraction of the intervals that fall in the consonant table
+         *
+         */
+        double consonantFraction() const noexcept;
+
+        /**
+         *
+         * @brief: mean pairScore of consecutive frequencies
+         *
+         */
+        double intervalConsonance() const noexcept;
+
+        /**
+         *
+         * @brief: mean octave folded pairScore over every pair of frequencies so far, 0 below two
+         *
+         */
+        double pitchConsonance() const noexcept;
+
+        /**
+         *
+         * @brief: writes the current statistics as classifier / listener input channels
+         *
+         * @param: out -> type: span<double>, numChannels values
+         *
+         */
+        void channels(std::span<double> out) const;
+
+        size_t count(Interval interval) const noexcept { return counts[static_cast<size_t>(interval)]; }
+        size_t getNumIntervals() const noexcept { return intervals; }
+        size_t getNumNotes() const noexcept { return notes; }
+
+        /**
+         *
+         * @brief: nearest named interval of a frequency ratio, octaves folded away
+         *
+         * @param: ratio -> type: double, higher over lower frequency, at least 1
+         * @return: Interval -> Other when no table ratio is within a quarter tone and a bit
+         *
+         */
+        static Interval classify(double ratio) noexcept;
+
+        /**
+         *
+         * @brief: dEngineer.py's pair score, 1 / (1 + 10 * distance to the nearest consonant ratio)
+         *
+         * @param: ratio -> type: double, higher over lower frequency
+         *
+         */
+        static double pairScore(double ratio) noexcept;
+
+        static bool isConsonant(Interval interval) noexcept;
+
+    private:
+        std::array<size_t, numClasses> counts;
+        // sum of c log c over the histogram, entropy = log N - plogp / N
+        double plogp;
+        size_t intervals;
+        size_t consonant;
+        double intervalScore;
+
+        std::vector<double> pitchCounts;
+        double pairSum;
+        size_t notes;
+        double previous;
+};
+
+/**
+ *
+ * @brief: interval channels after every frequency of a sequence
+ *
+ * @param: frequencies -> type: span<const double>, one frequency per second
+ * @return: std::vector<double> -> frequencies.size() rows of IntervalTracker::numChannels values
+ *
+ */
+std::vector<double> intervalChannels(std::span<const double> frequencies);
+
+#endif
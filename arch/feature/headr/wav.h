@@ -0,0 +1,76 @@
+#ifndef WAV_H
+#define WAV_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <span>
+#include <string>
+#include <vector>
+
+/**
+ *
+ * @class: WavReader -> streaming decoder for local RIFF / WAVE files
+ *
+ * @note: handles integer PCM (8, 16, 24 and 32 bit), 32 and 64 bit float and the extensible header
+ *          wrapping either. Frames are decoded block by block through a fixed byte buffer and mixed down
+ *          to mono in [-1, 1], so a recording of any length is never held in memory
+ *
+ */
+class WavReader
+{
+    public:
+        /**
+         *
+         * @brief: opens the file and parses the header up to the start of the samples
+         *
+         * @param: path -> type: const std::string&, WAV file to stream
+         *
+         */
+        explicit WavReader(const std::string& path);
+
+        /**
+         *
+         * @brief: decodes the next frames, every channel averaged into one mono sample
+         *
+         * @param: out -> type: span<double>, receives up to out.size() mono samples
+         * @return: size_t -> samples written, less than out.size() only at the end of the data
+         *
+         */
+        size_t read(std::span<double> out);
+
+        /**
+         *
+         * @brief: goes back to the first frame
+         *
+         */
+        void rewind();
+
+        uint32_t getSampleRate() const noexcept { return sampleRate; }
+        uint16_t getChannels() const noexcept { return channels; }
+        uint16_t getBitsPerSample() const noexcept { return bitsPerSample; }
+        uint64_t getNumFrames() const noexcept { return numFrames; }
+        uint64_t getFramesLeft() const noexcept { return framesLeft; }
+
+        // bytes decoded per block, bounds the reader's memory
+        static constexpr size_t blockBytes = 1 << 16;
+
+    private:
+        enum class Encoding { Int, Float };
+
+        // one channel sample at bytes, scaled to [-1, 1]
+        double decode(const unsigned char* bytes) const noexcept;
+
+        std::ifstream file;
+        std::vector<unsigned char> block;
+        Encoding encoding = Encoding::Int;
+        uint32_t sampleRate = 0;
+        uint16_t channels = 0;
+        uint16_t bitsPerSample = 0;
+        uint16_t frameBytes = 0;
+        uint64_t numFrames = 0;
+        uint64_t framesLeft = 0;
+        std::streampos dataStart = 0;
+};
+
+#endif
@@ -0,0 +1,351 @@
+#include "../headr/harmonic.h"
+#include "../headr/wav.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numbers>
+#include <stdexcept>
+
+namespace
+{
+    // candidates quieter than this fraction of the loudest bin are not taken as fundamentals
+    constexpr double peakFraction = 0.1;
+    // harmonics are floored at this fraction of the loudest bin so one missing harmonic cannot zero a score
+    constexpr double floorFraction = 1e-3;
+
+    size_t nextPowerOfTwo(size_t val) noexcept
+    {
+        size_t size = 4;
+        while (size < val)
+        {
+            size <<= 1;
+        }
+        return size;
+    }
+}
+
+/**
+ *
+ * @brief: constructor
+ *
+ * @param: size .
+ * type: size_t, transform length, a power of two of at least 4
+ *
+ */
+RealFft::RealFft(size_t size)
+        : length(size), half(size / 2)
+{
+    if (size < 4 || (size & (size - 1)) != 0)
+    {
+        throw std::invalid_argument("FFT size must be a power of two of at least 4");
+    }
+    bitReverse.resize(half);
+    size_t bits = 0;
+    while ((size_t(1) << bits) < half)
+    {
+        ++bits;
+    }
+    for (size_t i = 0; i < half; ++i)
+    {
+        size_t rev = 0;
+        for (size_t b = 0; b < bits; ++b)
+        {
+            rev |= ((i >> b) & 1) << (bits - 1 - b);
+        }
+        bitReverse[i] = rev;
+    }
+
+    // stage with span len keeps its len / 2 twiddles at offset len / 2 - 1
+    stageCos.resize(half);
+    stageSin.resize(half);
+    for (size_t len = 2; len <= half; len <<= 1)
+    {
+        size_t offset = len / 2 - 1;
+        for (size_t j = 0; j < len / 2; ++j)
+        {
+            double angle = 2.0 * std::numbers::pi * static_cast<double>(j) / static_cast<double>(len);
+            stageCos[offset + j] = std::cos(angle);
+            stageSin[offset + j] = -std::sin(angle);
+        }
+    }
+    splitCos.resize(half + 1);
+    splitSin.resize(half + 1);
+    for (size_t k = 0; k <= half; ++k)
+    {
+        double angle = 2.0 * std::numbers::pi * static_cast<double>(k) / static_cast<double>(length);
+        splitCos[k] = std::cos(angle);
+        splitSin[k] = -std::sin(angle);
+    }
+    re.resize(half);
+    im.resize(half);
+}
+
+/**
+ *
+ * @brief: in place iterative decimation in time FFT of the half length complex signal in re / im
+ *
+ */
+void RealFft::complexFft()
+{
+    for (size_t i = 0; i < half; ++i)
+    {
+        size_t j = bitReverse[i];
+        if (i < j)
+        {
+            std::swap(re[i], re[j]);
+            std::swap(im[i], im[j]);
+        }
+    }
+    double* r = re.data();
+    double* m = im.data();
+    for (size_t len = 2; len <= half; len <<= 1)
+    {
+        size_t span = len / 2;
+        const double* wc = stageCos.data() + span - 1;
+        const double* ws = stageSin.data() + span - 1;
+        for (size_t start = 0; start < half; start += len)
+        {
+            double* ar = r + start;
+            double* ai = m + start;
+            double* br = ar + span;
+            double* bi = ai + span;
+            for (size_t j = 0; j < span; ++j)
+            {
+                double tr = br[j] * wc[j] - bi[j] * ws[j];
+                double ti = br[j] * ws[j] + bi[j] * wc[j];
+                br[j] = ar[j] - tr;
+                bi[j] = ai[j] - ti;
+                ar[j] += tr;
+                ai[j] += ti;
+            }
+        }
+    }
+}
+
+/**
+ *
+ * @brief: power spectrum of input
+ *
+ * @param: input .
+ * type: span<const double>, size() samples
+ * @param: power .
+ * type: span<double>, size() / 2 + 1 bins of |X_k|^2
+ *
+ * @note: even samples go to the real part and odd samples to the imaginary part of a half length
+ *          transform Z, then X_k = E_k + W^k O_k with E_k = (Z_k + conj Z_{M-k}) / 2 and
+ *          O_k = -i (Z_k - conj Z_{M-k}) / 2
+ *
+ */
+void RealFft::powerSpectrum(std::span<const double> input, std::span<double> power)
+{
+    if (input.size() != length || power.size() != half + 1)
+    {
+        throw std::invalid_argument("FFT buffers do not match the transform size");
+    }
+    for (size_t i = 0; i < half; ++i)
+    {
+        re[i] = input[2 * i];
+        im[i] = input[2 * i + 1];
+    }
+    complexFft();
+    for (size_t k = 0; k <= half; ++k)
+    {
+        size_t a = k % half;
+        size_t b = (half - k) % half;
+        double er = 0.5 * (re[a] + re[b]);
+        double ei = 0.5 * (im[a] - im[b]);
+        double orr = 0.5 * (im[a] + im[b]);
+        double oi = -0.5 * (re[a] - re[b]);
+        double xr = er + splitCos[k] * orr - splitSin[k] * oi;
+        double xi = ei + splitCos[k] * oi + splitSin[k] * orr;
+        power[k] = xr * xr + xi * xi;
+    }
+}
+
+/**
+ *
+ * @brief: sizes the window, FFT and spectrum buffers for a sample rate
+ *
+ * @param: sampleRate .
+ * type: double, samples per second of the audio
+ * @param: config .
+ * type: HarmonicConfig, window and search range
+ *
+ */
+HarmonicExtractor::HarmonicExtractor(double sampleRate, HarmonicConfig config)
+        : config(config), sampleRate(sampleRate),
+          window(static_cast<size_t>(std::llround(sampleRate * config.windowSeconds))),
+          fft(nextPowerOfTwo(window))
+{
+    if (sampleRate <= 0.0 || window < 4)
+    {
+        throw std::invalid_argument("Harmonic window needs a positive sample rate and at least 4 samples");
+    }
+    if (config.harmonics == 0 || config.minFrequency <= 0.0 || config.maxFrequency <= config.minFrequency)
+    {
+        throw std::invalid_argument("Harmonic search range is empty");
+    }
+    hann.resize(window);
+    for (size_t i = 0; i < window; ++i)
+    {
+        hann[i] = 0.5 - 0.5 * std::cos(2.0 * std::numbers::pi * static_cast<double>(i) / static_cast<double>(window - 1));
+    }
+    padded.assign(fft.size(), 0.0);
+    power.resize(fft.size() / 2 + 1);
+    logMagnitude.resize(power.size());
+}
+
+/**
+ *
+ * @brief: dominant frequency of one window
+ *
+ * @param: window .
+ * type: span<const double>, windowSize() mono samples
+ * @return: double .
+ * frequency in Hz, 0 for a silent window
+ *
+ * @note: every loud local peak in the search range is a candidate fundamental, its score is the sum of
+ *          the log magnitudes at its first `harmonics` multiples (each within one bin), the best candidate
+ *          is refined with a parabola through the log magnitudes around it
+ *
+ */
+double HarmonicExtractor::dominantFrequency(std::span<const double> samples)
+{
+    if (samples.size() != window)
+    {
+        throw std::invalid_argument("Harmonic window size mismatch");
+    }
+    double energy = 0.0;
+    for (size_t i = 0; i < window; ++i)
+    {
+        padded[i] = samples[i] * hann[i];
+        energy += samples[i] * samples[i];
+    }
+    if (std::sqrt(energy / static_cast<double>(window)) < config.silenceRms)
+    {
+        return 0.0;
+    }
+    fft.powerSpectrum(padded, power);
+
+    // magnitudes in log space, floored relative to the loudest bin
+    double binHz = sampleRate / static_cast<double>(fft.size());
+    size_t last = power.size() - 1;
+    size_t lo = std::max<size_t>(1, static_cast<size_t>(std::ceil(config.minFrequency / binHz)));
+    size_t hi = std::min(last - 1, static_cast<size_t>(config.maxFrequency / binHz));
+    double loudest = *std::max_element(power.begin() + 1, power.end());
+    double floor = loudest * floorFraction * floorFraction;
+    for (size_t k = 0; k <= last; ++k)
+    {
+        logMagnitude[k] = 0.5 * std::log(std::max(power[k], floor));
+    }
+
+    double threshold = 0.5 * std::log(loudest * peakFraction * peakFraction);
+    double bestScore = -std::numeric_limits<double>::infinity();
+    size_t best = 0;
+    for (size_t k = lo; k <= hi; ++k)
+    {
+        if (logMagnitude[k] < threshold || logMagnitude[k] < logMagnitude[k - 1] || logMagnitude[k] < logMagnitude[k + 1])
+        {
+            continue;
+        }
+        double score = logMagnitude[k];
+        for (size_t h = 2; h <= config.harmonics; ++h)
+        {
+            size_t centre = h * k;
+            double harmonic = 0.5 * std::log(floor);
+            for (size_t b = centre - 1; b <= centre + 1 && b <= last; ++b)
+            {
+                harmonic = std::max(harmonic, logMagnitude[b]);
+            }
+            score += harmonic;
+        }
+        if (score > bestScore)
+        {
+            bestScore = score;
+            best = k;
+        }
+    }
+    if (best == 0)
+    {
+        return 0.0;
+    }
+    double left = logMagnitude[best - 1];
+    double centre = logMagnitude[best];
+    double right = logMagnitude[best + 1];
+    double curve = left - 2.0 * centre + right;
+    double offset = curve < 0.0 ? 0.5 * (left - right) / curve : 0.0;
+    return (static_cast<double>(best) + offset) * binHz;
+}
+
+/**
+ *
+ * @brief: streams a WAV file window by window, calling onWindow with every dominant frequency
+ *
+ * @param: path .
+ * type: const std::string&, WAV file
+ * @param: onWindow .
+ * type: std::function<void(double)>, called once per full window in order
+ * @param: config .
+ * type: HarmonicConfig, window and search range
+ * @return: size_t .
+ * number of windows, a trailing partial window is dropped
+ *
+ */
+size_t streamFrequencies(const std::string& path, const std::function<void(double)>& onWindow, HarmonicConfig config)
+{
+    WavReader reader(path);
+    HarmonicExtractor extractor(static_cast<double>(reader.getSampleRate()), config);
+    std::vector<double> samples(extractor.windowSize());
+    double previous = 0.0;
+    size_t windows = 0;
+    while (reader.read(samples) == samples.size())
+    {
+        double freq = extractor.dominantFrequency(samples);
+        if (freq <= 0.0)
+        {
+            // silence holds the last pitch, leading silence has none to hold
+            if (previous <= 0.0)
+            {
+                continue;
+            }
+            freq = previous;
+        }
+        previous = freq;
+        onWindow(freq);
+        ++windows;
+    }
+    return windows;
+}
+
+/**
+ *
+ * @brief: one dominant frequency per window of a WAV file
+ *
+ */
+std::vector<double> extractFrequencies(const std::string& path, HarmonicConfig config)
+{
+    std::vector<double> frequencies;
+    streamFrequencies(path, [&](double freq) { frequencies.push_back(freq); }, config);
+    return frequencies;
+}
+
+/**
+ *
+ * @brief: cuts a frequency track into consecutive rows for NetworkLayer::setInputLayer / the classifier
+ *
+ */
+std::vector<std::vector<double>> frequencyRows(std::span<const double> frequencies, size_t rowLength, size_t stride)
+{
+    if (rowLength == 0)
+    {
+        throw std::invalid_argument("Frequency rows need at least one value");
+    }
+    stride = stride == 0 ? rowLength : stride;
+    std::vector<std::vector<double>> rows;
+    for (size_t start = 0; start + rowLength <= frequencies.size(); start += stride)
+    {
+        rows.emplace_back(frequencies.begin() + static_cast<long>(start),
+                          frequencies.begin() + static_cast<long>(start + rowLength));
+    }
+    return rows;
+}
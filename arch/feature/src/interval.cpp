@@ -0,0 +1,275 @@
+#include "../headr/interval.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace
+{
+    // dEngineer.py consonant_ratios, the dissonant_ratios are the named entries below that are not in here
+    constexpr std::array<double, 7> consonantRatios = {1.0, 2.0, 3.0 / 2.0, 4.0 / 3.0, 5.0 / 4.0, 6.0 / 5.0, 5.0 / 3.0};
+
+    struct Named
+    {
+        double ratio;
+        IntervalTracker::Interval interval;
+    };
+    // every table ratio inside one octave, unison / octave are told apart by the unfolded ratio
+    constexpr std::array<Named, 8> namedRatios = {{
+        {16.0 / 15.0, IntervalTracker::Interval::MinorSecond},
+        {6.0 / 5.0, IntervalTracker::Interval::MinorThird},
+        {5.0 / 4.0, IntervalTracker::Interval::MajorThird},
+        {4.0 / 3.0, IntervalTracker::Interval::PerfectFourth},
+        {45.0 / 32.0, IntervalTracker::Interval::Tritone},
+        {3.0 / 2.0, IntervalTracker::Interval::PerfectFifth},
+        {5.0 / 3.0, IntervalTracker::Interval::MajorSixth},
+        {15.0 / 8.0, IntervalTracker::Interval::MajorSeventh},
+    }};
+    // half the gap between the closest table entries (minor and major third, 70 cents)
+    constexpr double toleranceCents = 35.0;
+
+    double cents(double ratio) noexcept
+    {
+        return 1200.0 * std::log2(ratio);
+    }
+
+    double xlogx(double count) noexcept
+    {
+        return count > 0.0 ? count * std::log(count) : 0.0;
+    }
+
+    // pair score of two pitch classes d cents apart, the better of the interval and its inversion
+    const std::vector<double>& pitchTable()
+    {
+        static const std::vector<double> table = []
+        {
+            std::vector<double> values(IntervalTracker::pitchBins);
+            for (size_t d = 0; d < values.size(); ++d)
+            {
+                double ratio = std::exp2(static_cast<double>(d) / static_cast<double>(values.size()));
+                values[d] = std::max(IntervalTracker::pairScore(ratio), IntervalTracker::pairScore(2.0 / ratio));
+            }
+            return values;
+        }();
+        return table;
+    }
+}
+
+IntervalTracker::IntervalTracker()
+        : pitchCounts(pitchBins, 0.0)
+{
+    reset();
+}
+
+/**
+ *
+ * @brief: nearest named interval of a frequency ratio, octaves folded away
+ *
+ * @param: ratio .
+ * type: double, higher over lower frequency, at least 1
+ * @return: Interval .
+ * Other when no table ratio is within a quarter tone and a bit
+ *
+ */
+IntervalTracker::Interval IntervalTracker::classify(double ratio) noexcept
+{
+    double total = cents(ratio);
+    double folded = std::fmod(total, 1200.0);
+    if (folded > 1200.0 - toleranceCents)
+    {
+        folded -= 1200.0;
+    }
+    if (std::abs(folded) <= toleranceCents)
+    {
+        return total < 600.0 ? Interval::Unison : Interval::Octave;
+    }
+    for (const Named& named : namedRatios)
+    {
+        if (std::abs(folded - cents(named.ratio)) <= toleranceCents)
+        {
+            return named.interval;
+        }
+    }
+    return Interval::Other;
+}
+
+/**
+ *
+ * @brief: dEngineer.py's pair score, 1 / (1 + 10 * distance to the nearest consonant ratio)
+ *
+ * @param: ratio .
+ * type: double, higher over lower frequency
+ *
+ */
+double IntervalTracker::pairScore(double ratio) noexcept
+{
+    double distance = std::numeric_limits<double>::infinity();
+    for (double consonantRatio : consonantRatios)
+    {
+        distance = std::min(distance, std::abs(ratio - consonantRatio));
+    }
+    return 1.0 / (1.0 + 10.0 * distance);
+}
+
+bool IntervalTracker::isConsonant(Interval interval) noexcept
+{
+    switch (interval)
+    {
+        case Interval::Unison:
+        case Interval::Octave:
+        case Interval::PerfectFifth:
+        case Interval::PerfectFourth:
+        case Interval::MajorThird:
+        case Interval::MinorThird:
+        case Interval::MajorSixth:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ *
+ * @brief: adds the next frequency of the sequence
+ *
+ * @param: freq .
+ * type: double, frequency in Hz, a non positive (silent / unvoiced) or non finite frame is skipped
+ *
+ * @note: a skipped frame holds the previous pitch, the next note's interval is taken against it
+ *
+ */
+void IntervalTracker::push(double freq) noexcept
+{
+    if (!(freq > 0.0) || !std::isfinite(freq))
+    {
+        return;
+    }
+
+    // pitch class against every earlier note, one rotated dot product over the histogram
+    const std::vector<double>& table = pitchTable();
+    double position = std::fmod(std::log2(freq) * static_cast<double>(pitchBins), static_cast<double>(pitchBins));
+    size_t bin = static_cast<size_t>(std::llround(position < 0.0 ? position + pitchBins : position)) % pitchBins;
+    if (notes > 0)
+    {
+        double sum = 0.0;
+        for (size_t b = 0; b <= bin; ++b)
+        {
+            sum += pitchCounts[b] * table[bin - b];
+        }
+        for (size_t b = bin + 1; b < pitchBins; ++b)
+        {
+            sum += pitchCounts[b] * table[b - bin];
+        }
+        pairSum += sum;
+    }
+    pitchCounts[bin] += 1.0;
+
+    if (notes > 0)
+    {
+        double ratio = std::max(freq, previous) / std::min(freq, previous);
+        size_t cls = static_cast<size_t>(classify(ratio));
+        double before = static_cast<double>(counts[cls]);
+        plogp += xlogx(before + 1.0) - xlogx(before);
+        ++counts[cls];
+        ++intervals;
+        consonant += isConsonant(static_cast<Interval>(cls)) ? 1 : 0;
+        intervalScore += pairScore(ratio);
+    }
+    previous = freq;
+    ++notes;
+}
+
+/**
+ *
+ * @brief: forgets the sequence, the next push starts a new one
+ *
+ */
+void IntervalTracker::reset() noexcept
+{
+    counts.fill(0);
+    plogp = 0.0;
+    intervals = 0;
+    consonant = 0;
+    intervalScore = 0.0;
+    std::fill(pitchCounts.begin(), pitchCounts.end(), 0.0);
+    pairSum = 0.0;
+    notes = 0;
+    previous = 0.0;
+}
+
+double IntervalTracker::entropy() const noexcept
+{
+    if (intervals == 0)
+    {
+        return 0.0;
+    }
+    double n = static_cast<double>(intervals);
+    return std::max(0.0, std::log(n) - plogp / n);
+}
+
+double IntervalTracker::normalizedEntropy() const noexcept
+{
+    return entropy() / std::log(static_cast<double>(numClasses));
+}
+
+double IntervalTracker::consonantFraction() const noexcept
+{
+    return intervals == 0 ? 0.0 : static_cast<double>(consonant) / static_cast<double>(intervals);
+}
+
+double IntervalTracker::intervalConsonance() const noexcept
+{
+    return intervals == 0 ? 0.0 : intervalScore / static_cast<double>(intervals);
+}
+
+double IntervalTracker::pitchConsonance() const noexcept
+{
+    if (notes < 2)
+    {
+        return 0.0;
+    }
+    double n = static_cast<double>(notes);
+    return pairSum / (0.5 * n * (n - 1.0));
+}
+
+/**
+ *
+ * @brief: writes the current statistics as classifier / listener input channels
+ *
+ * @param: out .
+ * type: span<double>, numChannels values
+ *
+ */
+void IntervalTracker::channels(std::span<double> out) const
+{
+    if (out.size() != numChannels)
+    {
+        throw std::invalid_argument("Interval channel count mismatch");
+    }
+    out[0] = normalizedEntropy();
+    out[1] = consonantFraction();
+    out[2] = intervalConsonance();
+    out[3] = pitchConsonance();
+}
+
+/**
+ *
+ * @brief: interval channels after every frequency of a sequence
+ *
+ * @param: frequencies .
+ * type: span<const double>, one frequency per second
+ * @return: std::vector<double> .
+ * frequencies.size() rows of IntervalTracker::numChannels values
+ *
+ */
+std::vector<double> intervalChannels(std::span<const double> frequencies)
+{
+    IntervalTracker tracker;
+    std::vector<double> rows(frequencies.size() * IntervalTracker::numChannels);
+    for (size_t t = 0; t < frequencies.size(); ++t)
+    {
+        tracker.push(frequencies[t]);
+        tracker.channels(std::span<double>(rows).subspan(t * IntervalTracker::numChannels, IntervalTracker::numChannels));
+    }
+    return rows;
+}
@@ -0,0 +1,200 @@
+#include "../headr/wav.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+    constexpr uint16_t formatPcm = 1;
+    constexpr uint16_t formatFloat = 3;
+    constexpr uint16_t formatExtensible = 0xFFFE;
+
+    // WAV is little endian whatever the host is
+    uint32_t readLe(const unsigned char* bytes, size_t count) noexcept
+    {
+        uint32_t val = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            val |= static_cast<uint32_t>(bytes[i]) << (8 * i);
+        }
+        return val;
+    }
+
+    void readExact(std::ifstream& file, unsigned char* out, size_t count, const char* what)
+    {
+        if (!file.read(reinterpret_cast<char*>(out), static_cast<std::streamsize>(count)))
+        {
+            throw std::invalid_argument(std::string("Truncated WAV file while reading the ") + what);
+        }
+    }
+}
+
+/**
+ *
+ * @brief: opens the file and parses the header up to the start of the samples
+ *
+ * @param: path .
+ * type: const std::string&, WAV file to stream
+ *
+ */
+WavReader::WavReader(const std::string& path)
+        : file(path, std::ios::binary)
+{
+    if (!file)
+    {
+        throw std::invalid_argument("Could not open WAV file: " + path);
+    }
+    unsigned char riff[12];
+    readExact(file, riff, sizeof(riff), "RIFF header");
+    if (std::memcmp(riff, "RIFF", 4) != 0 || std::memcmp(riff + 8, "WAVE", 4) != 0)
+    {
+        throw std::invalid_argument("Not a RIFF / WAVE file: " + path);
+    }
+
+    // walk the chunks until the data, fmt must come first
+    bool haveFormat = false;
+    while (true)
+    {
+        unsigned char header[8];
+        readExact(file, header, sizeof(header), "chunk header");
+        uint32_t size = readLe(header + 4, 4);
+        if (std::memcmp(header, "fmt ", 4) == 0)
+        {
+            if (size < 16)
+            {
+                throw std::invalid_argument("WAV format chunk is too short");
+            }
+            std::vector<unsigned char> fmt(size);
+            readExact(file, fmt.data(), size, "format chunk");
+            uint16_t format = static_cast<uint16_t>(readLe(fmt.data(), 2));
+            channels = static_cast<uint16_t>(readLe(fmt.data() + 2, 2));
+            sampleRate = readLe(fmt.data() + 4, 4);
+            frameBytes = static_cast<uint16_t>(readLe(fmt.data() + 12, 2));
+            bitsPerSample = static_cast<uint16_t>(readLe(fmt.data() + 14, 2));
+            if (format == formatExtensible && size >= 26)
+            {
+                // the first two bytes of the sub format GUID hold the actual format tag
+                format = static_cast<uint16_t>(readLe(fmt.data() + 24, 2));
+            }
+            if (format == formatPcm && bitsPerSample >= 8 && bitsPerSample <= 32 && bitsPerSample % 8 == 0)
+            {
+                encoding = Encoding::Int;
+            }
+            else if (format == formatFloat && (bitsPerSample == 32 || bitsPerSample == 64))
+            {
+                encoding = Encoding::Float;
+            }
+            else
+            {
+                throw std::invalid_argument("Unsupported WAV encoding, expected PCM or float samples");
+            }
+            if (channels == 0 || sampleRate == 0 || frameBytes != channels * (bitsPerSample / 8))
+            {
+                throw std::invalid_argument("Inconsistent WAV format chunk");
+            }
+            haveFormat = true;
+        }
+        else if (std::memcmp(header, "data", 4) == 0)
+        {
+            if (!haveFormat)
+            {
+                throw std::invalid_argument("WAV data chunk before the format chunk");
+            }
+            numFrames = size / frameBytes;
+            break;
+        }
+        else
+        {
+            // LIST, fact, cue ... chunks are padded to an even size
+            file.seekg(size + (size & 1), std::ios::cur);
+        }
+    }
+    dataStart = file.tellg();
+    framesLeft = numFrames;
+    block.resize(blockBytes / frameBytes * frameBytes);
+    if (block.empty())
+    {
+        block.resize(frameBytes);
+    }
+}
+
+/**
+ *
+ * @brief: one channel sample at bytes, scaled to [-1, 1]
+ *
+ */
+double WavReader::decode(const unsigned char* bytes) const noexcept
+{
+    if (encoding == Encoding::Float)
+    {
+        if (bitsPerSample == 32)
+        {
+            uint32_t raw = readLe(bytes, 4);
+            float val;
+            std::memcpy(&val, &raw, sizeof(val));
+            return static_cast<double>(val);
+        }
+        uint64_t raw = static_cast<uint64_t>(readLe(bytes, 4)) | (static_cast<uint64_t>(readLe(bytes + 4, 4)) << 32);
+        double val;
+        std::memcpy(&val, &raw, sizeof(val));
+        return val;
+    }
+    if (bitsPerSample == 8)
+    {
+        // 8 bit PCM is unsigned with 128 as zero
+        return (static_cast<double>(bytes[0]) - 128.0) / 128.0;
+    }
+    size_t width = bitsPerSample / 8;
+    uint32_t raw = readLe(bytes, width);
+    // sign extend from the top bit of the sample
+    int shift = 32 - bitsPerSample;
+    int32_t val = static_cast<int32_t>(raw << shift) >> shift;
+    return static_cast<double>(val) / static_cast<double>(1u << (bitsPerSample - 1));
+}
+
+/**
+ *
+ * @brief: decodes the next frames, every channel averaged into one mono sample
+ *
+ * @param: out .
+ * type: span<double>, receives up to out.size() mono samples
+ * @return: size_t .
+ * samples written, less than out.size() only at the end of the data
+ *
+ */
+size_t WavReader::read(std::span<double> out)
+{
+    size_t written = 0;
+    size_t width = bitsPerSample / 8;
+    double scale = 1.0 / channels;
+    while (written < out.size() && framesLeft > 0)
+    {
+        size_t frames = std::min<uint64_t>({out.size() - written, framesLeft, block.size() / frameBytes});
+        readExact(file, block.data(), frames * frameBytes, "samples");
+        const unsigned char* frame = block.data();
+        for (size_t f = 0; f < frames; ++f, frame += frameBytes)
+        {
+            double sum = 0.0;
+            for (size_t c = 0; c < channels; ++c)
+            {
+                sum += decode(frame + c * width);
+            }
+            out[written + f] = sum * scale;
+        }
+        written += frames;
+        framesLeft -= frames;
+    }
+    return written;
+}
+
+/**
+ *
+ * @brief: goes back to the first frame
+ *
+ */
+void WavReader::rewind()
+{
+    file.clear();
+    file.seekg(dataStart);
+    framesLeft = numFrames;
+}
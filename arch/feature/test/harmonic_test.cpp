@@ -0,0 +1,150 @@
+#include "../headr/harmonic.h"
+#include "../../layer/headr/layer.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <fstream>
+#include <numbers>
+
+class HarmonicTest : public ::testing::Test{};
+
+namespace
+{
+    // a note with two overtones, amplitudes 1, 0.5, 0.25 scaled by gain
+    double note(double freq, double t, double gain)
+    {
+        double phase = 2.0 * std::numbers::pi * freq * t;
+        return gain * (std::sin(phase) + 0.5 * std::sin(2.0 * phase) + 0.25 * std::sin(3.0 * phase)) / 1.75;
+    }
+
+    // 16 bit mono WAV, one note (0 for silence) per second
+    void writeMelody(const std::string& path, const std::vector<double>& notes, uint32_t rate)
+    {
+        std::ofstream file(path, std::ios::binary);
+        auto put = [&](uint32_t val, int bytes)
+        {
+            for (int i = 0; i < bytes; ++i)
+            {
+                file.put(static_cast<char>((val >> (8 * i)) & 0xFF));
+            }
+        };
+        uint32_t dataBytes = static_cast<uint32_t>(notes.size() * rate * 2);
+        file.write("RIFF", 4);
+        put(36 + dataBytes, 4);
+        file.write("WAVEfmt ", 8);
+        put(16, 4);
+        put(1, 2);
+        put(1, 2);
+        put(rate, 4);
+        put(rate * 2, 4);
+        put(2, 2);
+        put(16, 2);
+        file.write("data", 4);
+        put(dataBytes, 4);
+        for (size_t n = 0; n < notes.size(); ++n)
+        {
+            for (uint32_t i = 0; i < rate; ++i)
+            {
+                double t = static_cast<double>(i) / rate;
+                double val = notes[n] > 0.0 ? note(notes[n], t, 0.6) : 0.0;
+                put(static_cast<uint32_t>(static_cast<int32_t>(std::lround(val * 32767.0))) & 0xFFFF, 2);
+            }
+        }
+    }
+}
+
+/**
+ * @brief: Tests for the real FFT
+ */
+TEST_F(HarmonicTest, RealFft)
+{
+    // Test 1: the power spectrum matches a direct DFT
+    const size_t n = 64;
+    std::vector<double> signal(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        signal[i] = std::sin(0.7 * i) + 0.3 * std::cos(2.1 * i) + (i % 5 == 0 ? 0.2 : 0.0);
+    }
+    RealFft fft(n);
+    std::vector<double> power(n / 2 + 1);
+    fft.powerSpectrum(signal, power);
+    for (size_t k = 0; k <= n / 2; ++k)
+    {
+        std::complex<double> sum = 0.0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            sum += signal[i] * std::polar(1.0, -2.0 * std::numbers::pi * k * i / n);
+        }
+        EXPECT_NEAR(power[k], std::norm(sum), 1e-9) << "Power mismatch at bin " << k;
+    }
+
+    // Test 2: sizes that are not a power of two are rejected
+    EXPECT_THROW(RealFft(48), std::invalid_argument) << "Non power of two accepted";
+}
+
+/**
+ * @brief: Tests for the dominant harmonic frequency
+ */
+TEST_F(HarmonicTest, DominantFrequency)
+{
+    const double rate = 8000.0;
+    HarmonicExtractor extractor(rate);
+    EXPECT_EQ(extractor.windowSize(), 8000) << "Window is not one second";
+    EXPECT_EQ(extractor.fftSize(), 8192) << "FFT not padded to a power of two";
+    std::vector<double> window(extractor.windowSize());
+
+    // Test 1: the fundamental of a harmonic note is found to well under a semitone
+    for (double freq : {110.0, 261.63, 440.0, 493.88, 880.0})
+    {
+        for (size_t i = 0; i < window.size(); ++i)
+        {
+            window[i] = note(freq, i / rate, 0.5);
+        }
+        EXPECT_NEAR(extractor.dominantFrequency(window), freq, 0.5) << "Wrong pitch for " << freq;
+    }
+
+    // Test 2: a pure tone and a note whose second harmonic is loudest still give the fundamental
+    for (size_t i = 0; i < window.size(); ++i)
+    {
+        double phase = 2.0 * std::numbers::pi * 330.0 * i / rate;
+        window[i] = 0.4 * std::sin(phase) + 0.6 * std::sin(2.0 * phase) + 0.3 * std::sin(3.0 * phase);
+    }
+    EXPECT_NEAR(extractor.dominantFrequency(window), 330.0, 0.5) << "Octave error on a strong second harmonic";
+
+    // Test 3: silence
+    std::fill(window.begin(), window.end(), 0.0);
+    EXPECT_EQ(extractor.dominantFrequency(window), 0.0) << "Silence produced a pitch";
+}
+
+/**
+ * @brief: Tests for streaming a file into classifier rows
+ */
+TEST_F(HarmonicTest, StreamRows)
+{
+    std::string path = ::testing::TempDir() + "harmonic_test.wav";
+    std::vector<double> melody = {0.0, 261.63, 329.63, 0.0, 392.0, 523.25};
+    writeMelody(path, melody, 8000);
+
+    // Test 1: one frequency per second, leading silence skipped, inner silence holds the last pitch
+    std::vector<double> frequencies = extractFrequencies(path);
+    std::vector<double> expected = {261.63, 329.63, 329.63, 392.0, 523.25};
+    ASSERT_EQ(frequencies.size(), expected.size()) << "Window count mismatch";
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        EXPECT_NEAR(frequencies[i], expected[i], 0.5) << "Wrong pitch in second " << i;
+    }
+
+    // Test 2: rows fit the input layer
+    std::vector<std::vector<double>> rows = frequencyRows(frequencies, 3, 1);
+    ASSERT_EQ(rows.size(), 3) << "Sliding row count mismatch";
+    EXPECT_EQ(rows[2][0], frequencies[2]) << "Row stride mismatch";
+    EXPECT_EQ(frequencyRows(frequencies, 2).size(), 2) << "Non overlapping row count mismatch";
+    NetworkLayer<BaseNode> input(4, BaseNode(), true, nullptr, 3);
+    input.setInputLayer(rows[0]);
+    for (auto& node : input.getPrivMemberLayerNodes())
+    {
+        EXPECT_EQ(node.getInputs(), rows[0]) << "Row not loaded into the input layer";
+    }
+    std::remove(path.c_str());
+}
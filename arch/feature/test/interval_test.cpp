@@ -0,0 +1,118 @@
+#include "../headr/interval.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <map>
+
+class IntervalTest : public ::testing::Test{};
+
+/**
+ * @brief: Tests for interval classification
+ */
+TEST_F(IntervalTest, Classify)
+{
+    using Interval = IntervalTracker::Interval;
+
+    // Test 1: the table ratios, in and above the first octave
+    EXPECT_EQ(IntervalTracker::classify(1.0), Interval::Unison) << "Unison";
+    EXPECT_EQ(IntervalTracker::classify(2.0), Interval::Octave) << "Octave";
+    EXPECT_EQ(IntervalTracker::classify(4.0), Interval::Octave) << "Double octave";
+    EXPECT_EQ(IntervalTracker::classify(1.5), Interval::PerfectFifth) << "Fifth";
+    EXPECT_EQ(IntervalTracker::classify(3.0), Interval::PerfectFifth) << "Fifth above the octave";
+    EXPECT_EQ(IntervalTracker::classify(16.0 / 15.0), Interval::MinorSecond) << "Minor second";
+    EXPECT_EQ(IntervalTracker::classify(45.0 / 32.0), Interval::Tritone) << "Tritone";
+    EXPECT_EQ(IntervalTracker::classify(std::exp2(4.0 / 12.0)), Interval::MajorThird) << "Tempered third";
+
+    // Test 2: ratios away from every table entry
+    EXPECT_EQ(IntervalTracker::classify(1.6), Interval::Other) << "Minor sixth is not in the tables";
+    EXPECT_EQ(IntervalTracker::classify(1.78), Interval::Other) << "Minor seventh is not in the tables";
+
+    // Test 3: dEngineer.py's pair score
+    EXPECT_DOUBLE_EQ(IntervalTracker::pairScore(1.5), 1.0) << "Exact fifth";
+    EXPECT_NEAR(IntervalTracker::pairScore(16.0 / 15.0), 1.0 / (1.0 + 10.0 / 15.0), 1e-12) << "Minor second";
+}
+
+/**
+ * @brief: Tests for the streamed statistics against direct recomputation
+ */
+TEST_F(IntervalTest, Streaming)
+{
+    std::vector<double> frequencies = {261.63, 392.0, 523.25, 348.83, 465.1, 496.1, 264.6, 372.1, 697.7, 440.0, 220.0};
+    IntervalTracker tracker;
+    std::vector<double> channels(IntervalTracker::numChannels);
+
+    for (size_t n = 1; n <= frequencies.size(); ++n)
+    {
+        tracker.push(frequencies[n - 1]);
+
+        // histogram, entropy and consonance of the consecutive intervals
+        std::map<IntervalTracker::Interval, double> counts;
+        double consonant = 0.0;
+        double score = 0.0;
+        for (size_t i = 1; i < n; ++i)
+        {
+            double ratio = std::max(frequencies[i], frequencies[i - 1]) / std::min(frequencies[i], frequencies[i - 1]);
+            IntervalTracker::Interval cls = IntervalTracker::classify(ratio);
+            counts[cls] += 1.0;
+            consonant += IntervalTracker::isConsonant(cls) ? 1.0 : 0.0;
+            score += IntervalTracker::pairScore(ratio);
+        }
+        double entropy = 0.0;
+        for (const auto& [cls, count] : counts)
+        {
+            double p = count / static_cast<double>(n - 1);
+            entropy -= p * std::log(p);
+        }
+
+        // all pairs, octave folded, the O(n^2) pass the tracker replaces
+        double pairs = 0.0;
+        double pairSum = 0.0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            for (size_t j = i + 1; j < n; ++j)
+            {
+                double folded = std::exp2(std::abs(std::remainder(std::log2(frequencies[i] / frequencies[j]), 1.0)));
+                pairSum += std::max(IntervalTracker::pairScore(folded), IntervalTracker::pairScore(2.0 / folded));
+                pairs += 1.0;
+            }
+        }
+
+        // Test 1: O(1) updates match the recomputed statistics after every note
+        EXPECT_NEAR(tracker.entropy(), entropy, 1e-12) << "Entropy mismatch after " << n;
+        EXPECT_NEAR(tracker.consonantFraction(), n > 1 ? consonant / (n - 1) : 0.0, 1e-12) << "Fraction mismatch after " << n;
+        EXPECT_NEAR(tracker.intervalConsonance(), n > 1 ? score / (n - 1) : 0.0, 1e-12) << "Score mismatch after " << n;
+        // one cent pitch classes
+        EXPECT_NEAR(tracker.pitchConsonance(), pairs > 0.0 ? pairSum / pairs : 0.0, 1e-2) << "Pair score mismatch after " << n;
+    }
+
+    // Test 2: channels are the normalised statistics and stay in [0, 1]
+    tracker.channels(channels);
+    EXPECT_NEAR(channels[0], tracker.entropy() / std::log(static_cast<double>(IntervalTracker::numClasses)), 1e-12)
+                        << "Entropy channel not normalised";
+    for (double channel : channels)
+    {
+        EXPECT_GE(channel, 0.0) << "Channel below 0";
+        EXPECT_LE(channel, 1.0) << "Channel above 1";
+    }
+
+    // Test 3: the per step rows match the tracker, reset starts a new sequence
+    std::vector<double> rows = intervalChannels(frequencies);
+    ASSERT_EQ(rows.size(), frequencies.size() * IntervalTracker::numChannels) << "Row count mismatch";
+    for (size_t c = 0; c < channels.size(); ++c)
+    {
+        EXPECT_DOUBLE_EQ(rows[rows.size() - channels.size() + c], channels[c]) << "Last row mismatch at " << c;
+    }
+    tracker.reset();
+    EXPECT_EQ(tracker.getNumNotes(), 0) << "Reset kept notes";
+    EXPECT_EQ(tracker.entropy(), 0.0) << "Reset kept the histogram";
+    tracker.push(0.0);
+    EXPECT_EQ(tracker.getNumNotes(), 0) << "Silent frame counted as a note";
+
+    // Test 4: a track moving only in fifths carries no interval information
+    for (double freq : {200.0, 300.0, 450.0, 675.0})
+    {
+        tracker.push(freq);
+    }
+    EXPECT_NEAR(tracker.entropy(), 0.0, 1e-12) << "Single interval class has entropy";
+    EXPECT_EQ(tracker.count(IntervalTracker::Interval::PerfectFifth), 3) << "Fifths not counted";
+    EXPECT_DOUBLE_EQ(tracker.consonantFraction(), 1.0) << "Fifths not consonant";
+}
@@ -0,0 +1,120 @@
+#include "../headr/wav.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+class WavTest : public ::testing::Test{};
+
+namespace
+{
+    void putLe(std::ofstream& file, uint64_t val, size_t bytes)
+    {
+        for (size_t i = 0; i < bytes; ++i)
+        {
+            file.put(static_cast<char>((val >> (8 * i)) & 0xFF));
+        }
+    }
+
+    // writes interleaved samples in [-1, 1] with the given encoding, a LIST chunk sits before the data
+    void writeWav(const std::string& path, const std::vector<double>& samples, uint16_t channels, uint32_t rate,
+                  uint16_t bits, bool isFloat)
+    {
+        std::ofstream file(path, std::ios::binary);
+        uint32_t dataBytes = static_cast<uint32_t>(samples.size() * bits / 8);
+        file.write("RIFF", 4);
+        putLe(file, 4 + 24 + 12 + 8 + dataBytes, 4);
+        file.write("WAVE", 4);
+        file.write("fmt ", 4);
+        putLe(file, 16, 4);
+        putLe(file, isFloat ? 3 : 1, 2);
+        putLe(file, channels, 2);
+        putLe(file, rate, 4);
+        putLe(file, rate * channels * bits / 8, 4);
+        putLe(file, channels * bits / 8, 2);
+        putLe(file, bits, 2);
+        file.write("LIST", 4);
+        putLe(file, 3, 4);
+        file.write("abc\0", 4);
+        file.write("data", 4);
+        putLe(file, dataBytes, 4);
+        for (double val : samples)
+        {
+            if (isFloat)
+            {
+                float f = static_cast<float>(val);
+                uint32_t raw;
+                std::memcpy(&raw, &f, sizeof(raw));
+                putLe(file, raw, 4);
+            }
+            else if (bits == 8)
+            {
+                putLe(file, static_cast<uint64_t>(std::lround(val * 127.0 + 128.0)), 1);
+            }
+            else
+            {
+                double scale = static_cast<double>((1u << (bits - 1)) - 1);
+                putLe(file, static_cast<uint64_t>(static_cast<int64_t>(std::lround(val * scale))), bits / 8);
+            }
+        }
+    }
+}
+
+/**
+ * @brief: Tests for the streaming WAV decoder
+ */
+TEST_F(WavTest, Decode)
+{
+    std::string path = ::testing::TempDir() + "wav_test.wav";
+    std::vector<double> stereo;
+    for (int i = 0; i < 1000; ++i)
+    {
+        double val = std::sin(0.01 * i) * 0.8;
+        stereo.push_back(val);
+        stereo.push_back(-0.5 * val);
+    }
+
+    // Test 1: every sample format decodes to the same mono mix
+    struct Format { uint16_t bits; bool isFloat; double tolerance; };
+    for (Format format : {Format{8, false, 2e-2}, Format{16, false, 1e-4}, Format{24, false, 1e-6},
+                          Format{32, false, 1e-8}, Format{32, true, 1e-7}})
+    {
+        writeWav(path, stereo, 2, 8000, format.bits, format.isFloat);
+        WavReader reader(path);
+        ASSERT_EQ(reader.getNumFrames(), 1000) << format.bits << " bit frame count mismatch";
+        EXPECT_EQ(reader.getChannels(), 2) << "Channel count mismatch";
+        EXPECT_EQ(reader.getSampleRate(), 8000) << "Sample rate mismatch";
+        std::vector<double> mono(1000);
+        ASSERT_EQ(reader.read(mono), 1000) << format.bits << " bit short read";
+        for (int i = 0; i < 1000; i += 37)
+        {
+            EXPECT_NEAR(mono[i], 0.25 * stereo[2 * i], format.tolerance) << format.bits << " bit sample " << i;
+        }
+    }
+
+    // Test 2: reads stream in pieces, stop at the end and rewind
+    WavReader reader(path);
+    std::vector<double> piece(300);
+    size_t total = 0;
+    size_t got = 0;
+    while ((got = reader.read(piece)) > 0)
+    {
+        total += got;
+    }
+    EXPECT_EQ(total, 1000) << "Streamed frame count mismatch";
+    EXPECT_EQ(reader.getFramesLeft(), 0) << "Frames left after the end";
+    reader.rewind();
+    EXPECT_EQ(reader.read(piece), 300) << "Rewind did not restart the data";
+    EXPECT_NEAR(piece[10], 0.25 * stereo[20], 1e-7) << "Rewind landed on the wrong frame";
+
+    // Test 3: not a WAV file
+    {
+        std::ofstream junk(path, std::ios::binary);
+        junk << "definitely not audio";
+    }
+    EXPECT_THROW(WavReader bad(path), std::invalid_argument) << "Junk accepted";
+    EXPECT_THROW(WavReader missing(path + ".missing"), std::invalid_argument) << "Missing file accepted";
+    std::remove(path.c_str());
+}
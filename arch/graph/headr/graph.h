@@ -0,0 +1,232 @@
+#ifndef GRAPH_H
+#define GRAPH_H
+
+#include "../../layer/headr/layer.h"
+#include "../../memory/headr/arena.h"
+#include <cstddef>
+#include <map>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ *
+ * STATIC EXECUTION PLANS:
+ *  - GraphBuilder collects a model description as named operations in any order
+ *  - compile() orders them, fuses matmul -> bias -> activation chains into single dense kernels, snapshots
+ *      the weights and lays every intermediate value out in one buffer, reusing the space of values that
+ *      are no longer needed
+ *  - ExecutionPlan::run is a flat loop over precompiled kernels, no lookups, allocations or branches on
+ *      the model structure
+ *
+ */
+
+/**
+ *
+ * @enum: Activation -> element wise activations the plan can fuse into a kernel, one per policy in
+ *          activation.h
+ *
+ */
+enum class Activation
+{
+    Identity,
+    Tanh,
+    Sigmoid,
+    Relu,
+    LeakyRelu,
+    Gelu,
+    HardSigmoid
+};
+
+class ExecutionPlan;
+
+/**
+ *
+ * @class: GraphBuilder -> model description, every operation names its output and its inputs
+ *
+ * @note: weights are copied when the operation is added, rebuild the plan after training
+ *
+ */
+class GraphBuilder
+{
+    public:
+        /**
+         *
+         * @brief: a graph input of size values, fed in declaration order to ExecutionPlan::run
+         *
+         */
+        GraphBuilder& input(const std::string& name, size_t size);
+
+        /**
+         *
+         * @brief: weights (rows x cols, row major) times the value from
+         *
+         */
+        GraphBuilder& matmul(const std::string& name, const std::string& from, size_t rows, size_t cols,
+                             std::span<const double> weights);
+
+        /**
+         *
+         * @brief: adds a bias vector to the value from
+         *
+         */
+        GraphBuilder& bias(const std::string& name, const std::string& from, std::span<const double> values);
+
+        /**
+         *
+         * @brief: element wise activation of the value from
+         *
+         */
+        GraphBuilder& activation(const std::string& name, const std::string& from, Activation kind);
+
+        /**
+         *
+         * @brief: joins values end to end
+         *
+         */
+        GraphBuilder& concat(const std::string& name, const std::vector<std::string>& from);
+
+        /**
+         *
+         * @brief: a feedforward layer, expanded to matmul + bias + its activation (name/matmul, name/bias, name)
+         *
+         */
+        template <typename Act>
+        GraphBuilder& dense(const std::string& name, const std::string& from, NetworkLayer<BasicNode<Act>>& layer);
+
+        /**
+         *
+         * @brief: an LSTM layer, one timestep per run, the cell state lives in the plan
+         *
+         */
+        template <typename Act, typename Gate>
+        GraphBuilder& lstm(const std::string& name, const std::string& from,
+                           NetworkLayer<BasicLstmNode<Act, Gate>>& layer);
+
+        /**
+         *
+         * @brief: marks a value as a graph output, read back with ExecutionPlan::output in marking order
+         *
+         */
+        GraphBuilder& output(const std::string& name);
+
+        /**
+         *
+         * @brief: validates, orders, fuses and lays out the graph
+         *
+         * @return: ExecutionPlan -> ready to run, independent of the builder and the layers
+         *
+         */
+        ExecutionPlan compile() const;
+
+    private:
+        friend class ExecutionPlan;
+
+        enum class OpKind { Input, Matmul, Bias, Activation, Concat, Lstm };
+
+        struct Op
+        {
+            Op(OpKind kind, std::string name, std::vector<std::string> inputs = {})
+                    : kind(kind), name(std::move(name)), inputs(std::move(inputs)) {}
+
+            OpKind kind;
+            std::string name;
+            std::vector<std::string> inputs;
+            size_t rows = 0;
+            size_t cols = 0;
+            Activation act = Activation::Identity;
+            Activation gate = Activation::Sigmoid;
+            std::vector<double> weights;
+            std::vector<double> recurrent;
+            std::vector<double> bias;
+        };
+
+        GraphBuilder& add(Op op);
+
+        std::vector<Op> ops;
+        std::vector<std::string> outputs;
+};
+
+/**
+ *
+ * @class: ExecutionPlan -> compiled graph, run it as many times as needed
+ *
+ */
+class ExecutionPlan
+{
+    public:
+        ExecutionPlan(ExecutionPlan&&) noexcept = default;
+        ExecutionPlan& operator=(ExecutionPlan&&) noexcept = default;
+        ExecutionPlan(const ExecutionPlan&) = delete;
+        ExecutionPlan& operator=(const ExecutionPlan&) = delete;
+
+        /**
+         *
+         * @brief: runs every kernel once
+         *
+         * @param: inputs -> type: const std::vector<std::span<const double>>&, one per graph input
+         * @return: std::span<const double> -> the first output, valid until the next run
+         *
+         */
+        std::span<const double> run(const std::vector<std::span<const double>>& inputs);
+        std::span<const double> run(std::span<const double> input);
+
+        /**
+         *
+         * @brief: an output of the last run, in the order they were marked
+         *
+         */
+        std::span<const double> output(size_t index) const;
+
+        /**
+         *
+         * @brief: zeroes the cell state of every LSTM kernel
+         *
+         */
+        void resetState() noexcept;
+
+        size_t numKernels() const noexcept { return kernels.size(); }
+
+        // bytes of the shared activation buffer vs one buffer per intermediate value
+        size_t activationBytes() const noexcept { return buffer.size() * sizeof(double); }
+        size_t unsharedBytes() const noexcept { return unshared * sizeof(double); }
+
+        // names of the compiled kernels in execution order, fused chains are joined with '+'
+        const std::vector<std::string>& kernelNames() const noexcept { return names; }
+
+    private:
+        friend class GraphBuilder;
+        ExecutionPlan() = default;
+
+        struct Kernel;
+        using KernelFn = void (*)(const Kernel&, double*);
+
+        // one compiled step, everything it needs is resolved to offsets and pointers at compile time
+        struct Kernel
+        {
+            KernelFn fn = nullptr;
+            std::vector<size_t> in;
+            std::vector<size_t> inSize;
+            size_t out = 0;
+            size_t rows = 0;
+            size_t cols = 0;
+            const double* weights = nullptr;
+            const double* recurrent = nullptr;
+            const double* bias = nullptr;
+            double* stm = nullptr;
+            double* ltm = nullptr;
+            double* scratch = nullptr;
+        };
+
+        std::vector<Kernel> kernels;
+        std::vector<std::string> names;
+        std::vector<std::pair<size_t, size_t>> inputSlots;
+        std::vector<std::pair<size_t, size_t>> outputSlots;
+        std::vector<std::vector<double, AlignedAllocator<double>>> constants;
+        std::vector<double, AlignedAllocator<double>> state;
+        std::vector<double, AlignedAllocator<double>> buffer;
+        size_t unshared = 0;
+};
+
+#endif
@@ -0,0 +1,661 @@
+#include "../headr/graph.h"
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <type_traits>
+
+namespace
+{
+    using RowMajor = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+    // every value starts on a cache line of the shared buffer
+    constexpr size_t lane = Arena::alignment / sizeof(double);
+
+    size_t padded(size_t count) noexcept
+    {
+        return (count + lane - 1) / lane * lane;
+    }
+
+    /**
+     *
+     * @brief: calls fn.template operator()<Policy>() with the policy matching kind, so a kernel can be
+     *          instantiated per activation and picked once at compile time
+     *
+     */
+    template <typename Fn>
+    auto withPolicy(Activation kind, Fn&& fn)
+    {
+        switch (kind)
+        {
+            case Activation::Tanh: return fn.template operator()<TanhAct>();
+            case Activation::Sigmoid: return fn.template operator()<SigmoidAct>();
+            case Activation::Relu: return fn.template operator()<ReluAct>();
+            case Activation::LeakyRelu: return fn.template operator()<LeakyReluAct>();
+            case Activation::Gelu: return fn.template operator()<GeluAct>();
+            case Activation::HardSigmoid: return fn.template operator()<HardSigmoidAct>();
+            default: return fn.template operator()<IdentityAct>();
+        }
+    }
+
+    template <typename Act>
+    constexpr Activation kindOf() noexcept
+    {
+        if constexpr (std::is_same_v<Act, TanhAct>) return Activation::Tanh;
+        else if constexpr (std::is_same_v<Act, SigmoidAct>) return Activation::Sigmoid;
+        else if constexpr (std::is_same_v<Act, ReluAct>) return Activation::Relu;
+        else if constexpr (std::is_same_v<Act, LeakyReluAct>) return Activation::LeakyRelu;
+        else if constexpr (std::is_same_v<Act, GeluAct>) return Activation::Gelu;
+        else if constexpr (std::is_same_v<Act, HardSigmoidAct>) return Activation::HardSigmoid;
+        else return Activation::Identity;
+    }
+
+    template <typename Act>
+    inline void activate(Eigen::Map<Eigen::VectorXd>& y) noexcept
+    {
+        if constexpr (!std::is_same_v<Act, IdentityAct>)
+        {
+            y.array() = Act::apply(y.array());
+        }
+    }
+}
+
+/**
+ *
+ * @brief: a graph input of size values, fed in declaration order to ExecutionPlan::run
+ *
+ */
+GraphBuilder& GraphBuilder::input(const std::string& name, size_t size)
+{
+    Op op{OpKind::Input, name};
+    op.rows = size;
+    return add(std::move(op));
+}
+
+/**
+ *
+ * @brief: weights (rows x cols, row major) times the value from
+ *
+ */
+GraphBuilder& GraphBuilder::matmul(const std::string& name, const std::string& from, size_t rows, size_t cols,
+                                   std::span<const double> weights)
+{
+    if (weights.size() != rows * cols)
+    {
+        throw std::invalid_argument("Matmul weights do not match rows x cols");
+    }
+    Op op{OpKind::Matmul, name, {from}};
+    op.rows = rows;
+    op.cols = cols;
+    op.weights.assign(weights.begin(), weights.end());
+    return add(std::move(op));
+}
+
+/**
+ *
+ * @brief: adds a bias vector to the value from
+ *
+ */
+GraphBuilder& GraphBuilder::bias(const std::string& name, const std::string& from, std::span<const double> values)
+{
+    Op op{OpKind::Bias, name, {from}};
+    op.bias.assign(values.begin(), values.end());
+    return add(std::move(op));
+}
+
+/**
+ *
+ * @brief: element wise activation of the value from
+ *
+ */
+GraphBuilder& GraphBuilder::activation(const std::string& name, const std::string& from, Activation kind)
+{
+    Op op{OpKind::Activation, name, {from}};
+    op.act = kind;
+    return add(std::move(op));
+}
+
+/**
+ *
+ * @brief: joins values end to end
+ *
+ */
+GraphBuilder& GraphBuilder::concat(const std::string& name, const std::vector<std::string>& from)
+{
+    if (from.empty())
+    {
+        throw std::invalid_argument("Concat needs at least one input");
+    }
+    return add(Op{OpKind::Concat, name, from});
+}
+
+/**
+ *
+ * @brief: a feedforward layer, expanded to matmul + bias + its activation (name/matmul, name/bias, name)
+ *
+ */
+template <typename Act>
+GraphBuilder& GraphBuilder::dense(const std::string& name, const std::string& from, NetworkLayer<BasicNode<Act>>& layer)
+{
+    size_t nodes = layer.getPrivMemberLayerNodes().size();
+    size_t fanIn = layer.getFanIn();
+    std::vector<double> weights(nodes * fanIn);
+    std::vector<double> biases(nodes);
+    layer.unpackWeights(weights, {}, biases);
+    matmul(name + "/matmul", from, nodes, fanIn, weights);
+    bias(name + "/bias", name + "/matmul", biases);
+    return activation(name, name + "/bias", kindOf<Act>());
+}
+
+/**
+ *
+ * @brief: an LSTM layer, one timestep per run, the cell state lives in the plan
+ *
+ */
+template <typename Act, typename Gate>
+GraphBuilder& GraphBuilder::lstm(const std::string& name, const std::string& from,
+                                 NetworkLayer<BasicLstmNode<Act, Gate>>& layer)
+{
+    Op op{OpKind::Lstm, name, {from}};
+    op.act = kindOf<Act>();
+    op.gate = kindOf<Gate>();
+    op.rows = layer.getPrivMemberLayerNodes().size();
+    op.cols = layer.getFanIn();
+    op.weights.resize(4 * op.rows * op.cols);
+    op.recurrent.resize(4 * op.rows);
+    op.bias.resize(4 * op.rows);
+    layer.unpackWeights(op.weights, op.recurrent, op.bias);
+    return add(std::move(op));
+}
+
+/**
+ *
+ * @brief: marks a value as a graph output, read back with ExecutionPlan::output in marking order
+ *
+ */
+GraphBuilder& GraphBuilder::output(const std::string& name)
+{
+    outputs.push_back(name);
+    return *this;
+}
+
+GraphBuilder& GraphBuilder::add(Op op)
+{
+    ops.push_back(std::move(op));
+    return *this;
+}
+
+/**
+ *
+ * @brief: validates, orders, fuses and lays out the graph
+ *
+ * @note: ordering is Kahn's algorithm, ties broken by declaration order so plans are reproducible.
+ *          A matmul / bias whose only reader is a bias / activation is folded into that reader, so
+ *          dense + bias + tanh becomes one kernel. Buffers are handed out best fit from the blocks freed
+ *          by values whose last reader already ran
+ *
+ */
+ExecutionPlan GraphBuilder::compile() const
+{
+    size_t count = ops.size();
+    std::map<std::string, size_t> index;
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (!index.emplace(ops[i].name, i).second)
+        {
+            throw std::invalid_argument("Duplicate graph value " + ops[i].name);
+        }
+    }
+    std::vector<std::vector<size_t>> readers(count);
+    std::vector<size_t> pendingInputs(count, 0);
+    for (size_t i = 0; i < count; ++i)
+    {
+        for (const std::string& from : ops[i].inputs)
+        {
+            auto it = index.find(from);
+            if (it == index.end())
+            {
+                throw std::invalid_argument("Unknown graph value " + from);
+            }
+            readers[it->second].push_back(i);
+            ++pendingInputs[i];
+        }
+    }
+    std::vector<bool> isOutput(count, false);
+    for (const std::string& name : outputs)
+    {
+        auto it = index.find(name);
+        if (it == index.end())
+        {
+            throw std::invalid_argument("Unknown graph output " + name);
+        }
+        isOutput[it->second] = true;
+    }
+
+    // topological order
+    std::priority_queue<size_t, std::vector<size_t>, std::greater<size_t>> ready;
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (pendingInputs[i] == 0)
+        {
+            ready.push(i);
+        }
+    }
+    std::vector<size_t> order;
+    while (!ready.empty())
+    {
+        size_t i = ready.top();
+        ready.pop();
+        order.push_back(i);
+        for (size_t reader : readers[i])
+        {
+            if (--pendingInputs[reader] == 0)
+            {
+                ready.push(reader);
+            }
+        }
+    }
+    if (order.size() != count)
+    {
+        throw std::invalid_argument("Graph has a cycle");
+    }
+
+    // shapes
+    std::vector<size_t> sizes(count, 0);
+    for (size_t i : order)
+    {
+        const Op& op = ops[i];
+        size_t inSize = op.inputs.empty() ? 0 : sizes[index.at(op.inputs[0])];
+        switch (op.kind)
+        {
+            case OpKind::Input:
+                sizes[i] = op.rows;
+                break;
+            case OpKind::Matmul:
+            case OpKind::Lstm:
+                if (inSize != op.cols)
+                {
+                    throw std::invalid_argument("Graph value " + op.name + " expects " + std::to_string(op.cols)
+                                                + " inputs, got " + std::to_string(inSize));
+                }
+                sizes[i] = op.rows;
+                break;
+            case OpKind::Bias:
+                if (inSize != op.bias.size())
+                {
+                    throw std::invalid_argument("Bias " + op.name + " does not match its input");
+                }
+                sizes[i] = inSize;
+                break;
+            case OpKind::Activation:
+                sizes[i] = inSize;
+                break;
+            case OpKind::Concat:
+                for (const std::string& from : op.inputs)
+                {
+                    sizes[i] += sizes[index.at(from)];
+                }
+                break;
+        }
+    }
+
+    // fusion: every op lands in the kernel of the chain it belongs to
+    auto soleReader = [&](size_t i, OpKind kind) -> long
+    {
+        if (isOutput[i] || readers[i].size() != 1 || ops[readers[i][0]].kind != kind)
+        {
+            return -1;
+        }
+        return static_cast<long>(readers[i][0]);
+    };
+    struct Chain
+    {
+        size_t head;
+        size_t tail;
+        long matmul = -1;
+        long bias = -1;
+        Activation act = Activation::Identity;
+    };
+    std::vector<bool> absorbed(count, false);
+    std::vector<Chain> chains;
+    for (size_t i : order)
+    {
+        if (absorbed[i] || ops[i].kind == OpKind::Input)
+        {
+            continue;
+        }
+        Chain chain{i, i};
+        OpKind kind = ops[i].kind;
+        if (kind == OpKind::Matmul || kind == OpKind::Bias || kind == OpKind::Activation)
+        {
+            size_t cur = i;
+            if (kind == OpKind::Matmul)
+            {
+                chain.matmul = static_cast<long>(cur);
+                long next = soleReader(cur, OpKind::Bias);
+                if (next >= 0)
+                {
+                    cur = static_cast<size_t>(next);
+                    absorbed[cur] = true;
+                }
+            }
+            if (ops[cur].kind == OpKind::Bias)
+            {
+                chain.bias = static_cast<long>(cur);
+                long next = soleReader(cur, OpKind::Activation);
+                if (next >= 0)
+                {
+                    cur = static_cast<size_t>(next);
+                    absorbed[cur] = true;
+                }
+            }
+            if (ops[cur].kind == OpKind::Activation)
+            {
+                chain.act = ops[cur].act;
+            }
+            chain.tail = cur;
+        }
+        chains.push_back(chain);
+    }
+
+    // last kernel reading every value, a value nobody reads dies right after the kernel writing it and
+    // outputs are read after the last kernel
+    std::vector<size_t> lastUse(count, 0);
+    for (size_t k = 0; k < chains.size(); ++k)
+    {
+        lastUse[chains[k].tail] = k;
+    }
+    for (size_t k = 0; k < chains.size(); ++k)
+    {
+        for (const std::string& from : ops[chains[k].head].inputs)
+        {
+            lastUse[index.at(from)] = k;
+        }
+    }
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (isOutput[i])
+        {
+            lastUse[i] = std::numeric_limits<size_t>::max();
+        }
+    }
+
+    // buffer layout, only graph inputs and chain results get a slot
+    ExecutionPlan plan;
+    std::vector<size_t> offset(count, 0);
+    std::vector<bool> hasSlot(count, false);
+    std::vector<std::pair<size_t, size_t>> freeBlocks;
+    size_t end = 0;
+    auto allocate = [&](size_t i)
+    {
+        size_t need = padded(sizes[i]);
+        plan.unshared += need;
+        hasSlot[i] = true;
+        auto best = freeBlocks.end();
+        for (auto it = freeBlocks.begin(); it != freeBlocks.end(); ++it)
+        {
+            if (it->second >= need && (best == freeBlocks.end() || it->second < best->second))
+            {
+                best = it;
+            }
+        }
+        if (best == freeBlocks.end())
+        {
+            offset[i] = end;
+            end += need;
+            return;
+        }
+        offset[i] = best->first;
+        if (best->second > need)
+        {
+            best->first += need;
+            best->second -= need;
+        }
+        else
+        {
+            freeBlocks.erase(best);
+        }
+    };
+    auto release = [&](size_t k)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (hasSlot[i] && lastUse[i] == k)
+            {
+                freeBlocks.push_back({offset[i], padded(sizes[i])});
+            }
+        }
+    };
+    for (size_t i : order)
+    {
+        if (ops[i].kind == OpKind::Input)
+        {
+            allocate(i);
+            plan.inputSlots.push_back({offset[i], sizes[i]});
+        }
+    }
+
+    size_t stateSize = 0;
+    for (const Chain& chain : chains)
+    {
+        if (ops[chain.head].kind == OpKind::Lstm)
+        {
+            stateSize += 2 * padded(ops[chain.head].rows) + padded(4 * ops[chain.head].rows);
+        }
+    }
+    plan.state.assign(stateSize, 0.0);
+    size_t stateUsed = 0;
+
+    for (size_t k = 0; k < chains.size(); ++k)
+    {
+        const Chain& chain = chains[k];
+        const Op& head = ops[chain.head];
+        allocate(chain.tail);
+
+        ExecutionPlan::Kernel kernel;
+        kernel.out = offset[chain.tail];
+        kernel.rows = sizes[chain.tail];
+        for (const std::string& from : head.inputs)
+        {
+            kernel.in.push_back(offset[index.at(from)]);
+            kernel.inSize.push_back(sizes[index.at(from)]);
+        }
+        auto constant = [&](const std::vector<double>& vals) -> const double*
+        {
+            plan.constants.emplace_back(vals.begin(), vals.end());
+            return plan.constants.back().data();
+        };
+
+        std::string name;
+        if (head.kind == OpKind::Concat)
+        {
+            kernel.fn = [](const ExecutionPlan::Kernel& kn, double* buf)
+            {
+                double* out = buf + kn.out;
+                for (size_t p = 0; p < kn.in.size(); ++p)
+                {
+                    std::copy(buf + kn.in[p], buf + kn.in[p] + kn.inSize[p], out);
+                    out += kn.inSize[p];
+                }
+            };
+            name = head.name;
+        }
+        else if (head.kind == OpKind::Lstm)
+        {
+            kernel.cols = head.cols;
+            kernel.weights = constant(head.weights);
+            kernel.recurrent = constant(head.recurrent);
+            kernel.bias = constant(head.bias);
+            kernel.stm = plan.state.data() + stateUsed;
+            stateUsed += padded(head.rows);
+            kernel.ltm = plan.state.data() + stateUsed;
+            stateUsed += padded(head.rows);
+            kernel.scratch = plan.state.data() + stateUsed;
+            stateUsed += padded(4 * head.rows);
+            kernel.fn = withPolicy(head.act, [&]<typename Act>()
+            {
+                return withPolicy(head.gate, [&]<typename Gate>() -> ExecutionPlan::KernelFn
+                {
+                    return [](const ExecutionPlan::Kernel& kn, double* buf)
+                    {
+                        size_t n = kn.rows;
+                        Eigen::Map<const RowMajor> w(kn.weights, static_cast<Eigen::Index>(4 * n),
+                                                     static_cast<Eigen::Index>(kn.cols));
+                        Eigen::Map<const Eigen::VectorXd> x(buf + kn.in[0], static_cast<Eigen::Index>(kn.cols));
+                        Eigen::Map<Eigen::VectorXd> pre(kn.scratch, static_cast<Eigen::Index>(4 * n));
+                        pre.noalias() = w * x;
+                        double* out = buf + kn.out;
+                        for (size_t j = 0; j < n; ++j)
+                        {
+                            double gate[4];
+                            for (size_t g = 0; g < 4; ++g)
+                            {
+                                size_t slot = g * n + j;
+                                gate[g] = pre[static_cast<Eigen::Index>(slot)] + kn.recurrent[slot] * kn.stm[j]
+                                          + kn.bias[slot];
+                            }
+                            kn.ltm[j] = kn.ltm[j] * Gate::apply(gate[0]) + Gate::apply(gate[1]) * Act::apply(gate[2]);
+                            kn.stm[j] = Act::apply(kn.ltm[j]) * Gate::apply(gate[3]);
+                            out[j] = kn.stm[j];
+                        }
+                    };
+                });
+            });
+            name = head.name;
+        }
+        else
+        {
+            // dense chain: [matmul] [+ bias] [activation], resolved to one specialised kernel
+            bool hasWeights = chain.matmul >= 0;
+            if (hasWeights)
+            {
+                const Op& mm = ops[static_cast<size_t>(chain.matmul)];
+                kernel.cols = mm.cols;
+                kernel.weights = constant(mm.weights);
+            }
+            if (chain.bias >= 0)
+            {
+                kernel.bias = constant(ops[static_cast<size_t>(chain.bias)].bias);
+            }
+            kernel.fn = withPolicy(chain.act, [&]<typename Act>() -> ExecutionPlan::KernelFn
+            {
+                if (hasWeights)
+                {
+                    return [](const ExecutionPlan::Kernel& kn, double* buf)
+                    {
+                        Eigen::Map<const RowMajor> w(kn.weights, static_cast<Eigen::Index>(kn.rows),
+                                                     static_cast<Eigen::Index>(kn.cols));
+                        Eigen::Map<const Eigen::VectorXd> x(buf + kn.in[0], static_cast<Eigen::Index>(kn.cols));
+                        Eigen::Map<Eigen::VectorXd> y(buf + kn.out, static_cast<Eigen::Index>(kn.rows));
+                        y.noalias() = w * x;
+                        if (kn.bias)
+                        {
+                            y += Eigen::Map<const Eigen::VectorXd>(kn.bias, static_cast<Eigen::Index>(kn.rows));
+                        }
+                        activate<Act>(y);
+                    };
+                }
+                return [](const ExecutionPlan::Kernel& kn, double* buf)
+                {
+                    Eigen::Map<Eigen::VectorXd> y(buf + kn.out, static_cast<Eigen::Index>(kn.rows));
+                    y = Eigen::Map<const Eigen::VectorXd>(buf + kn.in[0], static_cast<Eigen::Index>(kn.rows));
+                    if (kn.bias)
+                    {
+                        y += Eigen::Map<const Eigen::VectorXd>(kn.bias, static_cast<Eigen::Index>(kn.rows));
+                    }
+                    activate<Act>(y);
+                };
+            });
+            for (size_t i = chain.head;; i = readers[i][0])
+            {
+                name += (name.empty() ? "" : "+") + ops[i].name;
+                if (i == chain.tail)
+                {
+                    break;
+                }
+            }
+        }
+        plan.kernels.push_back(std::move(kernel));
+        plan.names.push_back(name);
+        release(k);
+    }
+
+    for (const std::string& name : outputs)
+    {
+        size_t i = index.at(name);
+        plan.outputSlots.push_back({offset[i], sizes[i]});
+    }
+    plan.buffer.assign(end, 0.0);
+    return plan;
+}
+
+/**
+ *
+ * @brief: runs every kernel once
+ *
+ * @param: inputs .
+ * type: const std::vector<std::span<const double>>&, one per graph input
+ * @return: std::span<const double> .
+ * the first output, valid until the next run
+ *
+ */
+std::span<const double> ExecutionPlan::run(const std::vector<std::span<const double>>& inputs)
+{
+    if (inputs.size() != inputSlots.size())
+    {
+        throw std::invalid_argument("Plan expects " + std::to_string(inputSlots.size()) + " inputs");
+    }
+    for (size_t i = 0; i < inputs.size(); ++i)
+    {
+        if (inputs[i].size() != inputSlots[i].second)
+        {
+            throw std::invalid_argument("Plan input size mismatch");
+        }
+        std::copy(inputs[i].begin(), inputs[i].end(), buffer.begin() + static_cast<long>(inputSlots[i].first));
+    }
+    double* buf = buffer.data();
+    for (const Kernel& kernel : kernels)
+    {
+        kernel.fn(kernel, buf);
+    }
+    return outputSlots.empty() ? std::span<const double>() : output(0);
+}
+
+std::span<const double> ExecutionPlan::run(std::span<const double> input)
+{
+    return run(std::vector<std::span<const double>>{input});
+}
+
+/**
+ *
+ * @brief: an output of the last run, in the order they were marked
+ *
+ */
+std::span<const double> ExecutionPlan::output(size_t index) const
+{
+    const auto& slot = outputSlots.at(index);
+    return {buffer.data() + slot.first, slot.second};
+}
+
+/**
+ *
+ * @brief: zeroes the cell state of every LSTM kernel
+ *
+ */
+void ExecutionPlan::resetState() noexcept
+{
+    std::fill(state.begin(), state.end(), 0.0);
+}
+
+template GraphBuilder& GraphBuilder::dense(const std::string&, const std::string&, NetworkLayer<BaseNode>&);
+template GraphBuilder& GraphBuilder::dense(const std::string&, const std::string&, NetworkLayer<BasicNode<SigmoidAct>>&);
+template GraphBuilder& GraphBuilder::dense(const std::string&, const std::string&, NetworkLayer<BasicNode<ReluAct>>&);
+template GraphBuilder& GraphBuilder::dense(const std::string&, const std::string&,
+                                           NetworkLayer<BasicNode<LeakyReluAct>>&);
+template GraphBuilder& GraphBuilder::dense(const std::string&, const std::string&, NetworkLayer<BasicNode<GeluAct>>&);
+template GraphBuilder& GraphBuilder::dense(const std::string&, const std::string&,
+                                           NetworkLayer<BasicNode<HardSigmoidAct>>&);
+template GraphBuilder& GraphBuilder::lstm(const std::string&, const std::string&, NetworkLayer<LstmNode>&);
+template GraphBuilder& GraphBuilder::lstm(const std::string&, const std::string&, NetworkLayer<HardGateLstmNode>&);
@@ -0,0 +1,161 @@
+#include "../headr/graph.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <stdexcept>
+
+class GraphTest : public ::testing::Test{};
+
+/**
+ * @brief: Tests for ordering, fusion and buffer reuse
+ */
+TEST_F(GraphTest, CompileTests)
+{
+    std::vector<double> w1 = {0.5, -0.2, 0.1, 0.3, 0.7, -0.4};
+    std::vector<double> b1 = {0.1, -0.1};
+    std::vector<double> w2 = {0.6, -0.8};
+    std::vector<double> b2 = {0.05};
+
+    // Test 1: operations declared out of order are sorted and each dense chain becomes one kernel
+    GraphBuilder builder;
+    builder.activation("out", "out/bias", Activation::Sigmoid)
+           .bias("out/bias", "out/matmul", b2)
+           .matmul("out/matmul", "hidden", 1, 2, w2)
+           .activation("hidden", "hidden/bias", Activation::Tanh)
+           .bias("hidden/bias", "hidden/matmul", b1)
+           .matmul("hidden/matmul", "x", 2, 3, w1)
+           .input("x", 3)
+           .output("out");
+    ExecutionPlan plan = builder.compile();
+    ASSERT_EQ(plan.numKernels(), 2) << "Dense chains not fused";
+    EXPECT_EQ(plan.kernelNames()[0], "hidden/matmul+hidden/bias+hidden") << "Wrong first kernel";
+    EXPECT_EQ(plan.kernelNames()[1], "out/matmul+out/bias+out") << "Wrong second kernel";
+
+    // Test 2: the plan matches the reference computation
+    std::vector<double> x = {1.0, -0.5, 0.25};
+    double h0 = std::tanh(0.5 * 1.0 - 0.2 * -0.5 + 0.1 * 0.25 + 0.1);
+    double h1 = std::tanh(0.3 * 1.0 + 0.7 * -0.5 - 0.4 * 0.25 - 0.1);
+    double expected = 1.0 / (1.0 + std::exp(-(0.6 * h0 - 0.8 * h1 + 0.05)));
+    std::span<const double> out = plan.run(x);
+    ASSERT_EQ(out.size(), 1) << "Output size mismatch";
+    EXPECT_NEAR(out[0], expected, 1e-12) << "Plan output mismatch";
+
+    // Test 3: an intermediate that is also an output or read twice is not fused away
+    GraphBuilder branch;
+    branch.input("x", 3)
+          .matmul("m", "x", 2, 3, w1)
+          .bias("b", "m", b1)
+          .activation("t", "m", Activation::Tanh)
+          .concat("joined", {"b", "t"})
+          .output("joined");
+    ExecutionPlan branched = branch.compile();
+    EXPECT_EQ(branched.numKernels(), 4) << "Shared value was fused";
+    std::span<const double> joined = branched.run(x);
+    ASSERT_EQ(joined.size(), 4) << "Concat size mismatch";
+    EXPECT_NEAR(joined[2], std::tanh(joined[0] - b1[0]), 1e-12) << "Concat order mismatch";
+
+    // Test 4: a long chain reuses freed buffers
+    GraphBuilder chain;
+    std::vector<double> square(64 * 64, 0.01);
+    chain.input("x", 64);
+    std::string prev = "x";
+    for (int i = 0; i < 6; ++i)
+    {
+        std::string name = "l" + std::to_string(i);
+        chain.matmul(name, prev, 64, 64, square);
+        prev = name;
+    }
+    chain.output(prev);
+    ExecutionPlan deep = chain.compile();
+    EXPECT_LT(deep.activationBytes(), deep.unsharedBytes()) << "Buffers not reused";
+    EXPECT_LE(deep.activationBytes(), 3 * 64 * sizeof(double)) << "More than two live values at once";
+    std::vector<double> ones(64, 1.0);
+    std::span<const double> deepOut = deep.run(ones);
+    EXPECT_NEAR(deepOut[0], std::pow(0.64, 6), 1e-12) << "Reused buffers corrupted the chain";
+}
+
+/**
+ * @brief: Tests for plans built from network layers
+ */
+TEST_F(GraphTest, LayerTests)
+{
+    ExecContext ctx;
+    std::vector<double> x = {0.2, -0.4, 0.6};
+
+    // Test 1: two dense layers match NetworkLayer::forward
+    NetworkLayer<BaseNode> first(4, BaseNode(), true, nullptr, 3);
+    NetworkLayer<BaseNode> second(2, BaseNode(), true, nullptr, 4);
+    GraphBuilder builder;
+    builder.input("x", 3).dense("h", "x", first).dense("y", "h", second).output("y");
+    ExecutionPlan plan = builder.compile();
+    EXPECT_EQ(plan.numKernels(), 2) << "Dense layers not fused";
+    std::span<double> hidden = first.forward(ctx, x);
+    std::span<double> expected = second.forward(ctx, hidden);
+    std::span<const double> out = plan.run(x);
+    for (size_t j = 0; j < 2; ++j)
+    {
+        EXPECT_NEAR(out[j], expected[j], 1e-12) << "Dense plan mismatch at node " << j;
+    }
+
+    // Test 2: the LSTM kernel carries its state between runs and resetState clears it
+    NetworkLayer<LstmNode> cells(3, LstmNode(), true, nullptr, 3);
+    GraphBuilder recurrent;
+    recurrent.input("x", 3).lstm("c", "x", cells).output("c");
+    ExecutionPlan lstmPlan = recurrent.compile();
+    lstmPlan.run(x);
+    lstmPlan.resetState();
+    lstmPlan.run(x);
+    std::span<const double> planStep2 = lstmPlan.run(x);
+    cells.forward(ctx, x);
+    std::span<double> nodeStep2 = cells.forward(ctx, x);
+    for (size_t j = 0; j < 3; ++j)
+    {
+        EXPECT_NEAR(planStep2[j], nodeStep2[j], 1e-12) << "LSTM plan mismatch at node " << j;
+    }
+
+    // Test 3: the layer's activation policy is fused into its kernel
+    NetworkLayer<BasicNode<ReluAct>> relu(6, BasicNode<ReluAct>(), true, nullptr, 3);
+    GraphBuilder rectified;
+    rectified.input("x", 3).dense("r", "x", relu).output("r");
+    ExecutionPlan reluPlan = rectified.compile();
+    EXPECT_EQ(reluPlan.numKernels(), 1) << "Relu layer not fused";
+    std::span<const double> reluOut = reluPlan.run(x);
+    std::span<double> reluExpected = relu.forward(ctx, x);
+    for (size_t j = 0; j < 6; ++j)
+    {
+        EXPECT_NEAR(reluOut[j], reluExpected[j], 1e-12) << "Relu plan mismatch at node " << j;
+    }
+    ctx.endBatch();
+}
+
+/**
+ * @brief: Tests for invalid graphs
+ */
+TEST_F(GraphTest, ErrorTests)
+{
+    std::vector<double> w = {1.0, 0.0, 0.0, 1.0};
+
+    // Test 1: unknown inputs, duplicate names and cycles are rejected
+    GraphBuilder unknown;
+    unknown.input("x", 2).matmul("m", "y", 2, 2, w).output("m");
+    EXPECT_THROW(unknown.compile(), std::invalid_argument) << "Unknown input accepted";
+
+    GraphBuilder duplicate;
+    duplicate.input("x", 2).matmul("x", "x", 2, 2, w);
+    EXPECT_THROW(duplicate.compile(), std::invalid_argument) << "Duplicate name accepted";
+
+    GraphBuilder cycle;
+    cycle.input("x", 2).matmul("a", "b", 2, 2, w).matmul("b", "a", 2, 2, w).output("b");
+    EXPECT_THROW(cycle.compile(), std::invalid_argument) << "Cycle accepted";
+
+    // Test 2: shape mismatches are caught at compile time, input sizes at run time
+    GraphBuilder shape;
+    shape.input("x", 3).matmul("m", "x", 2, 2, w).output("m");
+    EXPECT_THROW(shape.compile(), std::invalid_argument) << "Shape mismatch accepted";
+    EXPECT_THROW(GraphBuilder().matmul("m", "x", 2, 3, w), std::invalid_argument) << "Bad weight count accepted";
+
+    GraphBuilder ok;
+    ok.input("x", 2).matmul("m", "x", 2, 2, w).output("m");
+    ExecutionPlan plan = ok.compile();
+    std::vector<double> wrong(3, 0.0);
+    EXPECT_THROW(plan.run(wrong), std::invalid_argument) << "Wrong input size accepted";
+}
@@ -0,0 +1,218 @@
+#ifndef KERNEL_H
+#define KERNEL_H
+
+#include "../../memory/headr/arena.h"
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/**
+ *
+ * @enum: Precision -> storage format of the packed weights a layer runs its forward pass on
+ *
+ * @note: Full runs on the double master weights, BF16 / FP16 run on 16 bit copies of them with
+ *          fp32 accumulation. Master weights always stay in full precision for training
+ *
+ */
+enum class Precision
+{
+    Full,
+    BF16,
+    FP16
+};
+
+/**
+ * @struct: Bf16 -> brain float, the top 16 bits of an IEEE float
+ */
+struct Bf16
+{
+    std::uint16_t bits;
+};
+
+/**
+ * @struct: Fp16 -> IEEE half precision float
+ */
+struct Fp16
+{
+    std::uint16_t bits;
+};
+
+/**
+ *
+ * @brief: float -> bf16 with round to nearest even, NaN stays NaN
+ *
+ */
+inline Bf16 toBf16(float val) noexcept
+{
+    std::uint32_t u = std::bit_cast<std::uint32_t>(val);
+    if ((u & 0x7fffffffu) > 0x7f800000u)
+    {
+        return Bf16{static_cast<std::uint16_t>((u >> 16) | 0x0040u)};
+    }
+    u += 0x7fffu + ((u >> 16) & 1u);
+    return Bf16{static_cast<std::uint16_t>(u >> 16)};
+}
+
+/**
+ *
+ * @brief: bf16 -> float, a plain shift so it vectorizes on every SIMD ISA
+ *
+ */
+inline float toFloat(Bf16 val) noexcept
+{
+    return std::bit_cast<float>(static_cast<std::uint32_t>(val.bits) << 16);
+}
+
+#if defined(__FLT16_MANT_DIG__) && (defined(__F16C__) || defined(__aarch64__))
+// hardware half conversion (F16C on x86, fcvt on arm64)
+inline Fp16 toFp16(float val) noexcept
+{
+    return Fp16{std::bit_cast<std::uint16_t>(static_cast<_Float16>(val))};
+}
+
+inline float toFloat(Fp16 val) noexcept
+{
+    return static_cast<float>(std::bit_cast<_Float16>(val.bits));
+}
+#else
+/**
+ *
+ * @brief: software fallback float -> fp16, round to nearest even, handles subnormals and inf/NaN
+ *
+ */
+inline Fp16 toFp16(float val) noexcept
+{
+    std::uint32_t u = std::bit_cast<std::uint32_t>(val);
+    std::uint32_t sign = (u >> 16) & 0x8000u;
+    std::uint32_t absVal = u & 0x7fffffffu;
+
+    if (absVal >= 0x7f800000u)
+    {
+        // inf stays inf, NaN keeps a quiet payload bit
+        return Fp16{static_cast<std::uint16_t>(sign | 0x7c00u | (absVal > 0x7f800000u ? 0x0200u : 0u))};
+    }
+    if (absVal >= 0x477ff000u)
+    {
+        // rounds past the largest half
+        return Fp16{static_cast<std::uint16_t>(sign | 0x7c00u)};
+    }
+    if (absVal < 0x38800000u)
+    {
+        // subnormal half: let the float adder do the rounding
+        float shifted = std::bit_cast<float>(absVal) + 0.5f;
+        return Fp16{static_cast<std::uint16_t>(sign | (std::bit_cast<std::uint32_t>(shifted) - 0x3f000000u))};
+    }
+    std::uint32_t mantOdd = (absVal >> 13) & 1u;
+    absVal += 0xc8000fffu + mantOdd;
+    return Fp16{static_cast<std::uint16_t>(sign | (absVal >> 13))};
+}
+
+/**
+ *
+ * @brief: software fallback fp16 -> float
+ *
+ */
+inline float toFloat(Fp16 val) noexcept
+{
+    std::uint32_t sign = static_cast<std::uint32_t>(val.bits & 0x8000u) << 16;
+    std::uint32_t expMant = static_cast<std::uint32_t>(val.bits & 0x7fffu) << 13;
+    std::uint32_t exp = expMant & 0x0f800000u;
+
+    if (exp == 0x0f800000u)
+    {
+        // inf / NaN
+        return std::bit_cast<float>(sign | expMant | 0x70000000u | 0x7f800000u);
+    }
+    if (exp == 0)
+    {
+        // zero / subnormal, renormalise through a float subtraction
+        float magic = std::bit_cast<float>(expMant + 0x38800000u) - std::bit_cast<float>(0x38800000u);
+        return std::bit_cast<float>(sign | std::bit_cast<std::uint32_t>(magic));
+    }
+    return std::bit_cast<float>(sign | (expMant + 0x38000000u));
+}
+#endif
+
+/**
+ *
+ * @brief: dot products with fp32 accumulation, the weights are converted on the fly
+ *
+ * @param: weights -> pointer to n packed weights
+ * @param: x -> pointer to n fp32 inputs
+ * @param: n -> type: size_t, length of the product
+ * @param: unroll -> type: size_t, independent accumulators, 4, 8 or 16 (anything else runs 8)
+ * @return: float -> the accumulated sum
+ *
+ * @note: the best unroll depends on the vector width and add latency of the CPU, the autotuner picks it
+ *
+ */
+float dot(const float* weights, const float* x, std::size_t n, std::size_t unroll = 8) noexcept;
+float dot(const Bf16* weights, const float* x, std::size_t n, std::size_t unroll = 8) noexcept;
+float dot(const Fp16* weights, const float* x, std::size_t n, std::size_t unroll = 8) noexcept;
+
+/**
+ *
+ * @class: HalfMatrix -> row major matrix of 16 bit weights
+ *
+ * @note: rows start on a 16 byte boundary so every row load is vector aligned
+ *
+ */
+class HalfMatrix
+{
+    public:
+        HalfMatrix() noexcept : precision(Precision::Full), numRows(0), numCols(0), stride(0), unroll(8), bits() {}
+
+        /**
+         *
+         * @brief: sizes the matrix and sets the storage format
+         *
+         * @param: format -> type: Precision, BF16 or FP16
+         * @param: rows -> type: size_t, number of rows
+         * @param: cols -> type: size_t, number of columns
+         *
+         */
+        void reset(Precision format, std::size_t rows, std::size_t cols);
+
+        /**
+         *
+         * @brief: converts one row of master weights into the packed format
+         *
+         * @param: row -> type: size_t, row index
+         * @param: values -> type: span<const double>, cols master weights
+         *
+         */
+        void setRow(std::size_t row, std::span<const double> values);
+
+        /**
+         *
+         * @brief: dot product of one row with x, fp32 accumulation
+         *
+         */
+        float rowDot(std::size_t row, const float* x) const noexcept;
+
+        /**
+         *
+         * @brief: sets the accumulators of rowDot
+         *
+         * @param: lanes -> type: size_t, 4, 8 or 16
+         *
+         */
+        void setUnroll(std::size_t lanes);
+
+        std::size_t rows() const noexcept { return numRows; }
+        std::size_t cols() const noexcept { return numCols; }
+        std::size_t bytes() const noexcept { return bits.size() * sizeof(std::uint16_t); }
+        Precision format() const noexcept { return precision; }
+
+    private:
+        Precision precision;
+        std::size_t numRows;
+        std::size_t numCols;
+        std::size_t stride;
+        std::size_t unroll;
+        std::vector<std::uint16_t, AlignedAllocator<std::uint16_t>> bits;
+};
+
+#endif
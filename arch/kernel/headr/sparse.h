@@ -0,0 +1,99 @@
+#ifndef SPARSE_H
+#define SPARSE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/**
+ *
+ * @enum: PruneMode -> how magnitude pruning picks the weights to drop
+ *
+ * @note: Unstructured drops the smallest individual weights, Structured drops whole input columns
+ *          (one input feature for every node and gate) ranked by their L2 norm
+ *
+ */
+enum class PruneMode
+{
+    Unstructured,
+    Structured
+};
+
+/**
+ *
+ * @class: CsrMatrix -> compressed sparse row matrix used by the sparse forward kernels
+ *
+ * @note: rows are appended in order from dense rows, exact zeros are skipped
+ *
+ */
+class CsrMatrix
+{
+    public:
+        CsrMatrix() noexcept : numCols(0), rowPtr(1, 0), colIdx(), values() {}
+
+        /**
+         *
+         * @brief: clears the matrix and sets the column count
+         *
+         * @param: cols -> type: size_t, number of columns every appended row must have
+         *
+         */
+        void reset(std::size_t cols);
+
+        /**
+         *
+         * @brief: appends one dense row, only the non zero entries are stored
+         *
+         * @param: dense -> type: span<const double>, cols values
+         *
+         */
+        void appendRow(std::span<const double> dense);
+
+        /**
+         *
+         * @brief: sparse dot product of one row with a dense vector
+         *
+         */
+        double rowDot(std::size_t row, const double* x) const noexcept
+        {
+            double sum = 0.0;
+            for (std::uint32_t k = rowPtr[row]; k < rowPtr[row + 1]; ++k)
+            {
+                sum += values[k] * x[colIdx[k]];
+            }
+            return sum;
+        }
+
+        /**
+         *
+         * @brief: out = A * x
+         *
+         */
+        void multiply(const double* x, double* out) const noexcept;
+
+        std::size_t rows() const noexcept { return rowPtr.size() - 1; }
+        std::size_t cols() const noexcept { return numCols; }
+        std::size_t nonZeros() const noexcept { return values.size(); }
+        double density() const noexcept;
+        std::size_t bytes() const noexcept;
+
+    private:
+        std::size_t numCols;
+        std::vector<std::uint32_t> rowPtr;
+        std::vector<std::uint32_t> colIdx;
+        std::vector<double> values;
+};
+
+/**
+ *
+ * @brief: magnitude threshold that zeroes the requested fraction of the given magnitudes
+ *
+ * @param: magnitudes -> type: std::vector<double>, absolute values (taken by value, it gets reordered)
+ * @param: sparsity -> type: double, fraction in [0, 1] of entries to drop
+ * @return: double -> entries with magnitude below the threshold should be pruned, -1 when nothing is
+ *
+ */
+double pruneThreshold(std::vector<double> magnitudes, double sparsity);
+
+#endif
@@ -0,0 +1,150 @@
+#include "../headr/kernel.h"
+#include <stdexcept>
+
+namespace
+{
+    inline float widen(float val) noexcept { return val; }
+    inline float widen(Bf16 val) noexcept { return toFloat(val); }
+    inline float widen(Fp16 val) noexcept { return toFloat(val); }
+
+    /**
+     *
+     * @brief: shared body of the dot kernels, Lanes independent accumulators so the compiler can keep
+     *          a full vector register of partial sums and the add latency is hidden
+     *
+     */
+    template <std::size_t Lanes, typename W>
+    float dotKernel(const W* __restrict weights, const float* __restrict x, std::size_t n) noexcept
+    {
+        float acc[Lanes] = {};
+        std::size_t i = 0;
+        for (; i + Lanes <= n; i += Lanes)
+        {
+            for (std::size_t k = 0; k < Lanes; ++k)
+            {
+                acc[k] += widen(weights[i + k]) * x[i + k];
+            }
+        }
+        for (; i < n; ++i)
+        {
+            acc[0] += widen(weights[i]) * x[i];
+        }
+        // pairwise fold, the same tree for every call
+        for (std::size_t width = Lanes / 2; width > 0; width /= 2)
+        {
+            for (std::size_t k = 0; k < width; ++k)
+            {
+                acc[k] = acc[2 * k] + acc[2 * k + 1];
+            }
+        }
+        return acc[0];
+    }
+
+    template <typename W>
+    float dotUnrolled(const W* weights, const float* x, std::size_t n, std::size_t unroll) noexcept
+    {
+        switch (unroll)
+        {
+            case 4: return dotKernel<4>(weights, x, n);
+            case 16: return dotKernel<16>(weights, x, n);
+            default: return dotKernel<8>(weights, x, n);
+        }
+    }
+}
+
+float dot(const float* weights, const float* x, std::size_t n, std::size_t unroll) noexcept
+{
+    return dotUnrolled(weights, x, n, unroll);
+}
+
+float dot(const Bf16* weights, const float* x, std::size_t n, std::size_t unroll) noexcept
+{
+    return dotUnrolled(weights, x, n, unroll);
+}
+
+float dot(const Fp16* weights, const float* x, std::size_t n, std::size_t unroll) noexcept
+{
+    return dotUnrolled(weights, x, n, unroll);
+}
+
+/**
+ *
+ * @brief: sizes the matrix and sets the storage format
+ *
+ * @param: format .
+ * type: Precision, BF16 or FP16
+ * @param: rows .
+ * type: size_t, number of rows
+ * @param: cols .
+ * type: size_t, number of columns
+ *
+ */
+void HalfMatrix::reset(Precision format, std::size_t rows, std::size_t cols)
+{
+    if (format == Precision::Full)
+    {
+        throw std::invalid_argument("HalfMatrix only stores BF16 or FP16 weights");
+    }
+    precision = format;
+    numRows = rows;
+    numCols = cols;
+    // rows padded to 8 halves (one 128 bit vector), cache line padding would double small layers
+    stride = (cols + 7) & ~std::size_t(7);
+    bits.assign(rows * stride, 0);
+}
+
+/**
+ *
+ * @brief: converts one row of master weights into the packed format
+ *
+ * @param: row .
+ * type: size_t, row index
+ * @param: values .
+ * type: span<const double>, cols master weights
+ *
+ */
+void HalfMatrix::setRow(std::size_t row, std::span<const double> values)
+{
+    if (row >= numRows || values.size() != numCols)
+    {
+        throw std::invalid_argument("HalfMatrix row does not match the matrix shape");
+    }
+    std::uint16_t* dst = bits.data() + row * stride;
+    for (std::size_t i = 0; i < numCols; ++i)
+    {
+        float val = static_cast<float>(values[i]);
+        dst[i] = precision == Precision::BF16 ? toBf16(val).bits : toFp16(val).bits;
+    }
+}
+
+/**
+ *
+ * @brief: dot product of one row with x, fp32 accumulation
+ *
+ */
+float HalfMatrix::rowDot(std::size_t row, const float* x) const noexcept
+{
+    const std::uint16_t* src = bits.data() + row * stride;
+    if (precision == Precision::BF16)
+    {
+        return dot(reinterpret_cast<const Bf16*>(src), x, numCols, unroll);
+    }
+    return dot(reinterpret_cast<const Fp16*>(src), x, numCols, unroll);
+}
+
+/**
+ *
+ * @brief: sets the accumulators of rowDot
+ *
+ * @param: lanes .
+ * type: size_t, 4, 8 or 16
+ *
+ */
+void HalfMatrix::setUnroll(std::size_t lanes)
+{
+    if (lanes != 4 && lanes != 8 && lanes != 16)
+    {
+        throw std::invalid_argument("Dot kernel unroll must be 4, 8 or 16");
+    }
+    unroll = lanes;
+}
@@ -0,0 +1,112 @@
+#include "../headr/sparse.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+/**
+ *
+ * @brief: clears the matrix and sets the column count
+ *
+ * @param: cols .
+ * type: size_t, number of columns every appended row must have
+ *
+ */
+void CsrMatrix::reset(std::size_t cols)
+{
+    numCols = cols;
+    rowPtr.assign(1, 0);
+    colIdx.clear();
+    values.clear();
+}
+
+/**
+ *
+ * @brief: appends one dense row, only the non zero entries are stored
+ *
+ * @param: dense .
+ * type: span<const double>, cols values
+ *
+ */
+void CsrMatrix::appendRow(std::span<const double> dense)
+{
+    if (dense.size() != numCols)
+    {
+        throw std::invalid_argument("CsrMatrix row does not match the column count");
+    }
+    for (std::size_t i = 0; i < dense.size(); ++i)
+    {
+        if (dense[i] != 0.0)
+        {
+            colIdx.push_back(static_cast<std::uint32_t>(i));
+            values.push_back(dense[i]);
+        }
+    }
+    rowPtr.push_back(static_cast<std::uint32_t>(values.size()));
+}
+
+/**
+ *
+ * @brief: out = A * x
+ *
+ */
+void CsrMatrix::multiply(const double* x, double* out) const noexcept
+{
+    for (std::size_t row = 0; row < rows(); ++row)
+    {
+        out[row] = rowDot(row, x);
+    }
+}
+
+/**
+ *
+ * @brief: fraction of stored entries, 1 for an empty matrix so it is never picked as sparse
+ *
+ */
+double CsrMatrix::density() const noexcept
+{
+    std::size_t total = rows() * numCols;
+    return total == 0 ? 1.0 : static_cast<double>(values.size()) / static_cast<double>(total);
+}
+
+/**
+ *
+ * @brief: memory held by the matrix in bytes
+ *
+ */
+std::size_t CsrMatrix::bytes() const noexcept
+{
+    return rowPtr.size() * sizeof(std::uint32_t) + colIdx.size() * sizeof(std::uint32_t) +
+           values.size() * sizeof(double);
+}
+
+/**
+ *
+ * @brief: magnitude threshold that zeroes the requested fraction of the given magnitudes
+ *
+ * @param: magnitudes .
+ * type: std::vector<double>, absolute values (taken by value, it gets reordered)
+ * @param: sparsity .
+ * type: double, fraction in [0, 1] of entries to drop
+ * @return: double .
+ * entries with magnitude below the threshold should be pruned, -1 when nothing is
+ *
+ */
+double pruneThreshold(std::vector<double> magnitudes, double sparsity)
+{
+    if (sparsity < 0.0 || sparsity > 1.0)
+    {
+        throw std::invalid_argument("Sparsity must be in [0, 1]");
+    }
+    std::size_t drop = static_cast<std::size_t>(sparsity * static_cast<double>(magnitudes.size()));
+    if (drop == 0)
+    {
+        return -1.0;
+    }
+    if (drop >= magnitudes.size())
+    {
+        return std::numeric_limits<double>::infinity();
+    }
+    // the first kept magnitude, everything strictly below it goes
+    std::nth_element(magnitudes.begin(), magnitudes.begin() + drop, magnitudes.end());
+    return magnitudes[drop];
+}
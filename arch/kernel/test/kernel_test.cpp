@@ -0,0 +1,99 @@
+#include "../headr/kernel.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
+
+class KernelTest : public ::testing::Test{};
+
+/**
+ * @brief: Tests for the bf16 / fp16 conversions
+ */
+TEST_F(KernelTest, HalfConversions)
+{
+    // Test 1: exactly representable values round trip
+    for (float val : {0.0f, 1.0f, -2.5f, 0.125f, 1024.0f})
+    {
+        EXPECT_EQ(toFloat(toBf16(val)), val) << "bf16 round trip failed for " << val;
+        EXPECT_EQ(toFloat(toFp16(val)), val) << "fp16 round trip failed for " << val;
+    }
+
+    // Test 2: relative error stays within half an ulp of each format
+    for (float val : {0.1f, -0.7f, 3.14159f, 123.456f})
+    {
+        EXPECT_NEAR(toFloat(toBf16(val)), val, std::abs(val) * 0.004f) << "bf16 rounding error too large";
+        EXPECT_NEAR(toFloat(toFp16(val)), val, std::abs(val) * 0.0005f) << "fp16 rounding error too large";
+    }
+
+    // Test 3: round to nearest even on a bf16 tie
+    EXPECT_EQ(toBf16(1.0f + 1.0f / 256.0f).bits, toBf16(1.0f).bits) << "bf16 tie did not round to even";
+
+    // Test 4: fp16 subnormals, overflow and special values
+    float subnormal = std::ldexp(1.0f, -20);
+    EXPECT_EQ(toFloat(toFp16(subnormal)), subnormal) << "fp16 subnormal lost";
+    EXPECT_TRUE(std::isinf(toFloat(toFp16(70000.0f)))) << "fp16 overflow did not saturate to inf";
+    EXPECT_TRUE(std::isnan(toFloat(toFp16(std::numeric_limits<float>::quiet_NaN())))) << "fp16 NaN lost";
+    EXPECT_TRUE(std::isnan(toFloat(toBf16(std::numeric_limits<float>::quiet_NaN())))) << "bf16 NaN lost";
+}
+
+/**
+ * @brief: Tests for the fp32 accumulating dot kernels
+ */
+TEST_F(KernelTest, DotKernels)
+{
+    // odd length exercises the tail loop
+    const size_t n = 37;
+    std::vector<float> x(n), w(n);
+    std::vector<Bf16> wBf(n);
+    std::vector<Fp16> wFp(n);
+    double expected = 0.0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        x[i] = std::sin(0.3f * i);
+        w[i] = std::cos(0.7f * i) * 0.5f;
+        wBf[i] = toBf16(w[i]);
+        wFp[i] = toFp16(w[i]);
+        expected += static_cast<double>(x[i]) * w[i];
+    }
+
+    // Test 1: fp32 weights
+    EXPECT_NEAR(dot(w.data(), x.data(), n), expected, 1e-4) << "fp32 dot mismatch";
+
+    // Test 2: 16 bit weights only lose the storage precision
+    EXPECT_NEAR(dot(wBf.data(), x.data(), n), expected, 5e-2) << "bf16 dot mismatch";
+    EXPECT_NEAR(dot(wFp.data(), x.data(), n), expected, 5e-3) << "fp16 dot mismatch";
+
+    // Test 3: every unroll gives the same product up to fp32 rounding
+    for (size_t unroll : {4, 8, 16})
+    {
+        EXPECT_NEAR(dot(w.data(), x.data(), n, unroll), expected, 1e-4) << "fp32 dot mismatch, unroll " << unroll;
+        EXPECT_NEAR(dot(wFp.data(), x.data(), n, unroll), dot(wFp.data(), x.data(), n), 1e-5)
+                            << "fp16 dot mismatch, unroll " << unroll;
+    }
+}
+
+/**
+ * @brief: Tests for the packed HalfMatrix
+ */
+TEST_F(KernelTest, HalfMatrix)
+{
+    HalfMatrix matrix;
+
+    // Test 1: Full precision cannot be packed
+    EXPECT_THROW(matrix.reset(Precision::Full, 2, 2), std::invalid_argument) << "Full precision accepted";
+
+    // Test 2: rows are packed and multiplied independently
+    matrix.reset(Precision::FP16, 2, 3);
+    matrix.setRow(0, std::vector<double>{1.0, 2.0, 3.0});
+    matrix.setRow(1, std::vector<double>{-1.0, 0.5, 0.0});
+    std::vector<float> x = {1.0f, 1.0f, 2.0f};
+    EXPECT_FLOAT_EQ(matrix.rowDot(0, x.data()), 9.0f) << "Row 0 product mismatch";
+    EXPECT_FLOAT_EQ(matrix.rowDot(1, x.data()), -0.5f) << "Row 1 product mismatch";
+
+    // Test 3: shape is checked
+    EXPECT_THROW(matrix.setRow(0, std::vector<double>{1.0}), std::invalid_argument) << "Bad row size accepted";
+
+    // Test 4: the unroll changes the kernel, not the product, and odd unrolls are rejected
+    matrix.setUnroll(16);
+    EXPECT_FLOAT_EQ(matrix.rowDot(0, x.data()), 9.0f) << "Unrolled row product mismatch";
+    EXPECT_THROW(matrix.setUnroll(3), std::invalid_argument) << "Unroll of 3 accepted";
+}
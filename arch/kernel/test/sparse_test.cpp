@@ -0,0 +1,51 @@
+#include "../headr/sparse.h"
+#include <gtest/gtest.h>
+
+class SparseTest : public ::testing::Test{};
+
+/**
+ * @brief: Tests for building and multiplying a CSR matrix
+ */
+TEST_F(SparseTest, CsrMultiply)
+{
+    CsrMatrix matrix;
+    matrix.reset(4);
+    matrix.appendRow(std::vector<double>{1.0, 0.0, 0.0, 2.0});
+    matrix.appendRow(std::vector<double>{0.0, 0.0, 0.0, 0.0});
+    matrix.appendRow(std::vector<double>{0.0, -3.0, 0.5, 0.0});
+
+    // Test 1: shape and density
+    EXPECT_EQ(matrix.rows(), 3) << "Row count mismatch";
+    EXPECT_EQ(matrix.nonZeros(), 4) << "Zeros were stored";
+    EXPECT_NEAR(matrix.density(), 4.0 / 12.0, 1e-12) << "Density mismatch";
+
+    // Test 2: product matches the dense product
+    std::vector<double> x = {1.0, 2.0, 3.0, 4.0};
+    std::vector<double> out(3);
+    matrix.multiply(x.data(), out.data());
+    EXPECT_DOUBLE_EQ(out[0], 9.0) << "Row 0 product mismatch";
+    EXPECT_DOUBLE_EQ(out[1], 0.0) << "Empty row product mismatch";
+    EXPECT_DOUBLE_EQ(out[2], -4.5) << "Row 2 product mismatch";
+
+    // Test 3: row size is checked
+    EXPECT_THROW(matrix.appendRow(std::vector<double>{1.0}), std::invalid_argument) << "Bad row size accepted";
+}
+
+/**
+ * @brief: Tests for the magnitude pruning threshold
+ */
+TEST_F(SparseTest, PruneThreshold)
+{
+    std::vector<double> magnitudes = {0.9, 0.1, 0.5, 0.3, 0.7};
+
+    // Test 1: 40% drops the two smallest
+    double threshold = pruneThreshold(magnitudes, 0.4);
+    EXPECT_DOUBLE_EQ(threshold, 0.5) << "Threshold should be the first kept magnitude";
+
+    // Test 2: nothing and everything
+    EXPECT_LT(pruneThreshold(magnitudes, 0.0), 0.0) << "Zero sparsity pruned weights";
+    EXPECT_GT(pruneThreshold(magnitudes, 1.0), 0.9) << "Full sparsity kept weights";
+
+    // Test 3: out of range sparsity
+    EXPECT_THROW(pruneThreshold(magnitudes, 1.5), std::invalid_argument) << "Bad sparsity accepted";
+}
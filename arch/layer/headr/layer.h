@@ -1,8 +1,37 @@
 #ifndef LAYER_H
 #define LAYER_H
 #include "../../node/headr/node.h"
+#include "../../memory/headr/context.h"
+#include "../../kernel/headr/kernel.h"
+#include "../../kernel/headr/sparse.h"
+#include "../../exec/headr/pool.h"
+#include "../../exec/headr/reduce.h"
+#include <span>
 #include <vector>
 
+/**
+ *
+ * @struct: LayerTuning -> blocking and threading of a layer's forward kernels, the autotuner picks them per
+ *              host and layer shape
+ *
+ * @values:
+ *     batchTile -> type: size_t, batch rows per block of forwardBatch, 0 runs the whole batch as one block
+ *     threads -> type: size_t, threads a call splits over, 0 uses the whole pool once the layer is wide
+ *                  enough (setParallel), 1 stays serial
+ *     chunksPerThread -> type: size_t, pieces per thread, more lets stealing even out uneven pieces
+ *     unroll -> type: size_t, accumulators of the 16 bit dot kernels, 4, 8 or 16
+ *
+ */
+struct LayerTuning
+{
+    size_t batchTile = 0;
+    size_t threads = 0;
+    size_t chunksPerThread = 2;
+    size_t unroll = 8;
+
+    bool operator==(const LayerTuning& other) const noexcept = default;
+};
+
 /**
  *
  * @class: NetworkLayer -> base neuron layer for network
@@ -32,10 +61,13 @@ class NetworkLayer
      *
      * @param size -> int, number of nodes in the layer
      * @param nodeType -> NodeType, type of nodes in the layer
+     * @param numInputs -> int, fan in of every node for an input layer, other layers take the size of prev
      *
-     * @notes It fills vec with size num of nodes of either base or LSTM, then it fills information matrix with bias and val
+     * @notes It fills vec with size num of nodes of either base or LSTM, then it fills information matrix with bias and val,
+     *          a fan in the nodes reject (e.g. 0 inputs) throws std::invalid_argument
      */
-    NetworkLayer(int size, NodeType nodeType, bool isInputLayer, NetworkLayer<NodeType>* prev = nullptr) noexcept;
+    NetworkLayer(int size, NodeType nodeType, bool isInputLayer, NetworkLayer<NodeType>* prev = nullptr,
+                 int numInputs = 1);
 
     /**
     *
@@ -69,6 +101,107 @@ class NetworkLayer
     */
     void calculateLayerOutput(const std::vector<std::vector<std::pair<double, double>>>& inputVals) noexcept;
 
+    /**
+    * @brief runs the layer on one input vector, the activations live in the context arena
+    *
+    * @param ctx -> ExecContext&, execution context that owns the per-batch arena
+    * @param inputs -> std::span<const double>, input values, one per node input, any other size throws
+    * @return std::span<double> -> one output per node (the STM for LSTM nodes), valid until ctx.endBatch()
+    */
+    std::span<double> forward(ExecContext& ctx, std::span<const double> inputs);
+
+    /**
+    * @brief runs one timestep for a batch of independent sequences, the cell state lives with the caller
+    *
+    * @param ctx -> ExecContext&, execution context that owns the per-batch arena
+    * @param inputs -> std::span<const double>, batch rows of one value per node input
+    * @param batch -> size_t, number of rows (the sequences still running at this step)
+    * @param stm, ltm -> std::span<double>, LSTM only: batch rows of one state per node, updated in place
+    *                     (GRU layers take stm alone, they have no LTM cell)
+    * @return std::span<double> -> batch rows of one output per node, valid until ctx.endBatch()
+    */
+    std::span<double> forwardBatch(ExecContext& ctx, std::span<const double> inputs, size_t batch,
+                                   std::span<double> stm = {}, std::span<double> ltm = {});
+
+    /**
+    * @brief copies the master weights into dense gate matrices, slot = gate * nodes + node, gates ordered
+    *           forget, input sig, input tanh, output (GRU update, reset, candidate, base layers have one gate)
+    *
+    * @param weights -> std::span<double>, slots x fanIn input weights
+    * @param recurrent -> std::span<double>, slots summed STM weights (LSTM / GRU only)
+    * @param bias -> std::span<double>, slots summed biases
+    */
+    void unpackWeights(std::span<double> weights, std::span<double> recurrent, std::span<double> bias);
+
+    /**
+    * @brief adds gradients taken against the unpackWeights layout to the node parameters in a bound buffer
+    *
+    * @param params -> ParamBuffer&, buffer the nodes are bound to
+    * @param dWeights, dRecurrent, dBias -> std::span<const double>, gradients in the unpacked layout
+    */
+    void scatterGrads(ParamBuffer& params, std::span<const double> dWeights, std::span<const double> dRecurrent,
+                      std::span<const double> dBias);
+
+    size_t getFanIn() const noexcept { return layerNodes.empty() ? 0 : layerNodes[0].getWeightVecSize(); }
+
+    /**
+    * @brief packs the master weights (weightVec / LSTM gate weights) into 16 bit storage for forward
+    *
+    * @param newPrecision -> Precision, BF16 or FP16 to pack, Full drops the packed copy
+    * @notes master weights stay in full precision, call syncPrecision after they are updated
+    */
+    void setPrecision(Precision newPrecision);
+
+    /**
+    * @brief re-packs the 16 bit and sparse copies from the master weights
+    */
+    void syncPrecision();
+
+    /**
+    * @brief magnitude pruning of the input weights (weightVec, or the input columns of every LSTM gate)
+    *
+    * @param sparsity -> double, fraction in [0, 1] of weights (or input columns) to zero
+    * @param mode -> PruneMode, single weights or whole input columns
+    */
+    void prune(double sparsity, PruneMode mode = PruneMode::Unstructured);
+
+    /**
+    * @brief sets the density at or below which forward switches to the CSR kernels (default 0.3)
+    */
+    void setSparseThreshold(double maxDensity);
+
+    /**
+    * @brief registers the parameters of every node with the model wide buffer
+    *
+    * @param buffer -> ParamBuffer&, bound by the caller once the whole model is registered
+    */
+    void registerParams(ParamBuffer& buffer);
+
+    /**
+    * @brief evaluates the nodes of wide layers in parallel on a work stealing pool
+    *
+    * @param workers -> ThreadPool*, pool to share with other layers, nullptr turns the parallel mode off
+    * @param minNodes -> size_t, layers with fewer nodes stay serial, the fork / join costs more than they do
+    * @notes every thread writes whole cache lines of the output so neighbouring slices never share one
+    */
+    void setParallel(ThreadPool* workers, size_t minNodes = 256) noexcept;
+
+    /**
+    * @brief sets the blocking and threading of forward / forwardBatch, results do not depend on it beyond
+    *           the fp32 rounding of the 16 bit kernels
+    *
+    * @param newTuning -> LayerTuning, a chunksPerThread of 0 or an unroll other than 4, 8, 16 throws
+    */
+    void setTuning(LayerTuning newTuning);
+
+    const LayerTuning& getTuning() const noexcept { return tuning; }
+    ThreadPool* getPool() const noexcept { return pool; }
+
+    Precision getPrecision() const noexcept { return precision; }
+    bool isSparse() const noexcept { return useSparse; }
+    double getDensity() const noexcept { return density; }
+    size_t getPackedBytes() const noexcept;
+
     /**
     * @breif sets the input for the layer
     *
@@ -112,17 +245,52 @@ class NetworkLayer
      void dataLoadLstm(std::vector<std::vector<double>> values);
 
      const std::vector<NetworkNode<NodeType>>& getPrivMemberLayerNodes() const noexcept{ return layerNodes; }
+     std::vector<NetworkNode<NodeType>>& getPrivMemberLayerNodes() noexcept{ return layerNodes; }
      std::vector<double> getPrivMemberLayerWeights() const noexcept { return LayerWeights; }
      NetworkLayer* getPrivMemberPrevLayer() const noexcept { return prevLayer; }
 
 
 
 private:
+        /**
+        * @brief forward pass on the packed copy, CSR kernels when sparse, else 16 bit with fp32 accumulation
+        */
+        std::span<double> forwardPacked(ExecContext& ctx, std::span<const double> inputs);
+
+        /**
+        * @brief runs body(begin, end) over the node range, split over the pool for wide layers
+        */
+        template <typename Body>
+        void forNodes(Body&& body);
+
+        /**
+        * @brief threads a call on this layer splits over, 1 when it stays serial
+        */
+        size_t threadsFor(size_t numNodes) const noexcept;
+
         std::vector<NetworkNode<NodeType>> layerNodes;
         std::vector<double> LayerOutputVec;
         std::vector<double> LayerWeights;
         NetworkLayer* prevLayer;
         std::vector<std::vector<double>> informationMatrix;
+
+        // packed weights, one matrix for BaseNode layers and one per gate (forget, input sig, input tanh,
+        // output) for LSTM layers, (update, reset, candidate) for GRU layers. The recurrent weights of a gate
+        // only ever multiply the scalar STM so they are kept pre-summed next to the pre-summed bias
+        // [gate * nodes + node]. The sparse copy uses the same layout with one CSR matrix per gate
+        Precision precision;
+        std::vector<HalfMatrix> packedWeights;
+        std::vector<CsrMatrix> sparseWeights;
+        std::vector<double> packedRecurrent;
+        std::vector<double> packedBias;
+        double sparseThreshold;
+        double density;
+        bool useSparse;
+
+        // intra layer parallel mode, off while pool is null
+        ThreadPool* pool;
+        size_t parallelMinNodes;
+        LayerTuning tuning;
 };
 
 #endif
\ No newline at end of file
@@ -1,7 +1,123 @@
 #include "../headr/layer.h"
+#include <Eigen/Dense>
+#include <algorithm>
+#include <numeric>
 #include <random>
 #include <iostream>
 
+namespace
+{
+    // gate matrices of a layer: forget, input sig, input tanh, output for LSTM, update, reset, candidate for GRU
+    template <typename NodeType>
+    inline constexpr size_t gateCount = isLstmNode<NodeType> ? 4 : isGruNode<NodeType> ? 3 : 1;
+
+    /**
+     * @brief advances one LSTM cell from its gate pre-activations (forget, input sig, input tanh, output)
+     *
+     * @tparam NodeType -> LSTM node type, its policies pick the gate and cell activations at compile time
+     * @param ltm, stm -> double&, cell state, in a node or in a caller owned batch state array
+     * @return double -> the new STM, which is the cell output
+     */
+    template <typename NodeType>
+    inline double lstmStep(double& ltm, double& stm, const double pre[4]) noexcept
+    {
+        using Gate = typename NodeType::GatePolicy;
+        using Act = typename NodeType::ActivationPolicy;
+        ltm *= Gate::apply(pre[0]);
+        ltm += Gate::apply(pre[1]) * Act::apply(pre[2]);
+        stm = Act::apply(ltm) * Gate::apply(pre[3]);
+        return stm;
+    }
+
+    template <typename NodeType>
+    inline double lstmStep(NodeType& cell, const double pre[4]) noexcept
+    {
+        return lstmStep<NodeType>(cell.LongTermState, cell.ShortTermState, pre);
+    }
+
+    /**
+     * @brief unpacks one LSTM gate into its input weights, summed recurrent weights and summed bias
+     *
+     * @param cell -> const NodeType&, LSTM node holding the interleaved gate vectors
+     * @param gate -> int, 0 forget, 1 input sig, 2 input tanh, 3 output
+     * @param fanIn -> size_t, number of inputs of the node
+     * @param row -> std::span<double>, receives the fanIn input weights
+     * @param recurrent -> double&, receives the sum of the STM weights
+     * @param bias -> double&, receives fanIn * bias (the node adds the bias once per input)
+     */
+    template <typename NodeType>
+    void unpackGate(const NodeType& cell, int gate, size_t fanIn, std::span<double> row,
+                    double& recurrent, double& bias)
+    {
+        const ParamVec& vals = gate == 0 ? cell.forgetVals : gate == 3 ? cell.outputVals : cell.inputVals;
+        size_t stride = (gate == 1 || gate == 2) ? 4 : 2;
+        size_t offset = gate == 2 ? 2 : 0;
+        size_t biasTail = gate == 1 ? 2 : 1;
+        if (vals.size() < stride * fanIn + biasTail)
+        {
+            throw std::invalid_argument("LSTM gate weights do not match the node fan in");
+        }
+
+        recurrent = 0.0;
+        for (size_t i = 0; i < fanIn; ++i)
+        {
+            row[i] = vals[i * stride + offset];
+            recurrent += vals[i * stride + offset + 1];
+        }
+        bias = static_cast<double>(fanIn) * vals[vals.size() - biasTail];
+    }
+
+    /**
+     * @brief advances one GRU cell from its gate pre-activations (update, reset, candidate)
+     *
+     * @param stm -> double&, hidden state, in a node or in a caller owned batch state array
+     * @param pre -> the update and reset sums with their STM term, the candidate sum without it
+     * @param candidateRecurrent -> double, summed STM weight of the candidate, applied to the reset STM
+     * @return double -> the new STM, which is the cell output
+     */
+    template <typename NodeType>
+    inline double gruStep(double& stm, const double pre[3], double candidateRecurrent) noexcept
+    {
+        using Gate = typename NodeType::GatePolicy;
+        using Act = typename NodeType::ActivationPolicy;
+        double update = Gate::apply(pre[0]);
+        double reset = Gate::apply(pre[1]);
+        double candidate = Act::apply(pre[2] + candidateRecurrent * reset * stm);
+        stm += update * (candidate - stm);
+        return stm;
+    }
+
+    template <typename NodeType>
+    inline const ParamVec& gruGate(const NodeType& cell, size_t gate) noexcept
+    {
+        return gate == 0 ? cell.updateVals : gate == 1 ? cell.resetVals : cell.candidateVals;
+    }
+
+    /**
+     * @brief unpacks one GRU gate, every gate has the LSTM forget gate layout
+     *
+     * @param gate -> size_t, 0 update, 1 reset, 2 candidate
+     */
+    template <typename NodeType>
+    void unpackGruGate(const NodeType& cell, size_t gate, size_t fanIn, std::span<double> row,
+                       double& recurrent, double& bias)
+    {
+        const ParamVec& vals = gruGate(cell, gate);
+        if (vals.size() < 2 * fanIn + 1)
+        {
+            throw std::invalid_argument("GRU gate weights do not match the node fan in");
+        }
+
+        recurrent = 0.0;
+        for (size_t i = 0; i < fanIn; ++i)
+        {
+            row[i] = vals[i * 2];
+            recurrent += vals[i * 2 + 1];
+        }
+        bias = static_cast<double>(fanIn) * vals[vals.size() - 1];
+    }
+}
+
 /**
  * @brief Default constructor
  * @param size -> int, number of nodes in the layer
@@ -9,21 +125,36 @@
  */
 template <typename NodeType>
 NetworkLayer<NodeType>::NetworkLayer(int size, NodeType nodeType, bool isInputLayer,
-                                     NetworkLayer<NodeType>* prev) noexcept :
+                                     NetworkLayer<NodeType>* prev, int numInputs) :
 
-// Initialize the vector to be of size, "size", and have each element be a node with default of one input
-        layerNodes(size, NetworkNode<NodeType>(1)),
+// Nodes are built in the body so every node gets its own random weights
+        layerNodes(),
         // Initialize the output vector to be of size, "size", and each element set to 0
         LayerOutputVec(size, 0),
         // Initialize the weight vector to be size of size, "size", each index 0 to be made random in body
         LayerWeights(size, 0),
         // Initialize layer to be null
         prevLayer(prev),
-        informationMatrix(10, std::vector<double>(3, 0))
+        // [outputs, STM, LTM] of every node, the layout dataLoadLstm reads from the previous layer
+        informationMatrix(3, std::vector<double>(size, 0.0)),
+        precision(Precision::Full),
+        sparseThreshold(0.3),
+        density(1.0),
+        useSparse(false),
+        pool(nullptr),
+        parallelMinNodes(256),
+        tuning()
 {
-    std::cout << "LayerNodes initialized with size: " << layerNodes.size() << "\n";
     try
     {
+        // every node reads the full output of the previous layer
+        int fanIn = (!isInputLayer && prevLayer) ? static_cast<int>(prevLayer->layerNodes.size()) : numInputs;
+        layerNodes.reserve(size);
+        for(int i = 0; i < size; i++)
+        {
+            layerNodes.emplace_back(fanIn);
+        }
+
         if(size != 0)
         {
             // randomize the weights
@@ -43,7 +174,7 @@ NetworkLayer<NodeType>::NetworkLayer(int size, NodeType nodeType, bool isInputLa
                     throw std::logic_error("prevLayer cannot be nullptr for non-input layers.");
                 }
 
-                if constexpr (std::is_same<NodeType, BaseNode>::value)
+                if constexpr (!isLstmNode<NodeType>)
                 {
                     // go through the output for each of the nodes in the last layer
                     for(auto& node : layerNodes)
@@ -57,10 +188,15 @@ NetworkLayer<NodeType>::NetworkLayer(int size, NodeType nodeType, bool isInputLa
                         }
                     }
                 }
-                else if constexpr (std::is_same<NodeType, LstmNode>::value)
+                else if constexpr (isLstmNode<NodeType>)
                 {
-                    //format the inputs with funciton
-                    dataLoadLstm(prevLayer->informationMatrix);
+                    //format the inputs with funciton, only once the previous layer has filled its
+                    //information matrix in the [outputs, STM, LTM] layout dataLoadLstm expects
+                    const std::vector<std::vector<double>>& info = prevLayer->informationMatrix;
+                    if (info.size() == 3 && info[0].size() == layerNodes.size())
+                    {
+                        dataLoadLstm(info);
+                    }
                 }
             }
             // NOTE: When calling this, you should call the dataFit funciton
@@ -83,7 +219,7 @@ NetworkLayer<NodeType>::NetworkLayer(int size, NodeType nodeType, bool isInputLa
 template <typename NodeType>
 void NetworkLayer<NodeType>::dataLoadLstm(std::vector<std::vector<double>> values)
 {
-    if constexpr (std::is_same<NodeType, LstmNode>::value)
+    if constexpr (isLstmNode<NodeType>)
     {
         // Validate input dimensions
         if (values.size() != 3 || values[0].empty())
@@ -126,7 +262,7 @@ void NetworkLayer<NodeType>::dataLoadLstm(std::vector<std::vector<double>> value
             layerNodes[i].changeInputVecWhole(layerOutputs);
 
             // Update STM and LTM in the LstmNode struct inside the node
-            auto& nodeInternal = static_cast<LstmNode&>(layerNodes[i].getNode());
+            auto& nodeInternal = static_cast<NodeType&>(layerNodes[i].getNode());
             nodeInternal.LongTermState = ltmAvg;
             nodeInternal.ShortTermState = stmAvg;
 
@@ -142,5 +278,748 @@ void NetworkLayer<NodeType>::dataLoadLstm(std::vector<std::vector<double>> value
     }
 }
 
+/**
+ *
+ * @breif loads one row of data (e.g. a frequency row from the harmonic frontend) into every node of the
+ *          input layer, values past the fan in are ignored and missing ones are left at 0
+ * @param values -> std::vec<double> values from the datafile to be run through the model
+ * @returns void
+ *
+ */
+template <typename NodeType>
+void NetworkLayer<NodeType>::setInputLayer(std::vector<double> values) noexcept
+{
+    for (auto& node : layerNodes)
+    {
+        std::vector<double>& inputs = node.getInputs();
+        inputs.assign(node.getWeightVecSize(), 0.0);
+        std::copy_n(values.begin(), std::min(values.size(), inputs.size()), inputs.begin());
+    }
+}
+
+/**
+ * @brief runs the layer on one input vector, the activations live in the context arena
+ *
+ * @param ctx -> ExecContext&, execution context that owns the per-batch arena
+ * @param inputs -> std::span<const double>, input values, one per node input
+ * @return std::span<double> -> one output per node (the STM for LSTM nodes), valid until ctx.endBatch()
+ */
+template <typename NodeType>
+std::span<double> NetworkLayer<NodeType>::forward(ExecContext& ctx, std::span<const double> inputs)
+{
+    if (useSparse || precision != Precision::Full)
+    {
+        return forwardPacked(ctx, inputs);
+    }
+    if (inputs.size() != getFanIn())
+    {
+        throw std::invalid_argument("Input size does not match the layer fan in");
+    }
+
+    std::span<double> out = ctx.scratch(layerNodes.size());
+    forNodes([&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            if constexpr (isLstmNode<NodeType>)
+            {
+                // the node carries its own cell state from the previous timestep
+                NodeType& cell = layerNodes[i].getNode();
+                layerNodes[i].find_output(inputs, cell.ShortTermState, cell.LongTermState);
+                out[i] = cell.ShortTermState;
+            }
+            else if constexpr (isGruNode<NodeType>)
+            {
+                NodeType& cell = layerNodes[i].getNode();
+                layerNodes[i].find_output(inputs, cell.ShortTermState);
+                out[i] = cell.ShortTermState;
+            }
+            else
+            {
+                layerNodes[i].find_output(inputs);
+                out[i] = layerNodes[i].get();
+            }
+        }
+    });
+    return out;
+}
+
+/**
+ * @brief evaluates the nodes of wide layers in parallel on a work stealing pool
+ *
+ * @param workers .
+ * ThreadPool*, pool to share with other layers, nullptr turns the parallel mode off
+ * @param minNodes .
+ * size_t, layers with fewer nodes stay serial
+ */
+template <typename NodeType>
+void NetworkLayer<NodeType>::setParallel(ThreadPool* workers, size_t minNodes) noexcept
+{
+    pool = workers;
+    parallelMinNodes = minNodes;
+}
+
+/**
+ * @brief sets the blocking and threading of forward / forwardBatch
+ *
+ * @param newTuning .
+ * LayerTuning, batch tile, threads, chunks per thread and dot kernel unroll
+ */
+template <typename NodeType>
+void NetworkLayer<NodeType>::setTuning(LayerTuning newTuning)
+{
+    if (newTuning.chunksPerThread == 0)
+    {
+        throw std::invalid_argument("Layer tuning needs at least one chunk per thread");
+    }
+    if (newTuning.unroll != 4 && newTuning.unroll != 8 && newTuning.unroll != 16)
+    {
+        throw std::invalid_argument("Layer tuning unroll must be 4, 8 or 16");
+    }
+    tuning = newTuning;
+    for (HalfMatrix& matrix : packedWeights)
+    {
+        matrix.setUnroll(tuning.unroll);
+    }
+}
+
+/**
+ * @brief threads a call on this layer splits over, 1 when it stays serial
+ *
+ * @note an explicit thread count overrides the width threshold of setParallel, it is capped by the pool
+ */
+template <typename NodeType>
+size_t NetworkLayer<NodeType>::threadsFor(size_t numNodes) const noexcept
+{
+    if (pool == nullptr)
+    {
+        return 1;
+    }
+    if (tuning.threads == 0)
+    {
+        return numNodes < parallelMinNodes ? 1 : pool->size();
+    }
+    return std::min(tuning.threads, pool->size());
+}
+
+/**
+ * @brief runs body(begin, end) over the node range, split over the pool for wide layers
+ *
+ * @note slices are whole cache lines of the arena output (8 doubles, the arena hands out 64 byte aligned
+ *          spans), chunksPerThread per thread so stealing can even out uneven chunks
+ */
+template <typename NodeType>
+template <typename Body>
+void NetworkLayer<NodeType>::forNodes(Body&& body)
+{
+    size_t numNodes = layerNodes.size();
+    size_t threads = threadsFor(numNodes);
+    if (threads <= 1)
+    {
+        body(size_t(0), numNodes);
+        return;
+    }
+    constexpr size_t lane = Arena::alignment / sizeof(double);
+    size_t lines = (numNodes + lane - 1) / lane;
+    pool->parallelFor(lines, tuning.chunksPerThread * threads, [&](size_t, size_t first, size_t last)
+    {
+        body(first * lane, std::min(last * lane, numNodes));
+    });
+}
+
+/**
+ * @brief packs the master weights (weightVec / LSTM gate weights) into 16 bit storage for forward
+ *
+ * @param newPrecision -> Precision, BF16 or FP16 to pack, Full drops the packed copy
+ */
+template <typename NodeType>
+void NetworkLayer<NodeType>::setPrecision(Precision newPrecision)
+{
+    precision = newPrecision;
+    syncPrecision();
+}
+
+/**
+ * @brief sets the density at or below which forward switches to the CSR kernels
+ *
+ * @param maxDensity -> double, fraction of non zero input weights, 0 disables the sparse path
+ */
+template <typename NodeType>
+void NetworkLayer<NodeType>::setSparseThreshold(double maxDensity)
+{
+    sparseThreshold = maxDensity;
+    syncPrecision();
+}
+
+/**
+ * @brief re-packs the 16 bit and sparse copies from the master weights
+ *
+ * @note the density of the master weights decides here, once, whether forward runs sparse
+ */
+template <typename NodeType>
+void NetworkLayer<NodeType>::syncPrecision()
+{
+    packedWeights.clear();
+    sparseWeights.clear();
+    packedRecurrent.clear();
+    packedBias.clear();
+    useSparse = false;
+    if (layerNodes.empty())
+    {
+        return;
+    }
+
+    size_t numNodes = layerNodes.size();
+    size_t fanIn = layerNodes[0].getWeightVecSize();
+    size_t numGates = gateCount<NodeType>;
+
+    // unpack every gate row once, both packed formats are built from these
+    std::vector<std::vector<double>> rows(numGates * numNodes);
+    std::vector<double> recurrent(numGates * numNodes, 0.0);
+    std::vector<double> bias(numGates * numNodes, 0.0);
+    size_t nonZero = 0;
+    for (size_t j = 0; j < numNodes; ++j)
+    {
+        const NetworkNode<NodeType>& node = layerNodes[j];
+        if (node.getWeightVecSize() != fanIn)
+        {
+            throw std::invalid_argument("Layer nodes must share the same fan in to be packed");
+        }
+        for (size_t gate = 0; gate < numGates; ++gate)
+        {
+            size_t slot = gate * numNodes + j;
+            rows[slot].resize(fanIn);
+            if constexpr (isLstmNode<NodeType>)
+            {
+                unpackGate(node.getNode(), static_cast<int>(gate), fanIn, rows[slot], recurrent[slot], bias[slot]);
+            }
+            else if constexpr (isGruNode<NodeType>)
+            {
+                unpackGruGate(node.getNode(), gate, fanIn, rows[slot], recurrent[slot], bias[slot]);
+            }
+            else
+            {
+                for (size_t i = 0; i < fanIn; ++i)
+                {
+                    rows[slot][i] = node.getWeightVecElement(i);
+                }
+                bias[slot] = node.getBiasVal();
+            }
+            nonZero += fanIn - std::count(rows[slot].begin(), rows[slot].end(), 0.0);
+        }
+    }
+
+    density = fanIn == 0 ? 1.0 : static_cast<double>(nonZero) / static_cast<double>(numGates * numNodes * fanIn);
+    useSparse = density <= sparseThreshold;
+    if (!useSparse && precision == Precision::Full)
+    {
+        // the node path runs on the master weights directly
+        return;
+    }
+
+    if constexpr (isLstmNode<NodeType> || isGruNode<NodeType>)
+    {
+        packedRecurrent = std::move(recurrent);
+    }
+    packedBias = std::move(bias);
+    if (useSparse)
+    {
+        sparseWeights.resize(numGates);
+        for (size_t gate = 0; gate < numGates; ++gate)
+        {
+            sparseWeights[gate].reset(fanIn);
+            for (size_t j = 0; j < numNodes; ++j)
+            {
+                sparseWeights[gate].appendRow(rows[gate * numNodes + j]);
+            }
+        }
+    }
+    else
+    {
+        packedWeights.resize(numGates);
+        for (size_t gate = 0; gate < numGates; ++gate)
+        {
+            packedWeights[gate].reset(precision, numNodes, fanIn);
+            packedWeights[gate].setUnroll(tuning.unroll);
+            for (size_t j = 0; j < numNodes; ++j)
+            {
+                packedWeights[gate].setRow(j, rows[gate * numNodes + j]);
+            }
+        }
+    }
+}
+
+/**
+ * @brief magnitude pruning of the input weights (weightVec, or the input columns of every LSTM gate)
+ *
+ * @param sparsity -> double, fraction in [0, 1] of weights (or input columns) to zero
+ * @param mode -> PruneMode, single weights or whole input columns
+ * @notes the master weights are zeroed in place and the packed copies rebuilt
+ */
+template <typename NodeType>
+void NetworkLayer<NodeType>::prune(double sparsity, PruneMode mode)
+{
+    if (layerNodes.empty())
+    {
+        return;
+    }
+    size_t fanIn = layerNodes[0].getWeightVecSize();
+
+    // visits every prunable weight with its input column
+    auto forEachWeight = [&](auto&& visit)
+    {
+        for (NetworkNode<NodeType>& node : layerNodes)
+        {
+            if constexpr (isLstmNode<NodeType>)
+            {
+                NodeType& cell = node.getNode();
+                for (size_t i = 0; i < fanIn; ++i)
+                {
+                    visit(i, cell.forgetVals[i * 2]);
+                    visit(i, cell.inputVals[i * 4]);
+                    visit(i, cell.inputVals[i * 4 + 2]);
+                    visit(i, cell.outputVals[i * 2]);
+                }
+            }
+            else if constexpr (isGruNode<NodeType>)
+            {
+                NodeType& cell = node.getNode();
+                for (size_t i = 0; i < fanIn; ++i)
+                {
+                    visit(i, cell.updateVals[i * 2]);
+                    visit(i, cell.resetVals[i * 2]);
+                    visit(i, cell.candidateVals[i * 2]);
+                }
+            }
+            else
+            {
+                for (size_t i = 0; i < fanIn; ++i)
+                {
+                    double weight = node.getWeightVecElement(i);
+                    visit(i, weight);
+                    node.setWeightVecElement(i, weight);
+                }
+            }
+        }
+    };
+
+    if (mode == PruneMode::Unstructured)
+    {
+        std::vector<double> magnitudes;
+        forEachWeight([&](size_t, double& weight) { magnitudes.push_back(std::abs(weight)); });
+        double threshold = pruneThreshold(std::move(magnitudes), sparsity);
+        forEachWeight([&](size_t, double& weight)
+        {
+            if (std::abs(weight) < threshold)
+            {
+                weight = 0.0;
+            }
+        });
+    }
+    else
+    {
+        std::vector<double> norms(fanIn, 0.0);
+        forEachWeight([&](size_t col, double& weight) { norms[col] += weight * weight; });
+        std::vector<bool> dropColumn(fanIn, false);
+        double threshold = pruneThreshold(norms, sparsity);
+        for (size_t i = 0; i < fanIn; ++i)
+        {
+            dropColumn[i] = norms[i] < threshold;
+        }
+        forEachWeight([&](size_t col, double& weight)
+        {
+            if (dropColumn[col])
+            {
+                weight = 0.0;
+            }
+        });
+    }
+    syncPrecision();
+}
+
+/**
+ * @brief registers the parameters of every node with the model wide buffer
+ *
+ * @param buffer .
+ * ParamBuffer&, bound by the caller once the whole model is registered
+ */
+template <typename NodeType>
+void NetworkLayer<NodeType>::registerParams(ParamBuffer& buffer)
+{
+    for (auto& node : layerNodes)
+    {
+        node.registerParams(buffer);
+    }
+}
+
+/**
+ * @brief size of the packed copies in bytes
+ */
+template <typename NodeType>
+size_t NetworkLayer<NodeType>::getPackedBytes() const noexcept
+{
+    size_t total = (packedRecurrent.size() + packedBias.size()) * sizeof(double);
+    for (const HalfMatrix& matrix : packedWeights)
+    {
+        total += matrix.bytes();
+    }
+    for (const CsrMatrix& matrix : sparseWeights)
+    {
+        total += matrix.bytes();
+    }
+    return total;
+}
+
+/**
+ * @brief forward pass on the packed copy, CSR kernels when sparse, else 16 bit with fp32 accumulation
+ *
+ * @note the LSTM / GRU math is the same as the node gates with the per input bias and STM terms pre-summed
+ */
+template <typename NodeType>
+std::span<double> NetworkLayer<NodeType>::forwardPacked(ExecContext& ctx, std::span<const double> inputs)
+{
+    size_t numNodes = layerNodes.size();
+    size_t fanIn = useSparse ? sparseWeights[0].cols() : packedWeights[0].cols();
+    if (inputs.size() != fanIn)
+    {
+        throw std::invalid_argument("Input size does not match the packed layer fan in");
+    }
+
+    // the 16 bit kernels run fp32 x 16 bit, the inputs are narrowed once per call
+    std::span<float> x;
+    if (!useSparse)
+    {
+        x = ctx.scratch<float>(fanIn);
+        for (size_t i = 0; i < fanIn; ++i)
+        {
+            x[i] = static_cast<float>(inputs[i]);
+        }
+    }
+    auto gateSum = [&](size_t gate, size_t j)
+    {
+        return useSparse ? sparseWeights[gate].rowDot(j, inputs.data())
+                         : static_cast<double>(packedWeights[gate].rowDot(j, x.data()));
+    };
+
+    std::span<double> out = ctx.scratch(numNodes);
+    forNodes([&](size_t begin, size_t end)
+    {
+        for (size_t j = begin; j < end; ++j)
+        {
+            if constexpr (isLstmNode<NodeType>)
+            {
+                NodeType& cell = layerNodes[j].getNode();
+                double pre[4];
+                for (size_t gate = 0; gate < 4; ++gate)
+                {
+                    size_t slot = gate * numNodes + j;
+                    pre[gate] = gateSum(gate, j) + packedRecurrent[slot] * cell.ShortTermState + packedBias[slot];
+                }
+                out[j] = lstmStep(cell, pre);
+            }
+            else if constexpr (isGruNode<NodeType>)
+            {
+                NodeType& cell = layerNodes[j].getNode();
+                double pre[3];
+                for (size_t gate = 0; gate < 3; ++gate)
+                {
+                    size_t slot = gate * numNodes + j;
+                    double recurrence = gate < 2 ? packedRecurrent[slot] * cell.ShortTermState : 0.0;
+                    pre[gate] = gateSum(gate, j) + recurrence + packedBias[slot];
+                }
+                out[j] = gruStep<NodeType>(cell.ShortTermState, pre, packedRecurrent[2 * numNodes + j]);
+            }
+            else
+            {
+                out[j] = NetworkNode<NodeType>::activation_func(gateSum(0, j) + packedBias[j]);
+            }
+        }
+    });
+    return out;
+}
+
+/**
+ * @brief copies the master weights into dense gate matrices, slot = gate * nodes + node
+ *
+ * @param weights .
+ * std::span<double>, slots x fanIn input weights
+ * @param recurrent .
+ * std::span<double>, slots summed STM weights (left untouched for base layers)
+ * @param bias .
+ * std::span<double>, slots summed biases
+ */
+template <typename NodeType>
+void NetworkLayer<NodeType>::unpackWeights(std::span<double> weights, std::span<double> recurrent, std::span<double> bias)
+{
+    size_t numNodes = layerNodes.size();
+    size_t fanIn = getFanIn();
+    size_t numGates = gateCount<NodeType>;
+    if (weights.size() < numGates * numNodes * fanIn || bias.size() < numGates * numNodes)
+    {
+        throw std::invalid_argument("Unpack buffers are smaller than the layer");
+    }
+    for (size_t j = 0; j < numNodes; ++j)
+    {
+        for (size_t gate = 0; gate < numGates; ++gate)
+        {
+            size_t slot = gate * numNodes + j;
+            std::span<double> row = weights.subspan(slot * fanIn, fanIn);
+            if constexpr (isLstmNode<NodeType>)
+            {
+                unpackGate(layerNodes[j].getNode(), static_cast<int>(gate), fanIn, row, recurrent[slot], bias[slot]);
+            }
+            else if constexpr (isGruNode<NodeType>)
+            {
+                unpackGruGate(layerNodes[j].getNode(), gate, fanIn, row, recurrent[slot], bias[slot]);
+            }
+            else
+            {
+                std::copy(layerNodes[j].getWeightParams().begin(), layerNodes[j].getWeightParams().end(), row.begin());
+                bias[slot] = layerNodes[j].getBiasVal();
+            }
+        }
+    }
+}
+
+/**
+ * @brief adds gradients taken against the unpacked layout to the node parameters in a bound buffer
+ *
+ * @note every STM weight of a gate gets the gradient of the summed recurrent weight, and the gate bias
+ *          gets fanIn times the gradient of the summed bias, since the node adds it once per input
+ */
+template <typename NodeType>
+void NetworkLayer<NodeType>::scatterGrads(ParamBuffer& params, std::span<const double> dWeights,
+                                          std::span<const double> dRecurrent, std::span<const double> dBias)
+{
+    size_t numNodes = layerNodes.size();
+    size_t fanIn = getFanIn();
+    for (size_t j = 0; j < numNodes; ++j)
+    {
+        if constexpr (isLstmNode<NodeType>)
+        {
+            NodeType& cell = layerNodes[j].getNode();
+            for (size_t gate = 0; gate < 4; ++gate)
+            {
+                const ParamVec& vals = gate == 0 ? cell.forgetVals : gate == 3 ? cell.outputVals : cell.inputVals;
+                std::span<double> grad = params.gradOf(vals);
+                size_t stride = (gate == 1 || gate == 2) ? 4 : 2;
+                size_t offset = gate == 2 ? 2 : 0;
+                size_t biasTail = gate == 1 ? 2 : 1;
+                size_t slot = gate * numNodes + j;
+                for (size_t i = 0; i < fanIn; ++i)
+                {
+                    grad[i * stride + offset] += dWeights[slot * fanIn + i];
+                    grad[i * stride + offset + 1] += dRecurrent[slot];
+                }
+                grad[grad.size() - biasTail] += static_cast<double>(fanIn) * dBias[slot];
+            }
+        }
+        else if constexpr (isGruNode<NodeType>)
+        {
+            NodeType& cell = layerNodes[j].getNode();
+            for (size_t gate = 0; gate < 3; ++gate)
+            {
+                std::span<double> grad = params.gradOf(gruGate(cell, gate));
+                size_t slot = gate * numNodes + j;
+                for (size_t i = 0; i < fanIn; ++i)
+                {
+                    grad[i * 2] += dWeights[slot * fanIn + i];
+                    grad[i * 2 + 1] += dRecurrent[slot];
+                }
+                grad[grad.size() - 1] += static_cast<double>(fanIn) * dBias[slot];
+            }
+        }
+        else
+        {
+            std::span<double> grad = params.gradOf(layerNodes[j].getWeightParams());
+            for (size_t i = 0; i < fanIn; ++i)
+            {
+                grad[i] += dWeights[j * fanIn + i];
+            }
+            params.gradOf(layerNodes[j].getBiasParam()) += dBias[j];
+        }
+    }
+}
+
+/**
+ * @brief runs one timestep for a batch of independent sequences, the cell state lives with the caller
+ *
+ * @note the input weights of every gate are unpacked once per call and applied to a block of rows as one
+ *          matrix product, the 16 bit / sparse copies are used row by row when they are active. Blocks are
+ *          batchTile rows and go over the pool when the tuning gives the layer more than one thread
+ */
+template <typename NodeType>
+std::span<double> NetworkLayer<NodeType>::forwardBatch(ExecContext& ctx, std::span<const double> inputs, size_t batch,
+                                                       std::span<double> stm, std::span<double> ltm)
+{
+    constexpr bool isLstm = isLstmNode<NodeType>;
+    constexpr bool isGru = isGruNode<NodeType>;
+    size_t numNodes = layerNodes.size();
+    size_t numGates = gateCount<NodeType>;
+    size_t slots = numGates * numNodes;
+    size_t fanIn = numNodes == 0 ? 0 : layerNodes[0].getWeightVecSize();
+    if (inputs.size() != batch * fanIn)
+    {
+        throw std::invalid_argument("Batch inputs do not match the layer fan in");
+    }
+    if (isLstm && (stm.size() < batch * numNodes || ltm.size() < batch * numNodes))
+    {
+        throw std::invalid_argument("Batch cell state is smaller than the batch");
+    }
+    if (isGru && stm.size() < batch * numNodes)
+    {
+        throw std::invalid_argument("Batch hidden state is smaller than the batch");
+    }
+
+    // pre activations without bias / recurrence, row b holds [gate * numNodes + node]. Every scratch span
+    // is taken here, the arena is not shared between the threads running blocks
+    std::span<double> pre = ctx.scratch(batch * slots);
+    std::span<double> out = ctx.scratch(batch * numNodes);
+    bool packed = useSparse || precision != Precision::Full;
+    std::span<double> weights;
+    std::span<float> x;
+    std::span<const double> recurrent;
+    std::span<const double> bias;
+    if (packed)
+    {
+        recurrent = packedRecurrent;
+        bias = packedBias;
+        if (!useSparse)
+        {
+            x = ctx.scratch<float>(batch * fanIn);
+        }
+    }
+    else
+    {
+        weights = ctx.scratch(slots * fanIn);
+        std::span<double> rec = ctx.scratch(slots);
+        std::span<double> bi = ctx.scratch(slots);
+        unpackWeights(weights, rec, bi);
+        recurrent = rec;
+        bias = bi;
+    }
+    bool deterministic = deterministicReductions();
+
+    // rows [first, last), blocks never share a row of pre, out or the cell state
+    auto runRows = [&](size_t first, size_t last)
+    {
+        size_t rows = last - first;
+        if (packed)
+        {
+            for (size_t b = first; b < last; ++b)
+            {
+                const double* row = inputs.data() + b * fanIn;
+                float* rowX = x.data() + b * fanIn;
+                if (!useSparse)
+                {
+                    std::transform(row, row + fanIn, rowX, [](double val) { return static_cast<float>(val); });
+                }
+                for (size_t gate = 0; gate < numGates; ++gate)
+                {
+                    for (size_t j = 0; j < numNodes; ++j)
+                    {
+                        pre[b * slots + gate * numNodes + j] = useSparse
+                                ? sparseWeights[gate].rowDot(j, row)
+                                : static_cast<double>(packedWeights[gate].rowDot(j, rowX));
+                    }
+                }
+            }
+        }
+        else if (deterministic)
+        {
+            // one fixed order dot per pre activation, Eigen's GEMM blocks by the detected cache sizes
+            for (size_t b = first; b < last; ++b)
+            {
+                for (size_t slot = 0; slot < slots; ++slot)
+                {
+                    pre[b * slots + slot] = fixedDot(inputs.data() + b * fanIn, weights.data() + slot * fanIn, fanIn);
+                }
+            }
+        }
+        else
+        {
+            using RowMajor = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+            Eigen::Map<const RowMajor> xs(inputs.data() + first * fanIn, rows, fanIn);
+            Eigen::Map<const RowMajor> w(weights.data(), slots, fanIn);
+            Eigen::Map<RowMajor> p(pre.data() + first * slots, rows, slots);
+            p.noalias() = xs * w.transpose();
+        }
+
+        if constexpr (isLstm)
+        {
+            for (size_t b = first; b < last; ++b)
+            {
+                const double* rowPre = pre.data() + b * slots;
+                for (size_t j = 0; j < numNodes; ++j)
+                {
+                    size_t cell = b * numNodes + j;
+                    double gates[4];
+                    for (size_t gate = 0; gate < 4; ++gate)
+                    {
+                        size_t slot = gate * numNodes + j;
+                        gates[gate] = rowPre[slot] + recurrent[slot] * stm[cell] + bias[slot];
+                    }
+                    out[cell] = lstmStep<NodeType>(ltm[cell], stm[cell], gates);
+                }
+            }
+        }
+        else if constexpr (isGru)
+        {
+            for (size_t b = first; b < last; ++b)
+            {
+                const double* rowPre = pre.data() + b * slots;
+                for (size_t j = 0; j < numNodes; ++j)
+                {
+                    size_t cell = b * numNodes + j;
+                    double gates[3];
+                    for (size_t gate = 0; gate < 3; ++gate)
+                    {
+                        size_t slot = gate * numNodes + j;
+                        double recurrence = gate < 2 ? recurrent[slot] * stm[cell] : 0.0;
+                        gates[gate] = rowPre[slot] + recurrence + bias[slot];
+                    }
+                    out[cell] = gruStep<NodeType>(stm[cell], gates, recurrent[2 * numNodes + j]);
+                }
+            }
+        }
+        else
+        {
+            // bias and activation over the whole block as one array expression
+            using RowArray = Eigen::Array<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+            Eigen::Map<const RowArray> p(pre.data() + first * slots, rows, numNodes);
+            Eigen::Map<const Eigen::Array<double, 1, Eigen::Dynamic>> b(bias.data(), numNodes);
+            Eigen::Map<RowArray> o(out.data() + first * numNodes, rows, numNodes);
+            o = NodeType::ActivationPolicy::apply(p.rowwise() + b);
+        }
+    };
+
+    size_t tile = tuning.batchTile == 0 ? batch : std::min(tuning.batchTile, batch);
+    size_t tiles = tile == 0 ? 0 : (batch + tile - 1) / tile;
+    size_t threads = tiles > 1 ? threadsFor(numNodes) : 1;
+    auto runTiles = [&](size_t, size_t firstTile, size_t lastTile)
+    {
+        for (size_t t = firstTile; t < lastTile; ++t)
+        {
+            runRows(t * tile, std::min(batch, (t + 1) * tile));
+        }
+    };
+    if (threads <= 1)
+    {
+        runTiles(0, 0, tiles);
+    }
+    else
+    {
+        pool->parallelFor(tiles, tuning.chunksPerThread * threads, runTiles);
+    }
+    return out;
+}
+
 template class NetworkLayer<BaseNode>;
-template class NetworkLayer<LstmNode>;
\ No newline at end of file
+template class NetworkLayer<BasicNode<SigmoidAct>>;
+template class NetworkLayer<BasicNode<ReluAct>>;
+template class NetworkLayer<BasicNode<LeakyReluAct>>;
+template class NetworkLayer<BasicNode<GeluAct>>;
+template class NetworkLayer<BasicNode<HardSigmoidAct>>;
+template class NetworkLayer<LstmNode>;
+template class NetworkLayer<GruNode>;
+template class NetworkLayer<HardGateLstmNode>;
\ No newline at end of file
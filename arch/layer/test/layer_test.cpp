@@ -45,6 +45,10 @@ TEST_F(LayerTest, ConstructorTests)
     } catch (const std::exception& e) {
         FAIL() << "Previous layer linkage check threw an exception: " << e.what();
     }
+
+    // Test 5: a fan in the nodes reject reaches the caller
+    EXPECT_THROW(NetworkLayer<LstmNode>(4, LstmNode(), true, nullptr, 0), std::invalid_argument)
+        << "Zero fan in accepted";
 }
 
 /**
@@ -107,3 +111,378 @@ TEST_F(LayerTest, DataLoadLstmTests)
 //                 }, std::logic_error) << "Logic error not thrown for BaseNode";
 }
 
+
+/**
+ * @brief: Tests for forward running out of the context arena
+ */
+TEST_F(LayerTest, ForwardTests)
+{
+    ExecContext ctx;
+    std::vector<double> inputs = {0.5, -0.25, 0.75};
+
+    // Test 1: BaseNode layer outputs match the nodes
+    NetworkLayer<BaseNode> baseLayer(4, BaseNode(), true, nullptr, 3);
+    std::span<double> out = baseLayer.forward(ctx, inputs);
+    ASSERT_EQ(out.size(), 4) << "Forward output size mismatch";
+    for (size_t i = 0; i < out.size(); ++i)
+    {
+        NetworkNode<BaseNode> node = baseLayer.getPrivMemberLayerNodes()[i];
+        EXPECT_NEAR(out[i], std::tanh(node.find_output(inputs)), 1e-9) << "Forward output mismatch at node " << i;
+    }
+
+    // Test 2: stacked layer takes the previous layer width as fan in
+    NetworkLayer<BaseNode> nextLayer(2, BaseNode(), false, &baseLayer);
+    EXPECT_EQ(nextLayer.getPrivMemberLayerNodes()[0].getWeightVecSize(), 4) << "Fan in not taken from prev layer";
+    std::span<double> nextOut = nextLayer.forward(ctx, out);
+    EXPECT_EQ(nextOut.size(), 2) << "Stacked forward output size mismatch";
+
+    // Test 3: LstmNode layer gives finite cell outputs
+    NetworkLayer<LstmNode> lstmLayer(3, LstmNode(), true, nullptr, 3);
+    std::span<double> lstmOut = lstmLayer.forward(ctx, inputs);
+    for (double val : lstmOut)
+    {
+        EXPECT_FALSE(std::isnan(val)) << "LSTM forward produced NaN";
+        EXPECT_LE(std::abs(val), 1.0) << "LSTM output outside tanh range";
+    }
+
+    // Test 4: wrong sized inputs throw like the packed path
+    std::vector<double> shortInputs = {0.5, -0.25};
+    EXPECT_THROW(baseLayer.forward(ctx, shortInputs), std::invalid_argument) << "Short input accepted";
+    EXPECT_THROW(lstmLayer.forward(ctx, shortInputs), std::invalid_argument) << "Short LSTM input accepted";
+
+    // Test 5: end of batch releases every activation
+    ctx.endBatch();
+    EXPECT_EQ(ctx.arena.used(), 0) << "endBatch did not release the activations";
+}
+
+/**
+ * @brief: Tests for the 16 bit packed forward pass
+ */
+TEST_F(LayerTest, PrecisionTests)
+{
+    ExecContext ctx;
+    std::vector<double> inputs = {0.5, -0.25, 0.75, 0.1};
+
+    // Test 1: BaseNode layer in bf16 / fp16 stays close to full precision
+    NetworkLayer<BaseNode> baseLayer(6, BaseNode(), true, nullptr, 4);
+    std::span<double> fullOut = baseLayer.forward(ctx, inputs);
+    std::vector<double> full(fullOut.begin(), fullOut.end());
+    for (Precision mode : {Precision::BF16, Precision::FP16})
+    {
+        baseLayer.setPrecision(mode);
+        std::span<double> packed = baseLayer.forward(ctx, inputs);
+        for (size_t i = 0; i < full.size(); ++i)
+        {
+            EXPECT_NEAR(packed[i], full[i], mode == Precision::BF16 ? 2e-2 : 2e-3) << "Packed output mismatch at " << i;
+        }
+    }
+
+    // Test 2: packed copy is smaller than the double master weights
+    EXPECT_LT(baseLayer.getPackedBytes(), 6 * 4 * sizeof(double)) << "Packed weights not smaller than master";
+
+    // Test 3: LstmNode layer from the same starting state
+    NetworkLayer<LstmNode> lstmLayer(3, LstmNode(), true, nullptr, 4);
+    std::vector<double> lstmFull;
+    for (double val : lstmLayer.forward(ctx, inputs))
+    {
+        lstmFull.push_back(val);
+    }
+    for (auto& node : lstmLayer.getPrivMemberLayerNodes())
+    {
+        node.getNode().LongTermState = 0.0;
+        node.getNode().ShortTermState = 0.0;
+    }
+    lstmLayer.setPrecision(Precision::FP16);
+    std::span<double> lstmPacked = lstmLayer.forward(ctx, inputs);
+    for (size_t i = 0; i < lstmFull.size(); ++i)
+    {
+        EXPECT_NEAR(lstmPacked[i], lstmFull[i], 5e-3) << "Packed LSTM output mismatch at " << i;
+    }
+
+    // Test 4: back to full precision drops the packed copy
+    lstmLayer.setPrecision(Precision::Full);
+    EXPECT_EQ(lstmLayer.getPackedBytes(), 0) << "Packed copy not released";
+    ctx.endBatch();
+}
+
+/**
+ * @brief: Tests for magnitude pruning and the sparse forward pass
+ */
+TEST_F(LayerTest, PruneTests)
+{
+    ExecContext ctx;
+    std::vector<double> inputs(20);
+    for (size_t i = 0; i < inputs.size(); ++i)
+    {
+        inputs[i] = std::sin(0.5 * i);
+    }
+
+    // Test 1: unstructured pruning reaches the requested density and switches to CSR
+    NetworkLayer<BaseNode> baseLayer(8, BaseNode(), true, nullptr, 20);
+    baseLayer.prune(0.8);
+    EXPECT_NEAR(baseLayer.getDensity(), 0.2, 0.05) << "Density after pruning mismatch";
+    EXPECT_TRUE(baseLayer.isSparse()) << "Pruned layer did not pick the sparse kernels";
+
+    // Test 2: sparse forward matches the dense node path on the pruned weights
+    std::span<double> sparseOut = baseLayer.forward(ctx, inputs);
+    baseLayer.setSparseThreshold(0.0);
+    EXPECT_FALSE(baseLayer.isSparse()) << "Sparse path not disabled";
+    std::span<double> denseOut = baseLayer.forward(ctx, inputs);
+    for (size_t i = 0; i < denseOut.size(); ++i)
+    {
+        EXPECT_NEAR(sparseOut[i], denseOut[i], 1e-12) << "Sparse output mismatch at " << i;
+    }
+
+    // Test 3: structured pruning zeroes whole input columns
+    NetworkLayer<BaseNode> structLayer(4, BaseNode(), true, nullptr, 20);
+    structLayer.prune(0.5, PruneMode::Structured);
+    size_t zeroColumns = 0;
+    for (size_t col = 0; col < 20; ++col)
+    {
+        bool allZero = true;
+        for (const auto& node : structLayer.getPrivMemberLayerNodes())
+        {
+            allZero = allZero && node.getWeightVecElement(col) == 0.0;
+        }
+        zeroColumns += allZero;
+    }
+    EXPECT_EQ(zeroColumns, 10) << "Structured pruning did not drop half the columns";
+
+    // Test 4: LSTM gates prune and run sparse from the same state as the dense path
+    NetworkLayer<LstmNode> lstmLayer(4, LstmNode(), true, nullptr, 20);
+    lstmLayer.prune(0.9);
+    EXPECT_TRUE(lstmLayer.isSparse()) << "Pruned LSTM layer did not pick the sparse kernels";
+    std::vector<double> lstmSparse;
+    for (double val : lstmLayer.forward(ctx, inputs))
+    {
+        lstmSparse.push_back(val);
+    }
+    for (auto& node : lstmLayer.getPrivMemberLayerNodes())
+    {
+        node.getNode().LongTermState = 0.0;
+        node.getNode().ShortTermState = 0.0;
+    }
+    lstmLayer.setSparseThreshold(0.0);
+    std::span<double> lstmDense = lstmLayer.forward(ctx, inputs);
+    for (size_t i = 0; i < lstmDense.size(); ++i)
+    {
+        EXPECT_NEAR(lstmSparse[i], lstmDense[i], 1e-9) << "Sparse LSTM output mismatch at " << i;
+    }
+    ctx.endBatch();
+}
+
+/**
+ * @brief: Tests for the batched timestep with caller owned cell state
+ */
+TEST_F(LayerTest, ForwardBatchTests)
+{
+    ExecContext ctx;
+    std::vector<double> rows = {0.2, -0.4, 0.6, -0.1, 0.3, 0.9};
+
+    // Test 1: every row of a base layer matches the single row forward
+    NetworkLayer<BaseNode> baseLayer(5, BaseNode(), true, nullptr, 3);
+    std::span<double> batched = baseLayer.forwardBatch(ctx, rows, 2);
+    ASSERT_EQ(batched.size(), 10) << "Batch output size mismatch";
+    std::span<double> single = baseLayer.forward(ctx, std::span<const double>(rows).subspan(3, 3));
+    for (size_t j = 0; j < 5; ++j)
+    {
+        EXPECT_NEAR(batched[5 + j], single[j], 1e-12) << "Base batch row mismatch at node " << j;
+    }
+
+    // Test 2: LSTM state is per row and matches the node path over two steps
+    NetworkLayer<LstmNode> lstmLayer(4, LstmNode(), true, nullptr, 3);
+    std::vector<double> stm(8, 0.0), ltm(8, 0.0);
+    lstmLayer.forwardBatch(ctx, rows, 2, stm, ltm);
+    std::span<double> step2 = lstmLayer.forwardBatch(ctx, rows, 2, stm, ltm);
+    for (auto& node : lstmLayer.getPrivMemberLayerNodes())
+    {
+        node.getNode().LongTermState = 0.0;
+        node.getNode().ShortTermState = 0.0;
+    }
+    std::span<const double> first(rows.data(), 3);
+    lstmLayer.forward(ctx, first);
+    std::span<double> nodeStep2 = lstmLayer.forward(ctx, first);
+    for (size_t j = 0; j < 4; ++j)
+    {
+        EXPECT_NEAR(step2[j], nodeStep2[j], 1e-12) << "LSTM batch row mismatch at node " << j;
+        EXPECT_EQ(stm[j], step2[j]) << "Caller state not updated";
+    }
+
+    // Test 3: the 16 bit copy runs the batch too, and a short state is rejected
+    lstmLayer.setPrecision(Precision::BF16);
+    std::span<double> packed = lstmLayer.forwardBatch(ctx, rows, 2, stm, ltm);
+    EXPECT_EQ(packed.size(), 8) << "Packed batch output size mismatch";
+    std::vector<double> shortState(4, 0.0);
+    EXPECT_THROW(lstmLayer.forwardBatch(ctx, rows, 2, shortState, shortState), std::invalid_argument)
+                        << "Short cell state accepted";
+    ctx.endBatch();
+}
+
+/**
+ * @brief: Tests for the intra layer parallel mode
+ */
+TEST_F(LayerTest, ParallelTests)
+{
+    ExecContext ctx;
+    ThreadPool pool(3);
+    std::vector<double> inputs = {0.5, -0.25, 0.75, 0.1};
+
+    // Test 1: a wide base layer gives the same output serial and parallel
+    NetworkLayer<BaseNode> wide(300, BaseNode(), true, nullptr, 4);
+    std::span<double> serialOut = wide.forward(ctx, inputs);
+    std::vector<double> serial(serialOut.begin(), serialOut.end());
+    wide.setParallel(&pool, 64);
+    std::span<double> parallel = wide.forward(ctx, inputs);
+    for (size_t j = 0; j < serial.size(); ++j)
+    {
+        EXPECT_EQ(parallel[j], serial[j]) << "Parallel output mismatch at node " << j;
+    }
+
+    // Test 2: LSTM state advances the same on the packed path
+    NetworkLayer<LstmNode> lstm(130, LstmNode(), true, nullptr, 4);
+    NetworkLayer<LstmNode> twin(130, LstmNode(), true, nullptr, 4);
+    twin.getPrivMemberLayerNodes() = lstm.getPrivMemberLayerNodes();
+    lstm.setPrecision(Precision::BF16);
+    twin.setPrecision(Precision::BF16);
+    twin.setParallel(&pool, 64);
+    for (int step = 0; step < 3; ++step)
+    {
+        std::span<double> a = lstm.forward(ctx, inputs);
+        std::span<double> b = twin.forward(ctx, inputs);
+        for (size_t j = 0; j < a.size(); ++j)
+        {
+            ASSERT_EQ(a[j], b[j]) << "Parallel LSTM mismatch at step " << step << " node " << j;
+        }
+    }
+    ctx.endBatch();
+}
+
+/**
+ * @brief: Tests for layers built on non default activation policies
+ */
+TEST_F(LayerTest, ActivationPolicyTests)
+{
+    ExecContext ctx;
+    std::vector<double> rows = {0.2, -0.4, 0.6, -0.1, 0.3, 0.9};
+
+    // Test 1: the vectorised batch path applies the same policy as the node path
+    NetworkLayer<BasicNode<GeluAct>> gelu(5, BasicNode<GeluAct>(), true, nullptr, 3);
+    std::span<double> batched = gelu.forwardBatch(ctx, rows, 2);
+    std::span<double> single = gelu.forward(ctx, std::span<const double>(rows).subspan(3, 3));
+    for (size_t j = 0; j < 5; ++j)
+    {
+        EXPECT_NEAR(batched[5 + j], single[j], 1e-12) << "Gelu batch row mismatch at node " << j;
+    }
+
+    // Test 2: hard sigmoid gates match between the batch kernel and the node gates
+    NetworkLayer<HardGateLstmNode> cells(4, HardGateLstmNode(), true, nullptr, 3);
+    std::vector<double> stm(4, 0.0), ltm(4, 0.0);
+    std::span<const double> first(rows.data(), 3);
+    cells.forwardBatch(ctx, first, 1, stm, ltm);
+    std::span<double> step2 = cells.forwardBatch(ctx, first, 1, stm, ltm);
+    cells.forward(ctx, first);
+    std::span<double> nodeStep2 = cells.forward(ctx, first);
+    for (size_t j = 0; j < 4; ++j)
+    {
+        EXPECT_NEAR(step2[j], nodeStep2[j], 1e-12) << "Hard gate LSTM mismatch at node " << j;
+    }
+    ctx.endBatch();
+}
+
+/**
+ * @brief: Tests for GRU layers on the node, batched and packed paths
+ */
+TEST_F(LayerTest, GruTests)
+{
+    ExecContext ctx;
+    std::vector<double> rows = {0.2, -0.4, 0.6, -0.1, 0.3, 0.9};
+    std::span<const double> first(rows.data(), 3);
+
+    // Test 1: the batched kernel matches the node gates over two steps, with one state per row
+    NetworkLayer<GruNode> gruLayer(4, GruNode(), true, nullptr, 3);
+    std::vector<double> stm(8, 0.0);
+    gruLayer.forwardBatch(ctx, rows, 2, stm);
+    std::span<double> step2 = gruLayer.forwardBatch(ctx, rows, 2, stm);
+    gruLayer.forward(ctx, first);
+    std::span<double> nodeStep2 = gruLayer.forward(ctx, first);
+    for (size_t j = 0; j < 4; ++j)
+    {
+        EXPECT_NEAR(step2[j], nodeStep2[j], 1e-12) << "GRU batch row mismatch at node " << j;
+        EXPECT_EQ(stm[j], step2[j]) << "Caller state not updated";
+    }
+
+    // Test 2: three gates are unpacked, one fewer than an LSTM layer of the same width
+    size_t slots = 3 * 4;
+    std::vector<double> weights(slots * 3), recurrent(slots), bias(slots);
+    gruLayer.unpackWeights(weights, recurrent, bias);
+    const GruNode& cell = gruLayer.getPrivMemberLayerNodes()[1].getNode();
+    EXPECT_EQ(weights[(2 * 4 + 1) * 3 + 2], cell.candidateVals[4]) << "Candidate weight slot mismatch";
+    EXPECT_NEAR(recurrent[4 + 1], cell.resetVals[1] + cell.resetVals[3] + cell.resetVals[5], 1e-12)
+                        << "Reset recurrent weight mismatch";
+    EXPECT_NEAR(bias[1], 3.0 * cell.updateVals[6], 1e-12) << "Update bias mismatch";
+
+    // Test 3: the 16 bit copy stays close to the dense path, and a missing state is rejected
+    NetworkLayer<GruNode> twin(4, GruNode(), true, nullptr, 3);
+    twin.getPrivMemberLayerNodes() = gruLayer.getPrivMemberLayerNodes();
+    twin.setPrecision(Precision::BF16);
+    std::vector<double> denseState(2 * 4, 0.1), packedState(2 * 4, 0.1);
+    std::span<double> dense = gruLayer.forwardBatch(ctx, rows, 2, denseState);
+    std::span<double> packed = twin.forwardBatch(ctx, rows, 2, packedState);
+    for (size_t j = 0; j < 8; ++j)
+    {
+        EXPECT_NEAR(packed[j], dense[j], 2e-2) << "Packed GRU output mismatch at " << j;
+    }
+    EXPECT_THROW(gruLayer.forwardBatch(ctx, rows, 2), std::invalid_argument) << "Missing hidden state accepted";
+
+    // Test 4: pruning zeroes the input weights of every gate
+    gruLayer.prune(1.0);
+    EXPECT_EQ(gruLayer.getDensity(), 0.0) << "GRU gates left unpruned";
+    ctx.endBatch();
+}
+
+/**
+ * @brief: Tests for the blocking and threading knobs the autotuner sets
+ */
+TEST_F(LayerTest, TuningTests)
+{
+    ExecContext ctx;
+    ThreadPool pool(2);
+    std::vector<double> rows(10 * 3);
+    for (size_t i = 0; i < rows.size(); ++i)
+    {
+        rows[i] = std::sin(0.7 * static_cast<double>(i));
+    }
+
+    // Test 1: blocks of rows over the pool give the same batch as one block
+    NetworkLayer<LstmNode> lstm(6, LstmNode(), true, nullptr, 3);
+    std::vector<double> stm(60, 0.0), ltm(60, 0.0);
+    std::span<double> whole = lstm.forwardBatch(ctx, rows, 10, stm, ltm);
+    std::vector<double> expected(whole.begin(), whole.end());
+    std::fill(stm.begin(), stm.end(), 0.0);
+    std::fill(ltm.begin(), ltm.end(), 0.0);
+    lstm.setParallel(&pool);
+    lstm.setTuning(LayerTuning{3, 2, 2, 8});
+    std::span<double> tiled = lstm.forwardBatch(ctx, rows, 10, stm, ltm);
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        EXPECT_NEAR(tiled[i], expected[i], 1e-12) << "Tiled batch mismatch at " << i;
+    }
+
+    // Test 2: the unroll reaches the packed kernels and only moves the fp32 rounding
+    NetworkLayer<BaseNode> base(5, BaseNode(), true, nullptr, 3);
+    base.setPrecision(Precision::FP16);
+    std::span<double> eight = base.forwardBatch(ctx, rows, 10);
+    std::vector<double> reference(eight.begin(), eight.end());
+    base.setTuning(LayerTuning{4, 1, 1, 16});
+    std::span<double> sixteen = base.forwardBatch(ctx, rows, 10);
+    for (size_t i = 0; i < reference.size(); ++i)
+    {
+        EXPECT_NEAR(sixteen[i], reference[i], 1e-5) << "Unrolled packed batch mismatch at " << i;
+    }
+
+    // Test 3: tunings the kernels cannot run are rejected
+    EXPECT_THROW(base.setTuning(LayerTuning{0, 1, 0, 8}), std::invalid_argument) << "Zero chunks accepted";
+    EXPECT_THROW(base.setTuning(LayerTuning{0, 1, 1, 6}), std::invalid_argument) << "Unroll of 6 accepted";
+    EXPECT_EQ(base.getTuning().unroll, 16) << "Rejected tuning was applied";
+    ctx.endBatch();
+}
@@ -0,0 +1,145 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+/**
+ *
+ * @struct: AlignedAllocator -> std allocator that hands out cache line aligned storage
+ *
+ * @note: used for every buffer that a SIMD kernel sweeps over so loads never straddle a line
+ *
+ */
+template <typename T, std::size_t Align = 64>
+struct AlignedAllocator
+{
+    using value_type = T;
+
+    template <typename U>
+    struct rebind { using other = AlignedAllocator<U, Align>; };
+
+    AlignedAllocator() noexcept = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Align>&) noexcept {}
+
+    T* allocate(std::size_t count)
+    {
+        return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t{Align}));
+    }
+
+    void deallocate(T* ptr, std::size_t) noexcept
+    {
+        ::operator delete(ptr, std::align_val_t{Align});
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Align>&) const noexcept { return true; }
+};
+
+/**
+ *
+ * @class: Arena -> bump allocator for per-batch activations and scratch buffers
+ *
+ * @note: memory handed out by alloc is only valid until the next reset. Reset is O(1), it keeps the
+ *          reserved block so a steady state batch loop never touches malloc. If a batch overflows the
+ *          block, extra blocks are chained and folded into one bigger block on the next reset
+ *
+ */
+class Arena
+{
+    public:
+        static constexpr std::size_t alignment = 64;
+
+        /**
+         *
+         * @brief: constructor, reserves the first block
+         *
+         * @param: capacity -> type: size_t, number of bytes to reserve up front
+         *
+         */
+        explicit Arena(std::size_t capacity = std::size_t(1) << 16);
+
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        /**
+         *
+         * @brief: hands out an uninitialised, cache line aligned span of count elements
+         *
+         * @param: count -> type: size_t, number of elements
+         * @return: std::span<T> -> view into the arena, valid until reset()
+         *
+         */
+        template <typename T>
+        std::span<T> alloc(std::size_t count)
+        {
+            static_assert(std::is_trivially_destructible_v<T>, "Arena never runs destructors");
+            if (count == 0)
+            {
+                return {};
+            }
+            return {static_cast<T*>(allocBytes(count * sizeof(T))), count};
+        }
+
+        /**
+         *
+         * @brief: same as alloc but every element is set to value
+         *
+         */
+        template <typename T>
+        std::span<T> alloc(std::size_t count, T value)
+        {
+            std::span<T> out = alloc<T>(count);
+            for (T& elem : out)
+            {
+                elem = value;
+            }
+            return out;
+        }
+
+        /**
+         *
+         * @brief: releases every allocation at once
+         *
+         */
+        void reset() noexcept;
+
+        /**
+         *
+         * @brief: getter functions for the arena bookkeeping
+         *
+         */
+        std::size_t used() const noexcept { return usedBytes; }
+        std::size_t capacity() const noexcept { return totalBytes; }
+        std::size_t highWater() const noexcept { return peakBytes; }
+        std::size_t blockCount() const noexcept { return blocks.size(); }
+
+    private:
+        struct BlockDeleter
+        {
+            void operator()(std::byte* ptr) const noexcept { ::operator delete(ptr, std::align_val_t{alignment}); }
+        };
+
+        struct Block
+        {
+            std::unique_ptr<std::byte, BlockDeleter> data;
+            std::size_t size;
+        };
+
+        void* allocBytes(std::size_t bytes);
+        void addBlock(std::size_t bytes);
+
+        std::vector<Block> blocks;
+        std::size_t current;
+        std::size_t offset;
+        std::size_t usedBytes;
+        std::size_t totalBytes;
+        std::size_t peakBytes;
+};
+
+#endif
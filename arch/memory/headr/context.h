@@ -0,0 +1,39 @@
+#ifndef CONTEXT_H
+#define CONTEXT_H
+
+#include "arena.h"
+
+/**
+ *
+ * @struct: ExecContext -> state shared by every layer while one batch runs through the model
+ *
+ * @note: all activations and temporaries for the batch come out of the arena, call endBatch once
+ *          the outputs of the batch have been consumed
+ *
+ */
+struct ExecContext
+{
+    explicit ExecContext(std::size_t arenaBytes = std::size_t(1) << 16) : arena(arenaBytes) {}
+
+    /**
+     *
+     * @brief: scratch buffer for the current batch
+     *
+     * @param: count -> type: size_t, number of elements
+     * @return: std::span<T> -> valid until endBatch()
+     *
+     */
+    template <typename T = double>
+    std::span<T> scratch(std::size_t count) { return arena.template alloc<T>(count); }
+
+    /**
+     *
+     * @brief: drops every activation of the batch in O(1)
+     *
+     */
+    void endBatch() noexcept { arena.reset(); }
+
+    Arena arena;
+};
+
+#endif
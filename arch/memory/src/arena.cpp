@@ -0,0 +1,90 @@
+#include "../headr/arena.h"
+#include <algorithm>
+
+/**
+ *
+ * @brief: constructor, reserves the first block
+ *
+ * @param: capacity .
+ * type: size_t, number of bytes to reserve up front
+ *
+ */
+Arena::Arena(std::size_t capacity)
+        : blocks(), current(0), offset(0), usedBytes(0), totalBytes(0), peakBytes(0)
+{
+    addBlock(std::max(capacity, alignment));
+}
+
+/**
+ *
+ * @brief: bumps the offset of the current block, chains a new block when it is full
+ *
+ * @param: bytes .
+ * type: size_t, size of the request
+ * @return: void* .
+ * aligned pointer into the arena
+ *
+ */
+void* Arena::allocBytes(std::size_t bytes)
+{
+    // keep every allocation on its own cache line
+    std::size_t rounded = (bytes + alignment - 1) & ~(alignment - 1);
+
+    while (offset + rounded > blocks[current].size)
+    {
+        if (current + 1 == blocks.size())
+        {
+            // grow geometrically so a single overflow does not chain many small blocks
+            addBlock(std::max(rounded, blocks[current].size * 2));
+        }
+        ++current;
+        offset = 0;
+    }
+
+    void* ptr = blocks[current].data.get() + offset;
+    offset += rounded;
+    usedBytes += rounded;
+    peakBytes = std::max(peakBytes, usedBytes);
+    return ptr;
+}
+
+/**
+ *
+ * @brief: reserves another block and appends it to the chain
+ *
+ * @param: bytes .
+ * type: size_t, size of the new block
+ *
+ */
+void Arena::addBlock(std::size_t bytes)
+{
+    auto* raw = static_cast<std::byte*>(::operator new(bytes, std::align_val_t{alignment}));
+    blocks.push_back(Block{std::unique_ptr<std::byte, BlockDeleter>(raw), bytes});
+    totalBytes += bytes;
+}
+
+/**
+ *
+ * @brief: releases every allocation at once
+ *
+ * @note: when the last batch had to chain blocks, they are replaced by one block big enough for the
+ *          whole batch so the next one stays in a single contiguous region
+ *
+ */
+void Arena::reset() noexcept
+{
+    if (blocks.size() > 1)
+    {
+        std::size_t needed = totalBytes;
+        void* raw = ::operator new(needed, std::align_val_t{alignment}, std::nothrow);
+        // on failure the chain is kept as is, it still serves the next batch
+        if (raw)
+        {
+            blocks.clear();
+            blocks.push_back(Block{std::unique_ptr<std::byte, BlockDeleter>(static_cast<std::byte*>(raw)), needed});
+        }
+    }
+    current = 0;
+    offset = 0;
+    usedBytes = 0;
+}
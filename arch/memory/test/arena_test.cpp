@@ -0,0 +1,90 @@
+#include "../headr/arena.h"
+#include "../headr/context.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+
+class ArenaTest : public ::testing::Test{};
+
+/**
+ * @brief: Tests for alloc and the alignment of the spans it hands out
+ */
+TEST_F(ArenaTest, AllocAlignment)
+{
+    Arena arena(1024);
+
+    // Test 1: spans have the requested size
+    std::span<double> first = arena.alloc<double>(3);
+    EXPECT_EQ(first.size(), 3) << "Span size does not match the request";
+
+    // Test 2: every allocation starts on a cache line
+    std::span<float> second = arena.alloc<float>(5);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(first.data()) % Arena::alignment, 0) << "First span not aligned";
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(second.data()) % Arena::alignment, 0) << "Second span not aligned";
+
+    // Test 3: filled allocation
+    std::span<double> filled = arena.alloc<double>(4, 1.5);
+    for (double val : filled)
+    {
+        EXPECT_EQ(val, 1.5) << "Filled allocation has the wrong value";
+    }
+
+    // Test 4: zero sized request
+    EXPECT_TRUE(arena.alloc<double>(0).empty()) << "Zero sized request returned memory";
+}
+
+/**
+ * @brief: Tests that reset hands the same memory back out
+ */
+TEST_F(ArenaTest, ResetReusesMemory)
+{
+    Arena arena(1024);
+    double* before = arena.alloc<double>(16).data();
+    EXPECT_GT(arena.used(), 0) << "Allocation not accounted for";
+
+    // Test 1: reset drops the usage
+    arena.reset();
+    EXPECT_EQ(arena.used(), 0) << "Reset did not clear usage";
+
+    // Test 2: the next batch gets the same addresses
+    double* after = arena.alloc<double>(16).data();
+    EXPECT_EQ(before, after) << "Reset did not reuse the block";
+}
+
+/**
+ * @brief: Tests that an overflowing batch is folded into one block on reset
+ */
+TEST_F(ArenaTest, GrowthCoalesces)
+{
+    Arena arena(256);
+
+    // Test 1: overflow chains blocks
+    for (int i = 0; i < 10; i++)
+    {
+        arena.alloc<double>(16);
+    }
+    EXPECT_GT(arena.blockCount(), 1) << "Overflow did not chain a new block";
+    size_t peak = arena.highWater();
+
+    // Test 2: reset folds the chain into a single block that fits the whole batch
+    arena.reset();
+    EXPECT_EQ(arena.blockCount(), 1) << "Reset did not fold the chain";
+    EXPECT_GE(arena.capacity(), peak) << "Folded block is smaller than the last batch";
+    for (int i = 0; i < 10; i++)
+    {
+        arena.alloc<double>(16);
+    }
+    EXPECT_EQ(arena.blockCount(), 1) << "Steady state batch still chains blocks";
+}
+
+/**
+ * @brief: Tests for the execution context wrapper
+ */
+TEST_F(ArenaTest, ExecContext)
+{
+    ExecContext ctx(512);
+    std::span<double> scratch = ctx.scratch(8);
+    EXPECT_EQ(scratch.size(), 8) << "Scratch buffer has the wrong size";
+
+    ctx.endBatch();
+    EXPECT_EQ(ctx.arena.used(), 0) << "endBatch did not reset the arena";
+}
@@ -0,0 +1,158 @@
+#ifndef AUTOTUNE_H
+#define AUTOTUNE_H
+
+#include "model.h"
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ *
+ * AUTOTUNER:
+ *  - the best batch tile, thread count, chunks per thread and dot kernel unroll of a layer depend on the
+ *      CPU (cache sizes, vector width, core count), so one static choice is wrong somewhere in a mixed fleet
+ *  - at model load (or offline) every distinct layer shape is timed over the candidate grid on its real
+ *      forward path, forward for the classifier, forwardBatch for the listener, and the fastest is set
+ *  - winners are kept in a text cache under a host key (host name, CPU model, hardware threads), later
+ *      loads on the same host reuse them without timing anything, entries of other hosts are kept so one
+ *      file can be shared
+ *  - candidates that cannot change the kernel are dropped before timing (no pool: one thread, full
+ *      precision: one unroll, single row forward: one tile)
+ *
+ */
+
+/**
+ *
+ * @struct: AutotuneConfig -> candidate grid, timing effort and cache of an Autotuner
+ *
+ * @values:
+ *     cachePath -> type: std::string, tuning cache file, empty tunes without persisting
+ *     batch -> type: size_t, rows per forwardBatch call while timing recurrent layers
+ *     repeats -> type: size_t, timed calls per candidate per round
+ *     rounds -> type: size_t, passes over the grid, a candidate keeps its fastest round
+ *     retune -> type: bool, ignore cached winners and time again
+ *     batchTiles, threads, chunksPerThread, unrolls -> type: std::vector<size_t>, the grid (LayerTuning)
+ *
+ */
+struct AutotuneConfig
+{
+    std::string cachePath;
+    size_t batch = 32;
+    size_t repeats = 20;
+    size_t rounds = 2;
+    bool retune = false;
+    std::vector<size_t> batchTiles = {0, 4, 8, 16};
+    std::vector<size_t> threads = {1, 2, 4, 0};
+    std::vector<size_t> chunksPerThread = {1, 2, 4};
+    std::vector<size_t> unrolls = {4, 8, 16};
+};
+
+/**
+ *
+ * @struct: AutotuneEntry -> the winner for one layer shape
+ *
+ * @values:
+ *     shape -> type: std::string, node kind, nodes x fan in, precision, sparsity, rows and pool size
+ *     tuning -> type: LayerTuning, the fastest candidate
+ *     seconds -> type: double, time per call of the winner, 0 when it came from the cache
+ *     defaultSeconds -> type: double, time per call of the default LayerTuning, 0 when cached
+ *     cached -> type: bool, read from the cache instead of timed
+ *
+ */
+struct AutotuneEntry
+{
+    std::string shape;
+    LayerTuning tuning;
+    double seconds = 0.0;
+    double defaultSeconds = 0.0;
+    bool cached = false;
+};
+
+/**
+ *
+ * @struct: AutotuneReport -> what one tune() call did
+ *
+ * @values:
+ *     host -> type: std::string, host key the winners are stored under
+ *     shapes -> type: std::vector<AutotuneEntry>, one per distinct layer shape
+ *     layers -> type: size_t, layers the winners were applied to
+ *     cacheHits -> type: size_t, shapes answered from the cache
+ *     seconds -> type: double, wall time of the call, timing included
+ *
+ */
+struct AutotuneReport
+{
+    std::string host;
+    std::vector<AutotuneEntry> shapes;
+    size_t layers = 0;
+    size_t cacheHits = 0;
+    double seconds = 0.0;
+};
+
+/**
+ *
+ * @brief: key of this host in the tuning cache, host name, CPU model and hardware threads
+ *
+ */
+std::string autotuneHostKey();
+
+/**
+ *
+ * @class: Autotuner -> times the kernel blocking and threading of every layer shape and keeps the winners
+ *
+ */
+class Autotuner
+{
+    public:
+        /**
+         *
+         * @brief: constructor, reads the cache file when there is one
+         *
+         * @param: config -> type: AutotuneConfig, grid, timing effort and cache path
+         * @param: host -> type: std::string, host key, defaults to autotuneHostKey()
+         *
+         */
+        explicit Autotuner(AutotuneConfig config = {}, std::string host = autotuneHostKey());
+
+        /**
+         *
+         * @brief: tunes every layer of the model and writes the cache when anything was timed
+         *
+         * @param: model -> type: CompositeModel&, layers must already have their precision and pool set
+         * @return: AutotuneReport -> winners, cache hits and time spent
+         *
+         */
+        AutotuneReport tune(CompositeModel& model);
+
+        /**
+         *
+         * @brief: tunes the layers of one network, the cache is not written
+         *
+         */
+        void tune(Classifier& classifier, AutotuneReport& report);
+        void tune(Listener& listener, AutotuneReport& report);
+
+        /**
+         *
+         * @brief: writes every entry, this host's and the others', to the cache file
+         *
+         */
+        void save() const;
+
+        const std::string& getHost() const noexcept { return host; }
+
+    private:
+        // winner for the shape of layer, from the cache or timed
+        template <typename NodeType>
+        const LayerTuning& tuneLayer(NetworkLayer<NodeType>& layer, size_t rows, AutotuneReport& report);
+
+        void load();
+
+        AutotuneConfig config;
+        std::string host;
+        // host key -> shape -> winner
+        std::map<std::string, std::map<std::string, LayerTuning>> entries;
+};
+
+#endif
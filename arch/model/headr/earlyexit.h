@@ -0,0 +1,214 @@
+#ifndef EARLYEXIT_H
+#define EARLYEXIT_H
+
+#include "model.h"
+#include <array>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+/**
+ *
+ * ANYTIME CLASSIFICATION:
+ *  - the classifier needs the whole opening window, but most clearly consonant (or clearly jazz) openings
+ *      give themselves away after a few seconds
+ *  - the frequencies are streamed through an O(1) running state (interval entropy, consonant fraction and
+ *      interval consonance as in IntervalTracker, without its 1200 bin pitch histogram, plus pitch
+ *      statistics), and at every exit step a logistic head of numStateFeatures weights reads that state
+ *  - a head answers as soon as its calibrated confidence max(p, 1 - p) reaches its threshold, otherwise
+ *      the stream goes on to the next exit and finally to the full classifier
+ *  - calibrate() Platt scales every head on held out tracks and picks the lowest threshold whose exits
+ *      are still at least targetAccuracy correct
+ *
+ */
+
+/**
+ *
+ * @struct: EarlyExitDecision -> answer of one classification
+ *
+ * @values:
+ *     probability -> type: double, P(consonant) in [0, 1]
+ *     steps -> type: size_t, seconds read before answering
+ *     exit -> type: size_t, index of the head that answered, numExits() for the full classifier
+ *     confident -> type: bool, false when a partial sequence ran out before any threshold was reached
+ *
+ */
+struct EarlyExitDecision
+{
+    double probability = 0.5;
+    size_t steps = 0;
+    size_t exit = 0;
+    bool confident = false;
+};
+
+/**
+ *
+ * @struct: ExitStats -> what one exit did over an evaluation set
+ *
+ * @values:
+ *     step -> type: size_t, seconds read when this exit answers
+ *     taken -> type: size_t, decisions made here
+ *     correct -> type: size_t, of those, how many matched the label
+ *     seconds -> type: double, summed wall time of those decisions
+ *     maxSeconds -> type: double, slowest of them
+ *
+ */
+struct ExitStats
+{
+    size_t step = 0;
+    size_t taken = 0;
+    size_t correct = 0;
+    double seconds = 0.0;
+    double maxSeconds = 0.0;
+
+    double accuracy() const noexcept { return taken == 0 ? 0.0 : static_cast<double>(correct) / static_cast<double>(taken); }
+    double meanSeconds() const noexcept { return taken == 0 ? 0.0 : seconds / static_cast<double>(taken); }
+};
+
+/**
+ *
+ * @struct: EarlyExitReport -> per exit statistics, the last entry is the full classifier
+ *
+ * @values:
+ *     exits -> type: std::vector<ExitStats>, numExits() + 1 entries
+ *     accuracy -> type: double, accuracy of all decisions
+ *     fullAccuracy -> type: double, accuracy of the full classifier alone on the same tracks
+ *     meanSteps -> type: double, mean seconds read per decision
+ *     meanSeconds -> type: double, mean wall time per decision
+ *     fullSeconds -> type: double, mean wall time of the full classifier alone
+ *
+ */
+struct EarlyExitReport
+{
+    std::vector<ExitStats> exits;
+    double accuracy = 0.0;
+    double fullAccuracy = 0.0;
+    double meanSteps = 0.0;
+    double meanSeconds = 0.0;
+    double fullSeconds = 0.0;
+};
+
+/**
+ *
+ * @class: EarlyExitClassifier -> classifier with cheap exit heads on the running state of the sequence
+ *
+ */
+class EarlyExitClassifier
+{
+    public:
+        // interval entropy, consonant fraction, interval consonance, mean and last normalised frequency,
+        // last interval in octaves
+        static constexpr size_t numStateFeatures = 6;
+
+        /**
+         *
+         * @brief: constructor, the heads start at zero and never exit until fit or setThreshold
+         *
+         * @param: classifier -> type: Classifier&, final exit, with no channels or the IntervalTracker ones
+         * @param: exits -> type: std::vector<size_t>, strictly increasing steps in [1, window)
+         *
+         */
+        EarlyExitClassifier(Classifier& classifier, std::vector<size_t> exits);
+
+        /**
+         *
+         * @brief: trains every head by full batch logistic regression on the state at its step
+         *
+         * @param: tracks -> type: const std::vector<std::vector<double>>&, at least window seconds each
+         * @param: labels -> type: std::span<const double>, 1 for consonant, 0 for dissonant
+         * @param: epochs -> type: size_t, gradient steps per head
+         * @param: learningRate -> type: double, step size
+         *
+         */
+        void fit(const std::vector<std::vector<double>>& tracks, std::span<const double> labels, size_t epochs = 500,
+                 double learningRate = 0.5);
+
+        /**
+         *
+         * @brief: Platt scales every head and sets its threshold on held out tracks
+         *
+         * @param: tracks -> type: const std::vector<std::vector<double>>&, not the ones fit on
+         * @param: labels -> type: std::span<const double>, 1 for consonant, 0 for dissonant
+         * @param: targetAccuracy -> type: double, in (0.5, 1], accuracy a head must keep on what it answers
+         *
+         */
+        void calibrate(const std::vector<std::vector<double>>& tracks, std::span<const double> labels,
+                       double targetAccuracy);
+
+        /**
+         *
+         * @brief: one confidence threshold for every head, above 1 never exits early
+         *
+         */
+        void setThreshold(double threshold) noexcept;
+
+        /**
+         *
+         * @brief: reads the sequence until a head is confident, falls back to the full classifier
+         *
+         * @param: ctx -> type: ExecContext&, per batch arena, only used by the full classifier
+         * @param: frequencies -> type: span<const double>, one frequency per second, may be shorter than the
+         *              window, then the last head reached answers with confident false
+         * @return: EarlyExitDecision -> probability, seconds read and the exit taken
+         *
+         */
+        EarlyExitDecision classify(ExecContext& ctx, std::span<const double> frequencies);
+
+        /**
+         *
+         * @brief: classifies every track, timing each decision, and compares with the full classifier
+         *
+         * @param: ctx -> type: ExecContext&, per batch arena, reset after every track
+         * @param: tracks -> type: const std::vector<std::vector<double>>&, at least window seconds each
+         * @param: labels -> type: std::span<const double>, 1 for consonant, 0 for dissonant
+         * @return: EarlyExitReport -> per exit accuracy and latency
+         *
+         */
+        EarlyExitReport evaluate(ExecContext& ctx, const std::vector<std::vector<double>>& tracks,
+                                 std::span<const double> labels);
+
+        size_t numExits() const noexcept { return heads.size(); }
+        size_t getStep(size_t exit) const { return heads.at(exit).step; }
+        double getThreshold(size_t exit) const { return heads.at(exit).threshold; }
+
+    private:
+        struct Head
+        {
+            size_t step = 0;
+            std::array<double, numStateFeatures> weights{};
+            double bias = 0.0;
+            double threshold = 2.0;
+        };
+
+        // running state of a sequence, the input of the heads
+        class State
+        {
+            public:
+                void push(double freq) noexcept;
+                void features(std::span<double> out) const;
+
+            private:
+                std::array<size_t, IntervalTracker::numClasses> counts{};
+                size_t consonant = 0;
+                double intervalScore = 0.0;
+                double sum = 0.0;
+                double last = 0.0;
+                double interval = 0.0;
+                size_t count = 0;
+        };
+
+        // logit of a head on a state
+        static double logit(const Head& head, std::span<const double> state) noexcept;
+
+        // state features of every track at every exit step, [(track * heads + exit) * numStateFeatures]
+        std::vector<double> collect(const std::vector<std::vector<double>>& tracks,
+                                    std::span<const double> labels) const;
+
+        // full classifier on the window, with the tracker channels when the classifier takes them
+        double classifyFull(ExecContext& ctx, std::span<const double> window);
+
+        Classifier& classifier;
+        std::vector<Head> heads;
+};
+
+#endif
@@ -0,0 +1,274 @@
+#ifndef MODEL_H
+#define MODEL_H
+
+#include "../../layer/headr/layer.h"
+#include "../../data/headr/batch.h"
+#include "../../graph/headr/graph.h"
+#include "../../feature/headr/interval.h"
+#include "resultcache.h"
+#include <memory>
+#include <span>
+#include <vector>
+
+/**
+ *
+ * THE COMPOSITE MODEL:
+ *  - Classifier: feedforward stack of BaseNode layers, "what am I listening to?" (consonant vs dissonant)
+ *  - Listener: stacked LSTM of LstmNode layers, "how much do I like this?" at every second
+ *
+ */
+
+/**
+ *
+ * @brief: maps a frequency to octaves relative to A4 so the model sees values around [-1, 1]
+ *
+ */
+double normalizeFrequency(double hz) noexcept;
+
+/**
+ *
+ * @brief: interval from prev to hz in octaves, 0 when either frequency is not positive (silence / no pitch)
+ *
+ */
+double intervalOctaves(double prev, double hz) noexcept;
+
+/**
+ *
+ * @class: Classifier -> binary consonance classifier over one frequency per second
+ *
+ */
+class Classifier
+{
+    public:
+        /**
+         *
+         * @brief: constructor
+         *
+         * @param: numInputs -> type: int, number of frequencies per sequence
+         * @param: hiddenSizes -> type: const std::vector<int>&, width of every hidden layer
+         * @param: numChannels -> type: int, extra feature channels read after the frequencies
+         *
+         */
+        Classifier(int numInputs, const std::vector<int>& hiddenSizes, int numChannels = 0);
+
+        /**
+         *
+         * @brief: probability that the sequence is consonant
+         *
+         * @param: ctx -> type: ExecContext&, per batch arena
+         * @param: frequencies -> type: span<const double>, numInputs frequencies in Hz
+         * @param: channels -> type: span<const double>, numChannels features, passed through unnormalised
+         * @return: double -> P(consonant) in [0, 1]
+         *
+         */
+        double predict(ExecContext& ctx, std::span<const double> frequencies, std::span<const double> channels = {});
+
+        /**
+         *
+         * @brief: same as predict, through a plan made by compile()
+         *
+         * @param: plan -> type: ExecutionPlan&, compiled from this classifier
+         *
+         */
+        double predict(ExecContext& ctx, ExecutionPlan& plan, std::span<const double> frequencies,
+                       std::span<const double> channels = {});
+
+        /**
+         *
+         * @brief: compiles the layer stack into a static execution plan, one fused kernel per layer
+         *
+         * @return: ExecutionPlan -> snapshot of the current weights, recompile after training
+         *
+         */
+        ExecutionPlan compile();
+
+        /**
+         *
+         * @brief: registers every layer's parameters with the model wide buffer
+         *
+         */
+        void registerParams(ParamBuffer& buffer);
+
+        std::vector<std::unique_ptr<NetworkLayer<BaseNode>>>& getLayers() noexcept { return layers; }
+        int getNumInputs() const noexcept { return numInputs; }
+        int getNumChannels() const noexcept { return numChannels; }
+
+    private:
+        // normalised frequencies followed by the raw channels
+        std::span<double> inputs(ExecContext& ctx, std::span<const double> frequencies,
+                                 std::span<const double> channels) const;
+
+        int numInputs;
+        int numChannels;
+        std::vector<std::unique_ptr<NetworkLayer<BaseNode>>> layers;
+};
+
+/**
+ *
+ * @class: Listener -> stacked LSTM that scores its preference for every second it hears
+ *
+ * @note: the cell state lives in the LstmNodes and carries over between calls to step
+ *
+ */
+class Listener
+{
+    public:
+        // normalised frequency, interval to the previous second in octaves, classifier output
+        static constexpr int numFeatures = 3;
+
+        /**
+         *
+         * @brief: constructor
+         *
+         * @param: numInputs -> type: int, features per timestep
+         * @param: hiddenSizes -> type: const std::vector<int>&, width of every stacked LSTM layer
+         *
+         */
+        Listener(int numInputs, const std::vector<int>& hiddenSizes);
+
+        /**
+         *
+         * @brief: advances every layer one timestep
+         *
+         * @param: ctx -> type: ExecContext&, per batch arena
+         * @param: features -> type: span<const double>, numInputs features of this timestep
+         * @param: hidden -> type: span<double>, optional, receives the top layer STM
+         * @return: double -> preference in [0, 1] for this timestep
+         *
+         */
+        double step(ExecContext& ctx, std::span<const double> features, std::span<double> hidden = {});
+
+        /**
+         *
+         * @brief: runs a packed batch of sequences, every sequence starts from a zero cell state
+         *
+         * @param: ctx -> type: ExecContext&, per batch arena, also holds the per sequence cell state
+         * @param: batch -> type: const PackedBatch&, numInputs features per timestep
+         * @return: std::span<double> -> one preference per packed row, valid until ctx.endBatch()
+         *
+         * @note: the state of the nodes themselves is not touched, and at every step only the sequences
+         *          still running are computed
+         *
+         */
+        std::span<double> runPacked(ExecContext& ctx, const PackedBatch& batch);
+
+        /**
+         *
+         * @brief: advances rows independent sequences one timestep, the cell state lives with the caller
+         *
+         * @param: ctx -> type: ExecContext&, per batch arena
+         * @param: features -> type: span<const double>, rows x numInputs features of this timestep
+         * @param: rows -> type: size_t, number of sequences
+         * @param: stm, ltm -> type: span<const span<double>>, one rows x width state per layer, updated in place
+         * @return: std::span<double> -> one preference per row, valid until ctx.endBatch()
+         *
+         */
+        std::span<double> stepBatch(ExecContext& ctx, std::span<const double> features, size_t rows,
+                                    std::span<const std::span<double>> stm, std::span<const std::span<double>> ltm);
+
+        /**
+         *
+         * @brief: clears the STM / LTM of every cell before a new sequence
+         *
+         */
+        void resetState() noexcept;
+
+        /**
+         *
+         * @brief: registers every layer's parameters and the readout with the model wide buffer
+         *
+         */
+        void registerParams(ParamBuffer& buffer);
+
+        std::vector<std::unique_ptr<NetworkLayer<LstmNode>>>& getLayers() noexcept { return layers; }
+        ParamVec& getReadoutWeights() noexcept { return readoutWeights; }
+        ParamScalar& getReadoutBias() noexcept { return readoutBias; }
+
+    private:
+        std::vector<std::unique_ptr<NetworkLayer<LstmNode>>> layers;
+        ParamVec readoutWeights;
+        ParamScalar readoutBias;
+};
+
+/**
+ *
+ * @class: CompositeModel -> classifier followed by the listener over the same sequence
+ *
+ */
+class CompositeModel
+{
+    public:
+        /**
+         *
+         * @brief: constructor
+         *
+         * @param: window -> type: int, opening seconds of every track the classifier hears
+         * @param: classifierHidden -> type: const std::vector<int>&, classifier hidden widths
+         * @param: listenerHidden -> type: const std::vector<int>&, stacked LSTM widths
+         * @param: intervalChannels -> type: bool, append the IntervalTracker channels to the classifier
+         *              input and to every listener timestep
+         *
+         */
+        CompositeModel(int window, const std::vector<int>& classifierHidden,
+                       const std::vector<int>& listenerHidden, bool intervalChannels = false);
+
+        /**
+         *
+         * @brief: classifies the opening window then lets the listener hear the whole track second by second
+         *
+         * @param: ctx -> type: ExecContext&, per batch arena
+         * @param: frequencies -> type: span<const double>, one frequency per second, at least window long
+         * @return: std::span<double> -> preference at every second, valid until ctx.endBatch()
+         *
+         */
+        std::span<double> run(ExecContext& ctx, std::span<const double> frequencies);
+
+        /**
+         *
+         * @brief: runs tracks of different lengths together as one packed batch
+         *
+         * @param: ctx -> type: ExecContext&, per batch arena
+         * @param: tracks -> type: const std::vector<std::vector<double>>&, one frequency per second each
+         * @return: std::vector<std::span<double>> -> preferences of every track in the given order,
+         *              valid until ctx.endBatch()
+         *
+         */
+        std::vector<std::span<double>> runBatch(ExecContext& ctx, const std::vector<std::vector<double>>& tracks);
+
+        /**
+         *
+         * @brief: registers classifier then listener parameters, bind the buffer afterwards
+         *
+         */
+        void registerParams(ParamBuffer& buffer);
+
+        /**
+         *
+         * @brief: answers repeated openings from a cache instead of a classifier forward pass
+         *
+         * @param: cache -> type: ResultCache*, shared by every caller, nullptr turns caching off
+         *
+         */
+        void setResultCache(ResultCache* cache) noexcept { resultCache = cache; }
+
+        Classifier& getClassifier() noexcept { return classifier; }
+        Listener& getListener() noexcept { return listener; }
+        bool hasIntervalChannels() const noexcept { return intervalChannels; }
+
+        // listener features per timestep, the interval channels come after the base ones
+        size_t numListenerFeatures() const noexcept;
+
+        // classifier output for the opening window of a track, through the result cache when one is set
+        double classify(ExecContext& ctx, std::span<const double> frequencies);
+
+    private:
+        // classifier forward pass on exactly the window
+        double classifyWindow(ExecContext& ctx, std::span<const double> window);
+
+        bool intervalChannels;
+        Classifier classifier;
+        Listener listener;
+        ResultCache* resultCache = nullptr;
+};
+
+#endif
@@ -0,0 +1,137 @@
+#ifndef POPULATION_H
+#define POPULATION_H
+
+#include "model.h"
+#include "../../exec/headr/pool.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/**
+ *
+ * LISTENER POPULATION:
+ *  - hundreds of thousands of small listeners, each with its own weights and STM / LTM, simulated together
+ *  - every parameter and every state value is stored as a lane of one value per listener, so the LSTM step
+ *      of a block of listeners is a handful of array expressions over contiguous lanes instead of one
+ *      NetworkLayer walk per listener
+ *  - blocks of listeners run a whole stimulus on their own, so their state stays in cache, and the blocks
+ *      are spread over a work stealing pool
+ *
+ */
+
+/**
+ *
+ * @struct: PopulationTrajectory -> aggregate preference of the population at every timestep
+ *
+ * @values:
+ *     mean -> type: std::vector<double>, mean preference
+ *     stddev -> type: std::vector<double>, standard deviation of the preferences
+ *     enjoying -> type: std::vector<double>, fraction of listeners with a preference above 0.5
+ *
+ */
+struct PopulationTrajectory
+{
+    std::vector<double> mean;
+    std::vector<double> stddev;
+    std::vector<double> enjoying;
+};
+
+/**
+ *
+ * @class: ListenerPopulation -> many listeners of one shape advanced side by side
+ *
+ * @note: lanes hold listener k at index k: input weights [(slot * fanIn + input) * listeners + k], gate
+ *          recurrent weights and biases [slot * listeners + k], state [node * listeners + k], with
+ *          slot = gate * nodes + node exactly as in NetworkLayer::unpackWeights
+ *
+ */
+class ListenerPopulation
+{
+    public:
+        // listeners per task, the lanes of one block of a small listener fit in L1 / L2
+        static constexpr size_t blockSize = 256;
+
+        /**
+         *
+         * @brief: every listener starts as base plus its own gaussian perturbation
+         *
+         * @param: base -> type: Listener&, shape and starting weights
+         * @param: listeners -> type: size_t, population size
+         * @param: spread -> type: double, standard deviation of the per listener weight noise
+         * @param: seed -> type: uint64_t, noise seed
+         *
+         */
+        ListenerPopulation(Listener& base, size_t listeners, double spread = 0.0, uint64_t seed = 1);
+
+        /**
+         *
+         * @brief: replaces one listener's weights with those of model, its state is cleared
+         *
+         * @param: listener -> type: size_t, index in the population
+         * @param: model -> type: Listener&, same shape as the population
+         *
+         */
+        void load(size_t listener, Listener& model);
+
+        /**
+         *
+         * @brief: clears every STM / LTM before a new stimulus
+         *
+         */
+        void resetState() noexcept;
+
+        /**
+         *
+         * @brief: runs the blocks on a pool, nullptr runs them on the calling thread
+         *
+         */
+        void setParallel(ThreadPool* workers) noexcept { pool = workers; }
+
+        /**
+         *
+         * @brief: plays one stimulus to every listener, the state carries on from the previous call
+         *
+         * @param: features -> type: span<const double>, steps rows of numInputs features heard by everyone
+         * @return: PopulationTrajectory -> aggregate preference at every step
+         *
+         * @note: the aggregate is reduced in block order, so it does not depend on the pool
+         *
+         */
+        PopulationTrajectory run(std::span<const double> features);
+
+        // preference of every listener after the last step
+        std::span<const double> preferences() const noexcept { return lastPreference; }
+
+        size_t size() const noexcept { return listeners; }
+        size_t getNumInputs() const noexcept { return numInputs; }
+
+        // bytes of weights and state held for the whole population
+        size_t bytes() const noexcept;
+
+    private:
+        struct Layer
+        {
+            size_t nodes = 0;
+            size_t fanIn = 0;
+            std::vector<double> weights;
+            std::vector<double> recurrent;
+            std::vector<double> bias;
+            std::vector<double> stm;
+            std::vector<double> ltm;
+        };
+
+        // one block of listeners [first, first + count) through every step
+        void runBlock(size_t first, size_t count, std::span<const double> features, std::span<double> sums,
+                      std::vector<double>& pre);
+
+        size_t listeners;
+        size_t numInputs;
+        std::vector<Layer> layers;
+        std::vector<double> readoutWeights;
+        std::vector<double> readoutBias;
+        std::vector<double> lastPreference;
+        ThreadPool* pool = nullptr;
+};
+
+#endif
@@ -0,0 +1,200 @@
+#ifndef RESULTCACHE_H
+#define RESULTCACHE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+
+/**
+ *
+ * RESULT CACHE:
+ *  - many requests rescore the same opening, or one a few cents off, so the classifier output is memoised
+ *      under the sequence snapped to the equal tempered grid of MusicDataGenerator::baseFrequencies
+ *      (A4 = 440 Hz, stepsPerSemitone steps per semitone) and hashed
+ *  - the key is two independent 64 bit hashes of the snapped sequence, nothing is allocated per lookup and a
+ *      false hit needs a 128 bit collision
+ *  - the entries are split over shards by hash, each shard is an LRU list behind its own mutex, so threads
+ *      looking up different tracks rarely meet on a lock
+ *  - an entry older than ttl counts as a miss and is dropped, a zero ttl keeps entries until evicted
+ *  - the cache knows nothing about the weights: clear() it after training
+ *
+ */
+
+/**
+ *
+ * @struct: ResultCacheConfig -> size, striping and expiry of a ResultCache
+ *
+ * @values:
+ *     capacity -> type: size_t, total entries, split evenly over the shards
+ *     shards -> type: size_t, lock stripes
+ *     ttl -> type: std::chrono::steady_clock::duration, entry lifetime, zero for no expiry
+ *     stepsPerSemitone -> type: size_t, grid resolution, 1 snaps to the nearest semitone
+ *
+ */
+struct ResultCacheConfig
+{
+    size_t capacity = 4096;
+    size_t shards = 16;
+    std::chrono::steady_clock::duration ttl = std::chrono::steady_clock::duration::zero();
+    size_t stepsPerSemitone = 1;
+};
+
+/**
+ *
+ * @struct: ResultCacheStats -> counters summed over the shards
+ *
+ * @values:
+ *     hits -> type: uint64_t, lookups answered from the cache
+ *     misses -> type: uint64_t, lookups that had to run the model, expired entries included
+ *     evictions -> type: uint64_t, least recently used entries dropped for room
+ *     expirations -> type: uint64_t, entries dropped for being older than ttl
+ *     size -> type: size_t, entries held now
+ *
+ */
+struct ResultCacheStats
+{
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    uint64_t expirations = 0;
+    size_t size = 0;
+
+    double hitRate() const noexcept
+    {
+        uint64_t lookups = hits + misses;
+        return lookups == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(lookups);
+    }
+};
+
+/**
+ *
+ * @class: ResultCache -> sharded, lock striped LRU of classifier outputs keyed by the snapped sequence
+ *
+ */
+class ResultCache
+{
+    public:
+        /**
+         *
+         * @struct: Key -> two independent hashes of one snapped sequence
+         *
+         */
+        struct Key
+        {
+            uint64_t first = 0;
+            uint64_t second = 0;
+
+            bool operator==(const Key& other) const noexcept = default;
+        };
+
+        /**
+         *
+         * @brief: constructor
+         *
+         * @param: config -> type: ResultCacheConfig, capacity, shards, ttl and grid
+         *
+         */
+        explicit ResultCache(ResultCacheConfig config = {});
+
+        /**
+         *
+         * @brief: key of a sequence, frequencies within half a grid step of the same point share it
+         *
+         * @param: frequencies -> type: span<const double>, one frequency per second in Hz
+         * @return: Key -> the hashes of the snapped sequence
+         *
+         */
+        Key key(std::span<const double> frequencies) const noexcept;
+
+        /**
+         *
+         * @brief: cached value of a key, refreshed as most recently used
+         *
+         * @param: key -> type: const Key&, from key()
+         * @param: value -> type: double&, set on a hit
+         * @return: bool -> true on a hit
+         *
+         */
+        bool lookup(const Key& key, double& value);
+
+        /**
+         *
+         * @brief: stores a value, evicting the shard's least recently used entry when it is full
+         *
+         */
+        void insert(const Key& key, double value);
+
+        /**
+         *
+         * @brief: cached value of the sequence, or compute() stored and returned
+         *
+         * @param: frequencies -> type: span<const double>, one frequency per second in Hz
+         * @param: compute -> type: callable() -> double, runs outside every lock
+         * @return: double -> the value
+         *
+         * @note: two threads missing on the same key both compute, the later insert wins
+         *
+         */
+        template <typename Compute>
+        double getOrCompute(std::span<const double> frequencies, Compute&& compute)
+        {
+            Key k = key(frequencies);
+            double value = 0.0;
+            if (lookup(k, value))
+            {
+                return value;
+            }
+            value = compute();
+            insert(k, value);
+            return value;
+        }
+
+        /**
+         *
+         * @brief: drops every entry, the counters are kept
+         *
+         */
+        void clear();
+
+        ResultCacheStats stats() const;
+
+    private:
+        struct Entry
+        {
+            Key key;
+            double value;
+            std::chrono::steady_clock::time_point stored;
+        };
+
+        struct KeyHash
+        {
+            size_t operator()(const Key& key) const noexcept { return static_cast<size_t>(key.second); }
+        };
+
+        // one lock stripe, most recently used at the front of lru
+        struct alignas(64) Shard
+        {
+            mutable std::mutex lock;
+            std::list<Entry> lru;
+            std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+            std::atomic<uint64_t> hits{0};
+            std::atomic<uint64_t> misses{0};
+            std::atomic<uint64_t> evictions{0};
+            std::atomic<uint64_t> expirations{0};
+        };
+
+        Shard& shardOf(const Key& key) noexcept { return shards[key.first % numShards]; }
+
+        ResultCacheConfig config;
+        size_t numShards;
+        size_t perShard;
+        std::unique_ptr<Shard[]> shards;
+};
+
+#endif
@@ -0,0 +1,267 @@
+#ifndef SESSION_H
+#define SESSION_H
+
+#include "model.h"
+#include "../../feature/headr/harmonic.h"
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ *
+ * SESSION SCHEDULER:
+ *  - every live listening session is a coroutine: it awaits the next second of audio, extracts its dominant
+ *      frequency, awaits one Listener step and yields, so a session costs its frame and buffers, not a thread
+ *  - sources are file descriptors (local files or pipes) of raw 32 bit float mono PCM at the configured
+ *      sample rate, read without blocking; one poller thread poll()s the descriptors of sessions waiting for
+ *      audio and queues a session once it holds a whole second or its source ended
+ *  - a small pool of workers takes up to maxBatch ready sessions per turn and resumes them, the steps they
+ *      await are run as one Listener::stepBatch over the per session state, then the sessions go to the back
+ *      of the ready queue, so no session runs two steps while another ready one waits
+ *  - the first window seconds are buffered and classified once (through the model's result cache when one
+ *      is set), then stepped, silence holds the previous pitch and leading silence is skipped as in
+ *      streamFrequencies, so a session scores exactly what CompositeModel::run scores on the same track
+ *
+ */
+
+/**
+ *
+ * @struct: SessionConfig -> pool size, batching and audio format of a SessionScheduler
+ *
+ * @values:
+ *     workers -> type: size_t, worker threads, 0 for one per hardware thread
+ *     maxBatch -> type: size_t, sessions one worker resumes and steps together per turn
+ *     sampleRate -> type: double, samples per second of every source
+ *     harmonic -> type: HarmonicConfig, frontend window and search range, one window is one step
+ *     bufferedSeconds -> type: size_t, audio read ahead per session before its source is left unpolled
+ *     onPreference -> type: std::function<void(size_t, size_t, double)>, called from the workers with the
+ *              session id, second and preference of every step, may be empty
+ *
+ */
+struct SessionConfig
+{
+    size_t workers = 0;
+    size_t maxBatch = 64;
+    double sampleRate = 8000.0;
+    HarmonicConfig harmonic;
+    size_t bufferedSeconds = 2;
+    std::function<void(size_t, size_t, double)> onPreference;
+};
+
+/**
+ *
+ * @struct: SessionResult -> what one session heard and scored
+ *
+ * @values:
+ *     frequencies -> type: std::vector<double>, dominant frequency of every stepped second
+ *     preferences -> type: std::vector<double>, listener preference of every stepped second
+ *     consonance -> type: double, classifier output of the opening window
+ *     finished -> type: bool, the session's coroutine returned, error says whether it stopped early
+ *     error -> type: std::string, why the session stopped early, empty when it did not
+ *
+ */
+struct SessionResult
+{
+    std::vector<double> frequencies;
+    std::vector<double> preferences;
+    double consonance = 0.0;
+    bool finished = false;
+    std::string error;
+};
+
+/**
+ *
+ * @struct: SessionStats -> counters of a SessionScheduler
+ *
+ * @values:
+ *     sessions -> type: size_t, sessions opened
+ *     finished -> type: size_t, sessions whose coroutine returned
+ *     steps -> type: size_t, listener steps run
+ *     batches -> type: size_t, stepBatch calls, steps / batches is the mean batch
+ *     polls -> type: size_t, poll() calls of the poller thread
+ *
+ */
+struct SessionStats
+{
+    size_t sessions = 0;
+    size_t finished = 0;
+    size_t steps = 0;
+    size_t batches = 0;
+    size_t polls = 0;
+
+    double meanBatch() const noexcept
+    {
+        return batches == 0 ? 0.0 : static_cast<double>(steps) / static_cast<double>(batches);
+    }
+};
+
+/**
+ *
+ * @class: SessionScheduler -> multiplexes streaming listening sessions onto a few workers and one poller
+ *
+ */
+class SessionScheduler
+{
+    public:
+        /**
+         *
+         * @brief: constructor, starts the poller and the workers
+         *
+         * @param: model -> type: CompositeModel&, shared by every session, its listener is only read
+         * @param: config -> type: SessionConfig, pool size, batching and audio format
+         *
+         */
+        explicit SessionScheduler(CompositeModel& model, SessionConfig config = {});
+
+        /**
+         *
+         * @brief: stops the threads, closes the sources and drops the sessions that are still running
+         *
+         */
+        ~SessionScheduler();
+
+        SessionScheduler(const SessionScheduler&) = delete;
+        SessionScheduler& operator=(const SessionScheduler&) = delete;
+
+        /**
+         *
+         * @brief: starts a session on an open descriptor, callable from any thread
+         *
+         * @param: fd -> type: int, readable end of a file or pipe, switched to non blocking, closed by the scheduler
+         * @return: size_t -> session id, ids count up from 0
+         *
+         */
+        size_t open(int fd);
+
+        /**
+         *
+         * @brief: starts a session on a file or named pipe
+         *
+         * @param: path -> type: const std::string&, raw float PCM source
+         * @return: size_t -> session id
+         *
+         */
+        size_t openFile(const std::string& path);
+
+        /**
+         *
+         * @brief: blocks until every session opened so far has finished
+         *
+         * @return: std::vector<SessionResult> -> one per session, in id order
+         *
+         */
+        std::vector<SessionResult> wait();
+
+        SessionStats stats() const;
+        const SessionConfig& getConfig() const noexcept { return config; }
+
+    private:
+        struct Worker;
+        struct Session;
+
+        /**
+         *
+         * @struct: Task -> coroutine of one session, created suspended and resumed by the workers
+         *
+         */
+        struct Task
+        {
+            struct promise_type
+            {
+                std::exception_ptr error;
+
+                Task get_return_object() { return Task{std::coroutine_handle<promise_type>::from_promise(*this)}; }
+                std::suspend_always initial_suspend() noexcept { return {}; }
+                std::suspend_always final_suspend() noexcept { return {}; }
+                void return_void() noexcept {}
+                void unhandled_exception() noexcept { error = std::current_exception(); }
+            };
+
+            std::coroutine_handle<promise_type> handle;
+        };
+
+        // awaits one whole second of audio, false once the source has ended
+        struct SecondAwaiter
+        {
+            Session& session;
+            size_t samples;
+
+            bool await_ready() const noexcept;
+            void await_suspend(std::coroutine_handle<>) noexcept;
+            bool await_resume();
+        };
+
+        // awaits one listener step, run by the worker together with the other sessions of its turn
+        struct StepAwaiter
+        {
+            Session& session;
+
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<>) noexcept;
+            double await_resume() const noexcept;
+        };
+
+        // the body of every session, the awaiters only mark what it waits for, the worker that resumed
+        // it hands it on once resume() returns, so a session is never resumed on two threads at once
+        Task listen(Session& session);
+
+        // hands sessions waiting for audio to the poller
+        void watch(std::span<Session* const> waiting);
+
+        // queues sessions for the workers
+        void makeReady(std::span<Session* const> sessionsReady);
+
+        // records the result of a returned coroutine and releases its source and frame
+        void finish(Session& session);
+
+        // reads what is available from a source, false once the session holds a second or the source ended
+        bool fill(Session& session);
+
+        // one stepBatch over the sessions a worker's turn left waiting on a step
+        void step(Worker& worker);
+
+        void pollLoop();
+        void workerLoop(Worker& worker);
+
+        CompositeModel& model;
+        SessionConfig config;
+        size_t window;
+        size_t numFeatures;
+        size_t samplesPerSecond;
+        // offsets of every layer's STM then LTM in a session's state
+        std::vector<size_t> stateOffsets;
+        size_t stateSize = 0;
+
+        mutable std::mutex mutex;
+        std::condition_variable readyCv;
+        std::condition_variable doneCv;
+        std::deque<Session*> ready;
+        std::vector<Session*> arrivals;
+        std::vector<std::unique_ptr<Session>> sessions;
+        size_t finishedCount = 0;
+        bool stopping = false;
+
+        // the classifier writes node outputs on its forward pass
+        std::mutex classifyMutex;
+
+        std::atomic<size_t> stepCount{0};
+        std::atomic<size_t> batchCount{0};
+        std::atomic<size_t> pollCount{0};
+
+        // poller wake up pipe, read end first
+        int wakeFds[2] = {-1, -1};
+        std::vector<std::unique_ptr<Worker>> workers;
+        std::thread poller;
+};
+
+#endif
@@ -0,0 +1,332 @@
+#include "../headr/autotune.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <unistd.h>
+
+namespace
+{
+    namespace fs = std::filesystem;
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     *
+     * @brief: cache key of a layer shape, everything that changes which candidate wins
+     *
+     */
+    template <typename NodeType>
+    std::string shapeKey(const NetworkLayer<NodeType>& layer, size_t rows)
+    {
+        std::ostringstream key;
+        key << (isLstmNode<NodeType> ? "lstm" : isGruNode<NodeType> ? "gru" : "base") << ' '
+            << layer.getPrivMemberLayerNodes().size() << 'x' << layer.getFanIn() << ' '
+            << (layer.getPrecision() == Precision::BF16 ? "bf16" : layer.getPrecision() == Precision::FP16 ? "fp16" : "full")
+            << ' ' << (layer.isSparse() ? "sparse" : "dense") << " rows" << rows
+            << " pool" << (layer.getPool() == nullptr ? 0 : layer.getPool()->size());
+        return key.str();
+    }
+
+    /**
+     *
+     * @brief: the candidate grid of a layer, the default tuning first, without settings the kernel ignores
+     *
+     */
+    template <typename NodeType>
+    std::vector<LayerTuning> candidates(const NetworkLayer<NodeType>& layer, size_t rows, const AutotuneConfig& config)
+    {
+        ThreadPool* pool = layer.getPool();
+        bool halfKernels = layer.getPrecision() != Precision::Full && !layer.isSparse();
+        std::vector<LayerTuning> grid = {LayerTuning{}};
+        for (size_t tile : rows > 1 ? config.batchTiles : std::vector<size_t>{0})
+        {
+            // a tile as large as the batch is one block
+            tile = tile >= rows ? 0 : tile;
+            // forwardBatch only splits a batch of several blocks, forward splits the nodes
+            bool split = pool != nullptr && (rows == 1 || tile != 0);
+            for (size_t threads : split ? config.threads : std::vector<size_t>{1})
+            {
+                threads = split && threads != 0 ? std::min(threads, pool->size()) : threads;
+                bool chunked = split && threads != 1;
+                for (size_t chunks : chunked ? config.chunksPerThread : std::vector<size_t>{LayerTuning{}.chunksPerThread})
+                {
+                    for (size_t unroll : halfKernels ? config.unrolls : std::vector<size_t>{LayerTuning{}.unroll})
+                    {
+                        LayerTuning tuning{tile, threads, chunks, unroll};
+                        if (std::find(grid.begin(), grid.end(), tuning) == grid.end())
+                        {
+                            grid.push_back(tuning);
+                        }
+                    }
+                }
+            }
+        }
+        return grid;
+    }
+}
+
+/**
+ *
+ * @brief: key of this host in the tuning cache, host name, CPU model and hardware threads
+ *
+ * @note: the CPU model comes from /proc/cpuinfo where there is one, tabs and newlines are replaced so the
+ *          key fits on one cache line
+ *
+ */
+std::string autotuneHostKey()
+{
+    char name[256] = {};
+    if (gethostname(name, sizeof(name) - 1) != 0)
+    {
+        name[0] = '\0';
+    }
+    std::string cpu = "unknown cpu";
+    std::ifstream info("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(info, line))
+    {
+        if (line.rfind("model name", 0) == 0 && line.find(':') != std::string::npos)
+        {
+            cpu = line.substr(line.find(':') + 1);
+            cpu.erase(0, cpu.find_first_not_of(' '));
+            break;
+        }
+    }
+    std::string key = std::string(name) + " / " + cpu + " / " + std::to_string(std::thread::hardware_concurrency());
+    std::replace_if(key.begin(), key.end(), [](char c) { return c == '\t' || c == '\n' || c == '\r'; }, ' ');
+    return key;
+}
+
+/**
+ *
+ * @brief: constructor, reads the cache file when there is one
+ *
+ * @param: config .
+ * type: AutotuneConfig, grid, timing effort and cache path
+ * @param: host .
+ * type: std::string, host key, defaults to autotuneHostKey()
+ *
+ */
+Autotuner::Autotuner(AutotuneConfig config, std::string host) : config(std::move(config)), host(std::move(host))
+{
+    if (this->config.repeats == 0 || this->config.rounds == 0 || this->config.batch == 0)
+    {
+        throw std::invalid_argument("Autotuner needs at least one repeat, round and batch row");
+    }
+    load();
+}
+
+/**
+ *
+ * @brief: reads the cache, one "host<TAB>shape<TAB>batchTile threads chunksPerThread unroll" per line
+ *
+ * @note: a missing file is an empty cache, malformed lines are dropped and get tuned again
+ *
+ */
+void Autotuner::load()
+{
+    if (config.cachePath.empty())
+    {
+        return;
+    }
+    std::ifstream file(config.cachePath);
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+        size_t first = line.find('\t');
+        size_t second = first == std::string::npos ? first : line.find('\t', first + 1);
+        if (second == std::string::npos)
+        {
+            continue;
+        }
+        LayerTuning tuning;
+        std::istringstream values(line.substr(second + 1));
+        if (!(values >> tuning.batchTile >> tuning.threads >> tuning.chunksPerThread >> tuning.unroll)
+            || tuning.chunksPerThread == 0 || (tuning.unroll != 4 && tuning.unroll != 8 && tuning.unroll != 16))
+        {
+            continue;
+        }
+        entries[line.substr(0, first)][line.substr(first + 1, second - first - 1)] = tuning;
+    }
+}
+
+/**
+ *
+ * @brief: writes every entry, this host's and the others', to the cache file
+ *
+ * @note: written next to the cache and renamed into place, so a reader never sees half a file
+ *
+ */
+void Autotuner::save() const
+{
+    if (config.cachePath.empty())
+    {
+        return;
+    }
+    fs::path path(config.cachePath);
+    fs::path temporary = path;
+    temporary += ".tmp";
+    {
+        std::ofstream file(temporary);
+        if (!file)
+        {
+            throw std::runtime_error("Could not write tuning cache " + temporary.string());
+        }
+        file << "# layer autotune cache: host<TAB>shape<TAB>batchTile threads chunksPerThread unroll\n";
+        for (const auto& [hostKey, shapes] : entries)
+        {
+            for (const auto& [shape, tuning] : shapes)
+            {
+                file << hostKey << '\t' << shape << '\t' << tuning.batchTile << ' ' << tuning.threads << ' '
+                     << tuning.chunksPerThread << ' ' << tuning.unroll << '\n';
+            }
+        }
+    }
+    fs::rename(temporary, path);
+}
+
+/**
+ *
+ * @brief: winner for the shape of layer, from the cache or timed over the candidate grid
+ *
+ * @note: recurrent layers are timed on forwardBatch with caller owned state, so the node state is never
+ *          touched, feedforward layers on the single row forward the classifier runs
+ *
+ */
+template <typename NodeType>
+const LayerTuning& Autotuner::tuneLayer(NetworkLayer<NodeType>& layer, size_t rows, AutotuneReport& report)
+{
+    std::string shape = shapeKey(layer, rows);
+    std::map<std::string, LayerTuning>& known = entries[host];
+    auto found = known.find(shape);
+    bool seen = std::any_of(report.shapes.begin(), report.shapes.end(),
+                            [&](const AutotuneEntry& entry) { return entry.shape == shape; });
+    if (found != known.end() && (seen || !config.retune))
+    {
+        if (!seen)
+        {
+            report.shapes.push_back(AutotuneEntry{shape, found->second, 0.0, 0.0, true});
+            ++report.cacheHits;
+        }
+        return found->second;
+    }
+
+    constexpr bool recurrent = isLstmNode<NodeType> || isGruNode<NodeType>;
+    size_t numNodes = layer.getPrivMemberLayerNodes().size();
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<double> dis(-1.0, 1.0);
+    std::vector<double> inputs(rows * layer.getFanIn());
+    for (double& val : inputs)
+    {
+        val = dis(gen);
+    }
+    std::vector<double> stm(rows * numNodes, 0.0);
+    std::vector<double> ltm(rows * numNodes, 0.0);
+    ExecContext ctx;
+    auto call = [&]
+    {
+        if constexpr (recurrent)
+        {
+            layer.forwardBatch(ctx, inputs, rows, stm, ltm);
+        }
+        else
+        {
+            layer.forward(ctx, inputs);
+        }
+        ctx.endBatch();
+    };
+
+    std::vector<LayerTuning> grid = candidates(layer, rows, config);
+    std::vector<double> best(grid.size(), 0.0);
+    for (size_t round = 0; round < config.rounds; ++round)
+    {
+        for (size_t c = 0; c < grid.size(); ++c)
+        {
+            layer.setTuning(grid[c]);
+            call();
+            Clock::time_point begin = Clock::now();
+            for (size_t r = 0; r < config.repeats; ++r)
+            {
+                call();
+            }
+            double perCall = std::chrono::duration<double>(Clock::now() - begin).count()
+                             / static_cast<double>(config.repeats);
+            best[c] = round == 0 ? perCall : std::min(best[c], perCall);
+        }
+    }
+    size_t winner = static_cast<size_t>(std::min_element(best.begin(), best.end()) - best.begin());
+    report.shapes.push_back(AutotuneEntry{shape, grid[winner], best[winner], best[0], false});
+    known[shape] = grid[winner];
+    return known[shape];
+}
+
+/**
+ *
+ * @brief: tunes the layers of one network, the cache is not written
+ *
+ * @param: classifier .
+ * type: Classifier&, timed on the single row forward
+ * @param: report .
+ * type: AutotuneReport&, receives the winners
+ *
+ */
+void Autotuner::tune(Classifier& classifier, AutotuneReport& report)
+{
+    for (auto& layer : classifier.getLayers())
+    {
+        layer->setTuning(tuneLayer(*layer, 1, report));
+        ++report.layers;
+    }
+}
+
+/**
+ *
+ * @brief: tunes the layers of one network, the cache is not written
+ *
+ * @param: listener .
+ * type: Listener&, timed on forwardBatch with config.batch rows
+ * @param: report .
+ * type: AutotuneReport&, receives the winners
+ *
+ */
+void Autotuner::tune(Listener& listener, AutotuneReport& report)
+{
+    for (auto& layer : listener.getLayers())
+    {
+        layer->setTuning(tuneLayer(*layer, config.batch, report));
+        ++report.layers;
+    }
+}
+
+/**
+ *
+ * @brief: tunes every layer of the model and writes the cache when anything was timed
+ *
+ * @param: model .
+ * type: CompositeModel&, layers must already have their precision and pool set
+ * @return: AutotuneReport .
+ * winners, cache hits and time spent
+ *
+ */
+AutotuneReport Autotuner::tune(CompositeModel& model)
+{
+    Clock::time_point begin = Clock::now();
+    AutotuneReport report;
+    report.host = host;
+    tune(model.getClassifier(), report);
+    tune(model.getListener(), report);
+    if (report.cacheHits < report.shapes.size())
+    {
+        save();
+    }
+    report.seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+    return report;
+}
@@ -0,0 +1,444 @@
+#include "../headr/earlyexit.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <stdexcept>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double sigmoid(double z) noexcept
+    {
+        return 1.0 / (1.0 + std::exp(-z));
+    }
+
+    void checkLabels(const std::vector<std::vector<double>>& tracks, std::span<const double> labels)
+    {
+        if (tracks.size() != labels.size() || tracks.empty())
+        {
+            throw std::invalid_argument("Early exit needs one label per track and at least one track");
+        }
+    }
+}
+
+/**
+ *
+ * @brief: adds the next frequency, O(1), the interval statistics follow IntervalTracker::push
+ *
+ * @param: freq .
+ * type: double, frequency in Hz, a non positive (silent / unvoiced) or non finite frame gives a zero interval
+ *          and holds the previous pitch, like the model path
+ *
+ */
+void EarlyExitClassifier::State::push(double freq) noexcept
+{
+    if (!(freq > 0.0) || !std::isfinite(freq))
+    {
+        interval = 0.0;
+        return;
+    }
+    if (count > 0)
+    {
+        double ratio = std::max(freq, last) / std::min(freq, last);
+        IntervalTracker::Interval cls = IntervalTracker::classify(ratio);
+        ++counts[static_cast<size_t>(cls)];
+        consonant += IntervalTracker::isConsonant(cls) ? 1 : 0;
+        intervalScore += IntervalTracker::pairScore(ratio);
+        interval = intervalOctaves(last, freq);
+    }
+    sum += normalizeFrequency(freq);
+    last = freq;
+    ++count;
+}
+
+/**
+ *
+ * @brief: writes the numStateFeatures head inputs
+ *
+ */
+void EarlyExitClassifier::State::features(std::span<double> out) const
+{
+    size_t intervals = count > 0 ? count - 1 : 0;
+    double entropy = 0.0;
+    if (intervals > 0)
+    {
+        double n = static_cast<double>(intervals);
+        for (size_t c : counts)
+        {
+            if (c > 0)
+            {
+                double share = static_cast<double>(c) / n;
+                entropy -= share * std::log(share);
+            }
+        }
+    }
+    out[0] = entropy / std::log(static_cast<double>(IntervalTracker::numClasses));
+    out[1] = intervals == 0 ? 0.0 : static_cast<double>(consonant) / static_cast<double>(intervals);
+    out[2] = intervals == 0 ? 0.0 : intervalScore / static_cast<double>(intervals);
+    out[3] = count == 0 ? 0.0 : sum / static_cast<double>(count);
+    out[4] = normalizeFrequency(last);
+    out[5] = std::abs(interval);
+}
+
+/**
+ *
+ * @brief: constructor, the heads start at zero and never exit until fit or setThreshold
+ *
+ * @param: classifier .
+ * type: Classifier&, final exit, with no channels or the IntervalTracker ones
+ * @param: exits .
+ * type: std::vector<size_t>, strictly increasing steps in [1, window)
+ *
+ */
+EarlyExitClassifier::EarlyExitClassifier(Classifier& classifier, std::vector<size_t> exits)
+        : classifier(classifier)
+{
+    size_t window = static_cast<size_t>(classifier.getNumInputs());
+    if (classifier.getNumChannels() != 0 && classifier.getNumChannels() != static_cast<int>(IntervalTracker::numChannels))
+    {
+        throw std::invalid_argument("Early exit classifier takes no channels or the interval channels");
+    }
+    if (exits.empty() || exits.front() == 0 || exits.back() >= window
+        || std::adjacent_find(exits.begin(), exits.end(), std::greater_equal<size_t>()) != exits.end())
+    {
+        throw std::invalid_argument("Exit steps must be strictly increasing and inside the classifier window");
+    }
+    for (size_t step : exits)
+    {
+        Head head;
+        head.step = step;
+        heads.push_back(head);
+    }
+}
+
+/**
+ *
+ * @brief: logit of a head on a state
+ *
+ */
+double EarlyExitClassifier::logit(const Head& head, std::span<const double> state) noexcept
+{
+    double z = head.bias;
+    for (size_t f = 0; f < numStateFeatures; ++f)
+    {
+        z += head.weights[f] * state[f];
+    }
+    return z;
+}
+
+/**
+ *
+ * @brief: streams every track once and keeps the state at every exit step
+ *
+ */
+std::vector<double> EarlyExitClassifier::collect(const std::vector<std::vector<double>>& tracks,
+                                                 std::span<const double> labels) const
+{
+    checkLabels(tracks, labels);
+    size_t window = static_cast<size_t>(classifier.getNumInputs());
+    std::vector<double> states(tracks.size() * heads.size() * numStateFeatures);
+    for (size_t t = 0; t < tracks.size(); ++t)
+    {
+        if (tracks[t].size() < window)
+        {
+            throw std::invalid_argument("Track is shorter than the classifier window");
+        }
+        State state;
+        size_t next = 0;
+        for (size_t step = 1; next < heads.size(); ++step)
+        {
+            state.push(tracks[t][step - 1]);
+            if (heads[next].step == step)
+            {
+                state.features({states.data() + (t * heads.size() + next) * numStateFeatures, numStateFeatures});
+                ++next;
+            }
+        }
+    }
+    return states;
+}
+
+/**
+ *
+ * @brief: trains every head by full batch logistic regression on the state at its step
+ *
+ * @param: tracks .
+ * type: const std::vector<std::vector<double>>&, at least window seconds each
+ * @param: labels .
+ * type: std::span<const double>, 1 for consonant, 0 for dissonant
+ * @param: epochs .
+ * type: size_t, gradient steps per head
+ * @param: learningRate .
+ * type: double, step size
+ *
+ */
+void EarlyExitClassifier::fit(const std::vector<std::vector<double>>& tracks, std::span<const double> labels,
+                              size_t epochs, double learningRate)
+{
+    std::vector<double> states = collect(tracks, labels);
+    double scale = 1.0 / static_cast<double>(tracks.size());
+    for (size_t e = 0; e < heads.size(); ++e)
+    {
+        Head& head = heads[e];
+        head.weights.fill(0.0);
+        head.bias = 0.0;
+        for (size_t epoch = 0; epoch < epochs; ++epoch)
+        {
+            std::array<double, numStateFeatures> grad{};
+            double gradBias = 0.0;
+            for (size_t t = 0; t < tracks.size(); ++t)
+            {
+                std::span<const double> state(states.data() + (t * heads.size() + e) * numStateFeatures,
+                                              numStateFeatures);
+                double error = sigmoid(logit(head, state)) - labels[t];
+                for (size_t f = 0; f < numStateFeatures; ++f)
+                {
+                    grad[f] += error * state[f];
+                }
+                gradBias += error;
+            }
+            for (size_t f = 0; f < numStateFeatures; ++f)
+            {
+                head.weights[f] -= learningRate * scale * grad[f];
+            }
+            head.bias -= learningRate * scale * gradBias;
+        }
+    }
+}
+
+/**
+ *
+ * @brief: Platt scales every head and sets its threshold on held out tracks
+ *
+ * @param: tracks .
+ * type: const std::vector<std::vector<double>>&, not the ones fit on
+ * @param: labels .
+ * type: std::span<const double>, 1 for consonant, 0 for dissonant
+ * @param: targetAccuracy .
+ * type: double, in (0.5, 1], accuracy a head must keep on what it answers
+ *
+ * @note: the scale a and shift c of sigmoid(a * z + c) come from a few Newton steps on the log loss and
+ *          are folded into the head, so a calibrated head costs the same as before. Each head is thresholded
+ *          on all held out tracks, not only the ones earlier heads let through
+ *
+ */
+void EarlyExitClassifier::calibrate(const std::vector<std::vector<double>>& tracks, std::span<const double> labels,
+                                    double targetAccuracy)
+{
+    if (!(targetAccuracy > 0.5 && targetAccuracy <= 1.0))
+    {
+        throw std::invalid_argument("Target accuracy must be in (0.5, 1]");
+    }
+    std::vector<double> states = collect(tracks, labels);
+    std::vector<double> logits(tracks.size());
+    std::vector<std::pair<double, bool>> ranked(tracks.size());
+    for (size_t e = 0; e < heads.size(); ++e)
+    {
+        Head& head = heads[e];
+        for (size_t t = 0; t < tracks.size(); ++t)
+        {
+            logits[t] = logit(head, {states.data() + (t * heads.size() + e) * numStateFeatures, numStateFeatures});
+        }
+
+        // Newton on (a, c), a small ridge keeps the system solvable when every logit is the same
+        double a = 1.0;
+        double c = 0.0;
+        for (int iter = 0; iter < 25; ++iter)
+        {
+            double ga = 0.0, gc = 0.0, haa = 1e-6, hac = 0.0, hcc = 1e-6;
+            for (size_t t = 0; t < tracks.size(); ++t)
+            {
+                double p = sigmoid(a * logits[t] + c);
+                double w = p * (1.0 - p);
+                ga += (p - labels[t]) * logits[t];
+                gc += p - labels[t];
+                haa += w * logits[t] * logits[t];
+                hac += w * logits[t];
+                hcc += w;
+            }
+            double det = haa * hcc - hac * hac;
+            if (!(det > 0.0))
+            {
+                break;
+            }
+            a -= (hcc * ga - hac * gc) / det;
+            c -= (haa * gc - hac * ga) / det;
+        }
+        for (double& weight : head.weights)
+        {
+            weight *= a;
+        }
+        head.bias = a * head.bias + c;
+
+        // most confident first, the threshold ends the longest prefix that is still accurate enough
+        for (size_t t = 0; t < tracks.size(); ++t)
+        {
+            double p = sigmoid(a * logits[t] + c);
+            ranked[t] = {std::max(p, 1.0 - p), (p >= 0.5) == (labels[t] >= 0.5)};
+        }
+        std::sort(ranked.begin(), ranked.end(), [](const auto& x, const auto& y) { return x.first > y.first; });
+        head.threshold = 2.0;
+        size_t correct = 0;
+        for (size_t k = 0; k < ranked.size(); ++k)
+        {
+            correct += ranked[k].second ? 1 : 0;
+            bool tieAhead = k + 1 < ranked.size() && ranked[k + 1].first == ranked[k].first;
+            if (!tieAhead && static_cast<double>(correct) >= targetAccuracy * static_cast<double>(k + 1))
+            {
+                head.threshold = ranked[k].first;
+            }
+        }
+    }
+}
+
+void EarlyExitClassifier::setThreshold(double threshold) noexcept
+{
+    for (Head& head : heads)
+    {
+        head.threshold = threshold;
+    }
+}
+
+/**
+ *
+ * @brief: full classifier on the window, with the tracker channels when the classifier takes them
+ *
+ */
+double EarlyExitClassifier::classifyFull(ExecContext& ctx, std::span<const double> window)
+{
+    if (classifier.getNumChannels() == 0)
+    {
+        return classifier.predict(ctx, window);
+    }
+    IntervalTracker tracker;
+    for (double freq : window)
+    {
+        tracker.push(freq);
+    }
+    std::span<double> channels = ctx.scratch(IntervalTracker::numChannels);
+    tracker.channels(channels);
+    return classifier.predict(ctx, window, channels);
+}
+
+/**
+ *
+ * @brief: reads the sequence until a head is confident, falls back to the full classifier
+ *
+ * @param: ctx .
+ * type: ExecContext&, per batch arena, only used by the full classifier
+ * @param: frequencies .
+ * type: span<const double>, one frequency per second, may be shorter than the window
+ * @return: EarlyExitDecision .
+ * probability, seconds read and the exit taken
+ *
+ */
+EarlyExitDecision EarlyExitClassifier::classify(ExecContext& ctx, std::span<const double> frequencies)
+{
+    size_t window = static_cast<size_t>(classifier.getNumInputs());
+    if (frequencies.size() < heads.front().step)
+    {
+        throw std::invalid_argument("Sequence ends before the first exit");
+    }
+    State state;
+    std::array<double, numStateFeatures> features;
+    EarlyExitDecision decision;
+    size_t next = 0;
+    for (size_t step = 1; step <= std::min(frequencies.size(), window) && next < heads.size(); ++step)
+    {
+        state.push(frequencies[step - 1]);
+        if (heads[next].step != step)
+        {
+            continue;
+        }
+        state.features(features);
+        decision.probability = sigmoid(logit(heads[next], features));
+        decision.steps = step;
+        decision.exit = next;
+        if (std::max(decision.probability, 1.0 - decision.probability) >= heads[next].threshold)
+        {
+            decision.confident = true;
+            return decision;
+        }
+        ++next;
+    }
+    if (frequencies.size() < window)
+    {
+        return decision;
+    }
+    decision.probability = classifyFull(ctx, frequencies.first(window));
+    decision.steps = window;
+    decision.exit = heads.size();
+    decision.confident = true;
+    return decision;
+}
+
+/**
+ *
+ * @brief: classifies every track, timing each decision, and compares with the full classifier
+ *
+ * @param: ctx .
+ * type: ExecContext&, per batch arena, reset after every track
+ * @param: tracks .
+ * type: const std::vector<std::vector<double>>&, at least window seconds each
+ * @param: labels .
+ * type: std::span<const double>, 1 for consonant, 0 for dissonant
+ * @return: EarlyExitReport .
+ * per exit accuracy and latency
+ *
+ */
+EarlyExitReport EarlyExitClassifier::evaluate(ExecContext& ctx, const std::vector<std::vector<double>>& tracks,
+                                              std::span<const double> labels)
+{
+    checkLabels(tracks, labels);
+    size_t window = static_cast<size_t>(classifier.getNumInputs());
+    EarlyExitReport report;
+    report.exits.resize(heads.size() + 1);
+    for (size_t e = 0; e < heads.size(); ++e)
+    {
+        report.exits[e].step = heads[e].step;
+    }
+    report.exits.back().step = window;
+
+    size_t correct = 0;
+    size_t fullCorrect = 0;
+    size_t steps = 0;
+    double seconds = 0.0;
+    double fullSeconds = 0.0;
+    for (size_t t = 0; t < tracks.size(); ++t)
+    {
+        if (tracks[t].size() < window)
+        {
+            throw std::invalid_argument("Track is shorter than the classifier window");
+        }
+        bool label = labels[t] >= 0.5;
+
+        Clock::time_point begin = Clock::now();
+        EarlyExitDecision decision = classify(ctx, tracks[t]);
+        double elapsed = std::chrono::duration<double>(Clock::now() - begin).count();
+        ctx.endBatch();
+        ExitStats& stats = report.exits[decision.exit];
+        bool right = (decision.probability >= 0.5) == label;
+        ++stats.taken;
+        stats.correct += right ? 1 : 0;
+        stats.seconds += elapsed;
+        stats.maxSeconds = std::max(stats.maxSeconds, elapsed);
+        correct += right ? 1 : 0;
+        steps += decision.steps;
+        seconds += elapsed;
+
+        begin = Clock::now();
+        double full = classifyFull(ctx, std::span<const double>(tracks[t]).first(window));
+        fullSeconds += std::chrono::duration<double>(Clock::now() - begin).count();
+        ctx.endBatch();
+        fullCorrect += (full >= 0.5) == label ? 1 : 0;
+    }
+    double count = static_cast<double>(tracks.size());
+    report.accuracy = static_cast<double>(correct) / count;
+    report.fullAccuracy = static_cast<double>(fullCorrect) / count;
+    report.meanSteps = static_cast<double>(steps) / count;
+    report.meanSeconds = seconds / count;
+    report.fullSeconds = fullSeconds / count;
+    return report;
+}
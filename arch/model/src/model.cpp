@@ -0,0 +1,443 @@
+#include "../headr/model.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+/**
+ *
+ * @brief: maps a frequency to octaves relative to A4 so the model sees values around [-1, 1]
+ *
+ */
+double normalizeFrequency(double hz) noexcept
+{
+    return hz > 0.0 ? std::log2(hz / 440.0) : 0.0;
+}
+
+/**
+ *
+ * @brief: interval from prev to hz in octaves, a 0 Hz step would otherwise feed -inf / NaN into the listener
+ *
+ */
+double intervalOctaves(double prev, double hz) noexcept
+{
+    return prev > 0.0 && hz > 0.0 ? std::log2(hz / prev) : 0.0;
+}
+
+/**
+ *
+ * @brief: constructor
+ *
+ * @param: numInputs .
+ * type: int, number of frequencies per sequence
+ * @param: hiddenSizes .
+ * type: const std::vector<int>&, width of every hidden layer
+ * @param: numChannels .
+ * type: int, extra feature channels read after the frequencies
+ *
+ */
+Classifier::Classifier(int numInputs, const std::vector<int>& hiddenSizes, int numChannels)
+        : numInputs(numInputs), numChannels(numChannels), layers()
+{
+    if (numInputs <= 0 || numChannels < 0)
+    {
+        throw std::invalid_argument("Classifier needs at least one input");
+    }
+    std::vector<int> sizes = hiddenSizes;
+    // single output node for the binary decision
+    sizes.push_back(1);
+    for (int size : sizes)
+    {
+        NetworkLayer<BaseNode>* prev = layers.empty() ? nullptr : layers.back().get();
+        layers.push_back(std::make_unique<NetworkLayer<BaseNode>>(size, BaseNode(), prev == nullptr, prev,
+                                                                  numInputs + numChannels));
+    }
+}
+
+/**
+ *
+ * @brief: normalised frequencies followed by the raw channels, in the arena
+ *
+ */
+std::span<double> Classifier::inputs(ExecContext& ctx, std::span<const double> frequencies,
+                                     std::span<const double> channels) const
+{
+    if (frequencies.size() != static_cast<size_t>(numInputs) || channels.size() != static_cast<size_t>(numChannels))
+    {
+        throw std::invalid_argument("Classifier input length mismatch");
+    }
+    std::span<double> values = ctx.scratch(frequencies.size() + channels.size());
+    for (size_t i = 0; i < frequencies.size(); ++i)
+    {
+        values[i] = normalizeFrequency(frequencies[i]);
+    }
+    std::copy(channels.begin(), channels.end(), values.begin() + static_cast<long>(frequencies.size()));
+    return values;
+}
+
+/**
+ *
+ * @brief: probability that the sequence is consonant
+ *
+ */
+double Classifier::predict(ExecContext& ctx, std::span<const double> frequencies, std::span<const double> channels)
+{
+    std::span<double> activations = inputs(ctx, frequencies, channels);
+    for (auto& layer : layers)
+    {
+        activations = layer->forward(ctx, activations);
+    }
+    // tanh output mapped onto a probability
+    return 0.5 * (activations[0] + 1.0);
+}
+
+/**
+ *
+ * @brief: same as predict, through a plan made by compile()
+ *
+ * @param: plan .
+ * type: ExecutionPlan&, compiled from this classifier
+ *
+ */
+double Classifier::predict(ExecContext& ctx, ExecutionPlan& plan, std::span<const double> frequencies,
+                           std::span<const double> channels)
+{
+    return 0.5 * (plan.run(inputs(ctx, frequencies, channels))[0] + 1.0);
+}
+
+/**
+ *
+ * @brief: compiles the layer stack into a static execution plan, one fused kernel per layer
+ *
+ */
+ExecutionPlan Classifier::compile()
+{
+    GraphBuilder builder;
+    builder.input("frequencies", static_cast<size_t>(numInputs + numChannels));
+    std::string prev = "frequencies";
+    for (size_t i = 0; i < layers.size(); ++i)
+    {
+        std::string name = "layer" + std::to_string(i);
+        builder.dense(name, prev, *layers[i]);
+        prev = name;
+    }
+    return builder.output(prev).compile();
+}
+
+/**
+ *
+ * @brief: registers every layer's parameters with the model wide buffer
+ *
+ */
+void Classifier::registerParams(ParamBuffer& buffer)
+{
+    for (auto& layer : layers)
+    {
+        layer->registerParams(buffer);
+    }
+}
+
+/**
+ *
+ * @brief: constructor
+ *
+ * @param: numInputs .
+ * type: int, features per timestep
+ * @param: hiddenSizes .
+ * type: const std::vector<int>&, width of every stacked LSTM layer
+ *
+ */
+Listener::Listener(int numInputs, const std::vector<int>& hiddenSizes)
+        : layers(), readoutWeights(), readoutBias(0.0)
+{
+    if (hiddenSizes.empty())
+    {
+        throw std::invalid_argument("Listener needs at least one LSTM layer");
+    }
+    for (int size : hiddenSizes)
+    {
+        NetworkLayer<LstmNode>* prev = layers.empty() ? nullptr : layers.back().get();
+        layers.push_back(std::make_unique<NetworkLayer<LstmNode>>(size, LstmNode(), prev == nullptr, prev, numInputs));
+    }
+
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_real_distribution<> dis(-1.0, 1.0);
+    readoutWeights.resize(hiddenSizes.back());
+    for (double& weight : readoutWeights)
+    {
+        weight = dis(gen);
+    }
+    readoutBias = dis(gen);
+}
+
+/**
+ *
+ * @brief: advances every layer one timestep
+ *
+ */
+double Listener::step(ExecContext& ctx, std::span<const double> features, std::span<double> hidden)
+{
+    std::span<const double> activations = features;
+    for (auto& layer : layers)
+    {
+        activations = layer->forward(ctx, activations);
+    }
+    if (!hidden.empty())
+    {
+        if (hidden.size() != activations.size())
+        {
+            throw std::invalid_argument("Hidden output does not match the top layer");
+        }
+        std::copy(activations.begin(), activations.end(), hidden.begin());
+    }
+    double sum = readoutBias;
+    for (size_t i = 0; i < readoutWeights.size(); ++i)
+    {
+        sum += readoutWeights[i] * activations[i];
+    }
+    return 1.0 / (1.0 + std::exp(-sum));
+}
+
+/**
+ *
+ * @brief: runs a packed batch of sequences, every sequence starts from a zero cell state
+ *
+ */
+std::span<double> Listener::runPacked(ExecContext& ctx, const PackedBatch& batch)
+{
+    if (batch.numFeatures != static_cast<size_t>(layers.front()->getPrivMemberLayerNodes()[0].getWeightVecSize()))
+    {
+        throw std::invalid_argument("Packed batch features do not match the listener inputs");
+    }
+    // sorted longest first, so the running sequences are always the leading rows of the state
+    size_t maxBatch = batch.numSteps() == 0 ? 0 : batch.batchSizes[0];
+    std::vector<std::span<double>> stm;
+    std::vector<std::span<double>> ltm;
+    for (auto& layer : layers)
+    {
+        size_t cells = maxBatch * layer->getPrivMemberLayerNodes().size();
+        stm.push_back(ctx.arena.alloc<double>(cells, 0.0));
+        ltm.push_back(ctx.arena.alloc<double>(cells, 0.0));
+    }
+
+    std::span<double> preferences = ctx.scratch(batch.rows());
+    for (size_t t = 0; t < batch.numSteps(); ++t)
+    {
+        size_t running = batch.batchSizes[t];
+        std::span<double> stepPreferences = stepBatch(ctx, batch.step(t), running, stm, ltm);
+        for (size_t k = 0; k < running; ++k)
+        {
+            preferences[batch.rowOf(k, t)] = stepPreferences[k];
+        }
+    }
+    return preferences;
+}
+
+/**
+ *
+ * @brief: advances rows independent sequences one timestep, the cell state lives with the caller
+ *
+ * @note: only reads the layers, so callers with their own context and state can share one listener
+ *
+ */
+std::span<double> Listener::stepBatch(ExecContext& ctx, std::span<const double> features, size_t rows,
+                                      std::span<const std::span<double>> stm, std::span<const std::span<double>> ltm)
+{
+    if (stm.size() != layers.size() || ltm.size() != layers.size())
+    {
+        throw std::invalid_argument("Listener state needs one STM and LTM per layer");
+    }
+    std::span<const double> activations = features;
+    for (size_t l = 0; l < layers.size(); ++l)
+    {
+        activations = layers[l]->forwardBatch(ctx, activations, rows, stm[l], ltm[l]);
+    }
+    std::span<double> preferences = ctx.scratch(rows);
+    size_t width = readoutWeights.size();
+    for (size_t k = 0; k < rows; ++k)
+    {
+        double sum = readoutBias;
+        for (size_t i = 0; i < width; ++i)
+        {
+            sum += readoutWeights[i] * activations[k * width + i];
+        }
+        preferences[k] = 1.0 / (1.0 + std::exp(-sum));
+    }
+    return preferences;
+}
+
+/**
+ *
+ * @brief: clears the STM / LTM of every cell before a new sequence
+ *
+ */
+void Listener::resetState() noexcept
+{
+    for (auto& layer : layers)
+    {
+        for (auto& node : layer->getPrivMemberLayerNodes())
+        {
+            node.getNode().LongTermState = 0.0;
+            node.getNode().ShortTermState = 0.0;
+        }
+    }
+}
+
+/**
+ *
+ * @brief: registers every layer's parameters and the readout with the model wide buffer
+ *
+ */
+void Listener::registerParams(ParamBuffer& buffer)
+{
+    for (auto& layer : layers)
+    {
+        layer->registerParams(buffer);
+    }
+    buffer.add(readoutWeights);
+    buffer.add(readoutBias);
+}
+
+/**
+ *
+ * @brief: registers classifier then listener parameters, bind the buffer afterwards
+ *
+ */
+void CompositeModel::registerParams(ParamBuffer& buffer)
+{
+    classifier.registerParams(buffer);
+    listener.registerParams(buffer);
+}
+
+CompositeModel::CompositeModel(int window, const std::vector<int>& classifierHidden,
+                               const std::vector<int>& listenerHidden, bool intervalChannels)
+        : intervalChannels(intervalChannels),
+          classifier(window, classifierHidden, intervalChannels ? static_cast<int>(IntervalTracker::numChannels) : 0),
+          listener(static_cast<int>(numListenerFeatures()), listenerHidden)
+{
+}
+
+size_t CompositeModel::numListenerFeatures() const noexcept
+{
+    return Listener::numFeatures + (intervalChannels ? IntervalTracker::numChannels : 0);
+}
+
+/**
+ *
+ * @brief: classifier output for the opening window, a cached one when the snapped window was seen before
+ *
+ */
+double CompositeModel::classify(ExecContext& ctx, std::span<const double> frequencies)
+{
+    std::span<const double> window = frequencies.first(static_cast<size_t>(classifier.getNumInputs()));
+    if (resultCache != nullptr)
+    {
+        return resultCache->getOrCompute(window, [&] { return classifyWindow(ctx, window); });
+    }
+    return classifyWindow(ctx, window);
+}
+
+/**
+ *
+ * @brief: classifier forward pass on the window, with the window's interval channels when enabled
+ *
+ */
+double CompositeModel::classifyWindow(ExecContext& ctx, std::span<const double> window)
+{
+    if (!intervalChannels)
+    {
+        return classifier.predict(ctx, window);
+    }
+    IntervalTracker tracker;
+    for (double freq : window)
+    {
+        tracker.push(freq);
+    }
+    std::span<double> channels = ctx.scratch(IntervalTracker::numChannels);
+    tracker.channels(channels);
+    return classifier.predict(ctx, window, channels);
+}
+
+/**
+ *
+ * @brief: classifies the sequence then lets the listener hear it second by second
+ *
+ */
+std::span<double> CompositeModel::run(ExecContext& ctx, std::span<const double> frequencies)
+{
+    size_t window = static_cast<size_t>(classifier.getNumInputs());
+    if (frequencies.size() < window)
+    {
+        throw std::invalid_argument("Track is shorter than the classifier window");
+    }
+    double consonant = classify(ctx, frequencies);
+
+    listener.resetState();
+    IntervalTracker tracker;
+    std::span<double> preferences = ctx.scratch(frequencies.size());
+    std::span<double> features = ctx.scratch(numListenerFeatures());
+    for (size_t t = 0; t < frequencies.size(); ++t)
+    {
+        features[0] = normalizeFrequency(frequencies[t]);
+        features[1] = t == 0 ? 0.0 : intervalOctaves(frequencies[t - 1], frequencies[t]);
+        features[2] = consonant;
+        if (intervalChannels)
+        {
+            tracker.push(frequencies[t]);
+            tracker.channels(features.subspan(Listener::numFeatures));
+        }
+        preferences[t] = listener.step(ctx, features);
+    }
+    return preferences;
+}
+
+/**
+ *
+ * @brief: runs tracks of different lengths together as one packed batch
+ *
+ */
+std::vector<std::span<double>> CompositeModel::runBatch(ExecContext& ctx, const std::vector<std::vector<double>>& tracks)
+{
+    size_t window = static_cast<size_t>(classifier.getNumInputs());
+    size_t numFeatures = numListenerFeatures();
+    std::vector<std::vector<double>> features(tracks.size());
+    for (size_t s = 0; s < tracks.size(); ++s)
+    {
+        const std::vector<double>& freqs = tracks[s];
+        if (freqs.size() < window)
+        {
+            throw std::invalid_argument("Track is shorter than the classifier window");
+        }
+        double consonant = classify(ctx, freqs);
+        std::vector<double> channels = intervalChannels ? ::intervalChannels(freqs) : std::vector<double>();
+        features[s].resize(freqs.size() * numFeatures);
+        for (size_t t = 0; t < freqs.size(); ++t)
+        {
+            double* row = features[s].data() + t * numFeatures;
+            row[0] = normalizeFrequency(freqs[t]);
+            row[1] = t == 0 ? 0.0 : intervalOctaves(freqs[t - 1], freqs[t]);
+            row[2] = consonant;
+            if (intervalChannels)
+            {
+                std::copy_n(channels.data() + t * IntervalTracker::numChannels, IntervalTracker::numChannels,
+                            row + Listener::numFeatures);
+            }
+        }
+    }
+
+    PackedBatch batch = packSequences(features, numFeatures);
+    std::span<double> packed = listener.runPacked(ctx, batch);
+
+    std::vector<std::span<double>> preferences(tracks.size());
+    for (size_t k = 0; k < batch.numSequences(); ++k)
+    {
+        std::span<double> track = ctx.scratch(batch.lengths[k]);
+        for (size_t t = 0; t < track.size(); ++t)
+        {
+            track[t] = packed[batch.rowOf(k, t)];
+        }
+        preferences[batch.order[k]] = track;
+    }
+    return preferences;
+}
@@ -0,0 +1,301 @@
+#include "../headr/population.h"
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+namespace
+{
+    using Act = LstmNode::ActivationPolicy;
+    using Gate = LstmNode::GatePolicy;
+    using Lane = Eigen::Map<Eigen::ArrayXd>;
+    using ConstLane = Eigen::Map<const Eigen::ArrayXd>;
+}
+
+/**
+ *
+ * @brief: every listener starts as base plus its own gaussian perturbation
+ *
+ * @param: base .
+ * type: Listener&, shape and starting weights
+ * @param: listeners .
+ * type: size_t, population size
+ * @param: spread .
+ * type: double, standard deviation of the per listener weight noise
+ * @param: seed .
+ * type: uint64_t, noise seed
+ *
+ */
+ListenerPopulation::ListenerPopulation(Listener& base, size_t listeners, double spread, uint64_t seed)
+        : listeners(listeners), numInputs(base.getLayers().front()->getFanIn())
+{
+    if (listeners == 0 || spread < 0.0)
+    {
+        throw std::invalid_argument("Population needs at least one listener and a non negative spread");
+    }
+    for (auto& stacked : base.getLayers())
+    {
+        Layer layer;
+        layer.nodes = stacked->getPrivMemberLayerNodes().size();
+        layer.fanIn = stacked->getFanIn();
+        size_t slots = 4 * layer.nodes;
+        layer.weights.resize(slots * layer.fanIn * listeners);
+        layer.recurrent.resize(slots * listeners);
+        layer.bias.resize(slots * listeners);
+        layer.stm.assign(layer.nodes * listeners, 0.0);
+        layer.ltm.assign(layer.nodes * listeners, 0.0);
+        layers.push_back(std::move(layer));
+    }
+    readoutWeights.resize(layers.back().nodes * listeners);
+    readoutBias.resize(listeners);
+    lastPreference.assign(listeners, 0.0);
+
+    for (size_t k = 0; k < listeners; ++k)
+    {
+        load(k, base);
+    }
+    if (spread > 0.0)
+    {
+        std::mt19937_64 gen(seed);
+        std::normal_distribution<double> noise(0.0, spread);
+        auto perturb = [&](std::vector<double>& lanes)
+        {
+            for (double& val : lanes)
+            {
+                val += noise(gen);
+            }
+        };
+        for (Layer& layer : layers)
+        {
+            perturb(layer.weights);
+            perturb(layer.recurrent);
+            perturb(layer.bias);
+        }
+        perturb(readoutWeights);
+        perturb(readoutBias);
+    }
+}
+
+/**
+ *
+ * @brief: replaces one listener's weights with those of model, its state is cleared
+ *
+ * @param: listener .
+ * type: size_t, index in the population
+ * @param: model .
+ * type: Listener&, same shape as the population
+ *
+ */
+void ListenerPopulation::load(size_t listener, Listener& model)
+{
+    auto& stacked = model.getLayers();
+    if (listener >= listeners || stacked.size() != layers.size())
+    {
+        throw std::invalid_argument("Listener does not fit the population");
+    }
+    std::vector<double> weights;
+    std::vector<double> recurrent;
+    std::vector<double> bias;
+    for (size_t l = 0; l < layers.size(); ++l)
+    {
+        Layer& layer = layers[l];
+        if (stacked[l]->getPrivMemberLayerNodes().size() != layer.nodes || stacked[l]->getFanIn() != layer.fanIn)
+        {
+            throw std::invalid_argument("Listener layer shape does not match the population");
+        }
+        size_t slots = 4 * layer.nodes;
+        weights.resize(slots * layer.fanIn);
+        recurrent.resize(slots);
+        bias.resize(slots);
+        stacked[l]->unpackWeights(weights, recurrent, bias);
+        for (size_t w = 0; w < weights.size(); ++w)
+        {
+            layer.weights[w * listeners + listener] = weights[w];
+        }
+        for (size_t slot = 0; slot < slots; ++slot)
+        {
+            layer.recurrent[slot * listeners + listener] = recurrent[slot];
+            layer.bias[slot * listeners + listener] = bias[slot];
+        }
+        for (size_t j = 0; j < layer.nodes; ++j)
+        {
+            layer.stm[j * listeners + listener] = 0.0;
+            layer.ltm[j * listeners + listener] = 0.0;
+        }
+    }
+    for (size_t i = 0; i < layers.back().nodes; ++i)
+    {
+        readoutWeights[i * listeners + listener] = model.getReadoutWeights()[i];
+    }
+    readoutBias[listener] = model.getReadoutBias();
+}
+
+/**
+ *
+ * @brief: clears every STM / LTM before a new stimulus
+ *
+ */
+void ListenerPopulation::resetState() noexcept
+{
+    for (Layer& layer : layers)
+    {
+        std::fill(layer.stm.begin(), layer.stm.end(), 0.0);
+        std::fill(layer.ltm.begin(), layer.ltm.end(), 0.0);
+    }
+    std::fill(lastPreference.begin(), lastPreference.end(), 0.0);
+}
+
+/**
+ *
+ * @brief: one block of listeners [first, first + count) through every step
+ *
+ * @param: sums .
+ * type: span<double>, per step sum, sum of squares and enjoying count of this block
+ * @param: pre .
+ * type: std::vector<double>&, caller's scratch for the gate pre activations
+ *
+ * @note: every expression below runs over the count lanes of one parameter, the same arithmetic as the
+ *          graph LSTM kernel done for many listeners at once
+ *
+ */
+void ListenerPopulation::runBlock(size_t first, size_t count, std::span<const double> features, std::span<double> sums,
+                                  std::vector<double>& pre)
+{
+    size_t steps = features.size() / numInputs;
+    Eigen::Index n = static_cast<Eigen::Index>(count);
+    for (size_t t = 0; t < steps; ++t)
+    {
+        std::span<const double> x = features.subspan(t * numInputs, numInputs);
+        for (size_t l = 0; l < layers.size(); ++l)
+        {
+            Layer& layer = layers[l];
+            const Layer* below = l == 0 ? nullptr : &layers[l - 1];
+            size_t slots = 4 * layer.nodes;
+            pre.resize(slots * count);
+            for (size_t slot = 0; slot < slots; ++slot)
+            {
+                Lane gate(pre.data() + slot * count, n);
+                size_t node = slot % layer.nodes;
+                gate = ConstLane(layer.bias.data() + slot * listeners + first, n)
+                       + ConstLane(layer.recurrent.data() + slot * listeners + first, n)
+                         * ConstLane(layer.stm.data() + node * listeners + first, n);
+                const double* w = layer.weights.data() + slot * layer.fanIn * listeners + first;
+                for (size_t i = 0; i < layer.fanIn; ++i, w += listeners)
+                {
+                    if (below == nullptr)
+                    {
+                        // the stimulus is the same for every listener
+                        gate += ConstLane(w, n) * x[i];
+                    }
+                    else
+                    {
+                        gate += ConstLane(w, n) * ConstLane(below->stm.data() + i * listeners + first, n);
+                    }
+                }
+            }
+            for (size_t j = 0; j < layer.nodes; ++j)
+            {
+                Lane ltm(layer.ltm.data() + j * listeners + first, n);
+                Lane stm(layer.stm.data() + j * listeners + first, n);
+                ConstLane forget(pre.data() + j * count, n);
+                ConstLane inSig(pre.data() + (layer.nodes + j) * count, n);
+                ConstLane inTanh(pre.data() + (2 * layer.nodes + j) * count, n);
+                ConstLane out(pre.data() + (3 * layer.nodes + j) * count, n);
+                ltm = ltm * Gate::apply(forget) + Gate::apply(inSig) * Act::apply(inTanh);
+                stm = Act::apply(ltm) * Gate::apply(out);
+            }
+        }
+
+        const Layer& top = layers.back();
+        Lane preference(lastPreference.data() + first, n);
+        preference = ConstLane(readoutBias.data() + first, n);
+        for (size_t i = 0; i < top.nodes; ++i)
+        {
+            preference += ConstLane(readoutWeights.data() + i * listeners + first, n)
+                          * ConstLane(top.stm.data() + i * listeners + first, n);
+        }
+        preference = 1.0 / (1.0 + (-preference).exp());
+        sums[3 * t] += preference.sum();
+        sums[3 * t + 1] += preference.square().sum();
+        sums[3 * t + 2] += static_cast<double>((preference > 0.5).count());
+    }
+}
+
+/**
+ *
+ * @brief: plays one stimulus to every listener, the state carries on from the previous call
+ *
+ * @param: features .
+ * type: span<const double>, steps rows of numInputs features heard by everyone
+ * @return: PopulationTrajectory .
+ * aggregate preference at every step
+ *
+ */
+PopulationTrajectory ListenerPopulation::run(std::span<const double> features)
+{
+    if (features.size() % numInputs != 0)
+    {
+        throw std::invalid_argument("Stimulus is not a whole number of feature rows");
+    }
+    size_t steps = features.size() / numInputs;
+    size_t blocks = (listeners + blockSize - 1) / blockSize;
+    std::vector<double> partial(blocks * steps * 3, 0.0);
+    auto body = [&](size_t, size_t begin, size_t end)
+    {
+        std::vector<double> pre;
+        for (size_t b = begin; b < end; ++b)
+        {
+            size_t first = b * blockSize;
+            runBlock(first, std::min(blockSize, listeners - first), features,
+                     std::span<double>(partial).subspan(b * steps * 3, steps * 3), pre);
+        }
+    };
+    if (pool == nullptr || blocks == 1)
+    {
+        body(0, 0, blocks);
+    }
+    else
+    {
+        pool->parallelFor(blocks, 4 * pool->size(), body);
+    }
+
+    PopulationTrajectory trajectory;
+    trajectory.mean.assign(steps, 0.0);
+    trajectory.stddev.assign(steps, 0.0);
+    trajectory.enjoying.assign(steps, 0.0);
+    double count = static_cast<double>(listeners);
+    for (size_t t = 0; t < steps; ++t)
+    {
+        double sum = 0.0;
+        double squares = 0.0;
+        double enjoying = 0.0;
+        for (size_t b = 0; b < blocks; ++b)
+        {
+            const double* block = partial.data() + b * steps * 3 + 3 * t;
+            sum += block[0];
+            squares += block[1];
+            enjoying += block[2];
+        }
+        double mean = sum / count;
+        trajectory.mean[t] = mean;
+        trajectory.stddev[t] = std::sqrt(std::max(0.0, squares / count - mean * mean));
+        trajectory.enjoying[t] = enjoying / count;
+    }
+    return trajectory;
+}
+
+/**
+ *
+ * @brief: bytes of weights and state held for the whole population
+ *
+ */
+size_t ListenerPopulation::bytes() const noexcept
+{
+    size_t values = readoutWeights.size() + readoutBias.size() + lastPreference.size();
+    for (const Layer& layer : layers)
+    {
+        values += layer.weights.size() + layer.recurrent.size() + layer.bias.size() + layer.stm.size() + layer.ltm.size();
+    }
+    return values * sizeof(double);
+}
@@ -0,0 +1,179 @@
+#include "../headr/resultcache.h"
+#include <climits>
+#include <cmath>
+#include <iterator>
+#include <stdexcept>
+
+namespace
+{
+    // splitmix64 finaliser, spreads every input bit over the word
+    uint64_t mix(uint64_t x) noexcept
+    {
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ULL;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+}
+
+/**
+ *
+ * @brief: constructor
+ *
+ * @param: config .
+ * type: ResultCacheConfig, capacity, shards, ttl and grid
+ *
+ */
+ResultCache::ResultCache(ResultCacheConfig config)
+        : config(config), numShards(config.shards), perShard(0)
+{
+    if (config.capacity == 0 || config.shards == 0 || config.stepsPerSemitone == 0)
+    {
+        throw std::invalid_argument("Result cache needs a positive capacity, shard count and grid");
+    }
+    if (config.ttl < std::chrono::steady_clock::duration::zero())
+    {
+        throw std::invalid_argument("Result cache ttl must not be negative");
+    }
+    perShard = (config.capacity + numShards - 1) / numShards;
+    shards = std::make_unique<Shard[]>(numShards);
+}
+
+/**
+ *
+ * @brief: key of a sequence, frequencies within half a grid step of the same point share it
+ *
+ * @param: frequencies .
+ * type: span<const double>, one frequency per second in Hz
+ * @return: Key .
+ * FNV-1a and a splitmix chain over the grid indices, both seeded with the length
+ *
+ */
+ResultCache::Key ResultCache::key(std::span<const double> frequencies) const noexcept
+{
+    double steps = 12.0 * static_cast<double>(config.stepsPerSemitone);
+    Key out;
+    out.first = 1469598103934665603ULL ^ frequencies.size();
+    out.second = mix(frequencies.size() + 0x9e3779b97f4a7c15ULL);
+    for (double freq : frequencies)
+    {
+        // silence and garbage all land on one point, off the grid of any real note
+        int64_t point = freq > 0.0 && std::isfinite(freq) ? std::llround(steps * std::log2(freq / 440.0)) : INT64_MIN;
+        uint64_t bits = static_cast<uint64_t>(point);
+        for (int b = 0; b < 8; ++b)
+        {
+            out.first ^= (bits >> (8 * b)) & 0xff;
+            out.first *= 1099511628211ULL;
+        }
+        out.second = mix(out.second ^ bits);
+    }
+    return out;
+}
+
+/**
+ *
+ * @brief: cached value of a key, refreshed as most recently used
+ *
+ * @param: key .
+ * type: const Key&, from key()
+ * @param: value .
+ * type: double&, set on a hit
+ * @return: bool .
+ * true on a hit
+ *
+ */
+bool ResultCache::lookup(const Key& key, double& value)
+{
+    Shard& shard = shardOf(key);
+    std::lock_guard<std::mutex> guard(shard.lock);
+    auto found = shard.index.find(key);
+    if (found == shard.index.end())
+    {
+        shard.misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    std::list<Entry>::iterator entry = found->second;
+    if (config.ttl != std::chrono::steady_clock::duration::zero()
+        && std::chrono::steady_clock::now() - entry->stored > config.ttl)
+    {
+        shard.lru.erase(entry);
+        shard.index.erase(found);
+        shard.expirations.fetch_add(1, std::memory_order_relaxed);
+        shard.misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    shard.lru.splice(shard.lru.begin(), shard.lru, entry);
+    value = entry->value;
+    shard.hits.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+/**
+ *
+ * @brief: stores a value, evicting the shard's least recently used entry when it is full
+ *
+ * @param: key .
+ * type: const Key&, from key()
+ * @param: value .
+ * type: double, classifier output
+ *
+ */
+void ResultCache::insert(const Key& key, double value)
+{
+    Shard& shard = shardOf(key);
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> guard(shard.lock);
+    auto found = shard.index.find(key);
+    if (found != shard.index.end())
+    {
+        found->second->value = value;
+        found->second->stored = now;
+        shard.lru.splice(shard.lru.begin(), shard.lru, found->second);
+        return;
+    }
+    if (shard.lru.size() >= perShard)
+    {
+        shard.index.erase(shard.lru.back().key);
+        // reuse the evicted node instead of freeing and allocating one
+        shard.lru.splice(shard.lru.begin(), shard.lru, std::prev(shard.lru.end()));
+        shard.lru.front() = Entry{key, value, now};
+        shard.evictions.fetch_add(1, std::memory_order_relaxed);
+    }
+    else
+    {
+        shard.lru.push_front(Entry{key, value, now});
+    }
+    shard.index.emplace(key, shard.lru.begin());
+}
+
+/**
+ *
+ * @brief: drops every entry, the counters are kept
+ *
+ */
+void ResultCache::clear()
+{
+    for (size_t s = 0; s < numShards; ++s)
+    {
+        std::lock_guard<std::mutex> guard(shards[s].lock);
+        shards[s].lru.clear();
+        shards[s].index.clear();
+    }
+}
+
+ResultCacheStats ResultCache::stats() const
+{
+    ResultCacheStats out;
+    for (size_t s = 0; s < numShards; ++s)
+    {
+        const Shard& shard = shards[s];
+        out.hits += shard.hits.load(std::memory_order_relaxed);
+        out.misses += shard.misses.load(std::memory_order_relaxed);
+        out.evictions += shard.evictions.load(std::memory_order_relaxed);
+        out.expirations += shard.expirations.load(std::memory_order_relaxed);
+        std::lock_guard<std::mutex> guard(shard.lock);
+        out.size += shard.lru.size();
+    }
+    return out;
+}
@@ -0,0 +1,650 @@
+#include "../headr/session.h"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdexcept>
+#include <unistd.h>
+
+/**
+ *
+ * @struct: Session -> one listening session, its source, audio buffer and listener state
+ *
+ * @note: the buffer is only touched by the poller while the session waits for audio and by the worker that
+ *          resumed it otherwise, the hand over goes through the scheduler mutex
+ *
+ */
+struct SessionScheduler::Session
+{
+    enum class Wait { Audio, Step };
+
+    size_t id = 0;
+    int fd = -1;
+    Task task;
+    Worker* worker = nullptr;
+    Wait waiting = Wait::Audio;
+
+    // raw PCM bytes read ahead, filled bytes from the front
+    std::vector<char> raw;
+    size_t filled = 0;
+    bool ended = false;
+    std::string readError;
+
+    // the second being extracted, the next step's features and its preference
+    std::vector<double> samples;
+    std::vector<double> features;
+    double preference = 0.0;
+    // every layer's STM then LTM, see stateOffsets
+    std::vector<double> state;
+
+    SessionResult result;
+};
+
+/**
+ *
+ * @struct: Worker -> one worker thread with its own frontend, arena and pending steps
+ *
+ */
+struct SessionScheduler::Worker
+{
+    Worker(double sampleRate, const HarmonicConfig& config) : extractor(sampleRate, config) {}
+
+    HarmonicExtractor extractor;
+    ExecContext ctx;
+    std::vector<Session*> pending;
+    std::vector<Session*> waiting;
+    std::vector<std::span<double>> stm;
+    std::vector<std::span<double>> ltm;
+    std::thread thread;
+};
+
+namespace
+{
+    // wakes the poller, a full pipe already holds a wake up so a failed write is fine
+    void wake(int fd) noexcept
+    {
+        char byte = 1;
+        [[maybe_unused]] ssize_t written = ::write(fd, &byte, 1);
+    }
+
+    void setNonBlocking(int fd)
+    {
+        int flags = ::fcntl(fd, F_GETFL);
+        if (flags < 0 || ::fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0)
+        {
+            throw std::runtime_error(std::string("Could not make descriptor non blocking: ") + std::strerror(errno));
+        }
+    }
+}
+
+bool SessionScheduler::SecondAwaiter::await_ready() const noexcept
+{
+    return session.ended || session.filled >= samples * sizeof(float);
+}
+
+void SessionScheduler::SecondAwaiter::await_suspend(std::coroutine_handle<>) noexcept
+{
+    session.waiting = Session::Wait::Audio;
+}
+
+/**
+ *
+ * @brief: decodes the oldest buffered second into samples, a trailing partial second is dropped
+ *
+ */
+bool SessionScheduler::SecondAwaiter::await_resume()
+{
+    size_t bytes = samples * sizeof(float);
+    if (session.filled < bytes)
+    {
+        return false;
+    }
+    for (size_t i = 0; i < samples; ++i)
+    {
+        float sample;
+        std::memcpy(&sample, session.raw.data() + i * sizeof(float), sizeof(float));
+        session.samples[i] = static_cast<double>(sample);
+    }
+    std::memmove(session.raw.data(), session.raw.data() + bytes, session.filled - bytes);
+    session.filled -= bytes;
+    return true;
+}
+
+void SessionScheduler::StepAwaiter::await_suspend(std::coroutine_handle<>) noexcept
+{
+    session.waiting = Session::Wait::Step;
+}
+
+double SessionScheduler::StepAwaiter::await_resume() const noexcept
+{
+    return session.preference;
+}
+
+/**
+ *
+ * @brief: constructor, starts the poller and the workers
+ *
+ * @param: model .
+ * type: CompositeModel&, shared by every session, its listener is only read
+ * @param: config .
+ * type: SessionConfig, pool size, batching and audio format
+ *
+ */
+SessionScheduler::SessionScheduler(CompositeModel& model, SessionConfig config)
+    : model(model), config(std::move(config))
+{
+    if (this->config.maxBatch == 0 || this->config.bufferedSeconds == 0)
+    {
+        throw std::invalid_argument("Session scheduler needs a batch of at least one and one buffered second");
+    }
+    size_t numWorkers = this->config.workers == 0
+                        ? std::max<size_t>(1, std::thread::hardware_concurrency()) : this->config.workers;
+    for (size_t w = 0; w < numWorkers; ++w)
+    {
+        workers.push_back(std::make_unique<Worker>(this->config.sampleRate, this->config.harmonic));
+    }
+    window = static_cast<size_t>(model.getClassifier().getNumInputs());
+    numFeatures = model.numListenerFeatures();
+    samplesPerSecond = workers.front()->extractor.windowSize();
+    for (auto& layer : model.getListener().getLayers())
+    {
+        size_t width = layer->getPrivMemberLayerNodes().size();
+        stateOffsets.push_back(stateSize);
+        stateOffsets.push_back(stateSize + width);
+        stateSize += 2 * width;
+    }
+
+    if (::pipe(wakeFds) != 0)
+    {
+        throw std::runtime_error(std::string("Could not create the poller pipe: ") + std::strerror(errno));
+    }
+    setNonBlocking(wakeFds[0]);
+    setNonBlocking(wakeFds[1]);
+    poller = std::thread([this] { pollLoop(); });
+    for (auto& worker : workers)
+    {
+        worker->thread = std::thread([this, w = worker.get()] { workerLoop(*w); });
+    }
+}
+
+/**
+ *
+ * @brief: stops the threads, closes the sources and drops the sessions that are still running
+ *
+ */
+SessionScheduler::~SessionScheduler()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    readyCv.notify_all();
+    wake(wakeFds[1]);
+    poller.join();
+    for (auto& worker : workers)
+    {
+        worker->thread.join();
+    }
+    for (auto& session : sessions)
+    {
+        if (session->task.handle)
+        {
+            session->task.handle.destroy();
+        }
+        if (session->fd >= 0)
+        {
+            ::close(session->fd);
+        }
+    }
+    ::close(wakeFds[0]);
+    ::close(wakeFds[1]);
+}
+
+/**
+ *
+ * @brief: starts a session on an open descriptor, callable from any thread
+ *
+ * @param: fd .
+ * type: int, readable end of a file or pipe, switched to non blocking, closed by the scheduler
+ * @return: size_t .
+ * session id, ids count up from 0
+ *
+ */
+size_t SessionScheduler::open(int fd)
+{
+    if (fd < 0)
+    {
+        throw std::invalid_argument("Session source is not an open descriptor");
+    }
+    setNonBlocking(fd);
+    auto session = std::make_unique<Session>();
+    session->fd = fd;
+    session->raw.resize(config.bufferedSeconds * samplesPerSecond * sizeof(float));
+    session->samples.resize(samplesPerSecond);
+    session->features.resize(numFeatures);
+    session->state.assign(stateSize, 0.0);
+    session->task = listen(*session);
+
+    Session* opened = session.get();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        opened->id = sessions.size();
+        sessions.push_back(std::move(session));
+    }
+    // nothing is buffered yet, so the session starts at the poller
+    watch(std::span<Session* const>(&opened, 1));
+    return opened->id;
+}
+
+/**
+ *
+ * @brief: starts a session on a file or named pipe
+ *
+ * @note: a named pipe is opened without waiting for a writer, one that has none yet reads as ended
+ *
+ */
+size_t SessionScheduler::openFile(const std::string& path)
+{
+    int fd = ::open(path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0)
+    {
+        throw std::runtime_error("Could not open session source " + path + ": " + std::strerror(errno));
+    }
+    return open(fd);
+}
+
+/**
+ *
+ * @brief: blocks until every session opened so far has finished
+ *
+ * @return: std::vector<SessionResult> .
+ * one per session, in id order
+ *
+ */
+std::vector<SessionResult> SessionScheduler::wait()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    doneCv.wait(lock, [&] { return finishedCount == sessions.size(); });
+    std::vector<SessionResult> results;
+    results.reserve(sessions.size());
+    for (const auto& session : sessions)
+    {
+        results.push_back(session->result);
+    }
+    return results;
+}
+
+SessionStats SessionScheduler::stats() const
+{
+    SessionStats counts;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        counts.sessions = sessions.size();
+        counts.finished = finishedCount;
+    }
+    counts.steps = stepCount.load();
+    counts.batches = batchCount.load();
+    counts.polls = pollCount.load();
+    return counts;
+}
+
+/**
+ *
+ * @brief: the body of every session, one iteration per second of audio
+ *
+ * @note: the opening window is only extracted, once it is complete the classifier runs and the buffered
+ *          seconds are stepped one by one before the session goes on live
+ *
+ */
+SessionScheduler::Task SessionScheduler::listen(Session& session)
+{
+    SessionResult& result = session.result;
+    IntervalTracker tracker;
+    while (co_await SecondAwaiter{session, samplesPerSecond})
+    {
+        double freq = session.worker->extractor.dominantFrequency(session.samples);
+        if (freq <= 0.0)
+        {
+            // silence holds the last pitch, leading silence has none to hold
+            if (result.frequencies.empty())
+            {
+                continue;
+            }
+            freq = result.frequencies.back();
+        }
+        result.frequencies.push_back(freq);
+        if (result.frequencies.size() < window)
+        {
+            continue;
+        }
+        if (result.frequencies.size() == window)
+        {
+            std::lock_guard<std::mutex> lock(classifyMutex);
+            result.consonance = model.classify(session.worker->ctx, result.frequencies);
+        }
+
+        for (size_t t = result.preferences.size(); t < result.frequencies.size(); ++t)
+        {
+            std::span<double> features = session.features;
+            features[0] = normalizeFrequency(result.frequencies[t]);
+            features[1] = t == 0 ? 0.0 : intervalOctaves(result.frequencies[t - 1], result.frequencies[t]);
+            features[2] = result.consonance;
+            if (model.hasIntervalChannels())
+            {
+                tracker.push(result.frequencies[t]);
+                tracker.channels(features.subspan(Listener::numFeatures));
+            }
+            double preference = co_await StepAwaiter{session};
+            result.preferences.push_back(preference);
+            if (config.onPreference)
+            {
+                config.onPreference(session.id, t, preference);
+            }
+        }
+    }
+
+    if (!session.readError.empty())
+    {
+        throw std::runtime_error(session.readError);
+    }
+    if (result.frequencies.size() < window)
+    {
+        throw std::runtime_error("Stream ended before the classifier window");
+    }
+}
+
+/**
+ *
+ * @brief: hands sessions waiting for audio to the poller
+ *
+ */
+void SessionScheduler::watch(std::span<Session* const> waiting)
+{
+    if (waiting.empty())
+    {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        arrivals.insert(arrivals.end(), waiting.begin(), waiting.end());
+    }
+    wake(wakeFds[1]);
+}
+
+/**
+ *
+ * @brief: queues sessions at the back of the ready queue for the workers
+ *
+ */
+void SessionScheduler::makeReady(std::span<Session* const> sessionsReady)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ready.insert(ready.end(), sessionsReady.begin(), sessionsReady.end());
+    }
+    if (sessionsReady.size() == 1)
+    {
+        readyCv.notify_one();
+    }
+    else
+    {
+        readyCv.notify_all();
+    }
+}
+
+/**
+ *
+ * @brief: records the result of a returned coroutine and releases its source, frame and buffers
+ *
+ */
+void SessionScheduler::finish(Session& session)
+{
+    SessionResult& result = session.result;
+    if (std::exception_ptr error = session.task.handle.promise().error)
+    {
+        try
+        {
+            std::rethrow_exception(error);
+        } catch (const std::exception& e)
+        {
+            result.error = e.what();
+        }
+    }
+    result.finished = true;
+    session.task.handle.destroy();
+    session.task.handle = nullptr;
+    ::close(session.fd);
+    session.fd = -1;
+    session.raw = {};
+    session.samples = {};
+    session.state = {};
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++finishedCount;
+    }
+    doneCv.notify_all();
+}
+
+/**
+ *
+ * @brief: reads what is available from a source into the session's buffer
+ *
+ * @return: bool .
+ * true while the session still waits for audio, false once it holds a second or its source ended
+ *
+ */
+bool SessionScheduler::fill(Session& session)
+{
+    while (session.filled < session.raw.size())
+    {
+        ssize_t got = ::read(session.fd, session.raw.data() + session.filled, session.raw.size() - session.filled);
+        if (got > 0)
+        {
+            session.filled += static_cast<size_t>(got);
+        }
+        else if (got == 0)
+        {
+            session.ended = true;
+            break;
+        }
+        else if (errno == EAGAIN || errno == EWOULDBLOCK)
+        {
+            break;
+        }
+        else if (errno != EINTR)
+        {
+            session.readError = std::string("Session source read failed: ") + std::strerror(errno);
+            session.ended = true;
+            break;
+        }
+    }
+    return !session.ended && session.filled < samplesPerSecond * sizeof(float);
+}
+
+/**
+ *
+ * @brief: poller thread, one poll() over the wake up pipe and every source waiting for audio
+ *
+ */
+void SessionScheduler::pollLoop()
+{
+    std::vector<Session*> watched;
+    std::vector<Session*> woken;
+    std::vector<pollfd> fds;
+    while (true)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (stopping)
+            {
+                return;
+            }
+            watched.insert(watched.end(), arrivals.begin(), arrivals.end());
+            arrivals.clear();
+        }
+
+        fds.assign(1, pollfd{wakeFds[0], POLLIN, 0});
+        for (Session* session : watched)
+        {
+            fds.push_back(pollfd{session->fd, POLLIN, 0});
+        }
+        if (::poll(fds.data(), fds.size(), -1) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            // a poller that cannot poll ends every session it watches instead of spinning
+            for (Session* session : watched)
+            {
+                session->readError = std::string("Session poll failed: ") + std::strerror(errno);
+                session->ended = true;
+            }
+            makeReady(watched);
+            watched.clear();
+            continue;
+        }
+        pollCount.fetch_add(1, std::memory_order_relaxed);
+        if (fds[0].revents != 0)
+        {
+            char drain[64];
+            while (::read(wakeFds[0], drain, sizeof(drain)) > 0)
+            {
+            }
+        }
+
+        woken.clear();
+        size_t kept = 0;
+        for (size_t i = 0; i < watched.size(); ++i)
+        {
+            Session* session = watched[i];
+            if (fds[i + 1].revents != 0 && !fill(*session))
+            {
+                woken.push_back(session);
+            }
+            else
+            {
+                watched[kept++] = session;
+            }
+        }
+        watched.resize(kept);
+        if (!woken.empty())
+        {
+            makeReady(woken);
+        }
+    }
+}
+
+/**
+ *
+ * @brief: worker thread, resumes up to maxBatch ready sessions, steps them together and requeues them
+ *
+ */
+void SessionScheduler::workerLoop(Worker& worker)
+{
+    std::vector<Session*> turn;
+    while (true)
+    {
+        turn.clear();
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            readyCv.wait(lock, [&] { return stopping || !ready.empty(); });
+            if (stopping)
+            {
+                return;
+            }
+            while (!ready.empty() && turn.size() < config.maxBatch)
+            {
+                turn.push_back(ready.front());
+                ready.pop_front();
+            }
+        }
+
+        // each session runs until it waits for audio, waits for its step or returns
+        for (Session* session : turn)
+        {
+            session->worker = &worker;
+            session->task.handle.resume();
+            if (session->task.handle.done())
+            {
+                finish(*session);
+            }
+            else if (session->waiting == Session::Wait::Audio)
+            {
+                worker.waiting.push_back(session);
+            }
+            else
+            {
+                worker.pending.push_back(session);
+            }
+        }
+        watch(worker.waiting);
+        worker.waiting.clear();
+        if (!worker.pending.empty())
+        {
+            step(worker);
+            // back of the queue, every other ready session gets its turn first
+            makeReady(worker.pending);
+            worker.pending.clear();
+        }
+        worker.ctx.endBatch();
+    }
+}
+
+/**
+ *
+ * @brief: one Listener::stepBatch over the sessions a worker's turn left waiting on a step
+ *
+ * @note: the sessions' state is gathered into one row each, stepped and scattered back
+ *
+ */
+void SessionScheduler::step(Worker& worker)
+{
+    std::vector<Session*>& pending = worker.pending;
+    size_t rows = pending.size();
+    ExecContext& ctx = worker.ctx;
+    std::span<double> features = ctx.scratch(rows * numFeatures);
+    for (size_t k = 0; k < rows; ++k)
+    {
+        std::copy(pending[k]->features.begin(), pending[k]->features.end(), features.begin() + k * numFeatures);
+    }
+
+    auto& layers = model.getListener().getLayers();
+    worker.stm.clear();
+    worker.ltm.clear();
+    for (size_t l = 0; l < layers.size(); ++l)
+    {
+        size_t width = layers[l]->getPrivMemberLayerNodes().size();
+        std::span<double> stm = ctx.scratch(rows * width);
+        std::span<double> ltm = ctx.scratch(rows * width);
+        for (size_t k = 0; k < rows; ++k)
+        {
+            const double* state = pending[k]->state.data();
+            std::copy_n(state + stateOffsets[2 * l], width, stm.begin() + k * width);
+            std::copy_n(state + stateOffsets[2 * l + 1], width, ltm.begin() + k * width);
+        }
+        worker.stm.push_back(stm);
+        worker.ltm.push_back(ltm);
+    }
+
+    std::span<double> preferences = model.getListener().stepBatch(ctx, features, rows, worker.stm, worker.ltm);
+
+    for (size_t l = 0; l < layers.size(); ++l)
+    {
+        size_t width = layers[l]->getPrivMemberLayerNodes().size();
+        for (size_t k = 0; k < rows; ++k)
+        {
+            double* state = pending[k]->state.data();
+            std::copy_n(worker.stm[l].begin() + k * width, width, state + stateOffsets[2 * l]);
+            std::copy_n(worker.ltm[l].begin() + k * width, width, state + stateOffsets[2 * l + 1]);
+        }
+    }
+    for (size_t k = 0; k < rows; ++k)
+    {
+        pending[k]->preference = preferences[k];
+    }
+    stepCount.fetch_add(rows, std::memory_order_relaxed);
+    batchCount.fetch_add(1, std::memory_order_relaxed);
+}
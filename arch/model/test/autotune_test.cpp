@@ -0,0 +1,138 @@
+#include "../headr/autotune.h"
+#include "../../data/headr/generator.h"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+
+class AutotuneTest : public ::testing::Test{};
+
+namespace
+{
+    AutotuneConfig quickConfig(const std::string& path)
+    {
+        AutotuneConfig config;
+        config.cachePath = path;
+        config.batch = 8;
+        config.repeats = 2;
+        config.rounds = 1;
+        return config;
+    }
+
+    std::vector<double> runModel(CompositeModel& model, const std::vector<double>& track)
+    {
+        ExecContext ctx;
+        std::span<double> preferences = model.run(ctx, track);
+        return std::vector<double>(preferences.begin(), preferences.end());
+    }
+}
+
+/**
+ * @brief: Tests for tuning a model, then reusing the winners from the cache
+ */
+TEST_F(AutotuneTest, Cache)
+{
+    std::string path = ::testing::TempDir() + "autotune_test.cache";
+    std::filesystem::remove(path);
+    ThreadPool pool(2);
+    CompositeModel model(8, {16, 8}, {16, 16});
+    for (auto& layer : model.getClassifier().getLayers())
+    {
+        layer->setParallel(&pool);
+    }
+    for (auto& layer : model.getListener().getLayers())
+    {
+        layer->setParallel(&pool);
+    }
+    std::vector<double> track = MusicDataGenerator(3).jazz(12).first;
+    std::vector<double> before = runModel(model, track);
+
+    // Test 1: every layer gets a winner, each distinct shape is timed once and the cache is written
+    Autotuner tuner(quickConfig(path), "host a");
+    AutotuneReport report = tuner.tune(model);
+    size_t numLayers = model.getClassifier().getLayers().size() + model.getListener().getLayers().size();
+    EXPECT_EQ(report.layers, numLayers) << "Layer count mismatch";
+    EXPECT_EQ(report.cacheHits, 0) << "Empty cache hit";
+    ASSERT_FALSE(report.shapes.empty()) << "No shape tuned";
+    for (const AutotuneEntry& entry : report.shapes)
+    {
+        EXPECT_GT(entry.seconds, 0.0) << "Shape " << entry.shape << " not timed";
+        EXPECT_LE(entry.seconds, entry.defaultSeconds) << "Winner slower than the default for " << entry.shape;
+    }
+    EXPECT_TRUE(std::filesystem::exists(path)) << "Cache not written";
+
+    // Test 2: the tuning changes the speed, not the preferences
+    std::vector<double> after = runModel(model, track);
+    ASSERT_EQ(after.size(), before.size()) << "Output size changed";
+    for (size_t t = 0; t < after.size(); ++t)
+    {
+        EXPECT_NEAR(after[t], before[t], 1e-9) << "Tuned preference mismatch at " << t;
+    }
+
+    // Test 3: a later load on the same host reads every winner back without timing
+    CompositeModel reloaded(8, {16, 8}, {16, 16});
+    for (auto& layer : reloaded.getListener().getLayers())
+    {
+        layer->setParallel(&pool);
+    }
+    for (auto& layer : reloaded.getClassifier().getLayers())
+    {
+        layer->setParallel(&pool);
+    }
+    Autotuner again(quickConfig(path), "host a");
+    AutotuneReport cached = again.tune(reloaded);
+    EXPECT_EQ(cached.cacheHits, cached.shapes.size()) << "Cached shape timed again";
+    for (size_t l = 0; l < reloaded.getListener().getLayers().size(); ++l)
+    {
+        EXPECT_EQ(reloaded.getListener().getLayers()[l]->getTuning(), model.getListener().getLayers()[l]->getTuning())
+                            << "Cached winner differs at listener layer " << l;
+    }
+
+    // Test 4: another host misses, and its winners are added next to the first host's
+    Autotuner other(quickConfig(path), "host b");
+    EXPECT_EQ(other.tune(reloaded).cacheHits, 0) << "Other host hit this host's cache";
+    std::ifstream file(path);
+    std::string line;
+    size_t hostA = 0;
+    size_t hostB = 0;
+    while (std::getline(file, line))
+    {
+        hostA += line.rfind("host a\t", 0) == 0 ? 1 : 0;
+        hostB += line.rfind("host b\t", 0) == 0 ? 1 : 0;
+    }
+    EXPECT_EQ(hostA, report.shapes.size()) << "First host's entries lost";
+    EXPECT_EQ(hostB, report.shapes.size()) << "Second host's entries missing";
+    std::filesystem::remove(path);
+}
+
+/**
+ * @brief: Tests for the cache format and the configuration checks
+ */
+TEST_F(AutotuneTest, Entries)
+{
+    std::string path = ::testing::TempDir() + "autotune_entries.cache";
+    {
+        std::ofstream file(path);
+        file << "# comment\n";
+        file << "host a\tbase 8x8 full dense rows1 pool0\t0 1 2 16\n";
+        file << "host a\tbase 4x8 full dense rows1 pool0\t0 1 2 5\n";
+        file << "host a\tno values\n";
+    }
+    CompositeModel model(8, {8, 4}, {4});
+
+    // Test 1: a valid line is applied, a line with a bad unroll is dropped and tuned again
+    Autotuner tuner(quickConfig(path), "host a");
+    AutotuneReport report = tuner.tune(model);
+    EXPECT_EQ(report.cacheHits, 1) << "Valid cache line not used";
+    EXPECT_EQ(model.getClassifier().getLayers()[0]->getTuning().unroll, 16) << "Cached unroll not applied";
+
+    // Test 2: retune times every shape even when it is cached
+    AutotuneConfig config = quickConfig(path);
+    config.retune = true;
+    Autotuner retuner(config, "host a");
+    EXPECT_EQ(retuner.tune(model).cacheHits, 0) << "Retune used the cache";
+
+    // Test 3: a config that cannot time anything is rejected
+    config.repeats = 0;
+    EXPECT_THROW(Autotuner bad(config), std::invalid_argument) << "Zero repeats accepted";
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,137 @@
+#include "../headr/earlyexit.h"
+#include "../../data/headr/generator.h"
+#include <gtest/gtest.h>
+#include <cmath>
+
+class EarlyExitTest : public ::testing::Test{};
+
+namespace
+{
+    // alternating classical (consonant) and jazz (dissonant) openings
+    void makeTracks(unsigned seed, size_t count, size_t length, std::vector<std::vector<double>>& tracks,
+                    std::vector<double>& labels)
+    {
+        MusicDataGenerator generator(seed);
+        for (size_t i = 0; i < count; ++i)
+        {
+            bool classical = i % 2 == 0;
+            tracks.push_back(classical ? generator.classical(length).first : generator.jazz(length).first);
+            labels.push_back(classical ? 1.0 : 0.0);
+        }
+    }
+}
+
+/**
+ * @brief: Tests for the exits and the fallback to the full classifier
+ */
+TEST_F(EarlyExitTest, Exits)
+{
+    ExecContext ctx;
+    Classifier classifier(10, {8, 4});
+    EarlyExitClassifier early(classifier, {3, 5, 7});
+    std::vector<std::vector<double>> tracks;
+    std::vector<double> labels;
+    makeTracks(3, 2, 10, tracks, labels);
+
+    // Test 1: before fitting no head is confident enough, the full classifier answers
+    EarlyExitDecision decision = early.classify(ctx, tracks[0]);
+    EXPECT_EQ(decision.exit, early.numExits()) << "Unfitted head answered";
+    EXPECT_EQ(decision.steps, 10) << "Full classifier read the wrong window";
+    EXPECT_TRUE(decision.confident) << "Full classifier not confident";
+    EXPECT_DOUBLE_EQ(decision.probability, classifier.predict(ctx, tracks[0])) << "Fallback differs from the classifier";
+
+    // Test 2: a threshold of one half always answers at the first exit after reading only its seconds
+    early.setThreshold(0.5);
+    decision = early.classify(ctx, std::span<const double>(tracks[1]).first(3));
+    EXPECT_EQ(decision.exit, 0) << "First head did not answer";
+    EXPECT_EQ(decision.steps, 3) << "First head read the wrong number of seconds";
+    EXPECT_DOUBLE_EQ(decision.probability, 0.5) << "Zero head is not one half";
+
+    // Test 3: a partial sequence with no confident head returns the last head reached, not confident
+    early.setThreshold(2.0);
+    decision = early.classify(ctx, std::span<const double>(tracks[1]).first(6));
+    EXPECT_EQ(decision.exit, 1) << "Partial sequence answered by the wrong head";
+    EXPECT_FALSE(decision.confident) << "Partial answer marked confident";
+    EXPECT_THROW(early.classify(ctx, std::span<const double>(tracks[1]).first(2)), std::invalid_argument)
+        << "Sequence shorter than the first exit accepted";
+
+    // Test 4: exits must be increasing and inside the window, channels must be the interval ones
+    EXPECT_THROW(EarlyExitClassifier(classifier, {5, 5}), std::invalid_argument) << "Repeated exit accepted";
+    EXPECT_THROW(EarlyExitClassifier(classifier, {3, 10}), std::invalid_argument) << "Exit at the window accepted";
+    Classifier wrongChannels(10, {4}, 2);
+    EXPECT_THROW(EarlyExitClassifier(wrongChannels, {3}), std::invalid_argument) << "Unknown channels accepted";
+}
+
+/**
+ * @brief: Tests for fitting, calibration and the statistics
+ */
+TEST_F(EarlyExitTest, Calibration)
+{
+    ExecContext ctx;
+    Classifier classifier(10, {8, 4}, static_cast<int>(IntervalTracker::numChannels));
+    EarlyExitClassifier early(classifier, {3, 5, 7});
+    std::vector<std::vector<double>> train;
+    std::vector<double> trainLabels;
+    makeTracks(11, 400, 10, train, trainLabels);
+    std::vector<std::vector<double>> held;
+    std::vector<double> heldLabels;
+    makeTracks(12, 400, 10, held, heldLabels);
+    std::vector<std::vector<double>> test;
+    std::vector<double> testLabels;
+    makeTracks(13, 400, 10, test, testLabels);
+
+    // Test 1: the fitted first head already separates the styles after three seconds
+    early.fit(train, trainLabels);
+    early.setThreshold(0.5);
+    EarlyExitReport first = early.evaluate(ctx, test, testLabels);
+    EXPECT_EQ(first.exits[0].taken, test.size()) << "Threshold one half let tracks past the first head";
+    EXPECT_GT(first.accuracy, 0.6) << "First head no better than chance";
+
+    // Test 2: calibrated heads keep close to the target on fresh tracks, and read fewer seconds than the window
+    early.calibrate(held, heldLabels, 0.9);
+    for (size_t e = 0; e < early.numExits(); ++e)
+    {
+        EXPECT_GE(early.getThreshold(e), 0.5) << "Threshold below one half at exit " << e;
+    }
+    EarlyExitReport report = early.evaluate(ctx, test, testLabels);
+    ASSERT_EQ(report.exits.size(), early.numExits() + 1) << "Missing the full classifier entry";
+    size_t taken = 0;
+    size_t earlyCorrect = 0;
+    size_t earlyTaken = 0;
+    for (size_t e = 0; e < report.exits.size(); ++e)
+    {
+        taken += report.exits[e].taken;
+        if (e < early.numExits())
+        {
+            earlyCorrect += report.exits[e].correct;
+            earlyTaken += report.exits[e].taken;
+        }
+        EXPECT_LE(report.exits[e].accuracy(), 1.0) << "Accuracy above one at exit " << e;
+    }
+    EXPECT_EQ(taken, test.size()) << "Decisions do not add up";
+    EXPECT_EQ(report.exits.back().step, 10) << "Full classifier step mismatch";
+    ASSERT_GT(earlyTaken, 0) << "No track exited early";
+    EXPECT_GT(static_cast<double>(earlyCorrect) / static_cast<double>(earlyTaken), 0.8)
+        << "Early exits far below the calibration target";
+    EXPECT_LT(report.meanSteps, 10.0) << "Early exit read the whole window on average";
+    EXPECT_GT(report.meanSeconds, 0.0) << "Decisions not timed";
+    EXPECT_GT(report.fullSeconds, 0.0) << "Full classifier not timed";
+
+    // Test 3: silent (0 Hz) seconds hold the previous pitch, on the heads and on the full classifier
+    std::vector<double> silent = test[0];
+    silent[1] = 0.0;
+    silent[8] = 0.0;
+    for (double threshold : {0.5, 2.0})
+    {
+        early.setThreshold(threshold);
+        EarlyExitDecision decision = early.classify(ctx, silent);
+        EXPECT_TRUE(std::isfinite(decision.probability)) << "Silence gave a non finite probability";
+        EXPECT_GE(decision.probability, 0.0) << "Probability below 0";
+        EXPECT_LE(decision.probability, 1.0) << "Probability above 1";
+    }
+
+    // Test 4: chance level targets and missing labels are rejected
+    EXPECT_THROW(early.calibrate(held, heldLabels, 0.5), std::invalid_argument) << "Chance level target accepted";
+    EXPECT_THROW(early.fit(held, std::span<const double>(trainLabels).first(3)), std::invalid_argument)
+        << "Label count mismatch accepted";
+}
@@ -0,0 +1,161 @@
+#include "../headr/model.h"
+#include "../../data/headr/generator.h"
+#include <gtest/gtest.h>
+#include <cmath>
+
+class ModelTest : public ::testing::Test{};
+
+/**
+ * @brief: Tests for the classifier + listener composite
+ */
+TEST_F(ModelTest, CompositeRun)
+{
+    ExecContext ctx;
+    CompositeModel model(10, {8, 4}, {6, 4});
+    std::vector<double> frequencies = {261.63, 392.0, 523.25, 329.63, 440.0, 277.18, 311.13, 493.88, 349.23, 261.63};
+
+    // Test 1: classifier output is a probability
+    double consonant = model.getClassifier().predict(ctx, frequencies);
+    EXPECT_GE(consonant, 0.0) << "Classifier probability below 0";
+    EXPECT_LE(consonant, 1.0) << "Classifier probability above 1";
+
+    // Test 2: stacked listener layers take the previous layer width
+    auto& layers = model.getListener().getLayers();
+    ASSERT_EQ(layers.size(), 2) << "Listener depth mismatch";
+    EXPECT_EQ(layers[1]->getPrivMemberLayerNodes()[0].getWeightVecSize(), 6) << "Stacked LSTM fan in mismatch";
+
+    // Test 3: one preference per second, every one in [0, 1]
+    std::span<double> preferences = model.run(ctx, frequencies);
+    ASSERT_EQ(preferences.size(), frequencies.size()) << "Preference trajectory length mismatch";
+    for (double preference : preferences)
+    {
+        EXPECT_GE(preference, 0.0) << "Preference below 0";
+        EXPECT_LE(preference, 1.0) << "Preference above 1";
+    }
+
+    // Test 4: runs are repeatable since the listener state is reset per sequence
+    std::vector<double> first(preferences.begin(), preferences.end());
+    std::span<double> second = model.run(ctx, frequencies);
+    for (size_t t = 0; t < first.size(); ++t)
+    {
+        EXPECT_DOUBLE_EQ(second[t], first[t]) << "Composite run not repeatable at " << t;
+    }
+
+    // Test 5: wrong sequence length
+    EXPECT_THROW(model.getClassifier().predict(ctx, std::vector<double>(3, 440.0)), std::invalid_argument)
+                        << "Bad sequence length accepted";
+
+    // Test 6: the compiled classifier agrees with the layer by layer path
+    ExecutionPlan plan = model.getClassifier().compile();
+    EXPECT_EQ(plan.numKernels(), 3) << "Classifier layers not fused";
+    EXPECT_NEAR(model.getClassifier().predict(ctx, plan, frequencies), consonant, 1e-12)
+                        << "Compiled classifier mismatch";
+
+    // Test 7: a silent (0 Hz) second gives a zero interval instead of -inf / NaN
+    EXPECT_EQ(intervalOctaves(0.0, 440.0), 0.0) << "Interval from silence not zero";
+    EXPECT_EQ(intervalOctaves(440.0, 0.0), 0.0) << "Interval into silence not zero";
+    EXPECT_DOUBLE_EQ(intervalOctaves(220.0, 440.0), 1.0) << "Octave interval mismatch";
+    std::vector<double> silent = frequencies;
+    silent[3] = 0.0;
+    for (double preference : model.run(ctx, silent))
+    {
+        EXPECT_TRUE(std::isfinite(preference)) << "Silence produced a non finite preference";
+    }
+    ctx.endBatch();
+}
+
+/**
+ * @brief: Tests for running tracks of different lengths as one packed batch
+ */
+TEST_F(ModelTest, PackedBatch)
+{
+    // Test 1: every track gets one preference per second, in the given order
+    CompositeModel model(10, {8, 4}, {6, 6});
+    MusicDataGenerator generator(7);
+    std::vector<std::vector<double>> tracks = {
+        generator.classical(12).first,
+        generator.jazz(25).first,
+        generator.classical(10).first,
+        generator.jazz(18).first
+    };
+    ExecContext ctx;
+    std::vector<std::span<double>> batched = model.runBatch(ctx, tracks);
+    ASSERT_EQ(batched.size(), tracks.size()) << "Track count mismatch";
+
+    // Test 2: packing changes nothing, each track matches running it on its own
+    for (size_t s = 0; s < tracks.size(); ++s)
+    {
+        ASSERT_EQ(batched[s].size(), tracks[s].size()) << "Track " << s << " length mismatch";
+        std::span<double> single = model.run(ctx, tracks[s]);
+        for (size_t t = 0; t < single.size(); ++t)
+        {
+            EXPECT_NEAR(batched[s][t], single[t], 1e-9) << "Track " << s << " differs at " << t;
+        }
+    }
+
+    // Test 3: a silent (0 Hz) second packs to the same finite preferences as the single run
+    std::vector<double> silent = tracks[1];
+    silent[5] = 0.0;
+    std::span<double> silentSingle = model.run(ctx, silent);
+    std::vector<double> expected(silentSingle.begin(), silentSingle.end());
+    std::span<double> silentBatched = model.runBatch(ctx, {silent})[0];
+    for (size_t t = 0; t < expected.size(); ++t)
+    {
+        EXPECT_TRUE(std::isfinite(silentBatched[t])) << "Silence produced a non finite preference at " << t;
+        EXPECT_NEAR(silentBatched[t], expected[t], 1e-9) << "Silent track differs at " << t;
+    }
+
+    // Test 4: tracks shorter than the classifier window are rejected
+    EXPECT_THROW(model.runBatch(ctx, {std::vector<double>(4, 440.0)}), std::invalid_argument)
+                        << "Short track accepted";
+    ctx.endBatch();
+}
+
+/**
+ * @brief: Tests for the interval entropy channels
+ */
+TEST_F(ModelTest, IntervalChannels)
+{
+    CompositeModel model(10, {8, 4}, {6, 4}, true);
+    MusicDataGenerator generator(11);
+    std::vector<std::vector<double>> tracks = {generator.jazz(16).first, generator.classical(12).first};
+    ExecContext ctx;
+
+    // Test 1: both networks are widened by the channels
+    size_t channels = IntervalTracker::numChannels;
+    EXPECT_EQ(model.getClassifier().getNumChannels(), static_cast<int>(channels)) << "Classifier channels missing";
+    EXPECT_EQ(model.getClassifier().getLayers()[0]->getPrivMemberLayerNodes()[0].getWeightVecSize(), 10 + channels)
+                        << "Classifier fan in mismatch";
+    EXPECT_EQ(model.getListener().getLayers()[0]->getPrivMemberLayerNodes()[0].getWeightVecSize(),
+              Listener::numFeatures + channels) << "Listener fan in mismatch";
+
+    // Test 2: the streamed and the packed paths see the same channels
+    std::vector<std::span<double>> batched = model.runBatch(ctx, tracks);
+    for (size_t s = 0; s < tracks.size(); ++s)
+    {
+        std::span<double> single = model.run(ctx, tracks[s]);
+        ASSERT_EQ(single.size(), batched[s].size()) << "Track " << s << " length mismatch";
+        for (size_t t = 0; t < single.size(); ++t)
+        {
+            EXPECT_NEAR(batched[s][t], single[t], 1e-9) << "Track " << s << " differs at " << t;
+        }
+    }
+
+    // Test 3: the classifier needs its channels
+    EXPECT_THROW(model.getClassifier().predict(ctx, std::span<const double>(tracks[0]).first(10)), std::invalid_argument)
+                        << "Missing channels accepted";
+
+    // Test 4: silent (0 Hz) frames, in the opening window and after it, hold the previous pitch
+    std::vector<double> silent = tracks[0];
+    silent[2] = 0.0;
+    silent[12] = 0.0;
+    std::span<double> single = model.run(ctx, silent);
+    std::vector<double> expected(single.begin(), single.end());
+    std::span<double> packed = model.runBatch(ctx, {silent})[0];
+    for (size_t t = 0; t < expected.size(); ++t)
+    {
+        EXPECT_TRUE(std::isfinite(expected[t])) << "Silence produced a non finite preference at " << t;
+        EXPECT_NEAR(packed[t], expected[t], 1e-9) << "Silent track differs at " << t;
+    }
+    ctx.endBatch();
+}
@@ -0,0 +1,113 @@
+#include "../headr/population.h"
+#include <gtest/gtest.h>
+#include <cmath>
+
+class PopulationTest : public ::testing::Test{};
+
+namespace
+{
+    std::vector<double> stimulus(size_t steps)
+    {
+        std::vector<double> features;
+        for (size_t t = 0; t < steps; ++t)
+        {
+            features.push_back(std::sin(0.4 * static_cast<double>(t)));
+            features.push_back(t == 0 ? 0.0 : 0.58);
+            features.push_back(t % 4 == 0 ? 0.9 : 0.2);
+        }
+        return features;
+    }
+
+    std::vector<double> listen(Listener& listener, const std::vector<double>& features)
+    {
+        ExecContext ctx;
+        listener.resetState();
+        std::vector<double> preferences;
+        for (size_t t = 0; t < features.size() / Listener::numFeatures; ++t)
+        {
+            std::span<const double> row(features.data() + t * Listener::numFeatures, Listener::numFeatures);
+            preferences.push_back(listener.step(ctx, row));
+            ctx.endBatch();
+        }
+        return preferences;
+    }
+}
+
+/**
+ * @brief: Tests for the lane layout against single listeners
+ */
+TEST_F(PopulationTest, MatchesListener)
+{
+    Listener base(Listener::numFeatures, {4, 3});
+    Listener other(Listener::numFeatures, {4, 3});
+    std::vector<double> features = stimulus(9);
+    std::vector<double> expected = listen(base, features);
+    std::vector<double> otherExpected = listen(other, features);
+
+    // Test 1: a population of clones has the base trajectory and no spread
+    ListenerPopulation population(base, 300);
+    population.load(7, other);
+    population.load(7, base);
+    PopulationTrajectory trajectory = population.run(features);
+    ASSERT_EQ(trajectory.mean.size(), expected.size()) << "Trajectory length mismatch";
+    for (size_t t = 0; t < expected.size(); ++t)
+    {
+        EXPECT_NEAR(trajectory.mean[t], expected[t], 1e-12) << "Mean preference mismatch at " << t;
+        EXPECT_NEAR(trajectory.stddev[t], 0.0, 1e-6) << "Clones disagree at " << t;
+        EXPECT_EQ(trajectory.enjoying[t], expected[t] > 0.5 ? 1.0 : 0.0) << "Enjoying fraction mismatch at " << t;
+    }
+
+    // Test 2: one listener with other weights, in the second block, follows its own model
+    population.resetState();
+    population.load(260, other);
+    population.run(features);
+    EXPECT_NEAR(population.preferences()[260], otherExpected.back(), 1e-12) << "Loaded listener mismatch";
+    EXPECT_NEAR(population.preferences()[259], expected.back(), 1e-12) << "Neighbour lane disturbed";
+
+    // Test 3: the state carries over between calls
+    population.resetState();
+    std::vector<double> head(features.begin(), features.begin() + 5 * Listener::numFeatures);
+    std::vector<double> tail(features.begin() + 5 * Listener::numFeatures, features.end());
+    population.run(head);
+    PopulationTrajectory rest = population.run(tail);
+    EXPECT_NEAR(population.preferences()[260], otherExpected.back(), 1e-12) << "State lost between calls";
+    EXPECT_EQ(rest.mean.size(), 4) << "Continued trajectory length mismatch";
+
+    // Test 4: shapes are checked
+    Listener wide(Listener::numFeatures, {5, 3});
+    EXPECT_THROW(population.load(0, wide), std::invalid_argument) << "Mismatched listener accepted";
+    EXPECT_THROW(population.run(std::vector<double>(4, 0.0)), std::invalid_argument) << "Ragged stimulus accepted";
+}
+
+/**
+ * @brief: Tests for a perturbed population on the pool
+ */
+TEST_F(PopulationTest, Parallel)
+{
+    Listener base(Listener::numFeatures, {4});
+    std::vector<double> features = stimulus(12);
+    ListenerPopulation serial(base, 5000, 0.3, 9);
+    ListenerPopulation parallel(base, 5000, 0.3, 9);
+    ThreadPool pool(3);
+    parallel.setParallel(&pool);
+
+    // Test 1: the pool does not change the aggregate, blocks are reduced in order
+    PopulationTrajectory a = serial.run(features);
+    PopulationTrajectory b = parallel.run(features);
+    for (size_t t = 0; t < a.mean.size(); ++t)
+    {
+        EXPECT_EQ(a.mean[t], b.mean[t]) << "Parallel mean differs at " << t;
+        EXPECT_EQ(a.stddev[t], b.stddev[t]) << "Parallel spread differs at " << t;
+        EXPECT_EQ(a.enjoying[t], b.enjoying[t]) << "Parallel enjoying differs at " << t;
+    }
+
+    // Test 2: perturbed listeners disagree, and the aggregate is consistent
+    EXPECT_GT(a.stddev.back(), 1e-3) << "Perturbation had no effect";
+    double mean = 0.0;
+    for (double preference : parallel.preferences())
+    {
+        mean += preference / 5000.0;
+    }
+    EXPECT_NEAR(a.mean.back(), mean, 1e-12) << "Mean does not match the final preferences";
+    EXPECT_GT(parallel.bytes(), 5000 * 60 * sizeof(double)) << "Lanes smaller than the weights";
+}
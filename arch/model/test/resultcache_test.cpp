@@ -0,0 +1,121 @@
+#include "../headr/model.h"
+#include "../../data/headr/generator.h"
+#include <gtest/gtest.h>
+#include <thread>
+
+class ResultCacheTest : public ::testing::Test{};
+
+/**
+ * @brief: Tests for the keys, the LRU order and the expiry
+ */
+TEST_F(ResultCacheTest, Entries)
+{
+    ResultCacheConfig config;
+    config.capacity = 2;
+    config.shards = 1;
+    ResultCache cache(config);
+    std::vector<double> track = {261.63, 392.0, 329.63};
+    std::vector<double> detuned = {262.5, 391.0, 330.4};
+    std::vector<double> other = {261.63, 392.0, 349.23};
+
+    // Test 1: a few cents off the grid gives the same key, a different note or length does not
+    EXPECT_EQ(cache.key(track), cache.key(detuned)) << "Detuned track has its own key";
+    EXPECT_FALSE(cache.key(track) == cache.key(other)) << "Different notes share a key";
+    EXPECT_FALSE(cache.key(track) == cache.key(std::span<const double>(track).first(2))) << "Prefix shares a key";
+
+    // Test 2: misses compute, hits do not
+    int computed = 0;
+    auto compute = [&] { ++computed; return 0.25 * computed; };
+    EXPECT_DOUBLE_EQ(cache.getOrCompute(track, compute), 0.25) << "First lookup value mismatch";
+    EXPECT_DOUBLE_EQ(cache.getOrCompute(detuned, compute), 0.25) << "Detuned lookup not served from the cache";
+    EXPECT_EQ(computed, 1) << "Hit ran the model";
+
+    // Test 3: the least recently used entry is evicted when the shard is full
+    std::vector<double> third = {440.0, 440.0, 440.0};
+    cache.getOrCompute(other, compute);
+    cache.getOrCompute(track, compute);
+    cache.getOrCompute(third, compute);
+    double value = 0.0;
+    EXPECT_TRUE(cache.lookup(cache.key(track), value)) << "Recently used entry evicted";
+    EXPECT_FALSE(cache.lookup(cache.key(other), value)) << "Least recently used entry kept";
+    ResultCacheStats stats = cache.stats();
+    EXPECT_EQ(stats.hits, 3) << "Hit count mismatch";
+    EXPECT_EQ(stats.misses, 4) << "Miss count mismatch";
+    EXPECT_EQ(stats.evictions, 1) << "Eviction count mismatch";
+    EXPECT_EQ(stats.size, 2) << "Cache holds more than its capacity";
+    cache.clear();
+    EXPECT_EQ(cache.stats().size, 0) << "Clear kept entries";
+
+    // Test 4: an entry older than the ttl is a miss
+    config.ttl = std::chrono::milliseconds(5);
+    ResultCache expiring(config);
+    expiring.insert(expiring.key(track), 0.5);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(expiring.lookup(expiring.key(track), value)) << "Expired entry served";
+    EXPECT_EQ(expiring.stats().expirations, 1) << "Expiry not counted";
+
+    // Test 5: empty capacity is rejected
+    config.capacity = 0;
+    EXPECT_THROW(ResultCache bad(config), std::invalid_argument) << "Zero capacity accepted";
+}
+
+/**
+ * @brief: Tests for the cache in front of the composite model's classifier
+ */
+TEST_F(ResultCacheTest, Model)
+{
+    CompositeModel model(10, {8, 4}, {6, 4}, true);
+    MusicDataGenerator generator(21);
+    std::vector<std::vector<double>> tracks;
+    for (int i = 0; i < 64; ++i)
+    {
+        tracks.push_back(i % 2 == 0 ? generator.classical(12).first : generator.jazz(12).first);
+    }
+    ExecContext ctx;
+    std::vector<std::vector<double>> expected;
+    for (const auto& track : tracks)
+    {
+        std::span<double> preferences = model.run(ctx, track);
+        expected.emplace_back(preferences.begin(), preferences.end());
+        ctx.endBatch();
+    }
+
+    // Test 1: cached runs give the same preferences, the second pass only hits
+    ResultCache cache;
+    model.setResultCache(&cache);
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        for (size_t t = 0; t < tracks.size(); ++t)
+        {
+            std::span<double> preferences = model.run(ctx, tracks[t]);
+            EXPECT_EQ(std::vector<double>(preferences.begin(), preferences.end()), expected[t])
+                << "Cached run differs on track " << t;
+            ctx.endBatch();
+        }
+    }
+    ResultCacheStats stats = cache.stats();
+    EXPECT_EQ(stats.misses, stats.size) << "A repeated opening missed";
+    EXPECT_EQ(stats.hits + stats.misses, 2 * tracks.size()) << "Lookup count mismatch";
+
+    // Test 2: threads hammering the same tracks all get the classifier's value
+    std::vector<std::thread> threads;
+    std::atomic<int> wrong{0};
+    for (int w = 0; w < 4; ++w)
+    {
+        threads.emplace_back([&, w]
+        {
+            for (int i = 0; i < 2000; ++i)
+            {
+                const std::vector<double>& track = tracks[static_cast<size_t>(i * 7 + w) % tracks.size()];
+                double value = cache.getOrCompute(std::span<const double>(track).first(10), [] { return -1.0; });
+                wrong += value < 0.0 ? 1 : 0;
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    EXPECT_EQ(wrong.load(), 0) << "Concurrent lookup missed a cached track";
+    model.setResultCache(nullptr);
+}
@@ -0,0 +1,242 @@
+#include "../headr/session.h"
+#include "../../data/headr/generator.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <numbers>
+#include <thread>
+#include <unistd.h>
+
+class SessionTest : public ::testing::Test{};
+
+namespace
+{
+    constexpr double rate = 8000.0;
+
+    // raw float PCM, one note with two overtones per second, 0 for a silent second
+    std::vector<float> melodyPcm(const std::vector<double>& notes)
+    {
+        size_t perSecond = static_cast<size_t>(rate);
+        std::vector<float> pcm(notes.size() * perSecond, 0.0f);
+        for (size_t s = 0; s < notes.size(); ++s)
+        {
+            for (size_t i = 0; notes[s] > 0.0 && i < perSecond; ++i)
+            {
+                double phase = 2.0 * std::numbers::pi * notes[s] * static_cast<double>(i) / rate;
+                pcm[s * perSecond + i] = static_cast<float>(
+                    0.5 * (std::sin(phase) + 0.5 * std::sin(2.0 * phase) + 0.25 * std::sin(3.0 * phase)) / 1.75);
+            }
+        }
+        return pcm;
+    }
+
+    // what the scheduler should hear: the frontend per second, silence held, leading silence skipped
+    std::vector<double> heard(const std::vector<float>& pcm)
+    {
+        HarmonicExtractor extractor(rate);
+        std::vector<double> window(extractor.windowSize());
+        std::vector<double> frequencies;
+        for (size_t start = 0; start + window.size() <= pcm.size(); start += window.size())
+        {
+            std::copy_n(pcm.begin() + static_cast<long>(start), window.size(), window.begin());
+            double freq = extractor.dominantFrequency(window);
+            if (freq <= 0.0)
+            {
+                if (frequencies.empty())
+                {
+                    continue;
+                }
+                freq = frequencies.back();
+            }
+            frequencies.push_back(freq);
+        }
+        return frequencies;
+    }
+
+    std::vector<double> runModel(CompositeModel& model, const std::vector<double>& frequencies)
+    {
+        ExecContext ctx;
+        std::span<double> preferences = model.run(ctx, frequencies);
+        return std::vector<double>(preferences.begin(), preferences.end());
+    }
+
+    void expectMatches(const SessionResult& result, const std::vector<double>& frequencies,
+                       const std::vector<double>& expected, size_t id)
+    {
+        EXPECT_TRUE(result.finished) << "Session " << id << " not finished";
+        EXPECT_TRUE(result.error.empty()) << "Session " << id << " failed: " << result.error;
+        ASSERT_EQ(result.frequencies, frequencies) << "Session " << id << " heard other frequencies";
+        ASSERT_EQ(result.preferences.size(), expected.size()) << "Session " << id << " step count mismatch";
+        for (size_t t = 0; t < expected.size(); ++t)
+        {
+            EXPECT_NEAR(result.preferences[t], expected[t], 1e-9) << "Session " << id << " preference at " << t;
+        }
+    }
+}
+
+/**
+ * @brief: Tests that a session scores a file exactly as CompositeModel::run scores its frequencies
+ */
+TEST_F(SessionTest, MatchesRun)
+{
+    CompositeModel model(4, {8, 4}, {8, 8}, true);
+    MusicDataGenerator generator(5);
+    std::vector<std::vector<double>> melodies = {generator.classical(8).first, generator.jazz(10).first};
+    // leading silence is skipped, a silent second in the middle holds the previous pitch
+    melodies.push_back({0.0, 0.0, 330.0, 440.0, 0.0, 523.25, 392.0, 0.0, 261.63});
+
+    std::vector<std::string> paths;
+    std::vector<std::vector<double>> frequencies;
+    for (size_t m = 0; m < melodies.size(); ++m)
+    {
+        std::vector<float> pcm = melodyPcm(melodies[m]);
+        paths.push_back(::testing::TempDir() + "session_test_" + std::to_string(m) + ".pcm");
+        std::ofstream file(paths.back(), std::ios::binary);
+        file.write(reinterpret_cast<const char*>(pcm.data()), static_cast<std::streamsize>(pcm.size() * sizeof(float)));
+        frequencies.push_back(heard(pcm));
+    }
+
+    // Test 1: every session matches the whole track run through the model, interval channels included
+    SessionConfig config;
+    config.workers = 2;
+    config.maxBatch = 2;
+    std::atomic<size_t> callbacks{0};
+    config.onPreference = [&](size_t, size_t, double) { ++callbacks; };
+    SessionScheduler scheduler(model, config);
+    for (size_t m = 0; m < paths.size(); ++m)
+    {
+        EXPECT_EQ(scheduler.openFile(paths[m]), m) << "Session ids not in open order";
+    }
+    std::vector<SessionResult> results = scheduler.wait();
+    ASSERT_EQ(results.size(), paths.size()) << "Result count mismatch";
+    size_t steps = 0;
+    for (size_t m = 0; m < results.size(); ++m)
+    {
+        expectMatches(results[m], frequencies[m], runModel(model, frequencies[m]), m);
+        steps += results[m].preferences.size();
+    }
+    EXPECT_EQ(frequencies[2].size(), 7) << "Leading silence not skipped";
+
+    // Test 2: the counters and the callback see every step
+    SessionStats stats = scheduler.stats();
+    EXPECT_EQ(stats.sessions, paths.size()) << "Session count mismatch";
+    EXPECT_EQ(stats.finished, paths.size()) << "Finished count mismatch";
+    EXPECT_EQ(stats.steps, steps) << "Step count mismatch";
+    EXPECT_EQ(callbacks.load(), steps) << "Callback count mismatch";
+    for (const std::string& path : paths)
+    {
+        std::remove(path.c_str());
+    }
+}
+
+/**
+ * @brief: Tests many pipe fed sessions multiplexed onto two workers
+ */
+TEST_F(SessionTest, Pipes)
+{
+    CompositeModel model(4, {8, 4}, {8, 8});
+    MusicDataGenerator generator(11);
+    std::vector<std::vector<double>> melodies;
+    std::vector<std::vector<float>> pcm;
+    std::vector<std::vector<double>> expected;
+    std::vector<std::vector<double>> frequencies;
+    for (size_t m = 0; m < 4; ++m)
+    {
+        melodies.push_back(m % 2 == 0 ? generator.classical(6 + m).first : generator.jazz(6 + m).first);
+        pcm.push_back(melodyPcm(melodies.back()));
+        frequencies.push_back(heard(pcm.back()));
+        expected.push_back(runModel(model, frequencies.back()));
+    }
+
+    SessionConfig config;
+    config.workers = 2;
+    config.maxBatch = 16;
+    SessionScheduler scheduler(model, config);
+    constexpr size_t numSessions = 64;
+    std::vector<int> writeEnds;
+    for (size_t s = 0; s < numSessions; ++s)
+    {
+        int ends[2];
+        ASSERT_EQ(::pipe(ends), 0) << "Could not create pipe " << s;
+        scheduler.open(ends[0]);
+        writeEnds.push_back(ends[1]);
+    }
+
+    // Test 1: audio trickles in a quarter second at a time, interleaved over every pipe
+    std::thread writer([&]
+    {
+        size_t chunk = static_cast<size_t>(rate) / 4;
+        std::vector<size_t> written(numSessions, 0);
+        for (bool more = true; more;)
+        {
+            more = false;
+            for (size_t s = 0; s < numSessions; ++s)
+            {
+                const std::vector<float>& source = pcm[s % pcm.size()];
+                size_t count = std::min(chunk, source.size() - written[s]);
+                const char* bytes = reinterpret_cast<const char*>(source.data() + written[s]);
+                for (size_t done = 0; done < count * sizeof(float);)
+                {
+                    ssize_t got = ::write(writeEnds[s], bytes + done, count * sizeof(float) - done);
+                    done += got > 0 ? static_cast<size_t>(got) : 0;
+                }
+                written[s] += count;
+                more = more || written[s] < source.size();
+            }
+        }
+        for (int fd : writeEnds)
+        {
+            ::close(fd);
+        }
+    });
+    std::vector<SessionResult> results = scheduler.wait();
+    writer.join();
+    ASSERT_EQ(results.size(), numSessions) << "Result count mismatch";
+    for (size_t s = 0; s < numSessions; ++s)
+    {
+        expectMatches(results[s], frequencies[s % pcm.size()], expected[s % pcm.size()], s);
+    }
+
+    // Test 2: steps of different sessions were batched together
+    SessionStats stats = scheduler.stats();
+    EXPECT_GT(stats.meanBatch(), 1.0) << "Sessions stepped one at a time";
+    EXPECT_LE(stats.meanBatch(), static_cast<double>(config.maxBatch)) << "Batch larger than maxBatch";
+    EXPECT_GT(stats.polls, 0) << "Poller never polled";
+}
+
+/**
+ * @brief: Tests sessions that end early and the argument checks
+ */
+TEST_F(SessionTest, Errors)
+{
+    CompositeModel model(4, {8, 4}, {8});
+    std::string path = ::testing::TempDir() + "session_short.pcm";
+    {
+        std::vector<float> pcm = melodyPcm({440.0, 330.0});
+        // half a second more, dropped as a partial second
+        pcm.resize(pcm.size() + static_cast<size_t>(rate) / 2, 0.1f);
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(pcm.data()), static_cast<std::streamsize>(pcm.size() * sizeof(float)));
+    }
+
+    // Test 1: a stream shorter than the classifier window finishes with an error and no preferences
+    SessionConfig config;
+    config.workers = 1;
+    SessionScheduler scheduler(model, config);
+    scheduler.openFile(path);
+    std::vector<SessionResult> results = scheduler.wait();
+    ASSERT_EQ(results.size(), 1) << "Result count mismatch";
+    EXPECT_TRUE(results[0].finished) << "Short session not finished";
+    EXPECT_FALSE(results[0].error.empty()) << "Short session reported no error";
+    EXPECT_EQ(results[0].frequencies.size(), 2) << "Partial second not dropped";
+    EXPECT_TRUE(results[0].preferences.empty()) << "Short session stepped";
+
+    // Test 2: bad sources and configs are rejected
+    EXPECT_THROW(scheduler.open(-1), std::invalid_argument) << "Closed descriptor accepted";
+    EXPECT_THROW(scheduler.openFile(path + ".missing"), std::runtime_error) << "Missing file accepted";
+    config.maxBatch = 0;
+    EXPECT_THROW(SessionScheduler bad(model, config), std::invalid_argument) << "Zero batch accepted";
+    std::remove(path.c_str());
+}
@@ -0,0 +1,122 @@
+#ifndef ACTIVATION_H
+#define ACTIVATION_H
+
+#include <Eigen/Core>
+#include <algorithm>
+#include <cmath>
+
+/**
+ *
+ * ACTIVATION POLICIES:
+ *  - every policy is a stateless struct with two static forms of the same function
+ *      apply(double) -> scalar form, used by the per node and per cell paths
+ *      apply(ArrayBase) -> Eigen array expression, used by the layer kernels on whole rows / batches
+ *  - the node types take them as template parameters, so the activation is resolved at compile time and
+ *      inlined into every kernel, there is no runtime switch on the activation
+ *
+ */
+
+/**
+ *
+ * @struct: IdentityAct -> x, for outputs that stay linear
+ *
+ */
+struct IdentityAct
+{
+    static double apply(double val) noexcept { return val; }
+
+    template <typename Derived>
+    static const Derived& apply(const Eigen::ArrayBase<Derived>& val) { return val.derived(); }
+};
+
+/**
+ *
+ * @struct: TanhAct -> tanh(x)
+ *
+ */
+struct TanhAct
+{
+    static double apply(double val) noexcept { return std::tanh(val); }
+
+    template <typename Derived>
+    static auto apply(const Eigen::ArrayBase<Derived>& val) { return val.tanh(); }
+};
+
+/**
+ *
+ * @struct: SigmoidAct -> 1 / (1 + e^-x)
+ *
+ */
+struct SigmoidAct
+{
+    static double apply(double val) noexcept { return 1.0 / (1.0 + std::exp(-val)); }
+
+    template <typename Derived>
+    static auto apply(const Eigen::ArrayBase<Derived>& val) { return (1.0 + (-val).exp()).inverse(); }
+};
+
+/**
+ *
+ * @struct: ReluAct -> max(x, 0)
+ *
+ */
+struct ReluAct
+{
+    static double apply(double val) noexcept { return val > 0.0 ? val : 0.0; }
+
+    template <typename Derived>
+    static auto apply(const Eigen::ArrayBase<Derived>& val) { return val.max(0.0); }
+};
+
+/**
+ *
+ * @struct: LeakyReluAct -> x for x > 0, slope * x otherwise
+ *
+ */
+struct LeakyReluAct
+{
+    static constexpr double slope = 0.01;
+
+    static double apply(double val) noexcept { return val > 0.0 ? val : slope * val; }
+
+    template <typename Derived>
+    static auto apply(const Eigen::ArrayBase<Derived>& val) { return val.max(slope * val); }
+};
+
+/**
+ *
+ * @struct: GeluAct -> x * Phi(x), tanh approximation
+ *
+ */
+struct GeluAct
+{
+    // sqrt(2 / pi)
+    static constexpr double scale = 0.7978845608028654;
+    static constexpr double cubic = 0.044715;
+
+    static double apply(double val) noexcept
+    {
+        return 0.5 * val * (1.0 + std::tanh(scale * (val + cubic * val * val * val)));
+    }
+
+    template <typename Derived>
+    static auto apply(const Eigen::ArrayBase<Derived>& val)
+    {
+        return 0.5 * val * (1.0 + (scale * (val + cubic * val.cube())).tanh());
+    }
+};
+
+/**
+ *
+ * @struct: HardSigmoidAct -> clamp(0.2 * x + 0.5, 0, 1), a piecewise linear sigmoid without exp
+ *
+ */
+struct HardSigmoidAct
+{
+    static double apply(double val) noexcept { return std::clamp(0.2 * val + 0.5, 0.0, 1.0); }
+
+    template <typename Derived>
+    static auto apply(const Eigen::ArrayBase<Derived>& val) { return (0.2 * val + 0.5).max(0.0).min(1.0); }
+};
+
+#endif
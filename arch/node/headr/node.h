@@ -1,10 +1,15 @@
 #ifndef NODE_H
 #define NODE_H
 
+#include "activation.h"
+#include "param.h"
+#include <cmath>
+#include <cstddef>
+#include <span>
+#include <type_traits>
 #include <vector>
 
 
-
 /**
  *
  * THINGS TO ADD:
@@ -19,35 +24,105 @@
 
 
 /**
- *  @struct: BaseNode -> feedforward model node
+ *  @struct: BasicNode -> feedforward model node
+ *
+ *  @tparam: Act -> activation policy (activation.h) applied to the weighted sum
  */
- struct BaseNode
+template <typename Act = TanhAct>
+ struct BasicNode
          {
+             using ActivationPolicy = Act;
+
              static double activation_func(double nodeInfo) noexcept
              {
-                 return std::tanh(nodeInfo);
+                 return Act::apply(nodeInfo);
              }
 
          };
 
+using BaseNode = BasicNode<TanhAct>;
+
 /**
- * @struct: LstmNode -> LSTM node model
+ * @struct: BasicLstmNode -> LSTM node model
+ *
+ * @tparam: Act -> activation policy of the cell input and the cell output (tanh in the classic LSTM)
+ * @tparam: Gate -> activation policy of the forget, input and output gates (sigmoid in the classic LSTM)
  *
  * @values:
  *     LongTermState -> type: double, the long term state of the node
  *     ShortTermStare -> type: double, the short term state of the node
- *     forgetVals -> type: vector<double>, the weights and bias of the forget gate
- *     inputVals -> type: vector<double>, the weights and bias of the input gate
- *     outputVals -> type: vector<double>, the weights and bias of the output gate
+ *     forgetVals -> type: ParamVec, the weights and bias of the forget gate
+ *     inputVals -> type: ParamVec, the weights and bias of the input gate
+ *     outputVals -> type: ParamVec, the weights and bias of the output gate
  */
- struct LstmNode:BaseNode
+template <typename Act = TanhAct, typename Gate = SigmoidAct>
+ struct BasicLstmNode:BasicNode<Act>
              {
+                 using GatePolicy = Gate;
+
                  double LongTermState = 0.0;
                  double ShortTermState = 0.0;
-                 std::vector<double> forgetVals;
-                 std::vector<double> inputVals;
-                 std::vector<double> outputVals;
+                 ParamVec forgetVals;
+                 ParamVec inputVals;
+                 ParamVec outputVals;
              };
+
+using LstmNode = BasicLstmNode<TanhAct, SigmoidAct>;
+
+// LSTM with piecewise linear gates, no exp on the gate path
+using HardGateLstmNode = BasicLstmNode<TanhAct, HardSigmoidAct>;
+
+/**
+ * @brief: true for every BasicLstmNode, whatever its policies
+ */
+template <typename NodeType>
+struct IsLstmNode : std::false_type {};
+
+template <typename Act, typename Gate>
+struct IsLstmNode<BasicLstmNode<Act, Gate>> : std::true_type {};
+
+template <typename NodeType>
+inline constexpr bool isLstmNode = IsLstmNode<NodeType>::value;
+
+/**
+ * @struct: BasicGruNode -> GRU node model, update and reset gates over one hidden state, no LTM cell
+ *
+ * @tparam: Act -> activation policy of the candidate state (tanh in the classic GRU)
+ * @tparam: Gate -> activation policy of the update and reset gates (sigmoid in the classic GRU)
+ *
+ * @values:
+ *     ShortTermState -> type: double, the hidden state of the node, which is also its output
+ *     updateVals -> type: ParamVec, the weights and bias of the update gate
+ *     resetVals -> type: ParamVec, the weights and bias of the reset gate
+ *     candidateVals -> type: ParamVec, the weights and bias of the candidate state
+ *
+ * @note: every vec is laid out like the LSTM forget gate, [input weight, STM weight] per input then the bias
+ */
+template <typename Act = TanhAct, typename Gate = SigmoidAct>
+ struct BasicGruNode:BasicNode<Act>
+             {
+                 using GatePolicy = Gate;
+
+                 double ShortTermState = 0.0;
+                 ParamVec updateVals;
+                 ParamVec resetVals;
+                 ParamVec candidateVals;
+             };
+
+using GruNode = BasicGruNode<TanhAct, SigmoidAct>;
+
+/**
+ * @brief: true for every BasicGruNode, whatever its policies
+ */
+template <typename NodeType>
+struct IsGruNode : std::false_type {};
+
+template <typename Act, typename Gate>
+struct IsGruNode<BasicGruNode<Act, Gate>> : std::true_type {};
+
+template <typename NodeType>
+inline constexpr bool isGruNode = IsGruNode<NodeType>::value;
+
 /**
  * 
  * @class: NetworkNode -> base neuron for network
@@ -101,11 +176,12 @@ class NetworkNode
          * 
          * @breif: Calculates the output of the node for the inputs coming in
          * 
-         * @param: inputs ->  type: vector<double>, input values for the node
+         * @param: inputs ->  type: span<const double>, input values for the node (vectors and arena
+         *                      buffers both bind here without a copy)
          * @return: output -> type: double, calculated output post weighted sum, bias, and
          *                      activation function
          */
-        double find_output(const std::vector<double>& inputs, double agreSTM = (0), double agreLTM = (0)) noexcept;
+        double find_output(std::span<const double> inputs, double agreSTM = (0), double agreLTM = (0)) noexcept;
 
         /**
          * 
@@ -147,12 +223,36 @@ class NetworkNode
          */
         double getWeightVecElement(size_t index) const noexcept { return weightVec.at(index); }
 
+        /**
+         * @breif: setter function for the elements of the weight vector
+         *
+         * @param: index -> type: size_t, the index of the element
+         * @param: val -> type: double, the new weight
+         *
+         */
+        void setWeightVecElement(size_t index, double val) noexcept { weightVec[index] = val; }
+
         /**
          * @breif: getter function for the weight vector
          *
          * @return: vector<double> -> type: vector<double>, the weight vector
          */
-        std::vector<double> getWeightVec(size_t index) const noexcept { return weightVec; }
+        std::vector<double> getWeightVec(size_t index) const noexcept { return {weightVec.begin(), weightVec.end()}; }
+
+        /**
+         * @breif: getter functions for the parameter views, used to find their gradients in a ParamBuffer
+         */
+        ParamVec& getWeightParams() noexcept { return weightVec; }
+        ParamScalar& getBiasParam() noexcept { return biasVal; }
+
+        /**
+         *
+         * @brief: registers every trainable value of the node (weights, bias, LSTM gates) with the buffer
+         *
+         * @param: buffer -> type: ParamBuffer&, model wide parameter buffer, bound by the caller
+         *
+         */
+        void registerParams(ParamBuffer& buffer);
 
         /**
          *
@@ -214,18 +314,20 @@ class NetworkNode
           /**
            * @breif calculates the forget gate
            *
-           * @param: inputs -> std::vector<double>, the input value
+           * @param: inputs -> std::span<const double>, the input value (defaults to the stored inputs)
            * @return: double -> the new LT memory cell
            */
            double calcForgetGate();
+           double calcForgetGate(std::span<const double> in);
 
            /**
            * @breif calculates the input gate
            *
-           * @param: inputs -> std::vector<double>, the input value
+           * @param: inputs -> std::span<const double>, the input value (defaults to the stored inputs)
            * @return: double -> the new LT memory cell
            */
            double calcInputGate();
+           double calcInputGate(std::span<const double> in);
 
            /**
            * @breif calculates the input gate
@@ -235,6 +337,26 @@ class NetworkNode
            */
            std::vector<double> calcOutputGate();
 
+           /**
+           * @breif allocation free output gate, used on the hot path
+           *
+           * @param: in -> std::span<const double>, the input value
+           * @return: double -> the new ST memory cell, which is also the gate output
+           */
+           double calcOutputGate(std::span<const double> in);
+
+           /**
+            * HELPER FUNCTIONS FOR THE GRU NODE
+            */
+
+           /**
+           * @breif advances the GRU hidden state, h = (1 - z) * h + z * tanh(candidate over r * h)
+           *
+           * @param: in -> std::span<const double>, the input value
+           * @return: double -> the new ST memory cell, which is also the node output
+           */
+           double calcGruStep(std::span<const double> in);
+
            void changeInputVecWhole(std::vector<double> vec)
            {
                inputs.resize(vec.size());
@@ -243,10 +365,10 @@ class NetworkNode
 
     private:
         NodeType node;
-        std::vector<double> weightVec;
+        ParamVec weightVec;
         std::vector<double> inputs;
         int numOutput;
-        double biasVal;
+        ParamScalar biasVal;
         double output;
 };
 
@@ -0,0 +1,295 @@
+#ifndef PARAM_H
+#define PARAM_H
+
+#include "../../memory/headr/arena.h"
+#include <cstddef>
+#include <initializer_list>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+/**
+ *
+ * PARAMETER STORAGE:
+ *  - every trainable value in a node (weightVec, biasVal, the LSTM gate weights) is a ParamVec / ParamScalar
+ *  - on its own a view owns its values, so nodes behave exactly like before
+ *  - once a ParamBuffer binds the model, every view points into one flat, aligned values array and the
+ *      matching grads array, so an optimizer step is one streaming sweep instead of a walk per node
+ *
+ */
+
+/**
+ *
+ * @class: ParamVec -> vector of parameters that either owns its values or views a ParamBuffer
+ *
+ * @note: copies are always owning (a copied node never aliases the buffer of the original),
+ *          assigning to a bound view writes the values through, so the sizes have to match
+ *
+ */
+class ParamVec
+{
+    public:
+        ParamVec() noexcept { sync(); }
+        explicit ParamVec(std::size_t count, double val = 0.0) : owned(count, val) { sync(); }
+        ParamVec(std::initializer_list<double> vals) : owned(vals) { sync(); }
+        ParamVec(const ParamVec& base) : owned(base.begin(), base.end()) { sync(); }
+
+        ParamVec& operator=(const ParamVec& base)
+        {
+            if (this != &base)
+            {
+                assign(base.begin(), base.end());
+            }
+            return *this;
+        }
+
+        ParamVec& operator=(std::initializer_list<double> vals)
+        {
+            assign(vals.begin(), vals.end());
+            return *this;
+        }
+
+        std::size_t size() const noexcept { return len; }
+        bool empty() const noexcept { return len == 0; }
+        bool isBound() const noexcept { return bound; }
+
+        double* data() noexcept { return ptr; }
+        const double* data() const noexcept { return ptr; }
+        double* begin() noexcept { return ptr; }
+        double* end() noexcept { return ptr + len; }
+        const double* begin() const noexcept { return ptr; }
+        const double* end() const noexcept { return ptr + len; }
+
+        double& operator[](std::size_t index) noexcept { return ptr[index]; }
+        double operator[](std::size_t index) const noexcept { return ptr[index]; }
+        double& back() noexcept { return ptr[len - 1]; }
+        double back() const noexcept { return ptr[len - 1]; }
+
+        double at(std::size_t index) const
+        {
+            if (index >= len)
+            {
+                throw std::out_of_range("ParamVec index out of range");
+            }
+            return ptr[index];
+        }
+
+        operator std::span<double>() noexcept { return {ptr, len}; }
+        operator std::span<const double>() const noexcept { return {ptr, len}; }
+
+        /**
+         *
+         * @brief: shape changes, only allowed while the view still owns its values
+         *
+         */
+        void resize(std::size_t count, double val = 0.0)
+        {
+            requireOwned();
+            owned.resize(count, val);
+            sync();
+        }
+
+        void reserve(std::size_t count)
+        {
+            requireOwned();
+            owned.reserve(count);
+            sync();
+        }
+
+        void push_back(double val)
+        {
+            requireOwned();
+            owned.push_back(val);
+            sync();
+        }
+
+        /**
+         *
+         * @brief: drops the values, a bound view is detached from its buffer
+         *
+         */
+        void clear() noexcept
+        {
+            bound = false;
+            owned.clear();
+            sync();
+        }
+
+        /**
+         *
+         * @brief: moves the values into target and makes this a view of it (called by ParamBuffer::bind)
+         *
+         * @param: target -> type: double*, size() doubles inside the buffer
+         *
+         */
+        void bind(double* target) noexcept
+        {
+            for (std::size_t i = 0; i < len; ++i)
+            {
+                target[i] = ptr[i];
+            }
+            owned.clear();
+            owned.shrink_to_fit();
+            ptr = target;
+            bound = true;
+        }
+
+    private:
+        template <typename It>
+        void assign(It first, It last)
+        {
+            std::size_t count = static_cast<std::size_t>(last - first);
+            if (bound)
+            {
+                if (count != len)
+                {
+                    throw std::length_error("Cannot resize a ParamVec bound to a ParamBuffer");
+                }
+                for (std::size_t i = 0; i < count; ++i, ++first)
+                {
+                    ptr[i] = *first;
+                }
+                return;
+            }
+            owned.assign(first, last);
+            sync();
+        }
+
+        void requireOwned() const
+        {
+            if (bound)
+            {
+                throw std::logic_error("Cannot reshape a ParamVec bound to a ParamBuffer");
+            }
+        }
+
+        void sync() noexcept
+        {
+            ptr = owned.data();
+            len = owned.size();
+        }
+
+        std::vector<double> owned;
+        double* ptr = nullptr;
+        std::size_t len = 0;
+        bool bound = false;
+};
+
+/**
+ *
+ * @class: ParamScalar -> single parameter (a bias) that either owns its value or views a ParamBuffer
+ *
+ * @note: converts to / assigns from double, so it reads like the plain double it replaces
+ *
+ */
+class ParamScalar
+{
+    public:
+        ParamScalar(double val = 0.0) noexcept : owned(val), ptr(&owned) {}
+        ParamScalar(const ParamScalar& base) noexcept : owned(*base.ptr), ptr(&owned) {}
+
+        ParamScalar& operator=(const ParamScalar& base) noexcept
+        {
+            *ptr = *base.ptr;
+            return *this;
+        }
+
+        ParamScalar& operator=(double val) noexcept
+        {
+            *ptr = val;
+            return *this;
+        }
+
+        operator double() const noexcept { return *ptr; }
+
+        double* data() noexcept { return ptr; }
+        const double* data() const noexcept { return ptr; }
+        bool isBound() const noexcept { return ptr != &owned; }
+
+        void bind(double* target) noexcept
+        {
+            *target = *ptr;
+            ptr = target;
+        }
+
+    private:
+        double owned;
+        double* ptr;
+};
+
+/**
+ *
+ * @class: ParamBuffer -> model wide flat values + gradients, 64 byte aligned for the optimizer kernels
+ *
+ * @note: usage is register everything, then bind once
+ *              ParamBuffer params;
+ *              model.registerParams(params);
+ *              params.bind();
+ *          the buffer has to outlive the model's use of it (the views point into it), and the model must
+ *          not be copied or restructured after bind, just like spans handed out by the arena
+ *
+ */
+class ParamBuffer
+{
+    public:
+        ParamBuffer() = default;
+        ParamBuffer(const ParamBuffer&) = delete;
+        ParamBuffer& operator=(const ParamBuffer&) = delete;
+
+        /**
+         *
+         * @brief: queues a view to be placed in the buffer at the next bind
+         *
+         * @param: view -> type: ParamVec& / ParamScalar&, parameter to place
+         *
+         */
+        void add(ParamVec& view);
+        void add(ParamScalar& view);
+
+        /**
+         *
+         * @brief: allocates the flat arrays, copies every registered value in and rebinds the views
+         *
+         */
+        void bind();
+
+        /**
+         *
+         * @brief: sets every gradient to zero, call before accumulating a new batch
+         *
+         */
+        void zeroGrad() noexcept;
+
+        /**
+         *
+         * @brief: gradient storage that matches a bound view
+         *
+         * @param: view -> type: const ParamVec& / const ParamScalar&, view bound to this buffer
+         * @return: span<double> / double& -> gradients laid out like the view's values
+         *
+         */
+        std::span<double> gradOf(const ParamVec& view);
+        double& gradOf(const ParamScalar& view);
+
+        std::span<double> values() noexcept { return {vals.data(), count}; }
+        std::span<double> grads() noexcept { return {grad.data(), count}; }
+        std::span<const double> values() const noexcept { return {vals.data(), count}; }
+        std::span<const double> grads() const noexcept { return {grad.data(), count}; }
+
+        std::size_t size() const noexcept { return count; }
+        bool isBound() const noexcept { return bound; }
+
+        static constexpr std::size_t alignment = 64;
+
+    private:
+        std::size_t offsetOf(const double* ptr, std::size_t len) const;
+
+        std::vector<ParamVec*> pendingVecs;
+        std::vector<ParamScalar*> pendingScalars;
+        std::vector<double, AlignedAllocator<double, alignment>> vals;
+        std::vector<double, AlignedAllocator<double, alignment>> grad;
+        std::size_t count = 0;
+        bool bound = false;
+};
+
+#endif
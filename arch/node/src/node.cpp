@@ -1,4 +1,5 @@
 #include "../headr/node.h"
+#include "../../exec/headr/reduce.h"
 #include <cmath>
 #include <stdexcept>
 #include <random>
@@ -25,7 +26,7 @@ NetworkNode<NodeType>::NetworkNode(int inputs)
 {
     try
     {
-        if constexpr(std::is_same<NodeType, LstmNode>::value)
+        if constexpr(isLstmNode<NodeType>)
         {
             // Set the weights to random values - forget
             node.
@@ -40,7 +41,7 @@ NetworkNode<NodeType>::NetworkNode(int inputs)
             node.
             inputVals.resize(4 * inputs + 2);
             for(auto& weight : node.
-            forgetVals)
+            inputVals)
             {
                 weight = distribution(generate);
             }
@@ -49,11 +50,23 @@ NetworkNode<NodeType>::NetworkNode(int inputs)
             node.
             outputVals.resize(2 * inputs + 1);
             for(auto& weight : node.
-            forgetVals)
+            outputVals)
             {
                 weight = distribution(generate);
             }
         }
+        else if constexpr(isGruNode<NodeType>)
+        {
+            // Set the weights to random values - update, reset and candidate
+            for(ParamVec* vals : {&node.updateVals, &node.resetVals, &node.candidateVals})
+            {
+                vals->resize(2 * inputs + 1);
+                for(auto& weight : *vals)
+                {
+                    weight = distribution(generate);
+                }
+            }
+        }
         // Set the weights to random values
         if (inputs <= 0)
         {
@@ -121,17 +134,9 @@ NetworkNode<NodeType>::NetworkNode(int inNum, int outNum)
  */
 template <typename NodeType>
 NetworkNode<NodeType>::NetworkNode(const NetworkNode& base) noexcept
-        : weightVec(), biasVal(base.biasVal), output(base.output), numOutput(base.numOutput)
+        : node(base.node), weightVec(base.weightVec), inputs(base.inputs), biasVal(base.biasVal), output(base.output),
+            numOutput(base.numOutput)
 {
-    try {
-        // deep copy: done by allocating memory and then copying the data
-        weightVec.reserve(base.weightVec.size());
-        weightVec.insert(weightVec.end(), base.weightVec.begin(), base.weightVec.end());
-    } catch (const std::exception& e) {
-        // alloc fault: clear vec to original state
-        weightVec.clear();
-        throw std::runtime_error("NetworkNode constructor failed");
-    }
 }
 
 /**
@@ -147,10 +152,12 @@ NetworkNode<NodeType>::NetworkNode(const NetworkNode& base) noexcept
 template <typename NodeType>
 NetworkNode<NodeType>& NetworkNode<NodeType>::operator=(const NetworkNode& base) noexcept {
     if (this != &base) {
-        // Prepare newWeightVec and ensure it won't throw
-        weightVec.clear();
-        weightVec.reserve(base.weightVec.size());
-        weightVec.insert(weightVec.end(), base.weightVec.begin(), base.weightVec.end());
+        // copies the values, a node bound to a ParamBuffer keeps writing into it
+        weightVec = base.weightVec;
+
+        // gate weights, cell state and stored inputs travel with the node
+        node = base.node;
+        inputs = base.inputs;
 
         // Assign scalar values which are noexcept by default
         biasVal = base.biasVal;
@@ -167,7 +174,33 @@ NetworkNode<NodeType>& NetworkNode<NodeType>::operator=(const NetworkNode& base)
 template <typename NodeType>
 NetworkNode<NodeType>::~NetworkNode() noexcept
 {
-    weightVec.clear();
+}
+
+/**
+ *
+ * @brief: registers every trainable value of the node (weights, bias, LSTM / GRU gates) with the buffer
+ *
+ * @param: buffer .
+ * type: ParamBuffer&, model wide parameter buffer, bound by the caller
+ *
+ */
+template <typename NodeType>
+void NetworkNode<NodeType>::registerParams(ParamBuffer& buffer)
+{
+    buffer.add(weightVec);
+    buffer.add(biasVal);
+    if constexpr(isLstmNode<NodeType>)
+    {
+        buffer.add(node.forgetVals);
+        buffer.add(node.inputVals);
+        buffer.add(node.outputVals);
+    }
+    else if constexpr(isGruNode<NodeType>)
+    {
+        buffer.add(node.updateVals);
+        buffer.add(node.resetVals);
+        buffer.add(node.candidateVals);
+    }
 }
 
 
@@ -182,7 +215,7 @@ NetworkNode<NodeType>::~NetworkNode() noexcept
  *                      activation function
  */
 template <typename NodeType>
-double NetworkNode<NodeType>::find_output(const std::vector<double>& inputs,
+double NetworkNode<NodeType>::find_output(std::span<const double> inputs,
                                           double agreSTM,
                                           double agreLTM) noexcept {
     try {
@@ -190,7 +223,7 @@ double NetworkNode<NodeType>::find_output(const std::vector<double>& inputs,
             throw std::invalid_argument("Input vector size does not match weight vector size");
         }
 
-        if constexpr(std::is_same<NodeType, LstmNode>::value)
+        if constexpr(isLstmNode<NodeType>)
         {
             // aggregated value of LTM cell based on average of inputs from prev cells
             node.
@@ -198,15 +231,24 @@ double NetworkNode<NodeType>::find_output(const std::vector<double>& inputs,
             // aggregated value of STM cell based on average of inputs from prev cells
             node.
             ShortTermState = agreSTM;
-            calcForgetGate();
-            calcInputGate();
-            output = calcOutputGate()[0];
+            calcForgetGate(inputs);
+            calcInputGate(inputs);
+            output = calcOutputGate(inputs);
+        }
+        else if constexpr(isGruNode<NodeType>)
+        {
+            // the GRU has no LTM cell, only the aggregated STM is carried in
+            node.
+            ShortTermState = agreSTM;
+            output = calcGruStep(inputs);
         }
 
-        // Convert inputs and weight vector to Eigen vectors
-        Eigen::VectorXd inputVec = Eigen::Map<const Eigen::VectorXd>(inputs.data(), inputs.size());
-        Eigen::VectorXd weightVecEigen = Eigen::Map<const Eigen::VectorXd>(weightVec.data(), weightVec.size());
-        double weightedSum = weightVecEigen.dot(inputVec) + biasVal;
+        // Map the inputs and weight vector in place, no Eigen temporaries are allocated
+        Eigen::Map<const Eigen::VectorXd> inputVec(inputs.data(), inputs.size());
+        Eigen::Map<const Eigen::VectorXd> weightVecEigen(weightVec.data(), weightVec.size());
+        double dot = deterministicReductions() ? fixedDot(weightVec.data(), inputs.data(), inputs.size())
+                                               : weightVecEigen.dot(inputVec);
+        double weightedSum = dot + biasVal;
 
         // Apply activation function and store the output
         output = activation_func(weightedSum);
@@ -219,7 +261,7 @@ double NetworkNode<NodeType>::find_output(const std::vector<double>& inputs,
 
 /**
  * 
- * @brief: Applies the tanh activation function to the node's weighted sum and bias
+ * @brief: Applies the node type's activation policy to the node's weighted sum and bias
  * 
  * @param nodeInfo .
  * type: double, the weighted sum of inputs plus bias
@@ -229,7 +271,7 @@ double NetworkNode<NodeType>::find_output(const std::vector<double>& inputs,
 template <typename NodeType>
 double NetworkNode<NodeType>::activation_func(double nodeInfo) noexcept
 {
-    return std::tanh(nodeInfo);
+    return NodeType::activation_func(nodeInfo);
 };
 
 /**
@@ -270,23 +312,33 @@ void NetworkNode<NodeType>::set(double newVal) noexcept
 template <typename NodeType>
 double NetworkNode<NodeType>::calcForgetGate()
 {
-    if constexpr(std::is_same<NodeType, LstmNode>::value)
+    return calcForgetGate(inputs);
+}
+
+template <typename NodeType>
+double NetworkNode<NodeType>::calcForgetGate(std::span<const double> in)
+{
+    if constexpr(isLstmNode<NodeType>)
     {
+        if(node.forgetVals.size() < 2 * in.size() + 1)
+        {
+            throw std::invalid_argument("Forget gate weights do not match the input size");
+        }
         double runningSum = 0;
         double b1 = node.
                 forgetVals[node.
                 forgetVals.size() - 1];
-        for(int i = 0; i < inputs.size(); i++)
+        for(size_t i = 0; i < in.size(); i++)
         {
             double w1 = node.
                     forgetVals[i * 2];
             double w2 = node.
                     forgetVals[i * 2 + 1];
-            runningSum += (w1 * inputs[i]) + (w2 * node.
+            runningSum += (w1 * in[i]) + (w2 * node.
                     ShortTermState) + b1;
         }
         return(node.
-        LongTermState *= (1.0/ (1.0 + std::exp(-runningSum))));
+        LongTermState *= NodeType::GatePolicy::apply(runningSum));
 
     } else {
         throw std::invalid_argument("Node is not an LstmNode");
@@ -305,8 +357,18 @@ double NetworkNode<NodeType>::calcForgetGate()
 template <typename NodeType>
 double NetworkNode<NodeType>::calcInputGate()
 {
-    if constexpr(std::is_same<NodeType, LstmNode>::value)
+    return calcInputGate(inputs);
+}
+
+template <typename NodeType>
+double NetworkNode<NodeType>::calcInputGate(std::span<const double> in)
+{
+    if constexpr(isLstmNode<NodeType>)
     {
+        if(node.inputVals.size() < 4 * in.size() + 2)
+        {
+            throw std::invalid_argument("Input gate weights do not match the input size");
+        }
         // sig side calculation
         double b1 = node.
                 inputVals[node.
@@ -315,29 +377,29 @@ double NetworkNode<NodeType>::calcInputGate()
                 inputVals[node.
                 inputVals.size() - 1];
         double runningSumSig = 0;
-        for(int i = 0; i < inputs.size(); i++)
+        for(size_t i = 0; i < in.size(); i++)
         {
             double w1 = node.
                     inputVals[i * 4];
             double w2 = node.
                     inputVals[i * 4 + 1];
-            runningSumSig += (w1 * inputs[i]) + (w2 * node.
+            runningSumSig += (w1 * in[i]) + (w2 * node.
                     ShortTermState) + b1;
         }
-        runningSumSig = (1.0 / (1.0 + std::exp(-runningSumSig)));
+        runningSumSig = NodeType::GatePolicy::apply(runningSumSig);
 
         // tanh side calculation
         double runningSumTanh = 0;
-        for(int i = 0; i < inputs.size(); i++)
+        for(size_t i = 0; i < in.size(); i++)
         {
             double w3 = node.
                     inputVals[i * 4 + 2];
             double w4 = node.
                     inputVals[i * 4 + 3];
-            runningSumTanh += (w3 * inputs[i]) + (w4 * node.
+            runningSumTanh += (w3 * in[i]) + (w4 * node.
                     ShortTermState) + b2;
         }
-        runningSumTanh = std::tanh(runningSumTanh);
+        runningSumTanh = NodeType::ActivationPolicy::apply(runningSumTanh);
         return(node.
         LongTermState += (runningSumSig * runningSumTanh));
 
@@ -360,27 +422,37 @@ double NetworkNode<NodeType>::calcInputGate()
 template <typename NodeType>
 std::vector<double> NetworkNode<NodeType>::calcOutputGate()
 {
-    if constexpr(std::is_same<NodeType, LstmNode>::value)
+    double result = calcOutputGate(std::span<const double>(inputs));
+    return(std::vector<double>{result, result});
+}
+
+template <typename NodeType>
+double NetworkNode<NodeType>::calcOutputGate(std::span<const double> in)
+{
+    if constexpr(isLstmNode<NodeType>)
     {
+        if(node.outputVals.size() < 2 * in.size() + 1)
+        {
+            throw std::invalid_argument("Output gate weights do not match the input size");
+        }
         double runningSum = 0;
         double b1 = node.
                 outputVals[node.
                 outputVals.size() - 1];
-        for(int i = 0; i < inputs.size(); i++)
+        for(size_t i = 0; i < in.size(); i++)
         {
             double w1 = node.
                     outputVals[i * 2];
             double w2 = node.
                     outputVals[i * 2 + 1];
-            runningSum += (w1 * inputs[i]) + (w2 * node.
+            runningSum += (w1 * in[i]) + (w2 * node.
                     ShortTermState) + b1;
         }
-        double result = std::tanh(node.
-                LongTermState) * (1.0/ (1.0 + std::exp(-runningSum)));
+        double result = NodeType::ActivationPolicy::apply(node.
+                LongTermState) * NodeType::GatePolicy::apply(runningSum);
         node.
         ShortTermState = result;
-        return(std::vector<double>{result, result});
-
+        return result;
 
     } else {
         throw std::invalid_argument("Node is not an LstmNode");
@@ -388,9 +460,61 @@ std::vector<double> NetworkNode<NodeType>::calcOutputGate()
 }
 
 
+/**
+* @breif advances the GRU hidden state
+*
+* @param: in .
+ * std::span<const double>, the input value
+*
+* @return: double .
+ * the new ST memory cell, which is also the node output
+*
+* @note: the reset gate scales the STM seen by the candidate, the update gate blends the candidate into it
+*/
+template <typename NodeType>
+double NetworkNode<NodeType>::calcGruStep(std::span<const double> in)
+{
+    if constexpr(isGruNode<NodeType>)
+    {
+        size_t needed = 2 * in.size() + 1;
+        if(node.updateVals.size() < needed || node.resetVals.size() < needed || node.candidateVals.size() < needed)
+        {
+            throw std::invalid_argument("GRU gate weights do not match the input size");
+        }
+        // one gate sum, [input weight, STM weight] per input with the bias added once per input
+        auto gateSum = [&](const ParamVec& vals, double state)
+        {
+            double runningSum = 0;
+            double b1 = vals[vals.size() - 1];
+            for(size_t i = 0; i < in.size(); i++)
+            {
+                runningSum += (vals[i * 2] * in[i]) + (vals[i * 2 + 1] * state) + b1;
+            }
+            return runningSum;
+        };
+        double update = NodeType::GatePolicy::apply(gateSum(node.updateVals, node.ShortTermState));
+        double reset = NodeType::GatePolicy::apply(gateSum(node.resetVals, node.ShortTermState));
+        double candidate = NodeType::ActivationPolicy::apply(gateSum(node.candidateVals,
+                                                                     reset * node.ShortTermState));
+        node.
+        ShortTermState += update * (candidate - node.ShortTermState);
+        return node.ShortTermState;
+
+    } else {
+        throw std::invalid_argument("Node is not a GruNode");
+    }
+}
+
 
 template class NetworkNode<BaseNode>;
+template class NetworkNode<BasicNode<SigmoidAct>>;
+template class NetworkNode<BasicNode<ReluAct>>;
+template class NetworkNode<BasicNode<LeakyReluAct>>;
+template class NetworkNode<BasicNode<GeluAct>>;
+template class NetworkNode<BasicNode<HardSigmoidAct>>;
 template class NetworkNode<LstmNode>;
+template class NetworkNode<HardGateLstmNode>;
+template class NetworkNode<GruNode>;
 
 
 
@@ -0,0 +1,108 @@
+#include "../headr/param.h"
+#include <algorithm>
+
+/**
+ *
+ * @brief: queues a view to be placed in the buffer at the next bind
+ *
+ * @param: view .
+ * type: ParamVec& / ParamScalar&, parameter to place
+ *
+ */
+void ParamBuffer::add(ParamVec& view)
+{
+    if (bound)
+    {
+        throw std::logic_error("ParamBuffer is already bound");
+    }
+    pendingVecs.push_back(&view);
+}
+
+void ParamBuffer::add(ParamScalar& view)
+{
+    if (bound)
+    {
+        throw std::logic_error("ParamBuffer is already bound");
+    }
+    pendingScalars.push_back(&view);
+}
+
+/**
+ *
+ * @brief: allocates the flat arrays, copies every registered value in and rebinds the views
+ *
+ * @note: vectors are laid out in registration order followed by the scalars, the tail is padded to a
+ *          full cache line so the optimizer kernels can run whole vectors over it
+ *
+ */
+void ParamBuffer::bind()
+{
+    if (bound)
+    {
+        throw std::logic_error("ParamBuffer is already bound");
+    }
+    count = pendingScalars.size();
+    for (const ParamVec* view : pendingVecs)
+    {
+        count += view->size();
+    }
+    constexpr std::size_t lane = alignment / sizeof(double);
+    std::size_t padded = (count + lane - 1) / lane * lane;
+    vals.assign(padded, 0.0);
+    grad.assign(padded, 0.0);
+
+    std::size_t offset = 0;
+    for (ParamVec* view : pendingVecs)
+    {
+        std::size_t len = view->size();
+        view->bind(vals.data() + offset);
+        offset += len;
+    }
+    for (ParamScalar* view : pendingScalars)
+    {
+        view->bind(vals.data() + offset);
+        ++offset;
+    }
+    pendingVecs.clear();
+    pendingScalars.clear();
+    bound = true;
+}
+
+/**
+ *
+ * @brief: sets every gradient to zero, call before accumulating a new batch
+ *
+ */
+void ParamBuffer::zeroGrad() noexcept
+{
+    std::fill(grad.begin(), grad.end(), 0.0);
+}
+
+/**
+ *
+ * @brief: gradient storage that matches a bound view
+ *
+ * @param: view .
+ * type: const ParamVec& / const ParamScalar&, view bound to this buffer
+ * @return: span<double> / double& .
+ * gradients laid out like the view's values
+ *
+ */
+std::span<double> ParamBuffer::gradOf(const ParamVec& view)
+{
+    return {grad.data() + offsetOf(view.data(), view.size()), view.size()};
+}
+
+double& ParamBuffer::gradOf(const ParamScalar& view)
+{
+    return grad[offsetOf(view.data(), 1)];
+}
+
+std::size_t ParamBuffer::offsetOf(const double* ptr, std::size_t len) const
+{
+    if (!bound || ptr < vals.data() || ptr + len > vals.data() + count)
+    {
+        throw std::invalid_argument("View is not bound to this ParamBuffer");
+    }
+    return static_cast<std::size_t>(ptr - vals.data());
+}
@@ -0,0 +1,73 @@
+#include "../headr/node.h"
+#include <gtest/gtest.h>
+#include <cmath>
+
+class ActivationTest : public ::testing::Test{};
+
+namespace
+{
+    // the array form must give the scalar form on every element
+    template <typename Act>
+    void expectFormsAgree(const Eigen::ArrayXd& xs, const char* name)
+    {
+        Eigen::ArrayXd vec = Act::apply(xs);
+        for (Eigen::Index i = 0; i < xs.size(); ++i)
+        {
+            EXPECT_NEAR(vec[i], Act::apply(xs[i]), 1e-15) << name << " forms disagree at " << xs[i];
+        }
+    }
+}
+
+/**
+ * @brief: Tests for the activation policies
+ */
+TEST_F(ActivationTest, Policies)
+{
+    // Test 1: known values
+    EXPECT_DOUBLE_EQ(TanhAct::apply(0.5), std::tanh(0.5)) << "Tanh mismatch";
+    EXPECT_DOUBLE_EQ(SigmoidAct::apply(0.0), 0.5) << "Sigmoid mismatch";
+    EXPECT_DOUBLE_EQ(ReluAct::apply(-2.0), 0.0) << "Relu passed a negative";
+    EXPECT_DOUBLE_EQ(ReluAct::apply(1.5), 1.5) << "Relu changed a positive";
+    EXPECT_DOUBLE_EQ(LeakyReluAct::apply(-2.0), -0.02) << "Leaky relu slope mismatch";
+    EXPECT_NEAR(GeluAct::apply(1.0), 0.8411919906, 1e-9) << "Gelu mismatch";
+    EXPECT_DOUBLE_EQ(HardSigmoidAct::apply(0.0), 0.5) << "Hard sigmoid centre mismatch";
+    EXPECT_DOUBLE_EQ(HardSigmoidAct::apply(10.0), 1.0) << "Hard sigmoid not clamped high";
+    EXPECT_DOUBLE_EQ(HardSigmoidAct::apply(-10.0), 0.0) << "Hard sigmoid not clamped low";
+
+    // Test 2: scalar and array forms agree
+    Eigen::ArrayXd xs = Eigen::ArrayXd::LinSpaced(41, -4.0, 4.0);
+    expectFormsAgree<IdentityAct>(xs, "Identity");
+    expectFormsAgree<TanhAct>(xs, "Tanh");
+    expectFormsAgree<SigmoidAct>(xs, "Sigmoid");
+    expectFormsAgree<ReluAct>(xs, "Relu");
+    expectFormsAgree<LeakyReluAct>(xs, "LeakyRelu");
+    expectFormsAgree<GeluAct>(xs, "Gelu");
+    expectFormsAgree<HardSigmoidAct>(xs, "HardSigmoid");
+}
+
+/**
+ * @brief: Tests for nodes built on the policies
+ */
+TEST_F(ActivationTest, NodePolicies)
+{
+    std::vector<double> inputs = {0.4, -0.9};
+
+    // Test 1: the node type's policy is applied to the weighted sum
+    NetworkNode<BasicNode<ReluAct>> relu(2);
+    double sum = relu.find_output(inputs);
+    EXPECT_DOUBLE_EQ(relu.get(), sum > 0.0 ? sum : 0.0) << "Relu node output mismatch";
+    EXPECT_DOUBLE_EQ(NetworkNode<BaseNode>::activation_func(0.3), std::tanh(0.3)) << "Default node is not tanh";
+
+    // Test 2: LSTM detection covers every policy combination
+    EXPECT_TRUE(isLstmNode<LstmNode>) << "LstmNode not detected";
+    EXPECT_TRUE(isLstmNode<HardGateLstmNode>) << "HardGateLstmNode not detected";
+    EXPECT_FALSE(isLstmNode<BasicNode<GeluAct>>) << "Feedforward node detected as LSTM";
+
+    // Test 3: hard gates keep the cell state bounded like sigmoid gates do
+    NetworkNode<HardGateLstmNode> cell(2);
+    for (int t = 0; t < 20; ++t)
+    {
+        cell.find_output(inputs, cell.getNode().ShortTermState, cell.getNode().LongTermState);
+        EXPECT_LE(std::abs(cell.getNode().ShortTermState), 1.0) << "Hard gate STM out of range at " << t;
+    }
+}
@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include "../headr/node.h"
+
+class NetworkNodeGruTest : public ::testing::Test {};
+
+/**
+ * @brief Test initialization of NetworkNode with GruNode template
+ */
+TEST_F(NetworkNodeGruTest, Initialization)
+{
+    int numInputs = 5;
+    NetworkNode<GruNode> gruNode(numInputs);
+
+    // Test 1: Check weight vector size
+    EXPECT_EQ(gruNode.getWeightVecSize(), numInputs) << "Weight vector size mismatch.";
+
+    // Test 2: Check GruNode-specific attributes
+    auto& internalNode = gruNode.getNode();
+    EXPECT_EQ(internalNode.ShortTermState, 0.0) << "Short-term state not initialized to 0.";
+    EXPECT_EQ(internalNode.updateVals.size(), (2 * numInputs + 1)) << "Update gate vector size mismatch.";
+    EXPECT_EQ(internalNode.resetVals.size(), (2 * numInputs + 1)) << "Reset gate vector size mismatch.";
+    EXPECT_EQ(internalNode.candidateVals.size(), (2 * numInputs + 1)) << "Candidate vector size mismatch.";
+
+    // Test 3: the trait tells the node kinds apart
+    EXPECT_TRUE(isGruNode<GruNode>) << "GruNode not detected.";
+    EXPECT_FALSE(isGruNode<LstmNode>) << "LstmNode detected as a GRU.";
+    EXPECT_FALSE(isLstmNode<GruNode>) << "GruNode detected as an LSTM.";
+}
+
+/**
+ * @brief Test the GRU step against the gate equations
+ */
+TEST_F(NetworkNodeGruTest, GruStep)
+{
+    NetworkNode<GruNode> gruNode(2);
+    GruNode& cell = gruNode.getNode();
+    cell.updateVals = {0.5, -0.2, 0.3, 0.4, 0.1};
+    cell.resetVals = {-0.3, 0.6, 0.2, -0.1, 0.05};
+    cell.candidateVals = {0.7, 0.8, -0.4, 0.2, -0.1};
+    std::vector<double> inputs = {0.4, -0.6};
+    double state = 0.3;
+
+    // Test 1: one step matches h = (1 - z) * h + z * tanh(candidate over r * h)
+    auto sum = [&](const ParamVec& vals, double stm)
+    {
+        double total = 0.0;
+        for (size_t i = 0; i < inputs.size(); ++i)
+        {
+            total += vals[i * 2] * inputs[i] + vals[i * 2 + 1] * stm + vals[4];
+        }
+        return total;
+    };
+    double update = 1.0 / (1.0 + std::exp(-sum(cell.updateVals, state)));
+    double reset = 1.0 / (1.0 + std::exp(-sum(cell.resetVals, state)));
+    double candidate = std::tanh(sum(cell.candidateVals, reset * state));
+    double expected = (1.0 - update) * state + update * candidate;
+    cell.ShortTermState = state;
+    EXPECT_NEAR(gruNode.calcGruStep(inputs), expected, 1e-12) << "GRU step mismatch.";
+    EXPECT_NEAR(cell.ShortTermState, expected, 1e-12) << "Hidden state not updated.";
+
+    // Test 2: find_output carries the aggregated STM in and advances it
+    gruNode.find_output(inputs, state);
+    EXPECT_NEAR(cell.ShortTermState, expected, 1e-12) << "find_output GRU step mismatch.";
+
+    // Test 3: short gate weights are rejected
+    cell.resetVals = {0.1, 0.2};
+    EXPECT_THROW(gruNode.calcGruStep(inputs), std::invalid_argument) << "Short reset gate accepted.";
+
+    // Test 4: the LSTM gates are not available on a GRU node
+    EXPECT_THROW(gruNode.calcForgetGate(inputs), std::invalid_argument) << "Forget gate ran on a GRU node.";
+}
+
+/**
+ * @brief Test the GRU gates are registered with a parameter buffer
+ */
+TEST_F(NetworkNodeGruTest, RegisterParams)
+{
+    NetworkNode<GruNode> gruNode(3);
+    ParamBuffer buffer;
+    gruNode.registerParams(buffer);
+    buffer.bind();
+
+    // Test 1: weights, bias and the three gate vecs
+    EXPECT_EQ(buffer.size(), 3 + 1 + 3 * 7) << "Registered parameter count mismatch.";
+}
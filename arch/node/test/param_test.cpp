@@ -0,0 +1,68 @@
+#include "../headr/node.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+
+class ParamTest : public ::testing::Test{};
+
+/**
+ * @brief: Tests for the parameter views on their own
+ */
+TEST_F(ParamTest, Views)
+{
+    // Test 1: an unbound view owns its values and copies deeply
+    ParamVec weights = {1.0, 2.0, 3.0};
+    ParamVec copy = weights;
+    copy[0] = 9.0;
+    EXPECT_EQ(weights[0], 1.0) << "Copy aliased the original";
+    EXPECT_EQ(weights.size(), 3) << "Size mismatch";
+
+    // Test 2: bound views read and write the buffer
+    ParamScalar bias = 0.5;
+    ParamBuffer buffer;
+    buffer.add(weights);
+    buffer.add(bias);
+    buffer.bind();
+    EXPECT_EQ(buffer.size(), 4) << "Buffer size mismatch";
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(buffer.values().data()) % ParamBuffer::alignment, 0) << "Buffer not aligned";
+    EXPECT_EQ(buffer.values()[2], 3.0) << "Values not moved into the buffer";
+    EXPECT_EQ(buffer.values()[3], 0.5) << "Scalar not moved into the buffer";
+    buffer.values()[1] = -2.0;
+    EXPECT_EQ(weights[1], -2.0) << "View does not read the buffer";
+    bias = 1.5;
+    EXPECT_EQ(buffer.values()[3], 1.5) << "Scalar does not write the buffer";
+
+    // Test 3: gradients line up with the views, bound shapes are fixed
+    buffer.gradOf(weights)[2] = 4.0;
+    EXPECT_EQ(buffer.grads()[2], 4.0) << "Gradient slot mismatch";
+    EXPECT_EQ(&buffer.gradOf(bias), &buffer.grads()[3]) << "Scalar gradient slot mismatch";
+    EXPECT_THROW(weights.resize(5), std::logic_error) << "Bound view resized";
+    EXPECT_THROW(buffer.gradOf(copy), std::invalid_argument) << "Unbound view found in buffer";
+    buffer.zeroGrad();
+    EXPECT_EQ(buffer.grads()[2], 0.0) << "Gradients not cleared";
+}
+
+/**
+ * @brief: Tests for binding whole nodes
+ */
+TEST_F(ParamTest, NodeBinding)
+{
+    // Test 1: every LSTM parameter lands in the buffer and the node output is unchanged
+    NetworkNode<LstmNode> node(2);
+    std::vector<double> inputs = {0.3, -0.7};
+    double before = node.find_output(inputs, 0.1, 0.2);
+    ParamBuffer buffer;
+    node.registerParams(buffer);
+    buffer.bind();
+    EXPECT_EQ(buffer.size(), 2 + 1 + 5 + 10 + 5) << "LSTM parameter count mismatch";
+    EXPECT_DOUBLE_EQ(node.find_output(inputs, 0.1, 0.2), before) << "Binding changed the output";
+
+    // Test 2: writes to the buffer are seen by the node
+    buffer.values()[0] += 1.0;
+    EXPECT_NE(node.find_output(inputs, 0.1, 0.2), before) << "Node does not read the buffer";
+
+    // Test 3: copies of a bound node are independent
+    NetworkNode<LstmNode> copy = node;
+    copy.setWeightVecElement(0, 42.0);
+    EXPECT_NE(node.getWeightVecElement(0), 42.0) << "Copied node aliased the buffer";
+    EXPECT_FALSE(copy.getWeightParams().isBound()) << "Copied node still bound";
+}
@@ -0,0 +1,159 @@
+#ifndef BPTT_H
+#define BPTT_H
+
+#include "../../model/headr/model.h"
+#include <Eigen/Dense>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+/**
+ *
+ * @struct: BpttConfig -> truncation and checkpointing of the listener backward pass
+ *
+ * @values:
+ *     window -> type: size_t, timesteps per truncated chunk, gradients never flow across a chunk boundary
+ *     checkpointInterval -> type: size_t, only every k-th timestep's cell state is kept, the k steps in
+ *                              between are recomputed during the backward pass (1 keeps every step)
+ *
+ * @note: memory per chunk is window / k cell states plus k full timesteps of gate activations, so
+ *          k around sqrt(window) is the smallest, k = 1 is the fastest
+ *
+ */
+struct BpttConfig
+{
+    size_t window = 64;
+    size_t checkpointInterval = 8;
+};
+
+/**
+ *
+ * @struct: HiddenHint -> extra loss pulling the top layer STM, through a linear projection, towards given states
+ *
+ * @values:
+ *     targets -> type: span<const double>, width values per timestep
+ *     width -> type: size_t, values per timestep
+ *     projection -> type: span<const double>, width x top layer nodes, row major
+ *     projectionGrad -> type: span<double>, same shape, the projection gradient is added here
+ *     weight -> type: double, the term is weight * 0.5 * ||projection * stm - target||^2, averaged over the
+ *                  sequence like the preference loss
+ *
+ */
+struct HiddenHint
+{
+    std::span<const double> targets;
+    size_t width = 0;
+    std::span<const double> projection;
+    std::span<double> projectionGrad;
+    double weight = 0.0;
+};
+
+/**
+ *
+ * @class: TruncatedBptt -> accumulates listener gradients over arbitrarily long sequences in fixed memory
+ *
+ * @note: the loss is the mean of 0.5 * (preference - target)^2 over the sequence, gradients are added to
+ *          the listener's views in a bound ParamBuffer (layers and readout), so an optimizer can step
+ *          straight after. Each sequence starts from a zero cell state, the state of the nodes is not used
+ *
+ */
+class TruncatedBptt
+{
+    public:
+        /**
+         *
+         * @brief: constructor
+         *
+         * @param: listener -> type: Listener&, model to train, registered with params
+         * @param: params -> type: ParamBuffer&, bound buffer holding the listener parameters
+         * @param: config -> type: BpttConfig, window and checkpoint interval
+         *
+         */
+        TruncatedBptt(Listener& listener, ParamBuffer& params, BpttConfig config = {});
+
+        /**
+         *
+         * @brief: runs one sequence forward and backward, adding its gradients to the buffer
+         *
+         * @param: features -> type: span<const double>, one value per first layer input per timestep
+         * @param: targets -> type: span<const double>, target preference per timestep
+         * @param: hint -> type: const HiddenHint*, optional hidden state term, nullptr for none
+         * @return: double -> mean loss over the sequence, the hint term included
+         *
+         */
+        double accumulate(std::span<const double> features, std::span<const double> targets,
+                          const HiddenHint* hint = nullptr);
+
+        const BpttConfig& getConfig() const noexcept { return config; }
+
+        // peak number of checkpoints / fully stored timesteps held at once by the last accumulate
+        size_t getPeakCheckpoints() const noexcept { return peakCheckpoints; }
+        size_t getPeakStoredSteps() const noexcept { return peakStoredSteps; }
+
+    private:
+        using RowMatrix = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+        // unpacked weights of one layer and their gradients, slot = gate * nodes + node
+        struct LayerState
+        {
+            size_t nodes = 0;
+            size_t fanIn = 0;
+            RowMatrix weights;
+            Eigen::VectorXd recurrent;
+            Eigen::VectorXd bias;
+            RowMatrix dWeights;
+            Eigen::VectorXd dRecurrent;
+            Eigen::VectorXd dBias;
+        };
+
+        // cell state of every layer at one timestep
+        struct Checkpoint
+        {
+            std::vector<Eigen::VectorXd> stm;
+            std::vector<Eigen::VectorXd> ltm;
+        };
+
+        // everything the backward pass needs from one timestep of one layer
+        struct LayerCache
+        {
+            Eigen::VectorXd input;
+            Eigen::VectorXd pre;
+            Eigen::VectorXd stmPrev;
+            Eigen::VectorXd ltmPrev;
+            Eigen::VectorXd ltm;
+        };
+
+        struct StepCache
+        {
+            std::vector<LayerCache> layers;
+            Eigen::VectorXd output;
+            double preference = 0.0;
+        };
+
+        /**
+         *
+         * @brief: advances every layer one timestep from state, optionally recording the activations
+         *
+         * @return: double -> the readout preference
+         *
+         */
+        double stepForward(std::span<const double> features, Checkpoint& state, StepCache* cache);
+
+        void loadWeights();
+        void storeGrads();
+
+        Listener& listener;
+        ParamBuffer& params;
+        BpttConfig config;
+        // features per timestep, the fan in of the first layer
+        size_t width;
+        std::vector<LayerState> layers;
+        Eigen::VectorXd readout;
+        double readoutBias = 0.0;
+        Eigen::VectorXd dReadout;
+        double dReadoutBias = 0.0;
+        size_t peakCheckpoints = 0;
+        size_t peakStoredSteps = 0;
+};
+
+#endif
@@ -0,0 +1,213 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "optim.h"
+#include "../../data/headr/loader.h"
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ *
+ * TRAINING CHECKPOINTS:
+ *  - capture() copies the parameters and the optimizer state into a staging buffer, which is the only work
+ *      done on the training thread, and hands it to a background writer with a buffer swap
+ *  - the writer compares the snapshot with the last one it wrote in fixed size chunks and writes only the
+ *      chunks that changed, with a full snapshot every fullEvery files so the chain stays short
+ *  - every file is written to a temporary name, checksummed and renamed, so a crash leaves either the old
+ *      or the new file, and restore() ignores a torn or missing tail of the chain
+ *  - a checkpoint also records the training step, the loader position and the trainer's RNG, so a resumed
+ *      run sees the same batches and draws the same numbers as an uninterrupted one
+ *
+ */
+
+/**
+ *
+ * @struct: TrainingState -> where the training loop is, stored next to the parameters
+ *
+ * @values:
+ *     step -> type: size_t, the caller's step counter
+ *     loader -> type: LoaderPosition, PrefetchLoader::position() at the capture, LoaderConfig::start on resume
+ *     rng -> type: std::string, serialised random engine (saveRng / restoreRng)
+ *
+ */
+struct TrainingState
+{
+    size_t step = 0;
+    LoaderPosition loader;
+    std::string rng;
+};
+
+/**
+ *
+ * @struct: CheckpointConfig -> chunking and cadence of the checkpoint files
+ *
+ * @values:
+ *     chunkSize -> type: size_t, doubles per compared chunk, the unit of a delta
+ *     fullEvery -> type: size_t, every fullEvery-th file is a full snapshot, older files are then removed
+ *     waitForWriter -> type: bool, capture() waits for a busy writer instead of skipping the capture
+ *
+ */
+struct CheckpointConfig
+{
+    size_t chunkSize = 4096;
+    size_t fullEvery = 16;
+    bool waitForWriter = false;
+};
+
+/**
+ *
+ * @struct: CheckpointStats -> what the checkpointer did
+ *
+ * @values:
+ *     captures -> type: size_t, snapshots handed to the writer
+ *     skipped -> type: size_t, captures dropped because the writer still had one pending
+ *     fullWrites / deltaWrites -> type: size_t, files written of each kind
+ *     chunksWritten -> type: size_t, chunks written over all files
+ *     bytesWritten -> type: size_t, file bytes written
+ *     captureSeconds -> type: double, time the training thread spent in capture()
+ *     writeSeconds -> type: double, time the writer spent on files
+ *
+ */
+struct CheckpointStats
+{
+    size_t captures = 0;
+    size_t skipped = 0;
+    size_t fullWrites = 0;
+    size_t deltaWrites = 0;
+    size_t chunksWritten = 0;
+    size_t bytesWritten = 0;
+    double captureSeconds = 0.0;
+    double writeSeconds = 0.0;
+};
+
+/**
+ *
+ * @brief: serialises a standard random engine, the text form round trips the whole engine state
+ *
+ */
+template <typename Engine>
+std::string saveRng(const Engine& engine)
+{
+    std::ostringstream out;
+    out << engine;
+    return out.str();
+}
+
+template <typename Engine>
+void restoreRng(const std::string& state, Engine& engine)
+{
+    std::istringstream in(state);
+    in >> engine;
+    if (!in)
+    {
+        throw std::invalid_argument("RNG state does not match the engine");
+    }
+}
+
+/**
+ *
+ * @class: Checkpointer -> double buffered incremental checkpoints of a ParamBuffer and its optimizer
+ *
+ * @note: files are <directory>/ckpt-<sequence>.bin in host byte order, the directory is created if needed
+ *
+ */
+class Checkpointer
+{
+    public:
+        /**
+         *
+         * @brief: preallocates the snapshot buffers and starts the writer thread
+         *
+         * @param: directory -> type: std::string, where the files go
+         * @param: params -> type: ParamBuffer&, bound buffer to snapshot
+         * @param: optimizer -> type: Optimizer*, its state and step count are stored too, may be nullptr
+         * @param: config -> type: CheckpointConfig, chunk size and full snapshot cadence
+         *
+         */
+        Checkpointer(std::string directory, ParamBuffer& params, Optimizer* optimizer = nullptr,
+                     CheckpointConfig config = {});
+
+        // writes the pending snapshot, then stops the writer
+        ~Checkpointer();
+
+        Checkpointer(const Checkpointer&) = delete;
+        Checkpointer& operator=(const Checkpointer&) = delete;
+
+        /**
+         *
+         * @brief: snapshots the parameters and the optimizer, the file is written in the background
+         *
+         * @param: state -> type: const TrainingState&, loop position stored with the snapshot
+         * @return: bool -> false if the capture was skipped because the previous one is still pending
+         *
+         */
+        bool capture(const TrainingState& state);
+
+        /**
+         *
+         * @brief: waits until every captured snapshot is on disk, rethrows anything the writer threw
+         *
+         */
+        void flush();
+
+        CheckpointStats stats() const;
+
+        /**
+         *
+         * @brief: loads the newest complete checkpoint: the last full snapshot and the valid deltas after it
+         *
+         * @param: directory -> type: const std::string&, directory a Checkpointer wrote to
+         * @param: params -> type: ParamBuffer&, bound buffer with the layout that was saved
+         * @param: optimizer -> type: Optimizer*, receives the state and step count, may be nullptr
+         * @return: TrainingState -> the loop position of the restored snapshot
+         *
+         */
+        static TrainingState restore(const std::string& directory, ParamBuffer& params, Optimizer* optimizer = nullptr);
+
+    private:
+        struct Snapshot
+        {
+            std::vector<double> data;
+            TrainingState state;
+            size_t optimizerSteps = 0;
+        };
+
+        void run();
+        void write(const Snapshot& snap);
+
+        std::string directory;
+        ParamBuffer& params;
+        Optimizer* optimizer;
+        CheckpointConfig config;
+        size_t numArrays = 0;
+
+        // staging is filled by capture(), pending waits for the writer and current is being written, these
+        // three only ever swap. last is what the newest file on disk holds, empty before the first file
+        Snapshot staging;
+        Snapshot pending;
+        Snapshot current;
+        std::vector<double> last;
+        bool hasPending = false;
+        bool writing = false;
+        bool stopping = false;
+        size_t sequence = 0;
+        size_t lastFull = 0;
+        size_t total = 0;
+        std::exception_ptr error;
+
+        mutable std::mutex lock;
+        std::condition_variable ready;
+        std::condition_variable done;
+        CheckpointStats counters;
+        std::thread worker;
+};
+
+#endif
@@ -0,0 +1,141 @@
+#ifndef DISTILL_H
+#define DISTILL_H
+
+#include "bptt.h"
+#include "optim.h"
+#include <cstddef>
+#include <vector>
+
+/**
+ *
+ * LISTENER DISTILLATION:
+ *  - a wide or deep teacher Listener is run over the training sequences, its preferences (softened by a
+ *      temperature on the logit) become the student's targets and its top layer STM a hint
+ *  - the student's top layer is projected onto the teacher's width by a matrix trained along with it, so a
+ *      narrower student can still be pulled towards the teacher's hidden states
+ *  - both terms are trained with TruncatedBptt, so sequence length does not matter, and one optimizer step
+ *      is taken per sequence
+ *
+ */
+
+/**
+ *
+ * @struct: DistillConfig -> loss weights and schedule of a Distiller
+ *
+ * @values:
+ *     temperature -> type: double, teacher logits are divided by it, above 1 softens the targets
+ *     hiddenWeight -> type: double, weight of the hidden state hint, 0 trains on the preferences only
+ *     bptt -> type: BpttConfig, truncation window and checkpoint interval of the student's backward pass
+ *     timingRepeats -> type: size_t, packed runs per model when evaluate() times them
+ *
+ */
+struct DistillConfig
+{
+    double temperature = 1.0;
+    double hiddenWeight = 0.1;
+    BpttConfig bptt;
+    size_t timingRepeats = 5;
+};
+
+/**
+ *
+ * @struct: DistillReport -> how close and how much cheaper the student is
+ *
+ * @values:
+ *     agreement -> type: double, fraction of timesteps where both are on the same side of 0.5
+ *     meanAbsDiff -> type: double, mean |student - teacher| preference
+ *     maxAbsDiff -> type: double, largest |student - teacher| preference
+ *     teacherSecondsPerStep -> type: double, packed run time per timestep
+ *     studentSecondsPerStep -> type: double, packed run time per timestep
+ *     speedup -> type: double, teacher time over student time
+ *     teacherParams -> type: size_t, parameters of the teacher
+ *     studentParams -> type: size_t, parameters of the student
+ *
+ */
+struct DistillReport
+{
+    double agreement = 0.0;
+    double meanAbsDiff = 0.0;
+    double maxAbsDiff = 0.0;
+    double teacherSecondsPerStep = 0.0;
+    double studentSecondsPerStep = 0.0;
+    double speedup = 0.0;
+    size_t teacherParams = 0;
+    size_t studentParams = 0;
+};
+
+/**
+ *
+ * @brief: parameters of a listener, as many as registerParams adds to a buffer
+ *
+ */
+size_t listenerParams(Listener& listener) noexcept;
+
+/**
+ *
+ * @class: Distiller -> trains a compact student Listener on a teacher's soft outputs and hidden states
+ *
+ */
+class Distiller
+{
+    public:
+        /**
+         *
+         * @brief: constructor
+         *
+         * @param: teacher -> type: Listener&, trained model, only run forward
+         * @param: student -> type: Listener&, model to train, same number of inputs as the teacher
+         * @param: params -> type: ParamBuffer&, bound buffer holding the student's parameters
+         * @param: optimizer -> type: Optimizer&, steps params, its learning rate also steps the projection
+         * @param: config -> type: DistillConfig, temperature, hint weight and BPTT settings
+         *
+         */
+        Distiller(Listener& teacher, Listener& student, ParamBuffer& params, Optimizer& optimizer,
+                  DistillConfig config = {});
+
+        /**
+         *
+         * @brief: one pass over the sequences, one optimizer step each
+         *
+         * @param: sequences -> type: const std::vector<std::vector<double>>&, the listeners' fan in per timestep
+         * @return: double -> mean distillation loss over the sequences
+         *
+         */
+        double train(const std::vector<std::vector<double>>& sequences);
+
+        /**
+         *
+         * @brief: compares and times teacher and student on the same packed sequences
+         *
+         * @param: sequences -> type: const std::vector<std::vector<double>>&, the listeners' fan in per timestep
+         * @return: DistillReport -> agreement, preference gap and speedup
+         *
+         */
+        DistillReport evaluate(const std::vector<std::vector<double>>& sequences);
+
+        const std::vector<double>& getProjection() const noexcept { return projection; }
+
+    private:
+        // teacher preferences, softened, and top layer STM at every timestep of one sequence
+        void teach(std::span<const double> features);
+
+        Listener& teacher;
+        Listener& student;
+        ParamBuffer& params;
+        Optimizer& optimizer;
+        DistillConfig config;
+        TruncatedBptt bptt;
+        size_t teacherWidth;
+        size_t studentWidth;
+        // features per timestep, the shared first layer fan in
+        size_t width;
+
+        // teacher width x student width, row major
+        std::vector<double> projection;
+        std::vector<double> projectionGrad;
+        std::vector<double> softTargets;
+        std::vector<double> hiddenTargets;
+        ExecContext ctx;
+};
+
+#endif
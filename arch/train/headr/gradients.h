@@ -0,0 +1,69 @@
+#ifndef GRADIENTS_H
+#define GRADIENTS_H
+
+#include "hogwild.h"
+#include "../../exec/headr/reduce.h"
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <vector>
+
+/**
+ *
+ * DATA PARALLEL GRADIENTS:
+ *  - the samples of a batch are split over a pool, every task runs them on its own replica of the model,
+ *      and the per task gradients and losses are summed into the shared ParamBuffer for one optimizer step
+ *  - Fast keeps one partial gradient per pool chunk, so the summation order follows the thread count
+ *  - Deterministic (see reduce.h) splits the batch into leaves of leafSamples samples, whatever the pool,
+ *      runs each leaf on a zeroed replica and adds the leaf gradients with the fixed pairwise tree, so the
+ *      batch gradient and loss are the same bits on 1 or 64 threads
+ *
+ */
+
+/**
+ *
+ * @class: ParallelGradients -> synchronous batch gradients over a pool of model replicas
+ *
+ */
+class ParallelGradients
+{
+    public:
+        /**
+         *
+         * @brief: builds one replica per pool thread over every sample
+         *
+         * @param: shared -> type: ParamBuffer&, bound buffer the gradients are summed into
+         * @param: pool -> type: ThreadPool*, nullptr runs every sample on the calling thread
+         * @param: numSamples -> type: size_t, samples the batches index into
+         * @param: factory -> type: const ReplicaFactory&, called with the whole sample range
+         * @param: leafSamples -> type: size_t, samples per leaf in the deterministic mode
+         *
+         */
+        ParallelGradients(ParamBuffer& shared, ThreadPool* pool, size_t numSamples, const ReplicaFactory& factory,
+                          size_t leafSamples = 4);
+
+        /**
+         *
+         * @brief: overwrites the shared gradients with the sum over the batch, values are read from shared
+         *
+         * @param: batch -> type: span<const size_t>, sample indices in the order they are summed
+         * @return: double -> summed loss of the batch
+         *
+         */
+        double accumulate(std::span<const size_t> batch);
+
+        size_t getLeafSamples() const noexcept { return leafSamples; }
+
+    private:
+        ParamBuffer& shared;
+        ThreadPool* pool;
+        size_t numSamples;
+        size_t leafSamples;
+        std::vector<std::unique_ptr<HogwildReplica>> replicas;
+
+        // rows of partial gradients, one per leaf or per chunk, and their losses
+        std::vector<double> partials;
+        std::vector<double> losses;
+};
+
+#endif
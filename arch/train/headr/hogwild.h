@@ -0,0 +1,236 @@
+#ifndef HOGWILD_H
+#define HOGWILD_H
+
+#include "bptt.h"
+#include "metrics.h"
+#include "../../data/headr/dataset.h"
+#include "../../model/headr/model.h"
+#include <Eigen/Dense>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <vector>
+
+/**
+ *
+ * HOGWILD TRAINING:
+ *  - lock free asynchronous SGD, every worker reads and updates the one shared ParamBuffer without any
+ *      lock or barrier, a write lost to a concurrent write of the same weight is simply dropped
+ *  - each worker keeps a private replica of the model bound to its own buffer with the same layout: every
+ *      refreshInterval samples it pulls all the shared values in with relaxed atomic loads, runs the sample's
+ *      forward and backward on the replica, then writes p -= lr * g back with relaxed atomics for the non
+ *      zero gradients only, so sparse gradients touch only their own weights. The written values also go
+ *      into the replica, so between full pulls a worker sees its own updates and the latest shared value of
+ *      every weight it touched, only other workers' writes to the rest are up to refreshInterval - 1 samples
+ *      stale
+ *  - workers run their epochs independently, nobody waits for a slow worker
+ *
+ */
+
+/**
+ *
+ * @struct: HogwildConfig -> workers, schedule and placement of a Hogwild run
+ *
+ * @values:
+ *     threads -> type: size_t, workers, 0 uses every hardware thread
+ *     epochs -> type: size_t, passes of every worker over its shard
+ *     learningRate -> type: double, plain SGD step size
+ *     refreshInterval -> type: size_t, samples between full pulls of the shared buffer into a replica, 1
+ *                          pulls before every sample, larger values cut the dense reads that otherwise grow
+ *                          with threads x parameters
+ *     pinThreads -> type: bool, pin worker w to the w-th cpu, cpus ordered NUMA node by node
+ *     numaShards -> type: bool, contiguous shards copied into each worker's replica after pinning, so the
+ *                      first touch puts them on the worker's node, otherwise strided shards are read from
+ *                      the shared data
+ *     seed -> type: uint64_t, per worker shuffle seed base
+ *     metrics -> type: MetricsStream*, receives every worker's sample loss, gradient norm and learning rate
+ *                  with the worker's sample count as the step, may be nullptr
+ *
+ */
+struct HogwildConfig
+{
+    size_t threads = 0;
+    size_t epochs = 1;
+    double learningRate = 0.05;
+    size_t refreshInterval = 1;
+    bool pinThreads = false;
+    bool numaShards = false;
+    uint64_t seed = 42;
+    MetricsStream* metrics = nullptr;
+};
+
+/**
+ *
+ * @struct: HogwildStats -> what a run did
+ *
+ * @values:
+ *     epochLoss -> type: std::vector<double>, mean sample loss of every epoch over all workers
+ *     samples -> type: size_t, samples trained on
+ *     writes -> type: size_t, shared weights written, the zero gradients skipped
+ *     reads -> type: size_t, shared weights pulled into replicas by the full refreshes
+ *     threads -> type: size_t, workers used
+ *     pinnedThreads -> type: size_t, workers whose pinning succeeded
+ *     seconds -> type: double, wall time of the run
+ *
+ */
+struct HogwildStats
+{
+    std::vector<double> epochLoss;
+    size_t samples = 0;
+    size_t writes = 0;
+    size_t reads = 0;
+    size_t threads = 0;
+    size_t pinnedThreads = 0;
+    double seconds = 0.0;
+};
+
+/**
+ *
+ * @class: HogwildReplica -> one worker's private copy of the model and its shard of the samples
+ *
+ */
+class HogwildReplica
+{
+    public:
+        virtual ~HogwildReplica() = default;
+
+        // bound buffer of the replica, same layout as the shared one
+        virtual ParamBuffer& params() noexcept = 0;
+
+        // samples in the shard
+        virtual size_t size() const noexcept = 0;
+
+        /**
+         *
+         * @brief: adds the gradients of one sample to params(), the values hold the latest refresh
+         *
+         * @param: index -> type: size_t, sample within the shard
+         * @return: double -> loss of the sample
+         *
+         */
+        virtual double accumulate(size_t index) = 0;
+};
+
+// builds a worker's replica on the worker thread, after pinning, so its memory is node local
+using ReplicaFactory = std::function<std::unique_ptr<HogwildReplica>(std::span<const size_t> shard, bool copyShard)>;
+
+/**
+ *
+ * @class: HogwildTrainer -> runs the workers against a shared bound ParamBuffer
+ *
+ */
+class HogwildTrainer
+{
+    public:
+        /**
+         *
+         * @brief: constructor
+         *
+         * @param: shared -> type: ParamBuffer&, bound buffer every worker reads and updates
+         * @param: config -> type: HogwildConfig, workers, schedule and placement
+         *
+         */
+        HogwildTrainer(ParamBuffer& shared, HogwildConfig config = {});
+
+        /**
+         *
+         * @brief: trains until every worker finished its epochs, rethrows the first worker error
+         *
+         * @param: numSamples -> type: size_t, samples to shard over the workers
+         * @param: factory -> type: const ReplicaFactory&, called once per worker
+         * @return: HogwildStats -> loss curve and counters of the run
+         *
+         * @note: nothing else may touch the shared buffer while this runs
+         *
+         */
+        HogwildStats train(size_t numSamples, const ReplicaFactory& factory);
+
+        const HogwildConfig& getConfig() const noexcept { return config; }
+
+    private:
+        ParamBuffer& shared;
+        HogwildConfig config;
+};
+
+/**
+ *
+ * @class: ClassifierReplica -> classifier copy with a dense tanh backward pass
+ *
+ * @note: rows hold the classifier's numInputs frequencies followed by its channels, the label is the
+ *          target P(consonant), the loss is 0.5 * (P - label)^2
+ *
+ */
+class ClassifierReplica final : public HogwildReplica
+{
+    public:
+        /**
+         *
+         * @brief: constructor
+         *
+         * @param: shape -> type: Classifier&, model to copy, the values come from the shared buffer
+         * @param: data -> type: const Dataset&, all samples
+         * @param: shard -> type: span<const size_t>, rows of data this replica trains on
+         * @param: copyShard -> type: bool, copy the rows in instead of reading them from data
+         *
+         */
+        ClassifierReplica(Classifier& shape, const Dataset& data, std::span<const size_t> shard, bool copyShard);
+
+        ParamBuffer& params() noexcept override { return buffer; }
+        size_t size() const noexcept override { return rows.size(); }
+        double accumulate(size_t index) override;
+
+    private:
+        using RowMatrix = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+        Classifier model;
+        ParamBuffer buffer;
+        Dataset local;
+        const Dataset* source;
+        std::vector<size_t> rows;
+        std::vector<RowMatrix> weights;
+        std::vector<Eigen::VectorXd> biases;
+        std::vector<Eigen::VectorXd> activations;
+};
+
+/**
+ *
+ * @class: ListenerReplica -> listener copy trained with truncated BPTT
+ *
+ */
+class ListenerReplica final : public HogwildReplica
+{
+    public:
+        /**
+         *
+         * @brief: constructor
+         *
+         * @param: shape -> type: Listener&, model to copy, the values come from the shared buffer
+         * @param: features -> type: const std::vector<std::vector<double>>&, numInputs values per timestep
+         * @param: targets -> type: const std::vector<std::vector<double>>&, preference per timestep
+         * @param: shard -> type: span<const size_t>, sequences this replica trains on
+         * @param: copyShard -> type: bool, copy the sequences in instead of reading them from the inputs
+         * @param: bptt -> type: BpttConfig, truncation of the backward pass
+         *
+         */
+        ListenerReplica(Listener& shape, const std::vector<std::vector<double>>& features,
+                        const std::vector<std::vector<double>>& targets, std::span<const size_t> shard,
+                        bool copyShard, BpttConfig bptt = {});
+
+        ParamBuffer& params() noexcept override { return buffer; }
+        size_t size() const noexcept override { return rows.size(); }
+        double accumulate(size_t index) override;
+
+    private:
+        Listener model;
+        ParamBuffer buffer;
+        std::unique_ptr<TruncatedBptt> trainer;
+        std::vector<std::vector<double>> localFeatures;
+        std::vector<std::vector<double>> localTargets;
+        const std::vector<std::vector<double>>* features;
+        const std::vector<std::vector<double>>* targets;
+        std::vector<size_t> rows;
+};
+
+#endif
@@ -0,0 +1,224 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+
+/**
+ *
+ * TRAINING METRICS:
+ *  - training threads push fixed size records into a bounded lock free ring, a push is a compare and swap
+ *      on the ring head and a copy of one cache line, it never waits and never allocates
+ *  - a writer thread wakes every flushInterval, drains the ring and appends the records to a JSON lines
+ *      or CSV file, so no training thread ever touches the stream
+ *  - a full ring drops the record and counts it rather than stalling training, sampling every N steps and
+ *      the metric mask keep the volume down
+ *
+ */
+
+/**
+ *
+ * @enum: Metric -> what a record measures, Activation records carry per layer statistics
+ *
+ */
+enum class Metric : uint8_t
+{
+    Loss,
+    Accuracy,
+    GradNorm,
+    LearningRate,
+    Activation
+};
+
+constexpr unsigned metricBit(Metric metric) noexcept
+{
+    return 1u << static_cast<unsigned>(metric);
+}
+
+enum class MetricsFormat
+{
+    JsonLines,
+    Csv
+};
+
+/**
+ *
+ * @struct: MetricRecord -> one measurement, one line of the output
+ *
+ * @values:
+ *     step -> type: uint64_t, the pushing thread's step counter
+ *     seconds -> type: double, time since the stream started, stamped by push()
+ *     value -> type: double, the measurement, the mean for Activation
+ *     stddev / min / max -> type: double, spread of the activations, 0 for the other metrics
+ *     source -> type: uint32_t, worker or thread id
+ *     layer -> type: int32_t, layer of an Activation record, -1 otherwise
+ *     metric -> type: Metric, what is measured
+ *
+ */
+struct MetricRecord
+{
+    uint64_t step = 0;
+    double seconds = 0.0;
+    double value = 0.0;
+    double stddev = 0.0;
+    double min = 0.0;
+    double max = 0.0;
+    uint32_t source = 0;
+    int32_t layer = -1;
+    Metric metric = Metric::Loss;
+};
+
+/**
+ *
+ * @struct: MetricsConfig -> sampling, filtering and output of a MetricsStream
+ *
+ * @values:
+ *     every -> type: size_t, records are kept for steps that are a multiple of every
+ *     metrics -> type: unsigned, metricBit mask of the metrics to keep
+ *     capacity -> type: size_t, ring slots, rounded up to a power of two
+ *     format -> type: MetricsFormat, JSON lines or CSV with a header
+ *     flushInterval -> type: std::chrono::milliseconds, how often the writer drains the ring
+ *
+ */
+struct MetricsConfig
+{
+    size_t every = 1;
+    unsigned metrics = ~0u;
+    size_t capacity = 4096;
+    MetricsFormat format = MetricsFormat::JsonLines;
+    std::chrono::milliseconds flushInterval{20};
+};
+
+/**
+ *
+ * @struct: MetricsStats -> what happened to the pushed records
+ *
+ */
+struct MetricsStats
+{
+    size_t pushed = 0;
+    size_t dropped = 0;
+    size_t written = 0;
+};
+
+/**
+ *
+ * @class: MetricsStream -> many producer, one writer metrics channel to a file
+ *
+ * @note: push() and the helpers are safe from any number of threads, flush() and stats() from any thread
+ *
+ */
+class MetricsStream
+{
+    public:
+        /**
+         *
+         * @brief: opens the output, sizes the ring and starts the writer thread
+         *
+         * @param: path -> type: const std::string&, file to write, truncated
+         * @param: config -> type: MetricsConfig, sampling, filter, ring size and format
+         *
+         */
+        explicit MetricsStream(const std::string& path, MetricsConfig config = {});
+
+        // drains what is left in the ring, then stops the writer
+        ~MetricsStream();
+
+        MetricsStream(const MetricsStream&) = delete;
+        MetricsStream& operator=(const MetricsStream&) = delete;
+
+        /**
+         *
+         * @brief: whether a record of metric at step would be kept, check before computing an expensive one
+         *
+         */
+        bool wants(Metric metric, size_t step) const noexcept
+        {
+            return step % config.every == 0 && (config.metrics & metricBit(metric)) != 0;
+        }
+
+        /**
+         *
+         * @brief: queues a record without locking
+         *
+         * @param: record -> type: MetricRecord, seconds is stamped here
+         * @return: bool -> false if the record was filtered out or dropped on a full ring
+         *
+         */
+        bool push(MetricRecord record) noexcept;
+
+        // a scalar metric: loss, accuracy, gradient norm or learning rate
+        bool record(Metric metric, size_t step, double value, uint32_t source = 0) noexcept;
+
+        /**
+         *
+         * @brief: mean, standard deviation, min and max of one layer's activations as one record
+         *
+         * @param: step -> type: size_t, step counter
+         * @param: layer -> type: int, layer index
+         * @param: values -> type: span<const double>, the layer's outputs
+         * @param: source -> type: uint32_t, worker or thread id
+         *
+         */
+        bool activations(size_t step, int layer, std::span<const double> values, uint32_t source = 0) noexcept;
+
+        /**
+         *
+         * @brief: waits until every record pushed before the call is in the file
+         *
+         */
+        void flush();
+
+        MetricsStats stats() const noexcept;
+        const MetricsConfig& getConfig() const noexcept { return config; }
+
+    private:
+        // one ring slot, sequence says whose turn it is: pos for a producer, pos + 1 for the writer
+        struct alignas(64) Cell
+        {
+            std::atomic<size_t> sequence;
+            MetricRecord record;
+        };
+
+        void run();
+        size_t drain();
+        void format(const MetricRecord& record);
+
+        MetricsConfig config;
+        std::ofstream out;
+        std::string line;
+        std::chrono::steady_clock::time_point start;
+
+        std::unique_ptr<Cell[]> cells;
+        size_t mask = 0;
+        alignas(64) std::atomic<size_t> head{0};
+        alignas(64) size_t tail = 0;
+        std::atomic<size_t> pushed{0};
+        std::atomic<size_t> dropped{0};
+        std::atomic<size_t> written{0};
+
+        std::mutex lock;
+        std::condition_variable wake;
+        std::condition_variable drained;
+        bool flushRequested = false;
+        bool stopping = false;
+        std::thread worker;
+};
+
+/**
+ *
+ * @brief: L2 norm of a gradient array
+ *
+ */
+double gradientNorm(std::span<const double> grads) noexcept;
+
+#endif
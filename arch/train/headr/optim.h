@@ -0,0 +1,144 @@
+#ifndef OPTIM_H
+#define OPTIM_H
+
+#include "../../node/headr/param.h"
+#include "../../memory/headr/arena.h"
+#include <cstddef>
+#include <initializer_list>
+#include <span>
+#include <vector>
+
+/**
+ *
+ * OPTIMIZERS:
+ *  - every optimizer steps a whole bound ParamBuffer at once
+ *  - the update is fused: values, grads and the optimizer state are walked together block by block, each
+ *      block small enough to stay in L1 while Eigen runs the vectorised expressions over it, so a step
+ *      streams every array through memory once
+ *
+ */
+
+/**
+ *
+ * @class: Optimizer -> base class of the fused optimizers
+ *
+ */
+class Optimizer
+{
+    public:
+        explicit Optimizer(double learningRate);
+        virtual ~Optimizer() = default;
+
+        /**
+         *
+         * @brief: applies one update to every parameter from the gradients accumulated in the buffer
+         *
+         * @param: params -> type: ParamBuffer&, bound buffer, the gradients are left untouched
+         *
+         */
+        virtual void step(ParamBuffer& params) = 0;
+
+        double getLearningRate() const noexcept { return learningRate; }
+        void setLearningRate(double rate) noexcept { learningRate = rate; }
+        std::size_t getStepCount() const noexcept { return steps; }
+
+        /**
+         *
+         * @brief: the optimizer state arrays in a fixed order, sized to the buffer if no step was taken yet
+         *
+         * @param: params -> type: const ParamBuffer&, bound buffer the optimizer steps
+         * @return: std::vector<std::span<double>> -> one span of params.size() doubles per state array
+         *
+         * @note: used to checkpoint and restore the optimizer together with setStepCount
+         *
+         */
+        std::vector<std::span<double>> stateArrays(const ParamBuffer& params);
+        void setStepCount(std::size_t count) noexcept { steps = count; }
+
+        // doubles per fused block, 4 arrays of this fit in a 32KB L1
+        static constexpr std::size_t blockSize = 512;
+
+    protected:
+        using StateVec = std::vector<double, AlignedAllocator<double, ParamBuffer::alignment>>;
+
+        /**
+         *
+         * @brief: sizes the optimizer state to the buffer on the first step, throws if the buffer changed
+         *
+         */
+        void prepare(const ParamBuffer& params, std::initializer_list<StateVec*> state);
+
+        // every state array of the optimizer, in the order stateArrays hands them out
+        virtual std::vector<StateVec*> stateVecs() { return {}; }
+
+        double learningRate;
+        std::size_t steps = 0;
+};
+
+/**
+ *
+ * @class: SgdMomentum -> SGD with heavy ball momentum and L2 weight decay
+ *
+ * @note: v = momentum * v + g + weightDecay * p,  p -= lr * v
+ *
+ */
+class SgdMomentum final : public Optimizer
+{
+    public:
+        explicit SgdMomentum(double learningRate, double momentum = 0.9, double weightDecay = 0.0);
+
+        void step(ParamBuffer& params) override;
+
+        std::span<const double> velocity() const noexcept { return velocityVec; }
+
+    protected:
+        std::vector<StateVec*> stateVecs() override { return {&velocityVec}; }
+
+    private:
+        double momentum;
+        double weightDecay;
+        StateVec velocityVec;
+};
+
+/**
+ *
+ * @class: Adam -> Adam with bias correction, AdamW adds decoupled weight decay on top
+ *
+ */
+class Adam : public Optimizer
+{
+    public:
+        explicit Adam(double learningRate, double beta1 = 0.9, double beta2 = 0.999, double epsilon = 1e-8);
+
+        void step(ParamBuffer& params) override;
+
+        std::span<const double> firstMoment() const noexcept { return firstVec; }
+        std::span<const double> secondMoment() const noexcept { return secondVec; }
+
+    protected:
+        // decay applied to the parameters directly, outside of the adaptive step (0 for plain Adam)
+        double decoupledDecay = 0.0;
+
+        std::vector<StateVec*> stateVecs() override { return {&firstVec, &secondVec}; }
+
+    private:
+        double beta1;
+        double beta2;
+        double epsilon;
+        StateVec firstVec;
+        StateVec secondVec;
+};
+
+/**
+ *
+ * @class: AdamW -> Adam with decoupled weight decay, p -= lr * weightDecay * p every step
+ *
+ */
+class AdamW final : public Adam
+{
+    public:
+        explicit AdamW(double learningRate, double weightDecay = 0.01, double beta1 = 0.9, double beta2 = 0.999,
+                       double epsilon = 1e-8);
+};
+
+#endif
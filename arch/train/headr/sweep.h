@@ -0,0 +1,139 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include "../../data/headr/dataset.h"
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ *
+ * @struct: SweepPoint -> one hyperparameter setting of a sweep
+ *
+ */
+struct SweepPoint
+{
+    size_t id = 0;
+    std::map<std::string, double> params;
+
+    /**
+     *
+     * @brief: looks up a parameter, falls back when the sweep does not vary it
+     *
+     */
+    double get(const std::string& name, double fallback = 0.0) const
+    {
+        auto it = params.find(name);
+        return it == params.end() ? fallback : it->second;
+    }
+};
+
+/**
+ *
+ * @struct: SweepSpec -> grid and / or random search description
+ *
+ * @values:
+ *     grid -> every combination of the listed values is tried (e.g. width, depth)
+ *     ranges -> uniform [lo, hi) ranges sampled randomSamples times on top of each grid point
+ *     logRanges -> same but sampled log uniformly (learning rates)
+ *     randomSamples -> random draws per grid point, 0 runs the plain grid
+ *     seed -> seed of the random draws
+ *
+ */
+struct SweepSpec
+{
+    std::map<std::string, std::vector<double>> grid;
+    std::map<std::string, std::pair<double, double>> ranges;
+    std::map<std::string, std::pair<double, double>> logRanges;
+    size_t randomSamples = 0;
+    unsigned seed = 0;
+
+    /**
+     *
+     * @brief: expands the spec into the list of points to train
+     *
+     */
+    std::vector<SweepPoint> expand() const;
+};
+
+/**
+ *
+ * @struct: TrialResult -> outcome of training one point on one fold
+ *
+ */
+struct TrialResult
+{
+    size_t pointId = 0;
+    size_t fold = 0;
+    std::map<std::string, double> metrics;
+    double seconds = 0.0;
+    std::string error;
+};
+
+/**
+ *
+ * @brief: trains one model for a point on a fold and returns its metrics (e.g. loss, accuracy)
+ *
+ * @note: called concurrently, the dataset is shared and must only be read
+ *
+ */
+using TrainFn = std::function<std::map<std::string, double>(const SweepPoint&, const Dataset&, const Fold&)>;
+
+/**
+ *
+ * @class: SweepRunner -> trains every (point, fold) pair of a sweep concurrently
+ *
+ * @note: the dataset is loaded once and shared read-only by all workers, trials are handed out
+ *          from a shared counter so long and short trials balance across the workers
+ *
+ */
+class SweepRunner
+{
+    public:
+        /**
+         *
+         * @brief: constructor
+         *
+         * @param: threads -> type: size_t, number of workers, 0 uses one per hardware thread
+         * @param: folds -> type: size_t, k for k-fold cross validation, < 2 trains on the whole dataset
+         * @param: foldSeed -> type: unsigned, seed of the fold shuffle
+         *
+         */
+        explicit SweepRunner(size_t threads = 0, size_t folds = 1, unsigned foldSeed = 0) noexcept;
+
+        /**
+         *
+         * @brief: runs the sweep, blocks until every trial is done
+         *
+         * @param: spec -> type: const SweepSpec&, the points to try
+         * @param: data -> type: shared_ptr<const Dataset>, dataset shared by all workers
+         * @param: train -> type: const TrainFn&, trains one trial
+         * @return: std::vector<TrialResult> -> one result per (point, fold), ordered by point then fold
+         *
+         */
+        std::vector<TrialResult> run(const SweepSpec& spec, std::shared_ptr<const Dataset> data, const TrainFn& train);
+
+        /**
+         *
+         * @brief: writes a CSV report, one row per trial plus the fold mean of every point
+         *
+         * @param: path -> type: const std::string&, output file
+         * @param: points -> type: const std::vector<SweepPoint>&, the expanded sweep
+         * @param: results -> type: const std::vector<TrialResult>&, the trial results
+         *
+         */
+        static void writeReport(const std::string& path, const std::vector<SweepPoint>& points,
+                                const std::vector<TrialResult>& results);
+
+        size_t getThreads() const noexcept { return numThreads; }
+
+    private:
+        size_t numThreads;
+        size_t numFolds;
+        unsigned seed;
+};
+
+#endif
@@ -0,0 +1,301 @@
+#include "../headr/bptt.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+    // the listener runs LstmNode, the derivatives below assume its sigmoid gates and tanh cell
+    using Gate = LstmNode::GatePolicy;
+
+    Eigen::ArrayXd sigmoid(const Eigen::ArrayXd& val)
+    {
+        return Gate::apply(val);
+    }
+}
+
+/**
+ *
+ * @brief: constructor
+ *
+ * @param: listener .
+ * type: Listener&, model to train, registered with params
+ * @param: params .
+ * type: ParamBuffer&, bound buffer holding the listener parameters
+ * @param: config .
+ * type: BpttConfig, window and checkpoint interval
+ *
+ */
+TruncatedBptt::TruncatedBptt(Listener& listener, ParamBuffer& params, BpttConfig config)
+        : listener(listener), params(params), config(config), width(0)
+{
+    if (config.window == 0 || config.checkpointInterval == 0)
+    {
+        throw std::invalid_argument("BPTT window and checkpoint interval must be positive");
+    }
+    // features per timestep, the first layer fan in (3 for plain tracks, 7 with the interval channels)
+    width = listener.getLayers().empty() ? 0 : listener.getLayers().front()->getFanIn();
+    if (width == 0)
+    {
+        throw std::invalid_argument("Listener must take at least one feature per timestep");
+    }
+    if (!params.isBound())
+    {
+        throw std::logic_error("ParamBuffer must be bound before building the trainer");
+    }
+    // throws early if the listener was not registered with this buffer
+    params.gradOf(listener.getReadoutBias());
+}
+
+/**
+ *
+ * @brief: pulls the current master weights into the dense per layer matrices and clears their gradients
+ *
+ */
+void TruncatedBptt::loadWeights()
+{
+    auto& stack = listener.getLayers();
+    layers.resize(stack.size());
+    for (size_t l = 0; l < stack.size(); ++l)
+    {
+        LayerState& layer = layers[l];
+        layer.nodes = stack[l]->getPrivMemberLayerNodes().size();
+        layer.fanIn = stack[l]->getFanIn();
+        size_t slots = 4 * layer.nodes;
+        layer.weights.resize(slots, layer.fanIn);
+        layer.recurrent.resize(slots);
+        layer.bias.resize(slots);
+        stack[l]->unpackWeights({layer.weights.data(), slots * layer.fanIn},
+                                {layer.recurrent.data(), slots}, {layer.bias.data(), slots});
+        layer.dWeights.setZero(slots, layer.fanIn);
+        layer.dRecurrent.setZero(slots);
+        layer.dBias.setZero(slots);
+    }
+    ParamVec& weights = listener.getReadoutWeights();
+    readout = Eigen::Map<const Eigen::VectorXd>(weights.data(), weights.size());
+    readoutBias = listener.getReadoutBias();
+    dReadout.setZero(weights.size());
+    dReadoutBias = 0.0;
+}
+
+/**
+ *
+ * @brief: adds the accumulated dense gradients to the buffer
+ *
+ */
+void TruncatedBptt::storeGrads()
+{
+    auto& stack = listener.getLayers();
+    for (size_t l = 0; l < stack.size(); ++l)
+    {
+        LayerState& layer = layers[l];
+        size_t slots = 4 * layer.nodes;
+        stack[l]->scatterGrads(params, {layer.dWeights.data(), slots * layer.fanIn},
+                               {layer.dRecurrent.data(), slots}, {layer.dBias.data(), slots});
+    }
+    std::span<double> grad = params.gradOf(listener.getReadoutWeights());
+    for (size_t i = 0; i < grad.size(); ++i)
+    {
+        grad[i] += dReadout[static_cast<Eigen::Index>(i)];
+    }
+    params.gradOf(listener.getReadoutBias()) += dReadoutBias;
+}
+
+/**
+ *
+ * @brief: advances every layer one timestep from state, optionally recording the activations
+ *
+ * @note: same math as the layer forward, pre = W x + R * stm + B with the gates stacked by slot
+ *
+ */
+double TruncatedBptt::stepForward(std::span<const double> features, Checkpoint& state, StepCache* cache)
+{
+    Eigen::VectorXd x = Eigen::Map<const Eigen::VectorXd>(features.data(), static_cast<Eigen::Index>(features.size()));
+    for (size_t l = 0; l < layers.size(); ++l)
+    {
+        const LayerState& layer = layers[l];
+        Eigen::Index n = static_cast<Eigen::Index>(layer.nodes);
+        Eigen::VectorXd pre = layer.weights * x + layer.bias;
+        pre.array() += layer.recurrent.array() * state.stm[l].replicate(4, 1).array();
+
+        Eigen::VectorXd ltm = state.ltm[l].array() * sigmoid(pre.segment(0, n).array())
+                              + sigmoid(pre.segment(n, n).array()) * pre.segment(2 * n, n).array().tanh();
+        Eigen::VectorXd stm = ltm.array().tanh() * sigmoid(pre.segment(3 * n, n).array());
+        if (cache)
+        {
+            LayerCache& record = cache->layers[l];
+            record.input = x;
+            record.pre = std::move(pre);
+            record.stmPrev = state.stm[l];
+            record.ltmPrev = state.ltm[l];
+            record.ltm = ltm;
+        }
+        state.stm[l] = stm;
+        state.ltm[l] = std::move(ltm);
+        x = std::move(stm);
+    }
+    double preference = 1.0 / (1.0 + std::exp(-(readout.dot(x) + readoutBias)));
+    if (cache)
+    {
+        cache->output = x;
+        cache->preference = preference;
+    }
+    return preference;
+}
+
+/**
+ *
+ * @brief: runs one sequence forward and backward, adding its gradients to the buffer
+ *
+ * @note: each chunk of window steps is run forward once keeping only every k-th state, then walked
+ *          backwards segment by segment, recomputing the k steps of a segment from its checkpoint. A hint
+ *          adds its gradient straight into the top layer output, next to the readout's
+ *
+ */
+double TruncatedBptt::accumulate(std::span<const double> features, std::span<const double> targets,
+                                 const HiddenHint* hint)
+{
+    size_t steps = targets.size();
+    if (features.size() != steps * width)
+    {
+        throw std::invalid_argument("Features do not match the number of targets");
+    }
+    loadWeights();
+    using ConstRowMap = Eigen::Map<const RowMatrix>;
+    Eigen::Index top = static_cast<Eigen::Index>(layers.back().nodes);
+    Eigen::Index hintWidth = hint ? static_cast<Eigen::Index>(hint->width) : 0;
+    if (hint && (hint->targets.size() != steps * hint->width
+                 || hint->projection.size() != hint->width * layers.back().nodes
+                 || hint->projectionGrad.size() != hint->projection.size()))
+    {
+        throw std::invalid_argument("Hidden hint does not match the sequence or the top layer");
+    }
+    ConstRowMap projection(hint ? hint->projection.data() : nullptr, hintWidth, top);
+    Eigen::Map<RowMatrix> projectionGrad(hint ? hint->projectionGrad.data() : nullptr, hintWidth, top);
+    // projection * stm - target at timestep t
+    auto hintError = [&](size_t t, const Eigen::VectorXd& stm)
+    {
+        Eigen::Map<const Eigen::VectorXd> target(hint->targets.data() + t * hint->width, hintWidth);
+        return Eigen::VectorXd(projection * stm - target);
+    };
+    peakCheckpoints = 0;
+    peakStoredSteps = 0;
+    if (steps == 0)
+    {
+        return 0.0;
+    }
+
+    Checkpoint state;
+    for (const LayerState& layer : layers)
+    {
+        state.stm.push_back(Eigen::VectorXd::Zero(static_cast<Eigen::Index>(layer.nodes)));
+        state.ltm.push_back(Eigen::VectorXd::Zero(static_cast<Eigen::Index>(layer.nodes)));
+    }
+    auto timestep = [&](size_t t) { return features.subspan(t * width, width); };
+    double scale = 1.0 / static_cast<double>(steps);
+    double loss = 0.0;
+
+    std::vector<Checkpoint> checkpoints;
+    std::vector<StepCache> segment(config.checkpointInterval);
+    for (StepCache& cache : segment)
+    {
+        cache.layers.resize(layers.size());
+    }
+
+    for (size_t begin = 0; begin < steps; begin += config.window)
+    {
+        size_t end = std::min(steps, begin + config.window);
+
+        // forward, keeping the state at the start of every segment
+        checkpoints.clear();
+        for (size_t t = begin; t < end; ++t)
+        {
+            if ((t - begin) % config.checkpointInterval == 0)
+            {
+                checkpoints.push_back(state);
+            }
+            double diff = stepForward(timestep(t), state, nullptr) - targets[t];
+            loss += 0.5 * diff * diff;
+            if (hint)
+            {
+                loss += 0.5 * hint->weight * hintError(t, state.stm.back()).squaredNorm();
+            }
+        }
+        peakCheckpoints = std::max(peakCheckpoints, checkpoints.size());
+
+        // backward, the gradient into the chunk from the future is cut (truncation)
+        std::vector<Eigen::VectorXd> dStm;
+        std::vector<Eigen::VectorXd> dLtm;
+        for (const LayerState& layer : layers)
+        {
+            dStm.push_back(Eigen::VectorXd::Zero(static_cast<Eigen::Index>(layer.nodes)));
+            dLtm.push_back(Eigen::VectorXd::Zero(static_cast<Eigen::Index>(layer.nodes)));
+        }
+        for (size_t seg = checkpoints.size(); seg-- > 0;)
+        {
+            size_t segBegin = begin + seg * config.checkpointInterval;
+            size_t segEnd = std::min(end, segBegin + config.checkpointInterval);
+            Checkpoint replay = checkpoints[seg];
+            for (size_t t = segBegin; t < segEnd; ++t)
+            {
+                stepForward(timestep(t), replay, &segment[t - segBegin]);
+            }
+            peakStoredSteps = std::max(peakStoredSteps, segEnd - segBegin);
+
+            for (size_t t = segEnd; t-- > segBegin;)
+            {
+                const StepCache& cache = segment[t - segBegin];
+                double y = cache.preference;
+                double dz = (y - targets[t]) * scale * y * (1.0 - y);
+                dReadout += dz * cache.output;
+                dReadoutBias += dz;
+
+                Eigen::VectorXd dOut = dStm.back() + dz * readout;
+                if (hint)
+                {
+                    Eigen::VectorXd dHint = hint->weight * scale * hintError(t, cache.output);
+                    dOut.noalias() += projection.transpose() * dHint;
+                    projectionGrad.noalias() += dHint * cache.output.transpose();
+                }
+                for (size_t l = layers.size(); l-- > 0;)
+                {
+                    LayerState& layer = layers[l];
+                    const LayerCache& record = cache.layers[l];
+                    Eigen::Index n = static_cast<Eigen::Index>(layer.nodes);
+                    Eigen::ArrayXd f = sigmoid(record.pre.segment(0, n).array());
+                    Eigen::ArrayXd i = sigmoid(record.pre.segment(n, n).array());
+                    Eigen::ArrayXd g = record.pre.segment(2 * n, n).array().tanh();
+                    Eigen::ArrayXd o = sigmoid(record.pre.segment(3 * n, n).array());
+                    Eigen::ArrayXd tc = record.ltm.array().tanh();
+
+                    Eigen::ArrayXd dh = dOut.array();
+                    Eigen::ArrayXd dc = dLtm[l].array() + dh * o * (1.0 - tc * tc);
+                    Eigen::VectorXd dPre(4 * n);
+                    dPre.segment(0, n) = dc * record.ltmPrev.array() * f * (1.0 - f);
+                    dPre.segment(n, n) = dc * g * i * (1.0 - i);
+                    dPre.segment(2 * n, n) = dc * i * (1.0 - g * g);
+                    dPre.segment(3 * n, n) = dh * tc * o * (1.0 - o);
+
+                    layer.dWeights.noalias() += dPre * record.input.transpose();
+                    layer.dRecurrent.array() += dPre.array() * record.stmPrev.replicate(4, 1).array();
+                    layer.dBias += dPre;
+
+                    // into the previous timestep through the cell and the node's own STM recurrence
+                    dLtm[l] = dc * f;
+                    Eigen::ArrayXd recurrentIn = dPre.array() * layer.recurrent.array();
+                    dStm[l] = recurrentIn.segment(0, n) + recurrentIn.segment(n, n)
+                              + recurrentIn.segment(2 * n, n) + recurrentIn.segment(3 * n, n);
+
+                    // into the layer below at the same timestep
+                    if (l > 0)
+                    {
+                        dOut = dStm[l - 1] + layer.weights.transpose() * dPre;
+                    }
+                }
+            }
+        }
+    }
+
+    storeGrads();
+    return loss * scale;
+}
@@ -0,0 +1,548 @@
+#include "../headr/checkpoint.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+
+namespace
+{
+    namespace fs = std::filesystem;
+    using Clock = std::chrono::steady_clock;
+
+    constexpr uint64_t magic = 0x54504b434d54534cULL;
+    constexpr uint64_t version = 1;
+    constexpr uint64_t fullKind = 0;
+    constexpr uint64_t deltaKind = 1;
+
+    // fixed part of every file, followed by the rng text, the chunks (index + doubles) and the checksum
+    struct FileHeader
+    {
+        uint64_t magic;
+        uint64_t version;
+        uint64_t kind;
+        uint64_t sequence;
+        uint64_t numValues;
+        uint64_t numArrays;
+        uint64_t chunkSize;
+        uint64_t step;
+        uint64_t epoch;
+        uint64_t batches;
+        uint64_t optimizerSteps;
+        uint64_t rngLength;
+        uint64_t chunkCount;
+    };
+    static_assert(sizeof(FileHeader) == 13 * sizeof(uint64_t), "FileHeader must not be padded");
+
+    double secondsSince(Clock::time_point start) noexcept
+    {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    // 64 bit FNV-1a, enough to tell a torn or corrupted file from a complete one
+    uint64_t fnv1a(const unsigned char* bytes, size_t size, uint64_t hash = 0xcbf29ce484222325ULL) noexcept
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            hash ^= bytes[i];
+            hash *= 0x100000001b3ULL;
+        }
+        return hash;
+    }
+
+    /**
+     *
+     * @brief: output file that hashes everything written to it
+     *
+     */
+    class HashedFile
+    {
+        public:
+            explicit HashedFile(const fs::path& path) : out(path, std::ios::binary | std::ios::trunc) {}
+
+            void put(const void* data, size_t size)
+            {
+                hash = fnv1a(static_cast<const unsigned char*>(data), size, hash);
+                out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+                bytes += size;
+            }
+
+            // appends the checksum and closes, false if any write failed
+            bool finish()
+            {
+                uint64_t sum = hash;
+                out.write(reinterpret_cast<const char*>(&sum), sizeof(sum));
+                bytes += sizeof(sum);
+                out.close();
+                return static_cast<bool>(out);
+            }
+
+            size_t size() const noexcept { return bytes; }
+
+        private:
+            std::ofstream out;
+            uint64_t hash = 0xcbf29ce484222325ULL;
+            size_t bytes = 0;
+    };
+
+    fs::path fileName(const std::string& directory, size_t sequence)
+    {
+        std::ostringstream name;
+        name << "ckpt-" << std::setw(8) << std::setfill('0') << sequence << ".bin";
+        return fs::path(directory) / name.str();
+    }
+
+    // sequence number of a checkpoint file name, false for anything else in the directory
+    bool sequenceOf(const fs::path& path, size_t& sequence)
+    {
+        std::string name = path.filename().string();
+        if (name.size() <= 9 || name.rfind("ckpt-", 0) != 0 || name.substr(name.size() - 4) != ".bin")
+        {
+            return false;
+        }
+        std::string digits = name.substr(5, name.size() - 9);
+        if (digits.empty() || !std::all_of(digits.begin(), digits.end(), [](char c) { return c >= '0' && c <= '9'; }))
+        {
+            return false;
+        }
+        sequence = std::stoull(digits);
+        return true;
+    }
+
+    std::vector<size_t> listSequences(const std::string& directory)
+    {
+        std::vector<size_t> sequences;
+        std::error_code code;
+        for (const fs::directory_entry& entry : fs::directory_iterator(directory, code))
+        {
+            size_t sequence = 0;
+            if (entry.is_regular_file() && sequenceOf(entry.path(), sequence))
+            {
+                sequences.push_back(sequence);
+            }
+        }
+        std::sort(sequences.begin(), sequences.end());
+        return sequences;
+    }
+
+    /**
+     *
+     * @brief: one checkpoint file read back whole, valid only if the checksum and the layout agree
+     *
+     */
+    struct ParsedFile
+    {
+        FileHeader header{};
+        std::string rng;
+        std::vector<unsigned char> bytes;
+        size_t chunks = 0;
+
+        bool read(const fs::path& path)
+        {
+            std::ifstream in(path, std::ios::binary);
+            if (!in)
+            {
+                return false;
+            }
+            bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+            if (bytes.size() < sizeof(FileHeader) + sizeof(uint64_t))
+            {
+                return false;
+            }
+            size_t body = bytes.size() - sizeof(uint64_t);
+            uint64_t sum = 0;
+            std::memcpy(&sum, bytes.data() + body, sizeof(sum));
+            if (fnv1a(bytes.data(), body) != sum)
+            {
+                return false;
+            }
+            std::memcpy(&header, bytes.data(), sizeof(header));
+            if (header.magic != magic || header.version != version || header.chunkSize == 0
+                || header.rngLength > body - sizeof(FileHeader))
+            {
+                return false;
+            }
+            rng.assign(reinterpret_cast<const char*>(bytes.data()) + sizeof(FileHeader), header.rngLength);
+            chunks = sizeof(FileHeader) + header.rngLength;
+
+            // walk the chunks once so apply() can trust them
+            size_t total = header.numValues * (1 + header.numArrays);
+            size_t offset = chunks;
+            for (uint64_t c = 0; c < header.chunkCount; ++c)
+            {
+                uint64_t index = 0;
+                if (offset + sizeof(index) > body)
+                {
+                    return false;
+                }
+                std::memcpy(&index, bytes.data() + offset, sizeof(index));
+                if (index * header.chunkSize >= total)
+                {
+                    return false;
+                }
+                offset += sizeof(index) + sizeof(double) * std::min<size_t>(header.chunkSize, total - index * header.chunkSize);
+                if (offset > body)
+                {
+                    return false;
+                }
+            }
+            return offset == body;
+        }
+
+        void apply(std::span<double> data) const
+        {
+            size_t offset = chunks;
+            for (uint64_t c = 0; c < header.chunkCount; ++c)
+            {
+                uint64_t index = 0;
+                std::memcpy(&index, bytes.data() + offset, sizeof(index));
+                offset += sizeof(index);
+                size_t first = index * header.chunkSize;
+                size_t len = std::min<size_t>(header.chunkSize, data.size() - first);
+                std::memcpy(data.data() + first, bytes.data() + offset, len * sizeof(double));
+                offset += len * sizeof(double);
+            }
+        }
+
+        bool follows(const ParsedFile& base) const noexcept
+        {
+            return header.kind == deltaKind && header.sequence == base.header.sequence + 1
+                   && header.numValues == base.header.numValues && header.numArrays == base.header.numArrays
+                   && header.chunkSize == base.header.chunkSize;
+        }
+    };
+}
+
+/**
+ *
+ * @brief: preallocates the snapshot buffers and starts the writer thread
+ *
+ * @param: directory .
+ * type: std::string, where the files go
+ * @param: params .
+ * type: ParamBuffer&, bound buffer to snapshot
+ * @param: optimizer .
+ * type: Optimizer*, its state and step count are stored too, may be nullptr
+ * @param: config .
+ * type: CheckpointConfig, chunk size and full snapshot cadence
+ *
+ * @note: numbering carries on after any checkpoint already in the directory, the first file is full
+ *
+ */
+Checkpointer::Checkpointer(std::string directory, ParamBuffer& params, Optimizer* optimizer, CheckpointConfig config)
+        : directory(std::move(directory)), params(params), optimizer(optimizer), config(config)
+{
+    if (!params.isBound())
+    {
+        throw std::logic_error("ParamBuffer must be bound before checkpointing it");
+    }
+    if (config.chunkSize == 0 || config.fullEvery == 0)
+    {
+        throw std::invalid_argument("Checkpoint chunk size and full snapshot interval must be positive");
+    }
+    numArrays = optimizer ? optimizer->stateArrays(params).size() : 0;
+    total = params.size() * (1 + numArrays);
+    for (Snapshot* snap : {&staging, &pending, &current})
+    {
+        snap->data.resize(total);
+    }
+    fs::create_directories(this->directory);
+    std::vector<size_t> existing = listSequences(this->directory);
+    sequence = existing.empty() ? 0 : existing.back() + 1;
+    worker = std::thread(&Checkpointer::run, this);
+}
+
+Checkpointer::~Checkpointer()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    ready.notify_all();
+    worker.join();
+}
+
+/**
+ *
+ * @brief: snapshots the parameters and the optimizer, the file is written in the background
+ *
+ * @param: state .
+ * type: const TrainingState&, loop position stored with the snapshot
+ * @return: bool .
+ * false if the capture was skipped because the previous one is still pending
+ *
+ * @note: only the trainer calls capture(), so once pending is free nobody else can take it while the
+ *          staging buffer is filled outside the lock
+ *
+ */
+bool Checkpointer::capture(const TrainingState& state)
+{
+    Clock::time_point start = Clock::now();
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+        if (hasPending && !config.waitForWriter)
+        {
+            ++counters.skipped;
+            counters.captureSeconds += secondsSince(start);
+            return false;
+        }
+        done.wait(guard, [&] { return !hasPending; });
+    }
+
+    std::span<const double> values = params.values();
+    auto out = std::copy(values.begin(), values.end(), staging.data.begin());
+    if (optimizer)
+    {
+        for (std::span<double> array : optimizer->stateArrays(params))
+        {
+            out = std::copy(array.begin(), array.end(), out);
+        }
+    }
+    staging.state = state;
+    staging.optimizerSteps = optimizer ? optimizer->getStepCount() : 0;
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        std::swap(staging, pending);
+        hasPending = true;
+        ++counters.captures;
+        counters.captureSeconds += secondsSince(start);
+    }
+    ready.notify_one();
+    return true;
+}
+
+/**
+ *
+ * @brief: waits until every captured snapshot is on disk, rethrows anything the writer threw
+ *
+ */
+void Checkpointer::flush()
+{
+    std::unique_lock<std::mutex> guard(lock);
+    done.wait(guard, [&] { return (!hasPending && !writing) || error; });
+    if (error)
+    {
+        std::exception_ptr thrown = error;
+        error = nullptr;
+        std::rethrow_exception(thrown);
+    }
+}
+
+CheckpointStats Checkpointer::stats() const
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return counters;
+}
+
+/**
+ *
+ * @brief: the writer thread, takes the pending snapshot and writes it while the trainer carries on
+ *
+ */
+void Checkpointer::run()
+{
+    for (;;)
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        ready.wait(guard, [&] { return hasPending || stopping; });
+        if (!hasPending)
+        {
+            return;
+        }
+        std::swap(pending, current);
+        hasPending = false;
+        writing = true;
+        guard.unlock();
+        done.notify_all();
+
+        Clock::time_point start = Clock::now();
+        std::exception_ptr thrown;
+        try
+        {
+            write(current);
+        }
+        catch (...)
+        {
+            thrown = std::current_exception();
+        }
+        guard.lock();
+        writing = false;
+        counters.writeSeconds += secondsSince(start);
+        if (thrown)
+        {
+            error = thrown;
+        }
+        guard.unlock();
+        done.notify_all();
+    }
+}
+
+/**
+ *
+ * @brief: writes one snapshot, full or as the chunks that differ from the last file
+ *
+ * @param: snap .
+ * type: const Snapshot&, the snapshot taken by the writer
+ *
+ * @note: the file is renamed into place only once it is complete, after a full snapshot every older file
+ *          is removed since nothing needs them any more
+ *
+ */
+void Checkpointer::write(const Snapshot& snap)
+{
+    bool full = last.empty() || sequence - lastFull >= config.fullEvery;
+    size_t chunkCount = (total + config.chunkSize - 1) / config.chunkSize;
+    std::vector<uint64_t> changed;
+    for (size_t c = 0; c < chunkCount; ++c)
+    {
+        size_t first = c * config.chunkSize;
+        size_t len = std::min(config.chunkSize, total - first);
+        if (full || std::memcmp(snap.data.data() + first, last.data() + first, len * sizeof(double)) != 0)
+        {
+            changed.push_back(c);
+        }
+    }
+
+    FileHeader header{magic, version, full ? fullKind : deltaKind, sequence, params.size(), numArrays,
+                      config.chunkSize, snap.state.step, snap.state.loader.epoch, snap.state.loader.batches,
+                      snap.optimizerSteps, snap.state.rng.size(), changed.size()};
+    fs::path path = fileName(directory, sequence);
+    fs::path temporary = path;
+    temporary += ".tmp";
+    size_t bytes = 0;
+    {
+        HashedFile file(temporary);
+        file.put(&header, sizeof(header));
+        file.put(snap.state.rng.data(), snap.state.rng.size());
+        for (uint64_t c : changed)
+        {
+            size_t first = c * config.chunkSize;
+            file.put(&c, sizeof(c));
+            file.put(snap.data.data() + first, std::min(config.chunkSize, total - first) * sizeof(double));
+        }
+        if (!file.finish())
+        {
+            throw std::runtime_error("Could not write checkpoint " + temporary.string());
+        }
+        bytes = file.size();
+    }
+    fs::rename(temporary, path);
+
+    if (full)
+    {
+        last = snap.data;
+        for (size_t older : listSequences(directory))
+        {
+            if (older < sequence)
+            {
+                std::error_code code;
+                fs::remove(fileName(directory, older), code);
+            }
+        }
+        lastFull = sequence;
+    }
+    else
+    {
+        for (uint64_t c : changed)
+        {
+            size_t first = c * config.chunkSize;
+            std::copy_n(snap.data.begin() + static_cast<long>(first), std::min(config.chunkSize, total - first),
+                        last.begin() + static_cast<long>(first));
+        }
+    }
+    ++sequence;
+
+    std::lock_guard<std::mutex> guard(lock);
+    ++(full ? counters.fullWrites : counters.deltaWrites);
+    counters.chunksWritten += changed.size();
+    counters.bytesWritten += bytes;
+}
+
+/**
+ *
+ * @brief: loads the newest complete checkpoint: the last full snapshot and the valid deltas after it
+ *
+ * @param: directory .
+ * type: const std::string&, directory a Checkpointer wrote to
+ * @param: params .
+ * type: ParamBuffer&, bound buffer with the layout that was saved
+ * @param: optimizer .
+ * type: Optimizer*, receives the state and step count, may be nullptr
+ * @return: TrainingState .
+ * the loop position of the restored snapshot
+ *
+ * @note: the chain stops at the first delta that is missing or fails its checksum, a crash while writing
+ *          therefore falls back to the snapshot before it
+ *
+ */
+TrainingState Checkpointer::restore(const std::string& directory, ParamBuffer& params, Optimizer* optimizer)
+{
+    if (!params.isBound())
+    {
+        throw std::logic_error("ParamBuffer must be bound before restoring into it");
+    }
+    std::vector<size_t> sequences = listSequences(directory);
+    ParsedFile base;
+    auto it = sequences.rbegin();
+    for (; it != sequences.rend(); ++it)
+    {
+        if (base.read(fileName(directory, *it)) && base.header.kind == fullKind)
+        {
+            break;
+        }
+    }
+    if (it == sequences.rend())
+    {
+        throw std::invalid_argument("No complete checkpoint in " + directory);
+    }
+
+    std::vector<std::span<double>> arrays;
+    if (optimizer)
+    {
+        arrays = optimizer->stateArrays(params);
+    }
+    if (base.header.numValues != params.size() || (optimizer && base.header.numArrays != arrays.size()))
+    {
+        throw std::invalid_argument("Checkpoint layout does not match the ParamBuffer or the optimizer");
+    }
+
+    std::vector<double> data(base.header.numValues * (1 + base.header.numArrays));
+    base.apply(data);
+    ParsedFile* newest = &base;
+    ParsedFile delta;
+    ParsedFile next;
+    for (size_t sequence = base.header.sequence + 1;
+         std::binary_search(sequences.begin(), sequences.end(), sequence) && next.read(fileName(directory, sequence))
+         && next.follows(*newest);
+         ++sequence)
+    {
+        next.apply(data);
+        std::swap(delta, next);
+        newest = &delta;
+    }
+
+    auto in = data.begin();
+    std::copy_n(in, params.size(), params.values().begin());
+    for (std::span<double> array : arrays)
+    {
+        in += static_cast<long>(params.size());
+        std::copy_n(in, array.size(), array.begin());
+    }
+    if (optimizer)
+    {
+        optimizer->setStepCount(newest->header.optimizerSteps);
+    }
+
+    TrainingState state;
+    state.step = newest->header.step;
+    state.loader = {newest->header.epoch, newest->header.batches};
+    state.rng = newest->rng;
+    return state;
+}
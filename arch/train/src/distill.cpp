@@ -0,0 +1,204 @@
+#include "../headr/distill.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    size_t topWidth(Listener& listener) noexcept
+    {
+        return listener.getLayers().back()->getPrivMemberLayerNodes().size();
+    }
+}
+
+/**
+ *
+ * @brief: parameters of a listener, counted the way NetworkNode::registerParams adds them
+ *
+ */
+size_t listenerParams(Listener& listener) noexcept
+{
+    size_t count = 0;
+    for (auto& layer : listener.getLayers())
+    {
+        for (auto& node : layer->getPrivMemberLayerNodes())
+        {
+            const LstmNode& cell = node.getNode();
+            count += node.getWeightVecSize() + 1 + cell.forgetVals.size() + cell.inputVals.size()
+                     + cell.outputVals.size();
+        }
+    }
+    return count + listener.getReadoutWeights().size() + 1;
+}
+
+/**
+ *
+ * @brief: constructor
+ *
+ * @param: teacher .
+ * type: Listener&, trained model, only run forward
+ * @param: student .
+ * type: Listener&, model to train, same number of inputs as the teacher
+ * @param: params .
+ * type: ParamBuffer&, bound buffer holding the student's parameters
+ * @param: optimizer .
+ * type: Optimizer&, steps params, its learning rate also steps the projection
+ * @param: config .
+ * type: DistillConfig, temperature, hint weight and BPTT settings
+ *
+ */
+Distiller::Distiller(Listener& teacher, Listener& student, ParamBuffer& params, Optimizer& optimizer,
+                     DistillConfig config)
+        : teacher(teacher), student(student), params(params), optimizer(optimizer), config(config),
+          bptt(student, params, config.bptt), teacherWidth(topWidth(teacher)), studentWidth(topWidth(student)),
+          width(teacher.getLayers().front()->getFanIn())
+{
+    if (!(config.temperature > 0.0) || config.hiddenWeight < 0.0 || config.timingRepeats == 0)
+    {
+        throw std::invalid_argument("Distillation needs a positive temperature and timing repeats, and a non "
+                                    "negative hint weight");
+    }
+    if (student.getLayers().front()->getFanIn() != width)
+    {
+        throw std::invalid_argument("Teacher and student must take the same number of inputs");
+    }
+    // teacher node i starts out matched with student node i % studentWidth
+    projection.assign(teacherWidth * studentWidth, 0.0);
+    for (size_t i = 0; i < teacherWidth; ++i)
+    {
+        projection[i * studentWidth + i % studentWidth] = 1.0;
+    }
+    projectionGrad.assign(projection.size(), 0.0);
+}
+
+/**
+ *
+ * @brief: teacher preferences, softened, and top layer STM at every timestep of one sequence
+ *
+ */
+void Distiller::teach(std::span<const double> features)
+{
+    size_t steps = features.size() / width;
+    softTargets.resize(steps);
+    hiddenTargets.resize(steps * teacherWidth);
+    teacher.resetState();
+    for (size_t t = 0; t < steps; ++t)
+    {
+        double preference = teacher.step(ctx, features.subspan(t * width, width),
+                                         {hiddenTargets.data() + t * teacherWidth, teacherWidth});
+        if (config.temperature != 1.0)
+        {
+            double clamped = std::clamp(preference, 1e-12, 1.0 - 1e-12);
+            double logit = std::log(clamped / (1.0 - clamped));
+            preference = 1.0 / (1.0 + std::exp(-logit / config.temperature));
+        }
+        softTargets[t] = preference;
+    }
+    ctx.endBatch();
+    teacher.resetState();
+}
+
+/**
+ *
+ * @brief: one pass over the sequences, one optimizer step each
+ *
+ * @param: sequences .
+ * type: const std::vector<std::vector<double>>&, the listeners' fan in per timestep
+ * @return: double .
+ * mean distillation loss over the sequences
+ *
+ */
+double Distiller::train(const std::vector<std::vector<double>>& sequences)
+{
+    double total = 0.0;
+    for (const std::vector<double>& features : sequences)
+    {
+        if (features.size() % width != 0)
+        {
+            throw std::invalid_argument("Sequence length is not a whole number of timesteps");
+        }
+        teach(features);
+        params.zeroGrad();
+        std::fill(projectionGrad.begin(), projectionGrad.end(), 0.0);
+        HiddenHint hint;
+        hint.targets = hiddenTargets;
+        hint.width = teacherWidth;
+        hint.projection = projection;
+        hint.projectionGrad = projectionGrad;
+        hint.weight = config.hiddenWeight;
+        total += bptt.accumulate(features, softTargets, config.hiddenWeight > 0.0 ? &hint : nullptr);
+        optimizer.step(params);
+        if (config.hiddenWeight > 0.0)
+        {
+            double rate = optimizer.getLearningRate();
+            for (size_t i = 0; i < projection.size(); ++i)
+            {
+                projection[i] -= rate * projectionGrad[i];
+            }
+        }
+    }
+    return sequences.empty() ? 0.0 : total / static_cast<double>(sequences.size());
+}
+
+/**
+ *
+ * @brief: compares and times teacher and student on the same packed sequences
+ *
+ * @param: sequences .
+ * type: const std::vector<std::vector<double>>&, the listeners' fan in per timestep
+ * @return: DistillReport .
+ * agreement, preference gap and speedup
+ *
+ * @note: both run through runPacked, the deployment path, and the faster of timingRepeats runs counts
+ *
+ */
+DistillReport Distiller::evaluate(const std::vector<std::vector<double>>& sequences)
+{
+    DistillReport report;
+    report.teacherParams = listenerParams(teacher);
+    report.studentParams = listenerParams(student);
+    PackedBatch batch = packSequences(sequences, width);
+    if (batch.rows() == 0)
+    {
+        return report;
+    }
+
+    auto time = [&](Listener& listener, std::vector<double>& out)
+    {
+        double best = 0.0;
+        for (size_t r = 0; r < config.timingRepeats; ++r)
+        {
+            Clock::time_point begin = Clock::now();
+            std::span<double> preferences = listener.runPacked(ctx, batch);
+            double elapsed = std::chrono::duration<double>(Clock::now() - begin).count();
+            out.assign(preferences.begin(), preferences.end());
+            ctx.endBatch();
+            best = r == 0 ? elapsed : std::min(best, elapsed);
+        }
+        return best;
+    };
+    std::vector<double> teacherOut;
+    std::vector<double> studentOut;
+    double teacherSeconds = time(teacher, teacherOut);
+    double studentSeconds = time(student, studentOut);
+
+    size_t agree = 0;
+    double diffSum = 0.0;
+    for (size_t row = 0; row < teacherOut.size(); ++row)
+    {
+        double diff = std::abs(studentOut[row] - teacherOut[row]);
+        agree += (studentOut[row] >= 0.5) == (teacherOut[row] >= 0.5) ? 1 : 0;
+        diffSum += diff;
+        report.maxAbsDiff = std::max(report.maxAbsDiff, diff);
+    }
+    double rows = static_cast<double>(teacherOut.size());
+    report.agreement = static_cast<double>(agree) / rows;
+    report.meanAbsDiff = diffSum / rows;
+    report.teacherSecondsPerStep = teacherSeconds / rows;
+    report.studentSecondsPerStep = studentSeconds / rows;
+    report.speedup = studentSeconds > 0.0 ? teacherSeconds / studentSeconds : 0.0;
+    return report;
+}
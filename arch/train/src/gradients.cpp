@@ -0,0 +1,133 @@
+#include "../headr/gradients.h"
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+/**
+ *
+ * @brief: builds one replica per pool thread over every sample
+ *
+ * @param: shared .
+ * type: ParamBuffer&, bound buffer the gradients are summed into
+ * @param: pool .
+ * type: ThreadPool*, nullptr runs every sample on the calling thread
+ * @param: numSamples .
+ * type: size_t, samples the batches index into
+ * @param: factory .
+ * type: const ReplicaFactory&, called with the whole sample range
+ * @param: leafSamples .
+ * type: size_t, samples per leaf in the deterministic mode
+ *
+ */
+ParallelGradients::ParallelGradients(ParamBuffer& shared, ThreadPool* pool, size_t numSamples,
+                                     const ReplicaFactory& factory, size_t leafSamples)
+        : shared(shared), pool(pool), numSamples(numSamples), leafSamples(leafSamples)
+{
+    if (!shared.isBound())
+    {
+        throw std::logic_error("ParamBuffer must be bound before reducing gradients into it");
+    }
+    if (leafSamples == 0)
+    {
+        throw std::invalid_argument("Gradient leaves need at least one sample");
+    }
+    std::vector<size_t> every(numSamples);
+    std::iota(every.begin(), every.end(), 0);
+    size_t threads = pool ? pool->size() : 1;
+    for (size_t r = 0; r < threads; ++r)
+    {
+        replicas.push_back(factory(every, false));
+        if (!replicas.back()->params().isBound() || replicas.back()->params().size() != shared.size())
+        {
+            throw std::invalid_argument("Replica buffer does not match the shared buffer");
+        }
+    }
+}
+
+/**
+ *
+ * @brief: overwrites the shared gradients with the sum over the batch, values are read from shared
+ *
+ * @param: batch .
+ * type: span<const size_t>, sample indices in the order they are summed
+ * @return: double .
+ * summed loss of the batch
+ *
+ * @note: a pool chunk always has its own replica, so which thread runs a leaf does not matter, a leaf
+ *          starts from zeroed gradients and its samples are added in batch order
+ *
+ */
+double ParallelGradients::accumulate(std::span<const size_t> batch)
+{
+    for (size_t index : batch)
+    {
+        if (index >= numSamples)
+        {
+            throw std::invalid_argument("Batch index out of range");
+        }
+    }
+    std::span<double> grads = shared.grads();
+    if (batch.empty())
+    {
+        std::fill(grads.begin(), grads.end(), 0.0);
+        return 0.0;
+    }
+    for (auto& replica : replicas)
+    {
+        std::span<const double> values = shared.values();
+        std::copy(values.begin(), values.end(), replica->params().values().begin());
+    }
+
+    size_t width = shared.size();
+    bool fixed = deterministicReductions();
+    size_t chunks = replicas.size();
+    size_t rows = fixed ? (batch.size() + leafSamples - 1) / leafSamples : std::min(chunks, batch.size());
+    size_t perRow = fixed ? leafSamples : (batch.size() + rows - 1) / rows;
+    partials.resize(rows * width);
+    losses.assign(rows, 0.0);
+
+    auto body = [&](size_t chunk, size_t begin, size_t end)
+    {
+        HogwildReplica& replica = *replicas[chunk];
+        ParamBuffer& local = replica.params();
+        for (size_t row = begin; row < end; ++row)
+        {
+            local.zeroGrad();
+            double loss = 0.0;
+            for (size_t s = row * perRow; s < std::min(batch.size(), (row + 1) * perRow); ++s)
+            {
+                loss += replica.accumulate(batch[s]);
+            }
+            losses[row] = loss;
+            std::copy(local.grads().begin(), local.grads().end(), partials.begin() + static_cast<long>(row * width));
+        }
+    };
+    if (pool == nullptr || rows == 1)
+    {
+        body(0, 0, rows);
+    }
+    else
+    {
+        pool->parallelFor(rows, chunks, body);
+    }
+
+    if (fixed)
+    {
+        treeCombine(pool, partials, rows, width);
+        treeCombine(nullptr, losses, rows, 1);
+    }
+    else
+    {
+        for (size_t row = 1; row < rows; ++row)
+        {
+            const double* from = partials.data() + row * width;
+            for (size_t i = 0; i < width; ++i)
+            {
+                partials[i] += from[i];
+            }
+            losses[0] += losses[row];
+        }
+    }
+    std::copy_n(partials.begin(), width, grads.begin());
+    return losses[0];
+}
@@ -0,0 +1,437 @@
+#include "../headr/hogwild.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace
+{
+    /**
+     *
+     * @brief: cpus in NUMA node order from sysfs, so consecutive workers fill one node before the next
+     *
+     */
+    std::vector<int> cpusByNode()
+    {
+        std::vector<int> cpus;
+        for (int node = 0;; ++node)
+        {
+            std::ifstream list("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+            if (!list)
+            {
+                break;
+            }
+            // comma separated ranges, "0-3,8-11"
+            std::string text;
+            std::getline(list, text);
+            std::stringstream ranges(text);
+            std::string range;
+            while (std::getline(ranges, range, ','))
+            {
+                size_t dash = range.find('-');
+                int first = std::stoi(range.substr(0, dash));
+                int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+                for (int cpu = first; cpu <= last; ++cpu)
+                {
+                    cpus.push_back(cpu);
+                }
+            }
+        }
+        if (cpus.empty())
+        {
+            cpus.resize(std::max(1u, std::thread::hardware_concurrency()));
+            std::iota(cpus.begin(), cpus.end(), 0);
+        }
+        return cpus;
+    }
+
+    bool pinCurrentThread(int cpu) noexcept
+    {
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+        (void)cpu;
+        return false;
+#endif
+    }
+
+    struct WorkerResult
+    {
+        std::vector<double> epochLoss;
+        size_t samples = 0;
+        size_t writes = 0;
+        size_t reads = 0;
+        bool pinned = false;
+    };
+}
+
+/**
+ *
+ * @brief: constructor
+ *
+ * @param: shared .
+ * type: ParamBuffer&, bound buffer every worker reads and updates
+ * @param: config .
+ * type: HogwildConfig, workers, schedule and placement
+ *
+ */
+HogwildTrainer::HogwildTrainer(ParamBuffer& shared, HogwildConfig config)
+        : shared(shared), config(config)
+{
+    if (!shared.isBound())
+    {
+        throw std::logic_error("ParamBuffer must be bound before building the trainer");
+    }
+    if (config.epochs == 0 || config.learningRate <= 0.0 || config.refreshInterval == 0)
+    {
+        throw std::invalid_argument("Hogwild needs at least one epoch, a positive learning rate and a refresh "
+                                    "interval");
+    }
+    if (this->config.threads == 0)
+    {
+        this->config.threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+/**
+ *
+ * @brief: trains until every worker finished its epochs, rethrows the first worker error
+ *
+ * @param: numSamples .
+ * type: size_t, samples to shard over the workers
+ * @param: factory .
+ * type: const ReplicaFactory&, called once per worker
+ * @return: HogwildStats .
+ * loss curve and counters of the run
+ *
+ */
+HogwildStats HogwildTrainer::train(size_t numSamples, const ReplicaFactory& factory)
+{
+    size_t threads = std::min(config.threads, std::max<size_t>(1, numSamples));
+    std::vector<int> cpus = config.pinThreads ? cpusByNode() : std::vector<int>();
+
+    // contiguous blocks for node local copies, strided otherwise
+    std::vector<std::vector<size_t>> shards(threads);
+    for (size_t i = 0; i < numSamples; ++i)
+    {
+        shards[config.numaShards ? i * threads / numSamples : i % threads].push_back(i);
+    }
+
+    std::vector<WorkerResult> results(threads);
+    std::exception_ptr error;
+    std::mutex errorLock;
+    std::atomic<bool> failed{false};
+    double* values = shared.values().data();
+    size_t count = shared.size();
+
+    auto worker = [&](size_t w)
+    {
+        try
+        {
+            WorkerResult& result = results[w];
+            if (!cpus.empty())
+            {
+                result.pinned = pinCurrentThread(cpus[w % cpus.size()]);
+            }
+            std::unique_ptr<HogwildReplica> replica = factory(shards[w], config.numaShards);
+            ParamBuffer& local = replica->params();
+            if (!local.isBound() || local.size() != count)
+            {
+                throw std::invalid_argument("Replica buffer does not match the shared buffer");
+            }
+            std::span<double> localValues = local.values();
+            std::span<const double> localGrads = local.grads();
+
+            std::vector<size_t> order(replica->size());
+            std::iota(order.begin(), order.end(), 0);
+            std::mt19937_64 gen(config.seed + w);
+            result.epochLoss.assign(config.epochs, 0.0);
+            for (size_t epoch = 0; epoch < config.epochs && !failed.load(std::memory_order_relaxed); ++epoch)
+            {
+                std::shuffle(order.begin(), order.end(), gen);
+                for (size_t index : order)
+                {
+                    if (result.samples % config.refreshInterval == 0)
+                    {
+                        for (size_t i = 0; i < count; ++i)
+                        {
+                            localValues[i] = std::atomic_ref<double>(values[i]).load(std::memory_order_relaxed);
+                        }
+                        result.reads += count;
+                    }
+                    local.zeroGrad();
+                    double loss = replica->accumulate(index);
+                    result.epochLoss[epoch] += loss;
+                    if (config.metrics)
+                    {
+                        // record() drops the unsampled steps, only the norm is worth checking for first
+                        MetricsStream& metrics = *config.metrics;
+                        uint32_t source = static_cast<uint32_t>(w);
+                        metrics.record(Metric::Loss, result.samples, loss, source);
+                        metrics.record(Metric::LearningRate, result.samples, config.learningRate, source);
+                        if (metrics.wants(Metric::GradNorm, result.samples))
+                        {
+                            metrics.record(Metric::GradNorm, result.samples, gradientNorm(localGrads), source);
+                        }
+                    }
+                    for (size_t i = 0; i < count; ++i)
+                    {
+                        if (localGrads[i] != 0.0)
+                        {
+                            // the replica keeps what it wrote, its own steps never wait for the next refresh
+                            std::atomic_ref<double> param(values[i]);
+                            localValues[i] = param.load(std::memory_order_relaxed)
+                                             - config.learningRate * localGrads[i];
+                            param.store(localValues[i], std::memory_order_relaxed);
+                            ++result.writes;
+                        }
+                    }
+                    ++result.samples;
+                }
+            }
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> guard(errorLock);
+            if (!error)
+            {
+                error = std::current_exception();
+            }
+            failed.store(true, std::memory_order_relaxed);
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    pool.reserve(threads);
+    for (size_t w = 0; w < threads; ++w)
+    {
+        pool.emplace_back(worker, w);
+    }
+    for (std::thread& thread : pool)
+    {
+        thread.join();
+    }
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+
+    HogwildStats stats;
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    stats.threads = threads;
+    stats.epochLoss.assign(config.epochs, 0.0);
+    for (const WorkerResult& result : results)
+    {
+        stats.samples += result.samples;
+        stats.writes += result.writes;
+        stats.reads += result.reads;
+        stats.pinnedThreads += result.pinned ? 1 : 0;
+        for (size_t epoch = 0; epoch < config.epochs; ++epoch)
+        {
+            stats.epochLoss[epoch] += result.epochLoss[epoch];
+        }
+    }
+    for (double& loss : stats.epochLoss)
+    {
+        loss /= static_cast<double>(std::max<size_t>(1, numSamples));
+    }
+    return stats;
+}
+
+namespace
+{
+    std::vector<int> hiddenSizes(Classifier& shape)
+    {
+        std::vector<int> sizes;
+        auto& layers = shape.getLayers();
+        // the last layer is the single output node the constructor adds itself
+        for (size_t l = 0; l + 1 < layers.size(); ++l)
+        {
+            sizes.push_back(static_cast<int>(layers[l]->getPrivMemberLayerNodes().size()));
+        }
+        return sizes;
+    }
+
+    std::vector<int> hiddenSizes(Listener& shape)
+    {
+        std::vector<int> sizes;
+        for (auto& layer : shape.getLayers())
+        {
+            sizes.push_back(static_cast<int>(layer->getPrivMemberLayerNodes().size()));
+        }
+        return sizes;
+    }
+}
+
+/**
+ *
+ * @brief: constructor
+ *
+ * @param: shape .
+ * type: Classifier&, model to copy, the values come from the shared buffer
+ * @param: data .
+ * type: const Dataset&, all samples
+ * @param: shard .
+ * type: span<const size_t>, rows of data this replica trains on
+ * @param: copyShard .
+ * type: bool, copy the rows in instead of reading them from data
+ *
+ */
+ClassifierReplica::ClassifierReplica(Classifier& shape, const Dataset& data, std::span<const size_t> shard,
+                                     bool copyShard)
+        : model(shape.getNumInputs(), hiddenSizes(shape), shape.getNumChannels()), source(&data)
+{
+    if (data.numFeatures != static_cast<size_t>(shape.getNumInputs() + shape.getNumChannels()))
+    {
+        throw std::invalid_argument("Dataset rows do not match the classifier inputs");
+    }
+    model.registerParams(buffer);
+    buffer.bind();
+    if (copyShard)
+    {
+        local.numFeatures = data.numFeatures;
+        for (size_t row : shard)
+        {
+            std::span<const double> values = data.row(row);
+            local.features.insert(local.features.end(), values.begin(), values.end());
+            local.labels.push_back(data.labels[row]);
+        }
+        source = &local;
+        rows.resize(shard.size());
+        std::iota(rows.begin(), rows.end(), 0);
+    }
+    else
+    {
+        rows.assign(shard.begin(), shard.end());
+    }
+    auto& layers = model.getLayers();
+    weights.resize(layers.size());
+    biases.resize(layers.size());
+    activations.resize(layers.size() + 1);
+}
+
+/**
+ *
+ * @brief: forward and backward of one row through the tanh layers
+ *
+ * @param: index .
+ * type: size_t, sample within the shard
+ * @return: double .
+ * 0.5 * (P - label)^2
+ *
+ */
+double ClassifierReplica::accumulate(size_t index)
+{
+    auto& layers = model.getLayers();
+    std::span<const double> row = source->row(rows[index]);
+    size_t numInputs = static_cast<size_t>(model.getNumInputs());
+
+    // same input as Classifier::predict, normalised frequencies then the raw channels
+    activations[0].resize(static_cast<Eigen::Index>(row.size()));
+    for (size_t i = 0; i < row.size(); ++i)
+    {
+        activations[0][static_cast<Eigen::Index>(i)] = i < numInputs ? normalizeFrequency(row[i]) : row[i];
+    }
+    for (size_t l = 0; l < layers.size(); ++l)
+    {
+        size_t nodes = layers[l]->getPrivMemberLayerNodes().size();
+        size_t fanIn = layers[l]->getFanIn();
+        weights[l].resize(static_cast<Eigen::Index>(nodes), static_cast<Eigen::Index>(fanIn));
+        biases[l].resize(static_cast<Eigen::Index>(nodes));
+        layers[l]->unpackWeights({weights[l].data(), nodes * fanIn}, {}, {biases[l].data(), nodes});
+        activations[l + 1] = ((weights[l] * activations[l]) + biases[l]).array().tanh().matrix();
+    }
+
+    double prediction = 0.5 * (activations.back()[0] + 1.0);
+    double error = prediction - source->labels[rows[index]];
+    Eigen::VectorXd delta = Eigen::VectorXd::Constant(1, 0.5 * error);
+    for (size_t l = layers.size(); l-- > 0;)
+    {
+        // through the tanh, then into the weights and the layer below
+        delta = (delta.array() * (1.0 - activations[l + 1].array().square())).matrix();
+        RowMatrix dWeights = delta * activations[l].transpose();
+        layers[l]->scatterGrads(buffer, {dWeights.data(), static_cast<size_t>(dWeights.size())}, {},
+                                {delta.data(), static_cast<size_t>(delta.size())});
+        if (l > 0)
+        {
+            delta = weights[l].transpose() * delta;
+        }
+    }
+    return 0.5 * error * error;
+}
+
+/**
+ *
+ * @brief: constructor
+ *
+ * @param: shape .
+ * type: Listener&, model to copy, the values come from the shared buffer
+ * @param: features .
+ * type: const std::vector<std::vector<double>>&, numInputs values per timestep
+ * @param: targets .
+ * type: const std::vector<std::vector<double>>&, preference per timestep
+ * @param: shard .
+ * type: span<const size_t>, sequences this replica trains on
+ * @param: copyShard .
+ * type: bool, copy the sequences in instead of reading them from the inputs
+ * @param: bptt .
+ * type: BpttConfig, truncation of the backward pass
+ *
+ */
+ListenerReplica::ListenerReplica(Listener& shape, const std::vector<std::vector<double>>& features,
+                                 const std::vector<std::vector<double>>& targets, std::span<const size_t> shard,
+                                 bool copyShard, BpttConfig bptt)
+        : model(static_cast<int>(shape.getLayers().front()->getFanIn()), hiddenSizes(shape)),
+          features(&features), targets(&targets)
+{
+    if (features.size() != targets.size())
+    {
+        throw std::invalid_argument("Listener features and targets hold a different number of sequences");
+    }
+    model.registerParams(buffer);
+    buffer.bind();
+    trainer = std::make_unique<TruncatedBptt>(model, buffer, bptt);
+    if (copyShard)
+    {
+        for (size_t seq : shard)
+        {
+            localFeatures.push_back(features[seq]);
+            localTargets.push_back(targets[seq]);
+        }
+        this->features = &localFeatures;
+        this->targets = &localTargets;
+        rows.resize(shard.size());
+        std::iota(rows.begin(), rows.end(), 0);
+    }
+    else
+    {
+        rows.assign(shard.begin(), shard.end());
+    }
+}
+
+/**
+ *
+ * @brief: one sequence forward and backward with truncated BPTT
+ *
+ */
+double ListenerReplica::accumulate(size_t index)
+{
+    size_t seq = rows[index];
+    return trainer->accumulate((*features)[seq], (*targets)[seq]);
+}
@@ -0,0 +1,348 @@
+#include "../headr/metrics.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+    const char* metricName(Metric metric) noexcept
+    {
+        switch (metric)
+        {
+            case Metric::Loss: return "loss";
+            case Metric::Accuracy: return "accuracy";
+            case Metric::GradNorm: return "grad_norm";
+            case Metric::LearningRate: return "learning_rate";
+            case Metric::Activation: return "activation";
+        }
+        return "unknown";
+    }
+
+    // shortest text that reads back to the same double, no locale and no allocation
+    template <typename T>
+    void append(std::string& line, T value)
+    {
+        char text[32];
+        std::to_chars_result result = std::to_chars(text, text + sizeof(text), value);
+        line.append(text, result.ptr);
+    }
+
+    // JSON has no NaN or infinity, a diverged loss is written as null
+    void appendJson(std::string& line, double value)
+    {
+        if (std::isfinite(value))
+        {
+            append(line, value);
+        }
+        else
+        {
+            line += "null";
+        }
+    }
+}
+
+/**
+ *
+ * @brief: opens the output, sizes the ring and starts the writer thread
+ *
+ * @param: path .
+ * type: const std::string&, file to write, truncated
+ * @param: config .
+ * type: MetricsConfig, sampling, filter, ring size and format
+ *
+ */
+MetricsStream::MetricsStream(const std::string& path, MetricsConfig config)
+        : config(config), out(path, std::ios::trunc), start(std::chrono::steady_clock::now())
+{
+    if (config.every == 0 || config.capacity == 0)
+    {
+        throw std::invalid_argument("Metrics sampling interval and ring capacity must be positive");
+    }
+    if (!out)
+    {
+        throw std::invalid_argument("Could not open metrics file: " + path);
+    }
+    size_t capacity = 1;
+    while (capacity < config.capacity)
+    {
+        capacity <<= 1;
+    }
+    cells = std::make_unique<Cell[]>(capacity);
+    for (size_t i = 0; i < capacity; ++i)
+    {
+        cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    mask = capacity - 1;
+    if (config.format == MetricsFormat::Csv)
+    {
+        out << "seconds,step,source,metric,layer,value,stddev,min,max\n";
+    }
+    worker = std::thread(&MetricsStream::run, this);
+}
+
+MetricsStream::~MetricsStream()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_all();
+    worker.join();
+}
+
+/**
+ *
+ * @brief: queues a record without locking
+ *
+ * @param: record .
+ * type: MetricRecord, seconds is stamped here
+ * @return: bool .
+ * false if the record was filtered out or dropped on a full ring
+ *
+ * @note: a producer claims slot pos by moving head from pos to pos + 1, which it may only do while the
+ *          slot's sequence is pos (the writer is done with it), and hands it over by publishing pos + 1
+ *
+ */
+bool MetricsStream::push(MetricRecord record) noexcept
+{
+    if (!wants(record.metric, record.step))
+    {
+        return false;
+    }
+    record.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    size_t pos = head.load(std::memory_order_relaxed);
+    Cell* cell = nullptr;
+    for (;;)
+    {
+        cell = &cells[pos & mask];
+        size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+        if (diff == 0)
+        {
+            if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            // the writer has not freed this slot yet, the ring is full
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        else
+        {
+            pos = head.load(std::memory_order_relaxed);
+        }
+    }
+    cell->record = record;
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    pushed.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool MetricsStream::record(Metric metric, size_t step, double value, uint32_t source) noexcept
+{
+    MetricRecord rec;
+    rec.metric = metric;
+    rec.step = step;
+    rec.value = value;
+    rec.source = source;
+    return push(rec);
+}
+
+/**
+ *
+ * @brief: mean, standard deviation, min and max of one layer's activations as one record
+ *
+ * @param: step .
+ * type: size_t, step counter
+ * @param: layer .
+ * type: int, layer index
+ * @param: values .
+ * type: span<const double>, the layer's outputs
+ * @param: source .
+ * type: uint32_t, worker or thread id
+ *
+ */
+bool MetricsStream::activations(size_t step, int layer, std::span<const double> values, uint32_t source) noexcept
+{
+    if (values.empty() || !wants(Metric::Activation, step))
+    {
+        return false;
+    }
+    MetricRecord rec;
+    rec.metric = Metric::Activation;
+    rec.step = step;
+    rec.layer = layer;
+    rec.source = source;
+    rec.min = rec.max = values.front();
+    double sum = 0.0;
+    double squares = 0.0;
+    for (double val : values)
+    {
+        sum += val;
+        squares += val * val;
+        rec.min = std::min(rec.min, val);
+        rec.max = std::max(rec.max, val);
+    }
+    double count = static_cast<double>(values.size());
+    rec.value = sum / count;
+    rec.stddev = std::sqrt(std::max(0.0, squares / count - rec.value * rec.value));
+    return push(rec);
+}
+
+/**
+ *
+ * @brief: waits until every record pushed before the call is in the file
+ *
+ */
+void MetricsStream::flush()
+{
+    size_t target = pushed.load(std::memory_order_relaxed);
+    std::unique_lock<std::mutex> guard(lock);
+    flushRequested = true;
+    wake.notify_all();
+    drained.wait(guard, [&] { return written.load(std::memory_order_relaxed) >= target; });
+}
+
+MetricsStats MetricsStream::stats() const noexcept
+{
+    MetricsStats stats;
+    stats.pushed = pushed.load(std::memory_order_relaxed);
+    stats.dropped = dropped.load(std::memory_order_relaxed);
+    stats.written = written.load(std::memory_order_relaxed);
+    return stats;
+}
+
+/**
+ *
+ * @brief: the writer thread, sleeps flushInterval or until a flush, then drains the ring
+ *
+ */
+void MetricsStream::run()
+{
+    for (;;)
+    {
+        bool last = false;
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            wake.wait_for(guard, config.flushInterval, [&] { return flushRequested || stopping; });
+            flushRequested = false;
+            last = stopping;
+        }
+        // a slot claimed but not yet published ends a pass, go again while records keep coming
+        while (drain() > 0)
+        {
+        }
+        out.flush();
+        {
+            // under the lock, so a flush() between its predicate check and its wait still wakes up
+            std::lock_guard<std::mutex> guard(lock);
+            drained.notify_all();
+        }
+        if (last)
+        {
+            return;
+        }
+    }
+}
+
+/**
+ *
+ * @brief: writes every published record in order, returns how many
+ *
+ */
+size_t MetricsStream::drain()
+{
+    size_t count = 0;
+    line.clear();
+    for (;;)
+    {
+        Cell& cell = cells[tail & mask];
+        if (cell.sequence.load(std::memory_order_acquire) != tail + 1)
+        {
+            break;
+        }
+        format(cell.record);
+        cell.sequence.store(tail + mask + 1, std::memory_order_release);
+        ++tail;
+        ++count;
+    }
+    out.write(line.data(), static_cast<std::streamsize>(line.size()));
+    written.fetch_add(count, std::memory_order_relaxed);
+    return count;
+}
+
+/**
+ *
+ * @brief: appends one record to the pending text in the configured format
+ *
+ */
+void MetricsStream::format(const MetricRecord& record)
+{
+    bool activation = record.metric == Metric::Activation;
+    if (config.format == MetricsFormat::Csv)
+    {
+        append(line, record.seconds);
+        line += ',';
+        append(line, record.step);
+        line += ',';
+        append(line, record.source);
+        line += ',';
+        line += metricName(record.metric);
+        line += ',';
+        append(line, record.layer);
+        for (double val : {record.value, record.stddev, record.min, record.max})
+        {
+            line += ',';
+            append(line, val);
+        }
+        line += '\n';
+        return;
+    }
+    line += "{\"seconds\":";
+    append(line, record.seconds);
+    line += ",\"step\":";
+    append(line, record.step);
+    line += ",\"source\":";
+    append(line, record.source);
+    line += ",\"metric\":\"";
+    line += metricName(record.metric);
+    line += '"';
+    if (activation)
+    {
+        line += ",\"layer\":";
+        append(line, record.layer);
+        line += ",\"mean\":";
+        appendJson(line, record.value);
+        line += ",\"stddev\":";
+        appendJson(line, record.stddev);
+        line += ",\"min\":";
+        appendJson(line, record.min);
+        line += ",\"max\":";
+        appendJson(line, record.max);
+    }
+    else
+    {
+        line += ",\"value\":";
+        appendJson(line, record.value);
+    }
+    line += "}\n";
+}
+
+/**
+ *
+ * @brief: L2 norm of a gradient array
+ *
+ */
+double gradientNorm(std::span<const double> grads) noexcept
+{
+    double squares = 0.0;
+    for (double grad : grads)
+    {
+        squares += grad * grad;
+    }
+    return std::sqrt(squares);
+}
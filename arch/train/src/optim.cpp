@@ -0,0 +1,217 @@
+#include "../headr/optim.h"
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+    using ArrayMap = Eigen::Map<Eigen::ArrayXd, Eigen::Aligned64>;
+
+    /**
+     *
+     * @brief: runs kernel(offset, length) over [0, count) in L1 sized blocks, every block starts on a
+     *          cache line since blockSize is a multiple of 8 doubles
+     *
+     */
+    template <typename Kernel>
+    void forEachBlock(std::size_t count, Kernel&& kernel)
+    {
+        for (std::size_t offset = 0; offset < count; offset += Optimizer::blockSize)
+        {
+            kernel(offset, static_cast<Eigen::Index>(std::min(Optimizer::blockSize, count - offset)));
+        }
+    }
+}
+
+/**
+ *
+ * @brief: constructor
+ *
+ * @param: learningRate .
+ * type: double, step size, must be positive
+ *
+ */
+Optimizer::Optimizer(double learningRate)
+        : learningRate(learningRate)
+{
+    if (learningRate <= 0.0)
+    {
+        throw std::invalid_argument("Learning rate must be positive");
+    }
+}
+
+/**
+ *
+ * @brief: sizes the optimizer state to the buffer on the first step, throws if the buffer changed
+ *
+ */
+void Optimizer::prepare(const ParamBuffer& params, std::initializer_list<StateVec*> state)
+{
+    if (!params.isBound())
+    {
+        throw std::logic_error("ParamBuffer must be bound before stepping an optimizer");
+    }
+    for (StateVec* vec : state)
+    {
+        if (steps == 0 && vec->empty())
+        {
+            vec->assign(params.size(), 0.0);
+        }
+        else if (vec->size() != params.size())
+        {
+            throw std::invalid_argument("Optimizer state does not match the ParamBuffer");
+        }
+    }
+}
+
+/**
+ *
+ * @brief: the optimizer state arrays in a fixed order, sized to the buffer if no step was taken yet
+ *
+ * @param: params .
+ * type: const ParamBuffer&, bound buffer the optimizer steps
+ * @return: std::vector<std::span<double>> .
+ * one span of params.size() doubles per state array
+ *
+ */
+std::vector<std::span<double>> Optimizer::stateArrays(const ParamBuffer& params)
+{
+    std::vector<StateVec*> state = stateVecs();
+    std::vector<std::span<double>> arrays;
+    for (StateVec* vec : state)
+    {
+        if (!params.isBound())
+        {
+            throw std::logic_error("ParamBuffer must be bound before reading the optimizer state");
+        }
+        if (vec->empty())
+        {
+            vec->assign(params.size(), 0.0);
+        }
+        else if (vec->size() != params.size())
+        {
+            throw std::invalid_argument("Optimizer state does not match the ParamBuffer");
+        }
+        arrays.emplace_back(vec->data(), vec->size());
+    }
+    return arrays;
+}
+
+/**
+ *
+ * @brief: constructor
+ *
+ * @param: learningRate .
+ * type: double, step size
+ * @param: momentum .
+ * type: double, velocity decay in [0, 1)
+ * @param: weightDecay .
+ * type: double, L2 penalty folded into the gradient
+ *
+ */
+SgdMomentum::SgdMomentum(double learningRate, double momentum, double weightDecay)
+        : Optimizer(learningRate), momentum(momentum), weightDecay(weightDecay)
+{
+    if (momentum < 0.0 || momentum >= 1.0)
+    {
+        throw std::invalid_argument("Momentum must be in [0, 1)");
+    }
+}
+
+/**
+ *
+ * @brief: v = momentum * v + g + weightDecay * p,  p -= lr * v, fused over each block
+ *
+ */
+void SgdMomentum::step(ParamBuffer& params)
+{
+    prepare(params, {&velocityVec});
+    double* value = params.values().data();
+    const double* grad = params.grads().data();
+    double* velocity = velocityVec.data();
+
+    forEachBlock(params.size(), [&](std::size_t offset, Eigen::Index len)
+    {
+        ArrayMap p(value + offset, len);
+        ArrayMap v(velocity + offset, len);
+        Eigen::Map<const Eigen::ArrayXd, Eigen::Aligned64> g(grad + offset, len);
+        v = momentum * v + g + weightDecay * p;
+        p -= learningRate * v;
+    });
+    ++steps;
+}
+
+/**
+ *
+ * @brief: constructor
+ *
+ * @param: learningRate .
+ * type: double, step size
+ * @param: beta1 .
+ * type: double, decay of the first moment
+ * @param: beta2 .
+ * type: double, decay of the second moment
+ * @param: epsilon .
+ * type: double, keeps the denominator away from zero
+ *
+ */
+Adam::Adam(double learningRate, double beta1, double beta2, double epsilon)
+        : Optimizer(learningRate), beta1(beta1), beta2(beta2), epsilon(epsilon)
+{
+    if (beta1 < 0.0 || beta1 >= 1.0 || beta2 < 0.0 || beta2 >= 1.0)
+    {
+        throw std::invalid_argument("Adam betas must be in [0, 1)");
+    }
+}
+
+/**
+ *
+ * @brief: bias corrected Adam step, m, v and p are updated in the same pass over each block
+ *
+ */
+void Adam::step(ParamBuffer& params)
+{
+    prepare(params, {&firstVec, &secondVec});
+    double t = static_cast<double>(steps + 1);
+    double stepSize = learningRate / (1.0 - std::pow(beta1, t));
+    double secondCorrection = 1.0 / (1.0 - std::pow(beta2, t));
+    double decay = 1.0 - learningRate * decoupledDecay;
+
+    double* value = params.values().data();
+    const double* grad = params.grads().data();
+    double* first = firstVec.data();
+    double* second = secondVec.data();
+
+    forEachBlock(params.size(), [&](std::size_t offset, Eigen::Index len)
+    {
+        ArrayMap p(value + offset, len);
+        ArrayMap m(first + offset, len);
+        ArrayMap v(second + offset, len);
+        Eigen::Map<const Eigen::ArrayXd, Eigen::Aligned64> g(grad + offset, len);
+        m = beta1 * m + (1.0 - beta1) * g;
+        v = beta2 * v + (1.0 - beta2) * g.square();
+        p = decay * p - stepSize * m / ((v * secondCorrection).sqrt() + epsilon);
+    });
+    ++steps;
+}
+
+/**
+ *
+ * @brief: constructor
+ *
+ * @param: learningRate .
+ * type: double, step size
+ * @param: weightDecay .
+ * type: double, decoupled decay, scaled by the learning rate every step
+ *
+ */
+AdamW::AdamW(double learningRate, double weightDecay, double beta1, double beta2, double epsilon)
+        : Adam(learningRate, beta1, beta2, epsilon)
+{
+    if (weightDecay < 0.0)
+    {
+        throw std::invalid_argument("Weight decay must be non negative");
+    }
+    decoupledDecay = weightDecay;
+}
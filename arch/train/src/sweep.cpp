@@ -0,0 +1,237 @@
+#include "../headr/sweep.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <thread>
+
+/**
+ *
+ * @brief: expands the spec into the list of points to train
+ *
+ */
+std::vector<SweepPoint> SweepSpec::expand() const
+{
+    // cartesian product of the grid
+    std::vector<std::map<std::string, double>> combos(1);
+    for (const auto& [name, values] : grid)
+    {
+        if (values.empty())
+        {
+            throw std::invalid_argument("Sweep grid entry has no values: " + name);
+        }
+        std::vector<std::map<std::string, double>> next;
+        next.reserve(combos.size() * values.size());
+        for (const auto& combo : combos)
+        {
+            for (double val : values)
+            {
+                next.push_back(combo);
+                next.back()[name] = val;
+            }
+        }
+        combos = std::move(next);
+    }
+
+    std::vector<SweepPoint> points;
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<> unit(0.0, 1.0);
+    size_t draws = randomSamples == 0 ? 1 : randomSamples;
+    for (const auto& combo : combos)
+    {
+        for (size_t d = 0; d < draws; ++d)
+        {
+            SweepPoint point{points.size(), combo};
+            if (randomSamples > 0)
+            {
+                for (const auto& [name, range] : ranges)
+                {
+                    point.params[name] = range.first + unit(gen) * (range.second - range.first);
+                }
+                for (const auto& [name, range] : logRanges)
+                {
+                    if (range.first <= 0.0 || range.second <= 0.0)
+                    {
+                        throw std::invalid_argument("Log range must be positive: " + name);
+                    }
+                    double logLo = std::log(range.first);
+                    double logHi = std::log(range.second);
+                    point.params[name] = std::exp(logLo + unit(gen) * (logHi - logLo));
+                }
+            }
+            points.push_back(std::move(point));
+        }
+    }
+    return points;
+}
+
+/**
+ *
+ * @brief: constructor
+ *
+ * @param: threads .
+ * type: size_t, number of workers, 0 uses one per hardware thread
+ * @param: folds .
+ * type: size_t, k for k-fold cross validation, < 2 trains on the whole dataset
+ * @param: foldSeed .
+ * type: unsigned, seed of the fold shuffle
+ *
+ */
+SweepRunner::SweepRunner(size_t threads, size_t folds, unsigned foldSeed) noexcept
+        : numThreads(threads), numFolds(folds), seed(foldSeed)
+{
+    if (numThreads == 0)
+    {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+/**
+ *
+ * @brief: runs the sweep, blocks until every trial is done
+ *
+ */
+std::vector<TrialResult> SweepRunner::run(const SweepSpec& spec, std::shared_ptr<const Dataset> data,
+                                          const TrainFn& train)
+{
+    if (!data)
+    {
+        throw std::invalid_argument("Sweep needs a dataset");
+    }
+    const std::vector<SweepPoint> points = spec.expand();
+    // the folds are computed once, every worker reads the same index lists
+    const std::vector<Fold> folds = kFoldSplits(data->size(), numFolds, seed);
+
+    size_t numTrials = points.size() * folds.size();
+    std::vector<TrialResult> results(numTrials);
+    std::atomic<size_t> nextTrial{0};
+
+    auto worker = [&]()
+    {
+        for (size_t trial = nextTrial.fetch_add(1); trial < numTrials; trial = nextTrial.fetch_add(1))
+        {
+            TrialResult& result = results[trial];
+            const SweepPoint& point = points[trial / folds.size()];
+            result.pointId = point.id;
+            result.fold = trial % folds.size();
+
+            auto start = std::chrono::steady_clock::now();
+            try
+            {
+                result.metrics = train(point, *data, folds[result.fold]);
+            } catch (const std::exception& e)
+            {
+                // one bad configuration must not take down the sweep
+                result.error = e.what();
+            }
+            result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    size_t spawn = std::min(numThreads, numTrials);
+    for (size_t t = 1; t < spawn; ++t)
+    {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : workers)
+    {
+        thread.join();
+    }
+    return results;
+}
+
+/**
+ *
+ * @brief: writes a CSV report, one row per trial plus the fold mean of every point
+ *
+ * @note: mean rows have fold "mean" and only average the folds that finished without an error
+ *
+ */
+void SweepRunner::writeReport(const std::string& path, const std::vector<SweepPoint>& points,
+                              const std::vector<TrialResult>& results)
+{
+    std::ofstream file(path);
+    if (!file)
+    {
+        throw std::invalid_argument("Could not open report file: " + path);
+    }
+
+    std::set<std::string> paramNames;
+    std::set<std::string> metricNames;
+    for (const SweepPoint& point : points)
+    {
+        for (const auto& param : point.params)
+        {
+            paramNames.insert(param.first);
+        }
+    }
+    for (const TrialResult& result : results)
+    {
+        for (const auto& metric : result.metrics)
+        {
+            metricNames.insert(metric.first);
+        }
+    }
+
+    file << "point,fold";
+    for (const std::string& name : paramNames)
+    {
+        file << "," << name;
+    }
+    for (const std::string& name : metricNames)
+    {
+        file << "," << name;
+    }
+    file << ",seconds,error\n";
+
+    auto writeRow = [&](const SweepPoint& point, const std::string& fold, const std::map<std::string, double>& metrics,
+                        double seconds, const std::string& error)
+    {
+        file << point.id << "," << fold;
+        for (const std::string& name : paramNames)
+        {
+            file << "," << point.get(name);
+        }
+        for (const std::string& name : metricNames)
+        {
+            auto it = metrics.find(name);
+            file << ",";
+            if (it != metrics.end())
+            {
+                file << it->second;
+            }
+        }
+        file << "," << seconds << "," << error << "\n";
+    };
+
+    for (const SweepPoint& point : points)
+    {
+        std::map<std::string, double> sums;
+        std::map<std::string, size_t> counts;
+        double seconds = 0.0;
+        for (const TrialResult& result : results)
+        {
+            if (result.pointId != point.id)
+            {
+                continue;
+            }
+            writeRow(point, std::to_string(result.fold), result.metrics, result.seconds, result.error);
+            seconds += result.seconds;
+            for (const auto& [name, val] : result.metrics)
+            {
+                sums[name] += val;
+                counts[name] += 1;
+            }
+        }
+        for (auto& [name, sum] : sums)
+        {
+            sum /= static_cast<double>(counts[name]);
+        }
+        writeRow(point, "mean", sums, seconds, "");
+    }
+}
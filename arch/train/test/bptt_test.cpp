@@ -0,0 +1,224 @@
+#include "../headr/bptt.h"
+#include "../headr/optim.h"
+#include "listener_data.h"
+#include <gtest/gtest.h>
+#include <cmath>
+
+class BpttTest : public ::testing::Test{};
+
+namespace
+{
+    struct Sequence
+    {
+        std::vector<double> features;
+        std::vector<double> targets;
+    };
+
+    Sequence makeSequence(size_t steps)
+    {
+        Sequence seq;
+        seq.features = makeFeatures(steps);
+        for (size_t t = 0; t < steps; ++t)
+        {
+            seq.targets.push_back(0.5 + 0.4 * std::sin(0.2 * static_cast<double>(t)));
+        }
+        return seq;
+    }
+}
+
+/**
+ * @brief: Tests for the truncated, checkpointed backward pass
+ */
+TEST_F(BpttTest, Gradients)
+{
+    Listener listener(Listener::numFeatures, {4, 3});
+    ParamBuffer params;
+    listener.registerParams(params);
+    params.bind();
+    Sequence seq = makeSequence(13);
+
+    // Test 1: the forward pass matches the listener's own packed run
+    TruncatedBptt full(listener, params, {64, 1});
+    double loss = full.accumulate(seq.features, seq.targets);
+    ExecContext ctx;
+    std::span<double> preferences = listener.runPacked(ctx, packSequences({seq.features}, Listener::numFeatures));
+    double expected = 0.0;
+    for (size_t t = 0; t < seq.targets.size(); ++t)
+    {
+        expected += 0.5 * std::pow(preferences[t] - seq.targets[t], 2) / static_cast<double>(seq.targets.size());
+    }
+    EXPECT_NEAR(loss, expected, 1e-12) << "Trainer forward differs from the listener";
+
+    // Test 2: analytic gradients match finite differences on every parameter
+    std::vector<double> analytic(params.grads().begin(), params.grads().end());
+    for (size_t p = 0; p < params.size(); ++p)
+    {
+        double saved = params.values()[p];
+        params.values()[p] = saved + 1e-6;
+        double up = full.accumulate(seq.features, seq.targets);
+        params.values()[p] = saved - 1e-6;
+        double down = full.accumulate(seq.features, seq.targets);
+        params.values()[p] = saved;
+        EXPECT_NEAR(analytic[p], (up - down) / 2e-6, 1e-6) << "Gradient mismatch at parameter " << p;
+    }
+
+    // Test 3: checkpointing recomputes the same gradients with fewer stored steps
+    params.zeroGrad();
+    TruncatedBptt checkpointed(listener, params, {64, 4});
+    checkpointed.accumulate(seq.features, seq.targets);
+    for (size_t p = 0; p < params.size(); ++p)
+    {
+        EXPECT_NEAR(params.grads()[p], analytic[p], 1e-12) << "Checkpointing changed gradient " << p;
+    }
+    EXPECT_EQ(checkpointed.getPeakStoredSteps(), 4) << "Stored steps exceed the interval";
+    EXPECT_EQ(checkpointed.getPeakCheckpoints(), 4) << "Checkpoint count mismatch";
+}
+
+/**
+ * @brief: Tests for truncation on long sequences
+ */
+TEST_F(BpttTest, Truncation)
+{
+    Listener listener(Listener::numFeatures, {3});
+    ParamBuffer params;
+    listener.registerParams(params);
+    params.bind();
+    Sequence seq = makeSequence(600);
+
+    // Test 1: memory is bounded by the window, not the sequence length
+    TruncatedBptt trainer(listener, params, {50, 7});
+    double loss = trainer.accumulate(seq.features, seq.targets);
+    EXPECT_GT(loss, 0.0) << "Loss not computed";
+    EXPECT_LE(trainer.getPeakCheckpoints(), 8) << "Checkpoints grew with the sequence";
+    EXPECT_LE(trainer.getPeakStoredSteps(), 7) << "Stored steps grew with the sequence";
+
+    // Test 2: cutting the gradient changes it, but not the loss
+    std::vector<double> truncated(params.grads().begin(), params.grads().end());
+    params.zeroGrad();
+    TruncatedBptt untruncated(listener, params, {600, 25});
+    EXPECT_NEAR(untruncated.accumulate(seq.features, seq.targets), loss, 1e-12) << "Truncation changed the loss";
+    double difference = 0.0;
+    for (size_t p = 0; p < params.size(); ++p)
+    {
+        difference += std::abs(params.grads()[p] - truncated[p]);
+    }
+    EXPECT_GT(difference, 0.0) << "Truncation had no effect";
+
+    // Test 3: bad configs and mismatched inputs are rejected
+    EXPECT_THROW(TruncatedBptt(listener, params, {0, 1}), std::invalid_argument) << "Zero window accepted";
+    EXPECT_THROW(trainer.accumulate(seq.features, std::vector<double>(3)), std::invalid_argument)
+                        << "Mismatched targets accepted";
+}
+
+/**
+ * @brief: Tests for the hidden state hint
+ */
+TEST_F(BpttTest, Hint)
+{
+    Listener listener(Listener::numFeatures, {4, 3});
+    ParamBuffer params;
+    listener.registerParams(params);
+    params.bind();
+    Sequence seq = makeSequence(9);
+    const size_t width = 5;
+    std::vector<double> hidden(seq.targets.size() * width);
+    std::vector<double> projection(width * 3);
+    std::vector<double> projectionGrad(projection.size(), 0.0);
+    for (size_t i = 0; i < hidden.size(); ++i)
+    {
+        hidden[i] = 0.3 * std::sin(0.9 * static_cast<double>(i));
+    }
+    for (size_t i = 0; i < projection.size(); ++i)
+    {
+        projection[i] = 0.5 * std::cos(1.3 * static_cast<double>(i));
+    }
+    HiddenHint hint;
+    hint.targets = hidden;
+    hint.width = width;
+    hint.projection = projection;
+    hint.projectionGrad = projectionGrad;
+    hint.weight = 0.7;
+    TruncatedBptt trainer(listener, params, {4, 2});
+
+    // Test 1: the hint adds to the loss
+    double plain = trainer.accumulate(seq.features, seq.targets);
+    params.zeroGrad();
+    double loss = trainer.accumulate(seq.features, seq.targets, &hint);
+    EXPECT_GT(loss, plain) << "Hint term missing from the loss";
+
+    // Test 2: parameter and projection gradients match finite differences, across the truncation
+    TruncatedBptt whole(listener, params, {64, 2});
+    params.zeroGrad();
+    std::fill(projectionGrad.begin(), projectionGrad.end(), 0.0);
+    whole.accumulate(seq.features, seq.targets, &hint);
+    std::vector<double> analytic(params.grads().begin(), params.grads().end());
+    std::vector<double> projectionAnalytic = projectionGrad;
+    std::vector<double> scratch(projection.size());
+    hint.projectionGrad = scratch;
+    for (size_t p = 0; p < params.size(); ++p)
+    {
+        double saved = params.values()[p];
+        params.values()[p] = saved + 1e-6;
+        double up = whole.accumulate(seq.features, seq.targets, &hint);
+        params.values()[p] = saved - 1e-6;
+        double down = whole.accumulate(seq.features, seq.targets, &hint);
+        params.values()[p] = saved;
+        EXPECT_NEAR(analytic[p], (up - down) / 2e-6, 1e-6) << "Gradient mismatch at parameter " << p;
+    }
+    for (size_t i = 0; i < projection.size(); ++i)
+    {
+        double saved = projection[i];
+        projection[i] = saved + 1e-6;
+        double up = whole.accumulate(seq.features, seq.targets, &hint);
+        projection[i] = saved - 1e-6;
+        double down = whole.accumulate(seq.features, seq.targets, &hint);
+        projection[i] = saved;
+        EXPECT_NEAR(projectionAnalytic[i], (up - down) / 2e-6, 1e-6) << "Projection gradient mismatch at " << i;
+    }
+
+    // Test 3: a hint of the wrong shape is rejected
+    hint.width = 4;
+    EXPECT_THROW(trainer.accumulate(seq.features, seq.targets, &hint), std::invalid_argument)
+                        << "Mismatched hint accepted";
+}
+
+/**
+ * @brief: Tests for listeners wider than the plain features (interval channels)
+ */
+TEST_F(BpttTest, ChannelWidth)
+{
+    const size_t width = 7;
+    Listener listener(static_cast<int>(width), {4});
+    ParamBuffer params;
+    listener.registerParams(params);
+    params.bind();
+    Sequence seq = makeSequence(20);
+    std::vector<double> features = widenFeatures(seq.features, width);
+    TruncatedBptt trainer(listener, params, {8, 2});
+
+    // Test 1: the forward pass matches the listener on 7 features per step
+    double loss = trainer.accumulate(features, seq.targets);
+    ExecContext ctx;
+    std::span<double> preferences = listener.runPacked(ctx, packSequences({features}, width));
+    double expected = 0.0;
+    for (size_t t = 0; t < seq.targets.size(); ++t)
+    {
+        expected += 0.5 * std::pow(preferences[t] - seq.targets[t], 2) / static_cast<double>(seq.targets.size());
+    }
+    EXPECT_NEAR(loss, expected, 1e-12) << "Trainer forward differs from the 7 input listener";
+
+    // Test 2: a few optimizer steps lower the loss
+    Adam optimizer(0.05);
+    for (int epoch = 0; epoch < 30; ++epoch)
+    {
+        params.zeroGrad();
+        trainer.accumulate(features, seq.targets);
+        optimizer.step(params);
+    }
+    params.zeroGrad();
+    EXPECT_LT(trainer.accumulate(features, seq.targets), loss) << "Training did not lower the loss";
+
+    // Test 3: the plain 3 feature layout is rejected instead of read out of bounds
+    EXPECT_THROW(trainer.accumulate(seq.features, seq.targets), std::invalid_argument)
+                        << "3 wide features accepted by a 7 input listener";
+}
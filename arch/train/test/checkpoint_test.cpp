@@ -0,0 +1,175 @@
+#include "../headr/checkpoint.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+class CheckpointTest : public ::testing::Test{};
+
+namespace
+{
+    void denseGrad(ParamBuffer& buffer, size_t step)
+    {
+        for (size_t i = 0; i < buffer.size(); ++i)
+        {
+            buffer.grads()[i] = std::sin(0.3 * static_cast<double>(i) + static_cast<double>(step));
+        }
+    }
+
+    std::string freshDirectory(const std::string& name)
+    {
+        std::string directory = ::testing::TempDir() + name;
+        std::filesystem::remove_all(directory);
+        return directory;
+    }
+
+    std::string file(const std::string& directory, const std::string& name)
+    {
+        return (std::filesystem::path(directory) / name).string();
+    }
+}
+
+/**
+ * @brief: Tests for incremental snapshots and resuming from them
+ */
+TEST_F(CheckpointTest, Resume)
+{
+    std::string directory = freshDirectory("checkpoint_resume");
+    ParamVec weights(40, 0.5);
+    ParamBuffer buffer;
+    buffer.add(weights);
+    buffer.bind();
+    Adam adam(0.01);
+    std::mt19937 gen(3);
+    TrainingState state;
+    CheckpointConfig config;
+    config.chunkSize = 8;
+    config.fullEvery = 3;
+    config.waitForWriter = true;
+    std::vector<double> beforeSparse;
+    {
+        // Test 1: a full snapshot every third file, deltas in between, older chains are removed
+        Checkpointer checkpointer(directory, buffer, &adam, config);
+        for (size_t step = 1; step <= 5; ++step)
+        {
+            denseGrad(buffer, step);
+            adam.step(buffer);
+            gen();
+            state.step = step;
+            state.loader = {step / 3, step % 3};
+            state.rng = saveRng(gen);
+            EXPECT_TRUE(checkpointer.capture(state)) << "Capture skipped while waiting for the writer";
+        }
+        checkpointer.flush();
+        CheckpointStats stats = checkpointer.stats();
+        EXPECT_EQ(stats.captures, 5) << "Capture count mismatch";
+        EXPECT_EQ(stats.fullWrites, 2) << "Full snapshot count mismatch";
+        EXPECT_EQ(stats.deltaWrites, 3) << "Delta count mismatch";
+        EXPECT_EQ(stats.chunksWritten, 5 * 15) << "Dense steps change every chunk";
+        EXPECT_FALSE(std::filesystem::exists(file(directory, "ckpt-00000002.bin"))) << "Old chain kept";
+        EXPECT_TRUE(std::filesystem::exists(file(directory, "ckpt-00000004.bin"))) << "Newest delta missing";
+
+        // Test 2: a sparse change is written as the one chunk holding it
+        beforeSparse.assign(weights.begin(), weights.end());
+        weights[5] += 1.0;
+        state.step = 6;
+        checkpointer.capture(state);
+        checkpointer.flush();
+        EXPECT_EQ(checkpointer.stats().chunksWritten, 5 * 15 + 1) << "Unchanged chunks written";
+    }
+
+    // Test 3: restore gives back the parameters, the optimizer, the loop position and the RNG
+    ParamVec restored(40, 0.0);
+    ParamBuffer other;
+    other.add(restored);
+    other.bind();
+    Adam resumed(0.01);
+    TrainingState back = Checkpointer::restore(directory, other, &resumed);
+    EXPECT_EQ(back.step, 6) << "Step mismatch";
+    EXPECT_EQ(back.loader.epoch, 1) << "Loader epoch mismatch";
+    EXPECT_EQ(back.loader.batches, 2) << "Loader batch mismatch";
+    EXPECT_EQ(resumed.getStepCount(), adam.getStepCount()) << "Optimizer step count mismatch";
+    for (size_t i = 0; i < 40; ++i)
+    {
+        EXPECT_EQ(restored[i], weights[i]) << "Parameter mismatch at " << i;
+        EXPECT_EQ(resumed.firstMoment()[i], adam.firstMoment()[i]) << "First moment mismatch at " << i;
+        EXPECT_EQ(resumed.secondMoment()[i], adam.secondMoment()[i]) << "Second moment mismatch at " << i;
+    }
+    std::mt19937 regen;
+    restoreRng(back.rng, regen);
+    EXPECT_EQ(regen(), gen()) << "RNG not restored";
+    denseGrad(buffer, 7);
+    denseGrad(other, 7);
+    adam.step(buffer);
+    resumed.step(other);
+    EXPECT_EQ(restored[17], weights[17]) << "Resumed run diverged";
+
+    // Test 4: a torn newest file falls back to the snapshot before it
+    {
+        std::ofstream torn(file(directory, "ckpt-00000005.bin"), std::ios::binary | std::ios::trunc);
+        torn << "partial";
+    }
+    back = Checkpointer::restore(directory, other, &resumed);
+    EXPECT_EQ(back.step, 5) << "Torn delta used";
+    EXPECT_EQ(restored[5], beforeSparse[5]) << "Torn delta applied";
+
+    // Test 5: another layout and an empty directory are rejected
+    ParamVec small(10, 0.0);
+    ParamBuffer smaller;
+    smaller.add(small);
+    smaller.bind();
+    EXPECT_THROW(Checkpointer::restore(directory, smaller), std::invalid_argument) << "Mismatched layout restored";
+    EXPECT_THROW(Checkpointer::restore(freshDirectory("checkpoint_empty"), other), std::invalid_argument)
+                        << "Restored from nothing";
+
+    // Test 6: a new checkpointer carries on the numbering with a full snapshot
+    {
+        Checkpointer again(directory, other, &resumed, config);
+        again.capture(back);
+        again.flush();
+        EXPECT_EQ(again.stats().fullWrites, 1) << "Resumed run did not start with a full snapshot";
+    }
+    EXPECT_TRUE(std::filesystem::exists(file(directory, "ckpt-00000006.bin"))) << "Numbering restarted";
+    EXPECT_FALSE(std::filesystem::exists(file(directory, "ckpt-00000003.bin"))) << "Superseded chain kept";
+    std::filesystem::remove_all(directory);
+}
+
+/**
+ * @brief: Tests for captures that never wait on the writer
+ */
+TEST_F(CheckpointTest, NonBlocking)
+{
+    // Test 1: a busy writer makes capture skip, the newest accepted capture is what restore sees
+    std::string directory = freshDirectory("checkpoint_skip");
+    ParamVec weights(5000, 0.0);
+    ParamBuffer buffer;
+    buffer.add(weights);
+    buffer.bind();
+    SgdMomentum sgd(0.1);
+    size_t accepted = 0;
+    {
+        Checkpointer checkpointer(directory, buffer, &sgd);
+        for (size_t step = 1; step <= 50; ++step)
+        {
+            denseGrad(buffer, step);
+            sgd.step(buffer);
+            TrainingState state;
+            state.step = step;
+            if (checkpointer.capture(state))
+            {
+                accepted = step;
+            }
+        }
+        checkpointer.flush();
+        CheckpointStats stats = checkpointer.stats();
+        EXPECT_EQ(stats.captures + stats.skipped, 50) << "Captures lost";
+        EXPECT_GE(stats.captures, 1) << "Nothing captured";
+    }
+    ParamVec restored(5000, 0.0);
+    ParamBuffer other;
+    other.add(restored);
+    other.bind();
+    EXPECT_EQ(Checkpointer::restore(directory, other).step, accepted) << "Restored an older capture";
+    std::filesystem::remove_all(directory);
+}
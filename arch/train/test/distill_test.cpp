@@ -0,0 +1,85 @@
+#include "../headr/distill.h"
+#include "listener_data.h"
+#include <gtest/gtest.h>
+#include <cmath>
+
+class DistillTest : public ::testing::Test{};
+
+/**
+ * @brief: Tests for distilling a wide listener into a narrow one
+ */
+TEST_F(DistillTest, Student)
+{
+    Listener teacher(Listener::numFeatures, {48, 48});
+    Listener student(Listener::numFeatures, {6});
+    ParamBuffer params;
+    student.registerParams(params);
+    params.bind();
+    Adam optimizer(0.01);
+    Distiller distiller(teacher, student, params, optimizer);
+    std::vector<std::vector<double>> train = makeSequences(24, 12);
+    std::vector<std::vector<double>> held = makeSequences(8, 30);
+
+    // Test 1: training brings the student's preferences towards the teacher's
+    DistillReport before = distiller.evaluate(held);
+    double first = distiller.train(train);
+    double last = first;
+    for (int epoch = 0; epoch < 40; ++epoch)
+    {
+        last = distiller.train(train);
+    }
+    DistillReport after = distiller.evaluate(held);
+    EXPECT_LT(last, first) << "Distillation loss did not fall";
+    EXPECT_LT(after.meanAbsDiff, before.meanAbsDiff) << "Student did not move towards the teacher";
+    EXPECT_GE(after.agreement, 0.0) << "Agreement below zero";
+    EXPECT_LE(after.agreement, 1.0) << "Agreement above one";
+
+    // Test 2: the student is a fraction of the teacher's size and runs faster per step
+    EXPECT_EQ(after.studentParams, params.size()) << "Student size does not match its buffer";
+    EXPECT_GT(after.teacherParams, 20 * after.studentParams) << "Teacher size mismatch";
+    EXPECT_GT(after.speedup, 1.0) << "Student not faster than the teacher";
+    EXPECT_GT(after.teacherSecondsPerStep, after.studentSecondsPerStep) << "Per step timing inconsistent";
+
+    // Test 3: bad settings and mismatched inputs are rejected
+    DistillConfig bad;
+    bad.temperature = 0.0;
+    EXPECT_THROW(Distiller(teacher, student, params, optimizer, bad), std::invalid_argument)
+        << "Zero temperature accepted";
+    Listener wide(Listener::numFeatures + 1, {4});
+    EXPECT_THROW(Distiller(wide, student, params, optimizer), std::invalid_argument) << "Input mismatch accepted";
+}
+
+/**
+ * @brief: Tests for distilling listeners that take the interval channels
+ */
+TEST_F(DistillTest, ChannelWidth)
+{
+    const size_t width = 7;
+    Listener teacher(static_cast<int>(width), {12});
+    Listener student(static_cast<int>(width), {4});
+    ParamBuffer params;
+    student.registerParams(params);
+    params.bind();
+    Adam optimizer(0.01);
+    Distiller distiller(teacher, student, params, optimizer);
+    std::vector<std::vector<double>> train;
+    for (const std::vector<double>& plain : makeSequences(8, 10))
+    {
+        train.push_back(widenFeatures(plain, width));
+    }
+
+    // Test 1: 7 features per step train and evaluate like the plain layout
+    double first = distiller.train(train);
+    double last = first;
+    for (int epoch = 0; epoch < 20; ++epoch)
+    {
+        last = distiller.train(train);
+    }
+    EXPECT_LT(last, first) << "Distillation loss did not fall on 7 inputs";
+    DistillReport report = distiller.evaluate(train);
+    EXPECT_GE(report.agreement, 0.0) << "Agreement below zero";
+    EXPECT_LE(report.agreement, 1.0) << "Agreement above one";
+
+    // Test 2: the plain 3 feature layout is rejected
+    EXPECT_THROW(distiller.train(makeSequences(1, 10)), std::invalid_argument) << "3 wide sequence accepted";
+}
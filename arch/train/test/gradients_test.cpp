@@ -0,0 +1,88 @@
+#include "../headr/gradients.h"
+#include "replica_data.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <numeric>
+
+class GradientsTest : public ::testing::Test{};
+
+namespace
+{
+    struct Reduced
+    {
+        std::vector<double> grads;
+        double loss = 0.0;
+    };
+
+    Reduced reduce(ParamBuffer& shared, ThreadPool* pool, const Dataset& data, Classifier& classifier,
+                   std::span<const size_t> batch)
+    {
+        ParallelGradients gradients(shared, pool, data.size(), [&](std::span<const size_t> shard, bool copyShard)
+        {
+            return std::make_unique<ClassifierReplica>(classifier, data, shard, copyShard);
+        });
+        Reduced out;
+        out.loss = gradients.accumulate(batch);
+        out.grads.assign(shared.grads().begin(), shared.grads().end());
+        return out;
+    }
+}
+
+/**
+ * @brief: Tests for bit identical batch gradients on any number of threads
+ */
+TEST_F(GradientsTest, Deterministic)
+{
+    const size_t window = 6;
+    Dataset data = makeDataset(64, window, 9);
+    Classifier classifier(static_cast<int>(window), {16, 8}, 1);
+    ParamBuffer shared;
+    classifier.registerParams(shared);
+    shared.bind();
+    std::vector<size_t> batch(37);
+    std::iota(batch.begin(), batch.end(), 11);
+
+    // Test 1: the fast mode matches a plain serial sum up to rounding
+    ThreadPool three(3);
+    Reduced fast = reduce(shared, &three, data, classifier, batch);
+    ClassifierReplica single(classifier, data, std::vector<size_t>(batch.begin(), batch.end()), true);
+    std::copy(shared.values().begin(), shared.values().end(), single.params().values().begin());
+    single.params().zeroGrad();
+    double loss = 0.0;
+    for (size_t s = 0; s < batch.size(); ++s)
+    {
+        loss += single.accumulate(s);
+    }
+    EXPECT_NEAR(fast.loss, loss, 1e-12) << "Fast loss mismatch";
+    for (size_t p = 0; p < shared.size(); ++p)
+    {
+        EXPECT_NEAR(fast.grads[p], single.params().grads()[p], 1e-12) << "Fast gradient mismatch at " << p;
+    }
+
+    // Test 2: the deterministic mode gives the same bits serially and on 2, 4 and 8 threads
+    setReductionMode(ReductionMode::Deterministic);
+    Reduced serial = reduce(shared, nullptr, data, classifier, batch);
+    for (size_t workers : {1, 3, 7})
+    {
+        ThreadPool pool(workers);
+        Reduced parallel = reduce(shared, &pool, data, classifier, batch);
+        EXPECT_EQ(parallel.loss, serial.loss) << "Loss changed on " << workers + 1 << " threads";
+        EXPECT_EQ(parallel.grads, serial.grads) << "Gradients changed on " << workers + 1 << " threads";
+    }
+    EXPECT_NEAR(serial.loss, loss, 1e-12) << "Deterministic loss mismatch";
+
+    // Test 3: the classifier forward runs the fixed order dot and agrees with the fast one
+    ExecContext ctx;
+    std::span<const double> row = data.row(5);
+    double fixed = classifier.predict(ctx, row.first(window), row.subspan(window));
+    setReductionMode(ReductionMode::Fast);
+    EXPECT_NEAR(classifier.predict(ctx, row.first(window), row.subspan(window)), fixed, 1e-12) << "Fixed order forward mismatch";
+
+    // Test 4: out of range samples are rejected
+    std::vector<size_t> wrong = {64};
+    ParallelGradients gradients(shared, nullptr, data.size(), [&](std::span<const size_t> shard, bool copyShard)
+    {
+        return std::make_unique<ClassifierReplica>(classifier, data, shard, copyShard);
+    });
+    EXPECT_THROW(gradients.accumulate(wrong), std::invalid_argument) << "Out of range sample accepted";
+}
@@ -0,0 +1,195 @@
+#include "../headr/hogwild.h"
+#include "replica_data.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <numeric>
+
+class HogwildTest : public ::testing::Test{};
+
+namespace
+{
+    // fixed start instead of the random node initialisation, so the loss curves are repeatable
+    void initialise(ParamBuffer& params)
+    {
+        std::span<double> values = params.values();
+        for (size_t p = 0; p < values.size(); ++p)
+        {
+            values[p] = 0.4 * std::sin(1.7 * static_cast<double>(p) + 0.3);
+        }
+    }
+}
+
+/**
+ * @brief: Tests for the classifier replica's backward pass
+ */
+TEST_F(HogwildTest, ClassifierGradients)
+{
+    Classifier classifier(6, {5, 3}, 1);
+    ParamBuffer shared;
+    classifier.registerParams(shared);
+    shared.bind();
+    Dataset data = makeDataset(4, 6, 5);
+    std::vector<size_t> shard = {3};
+    ClassifierReplica replica(classifier, data, shard, true);
+    ASSERT_EQ(replica.params().size(), shared.size()) << "Replica layout differs from the model";
+    std::copy(shared.values().begin(), shared.values().end(), replica.params().values().begin());
+
+    // Test 1: the replica's forward is the classifier's predict
+    replica.params().zeroGrad();
+    double loss = replica.accumulate(0);
+    ExecContext ctx;
+    std::span<const double> row = data.row(3);
+    double prediction = classifier.predict(ctx, row.first(6), row.subspan(6));
+    EXPECT_NEAR(loss, 0.5 * std::pow(prediction - data.labels[3], 2), 1e-12) << "Replica loss mismatch";
+
+    // Test 2: analytic gradients match finite differences on every parameter
+    std::vector<double> analytic(replica.params().grads().begin(), replica.params().grads().end());
+    std::span<double> values = replica.params().values();
+    for (size_t p = 0; p < values.size(); ++p)
+    {
+        double saved = values[p];
+        values[p] = saved + 1e-6;
+        double up = replica.accumulate(0);
+        values[p] = saved - 1e-6;
+        double down = replica.accumulate(0);
+        values[p] = saved;
+        EXPECT_NEAR(analytic[p], (up - down) / 2e-6, 1e-7) << "Gradient mismatch at parameter " << p;
+    }
+}
+
+/**
+ * @brief: Tests for lock free training of the shared buffer
+ */
+TEST_F(HogwildTest, Train)
+{
+    const size_t window = 6;
+    Dataset data = makeDataset(64, window, 5);
+    Classifier classifier(static_cast<int>(window), {8}, 1);
+    ParamBuffer shared;
+    classifier.registerParams(shared);
+    shared.bind();
+    initialise(shared);
+    auto factory = [&](std::span<const size_t> shard, bool copyShard)
+    {
+        return std::make_unique<ClassifierReplica>(classifier, data, shard, copyShard);
+    };
+
+    // Test 1: every worker trains its shard, the shared loss goes down
+    HogwildConfig config;
+    config.threads = 4;
+    config.epochs = 40;
+    config.learningRate = 0.1;
+    HogwildStats stats = HogwildTrainer(shared, config).train(data.size(), factory);
+    EXPECT_EQ(stats.threads, 4) << "Worker count mismatch";
+    EXPECT_EQ(stats.samples, config.epochs * data.size()) << "Samples skipped";
+    EXPECT_GT(stats.writes, 0) << "No shared writes";
+    EXPECT_LE(stats.writes, stats.samples * shared.size()) << "More writes than parameters touched";
+    ASSERT_EQ(stats.epochLoss.size(), config.epochs) << "Loss curve length mismatch";
+    EXPECT_LT(stats.epochLoss.back(), 0.8 * stats.epochLoss.front()) << "Hogwild did not learn";
+
+    // Test 2: the model reads the trained shared buffer, a replica refreshed from it gives the same losses
+    ExecContext ctx;
+    std::vector<size_t> all(data.size());
+    std::iota(all.begin(), all.end(), 0);
+    ClassifierReplica check(classifier, data, all, false);
+    std::copy(shared.values().begin(), shared.values().end(), check.params().values().begin());
+    for (size_t r = 0; r < data.size(); ++r)
+    {
+        std::span<const double> row = data.row(r);
+        double prediction = classifier.predict(ctx, row.first(window), row.subspan(window));
+        EXPECT_NEAR(check.accumulate(r), 0.5 * std::pow(prediction - data.labels[r], 2), 1e-12)
+            << "Model did not see the updates at row " << r;
+    }
+
+    // Test 3: pinned workers on node local contiguous shards
+    config.threads = 2;
+    config.epochs = 5;
+    config.pinThreads = true;
+    config.numaShards = true;
+    HogwildStats pinned = HogwildTrainer(shared, config).train(data.size(), factory);
+    EXPECT_EQ(pinned.samples, config.epochs * data.size()) << "Sharded samples skipped";
+    EXPECT_LE(pinned.pinnedThreads, pinned.threads) << "Pinned count out of range";
+
+    // Test 4: workers report to a metrics stream every 8th sample
+    std::string path = ::testing::TempDir() + "hogwild_metrics.jsonl";
+    {
+        MetricsConfig metricsConfig;
+        metricsConfig.every = 8;
+        MetricsStream stream(path, metricsConfig);
+        config.metrics = &stream;
+        HogwildTrainer(shared, config).train(data.size(), factory);
+        config.metrics = nullptr;
+        stream.flush();
+        // 2 workers, 160 samples each, every 8th sampled, 3 records per sample
+        EXPECT_EQ(stream.stats().written, 2 * 20 * 3) << "Worker metrics count mismatch";
+    }
+    std::remove(path.c_str());
+
+    // Test 5: one worker sees its own writes, so refreshing less often trains the same weights with fewer reads
+    config.threads = 1;
+    config.pinThreads = false;
+    config.numaShards = false;
+    initialise(shared);
+    HogwildStats every = HogwildTrainer(shared, config).train(data.size(), factory);
+    std::vector<double> everyValues(shared.values().begin(), shared.values().end());
+    initialise(shared);
+    config.refreshInterval = 8;
+    HogwildStats sparse = HogwildTrainer(shared, config).train(data.size(), factory);
+    EXPECT_EQ(every.reads, every.samples * shared.size()) << "Full refresh count mismatch";
+    EXPECT_EQ(sparse.reads, every.reads / 8) << "Refresh interval not applied";
+    for (size_t p = 0; p < shared.size(); ++p)
+    {
+        EXPECT_EQ(shared.values()[p], everyValues[p]) << "Refresh interval changed a single worker at " << p;
+    }
+    config.refreshInterval = 0;
+    EXPECT_THROW(HogwildTrainer(shared, config), std::invalid_argument) << "Zero refresh interval accepted";
+    config.refreshInterval = 1;
+
+    // Test 6: a replica with another layout and an unbound buffer are rejected
+    Classifier other(static_cast<int>(window), {3}, 1);
+    auto wrong = [&](std::span<const size_t> shard, bool copyShard)
+    {
+        return std::make_unique<ClassifierReplica>(other, data, shard, copyShard);
+    };
+    EXPECT_THROW(HogwildTrainer(shared, config).train(data.size(), wrong), std::invalid_argument)
+                        << "Mismatched replica accepted";
+    ParamBuffer unbound;
+    EXPECT_THROW(HogwildTrainer(unbound, config), std::logic_error) << "Unbound buffer accepted";
+}
+
+/**
+ * @brief: Tests for lock free listener training
+ */
+TEST_F(HogwildTest, Listener)
+{
+    // Test 1: the stacked LSTM gate vectors train through the same shared buffer
+    Listener listener(Listener::numFeatures, {4});
+    ParamBuffer shared;
+    listener.registerParams(shared);
+    shared.bind();
+    initialise(shared);
+    std::vector<std::vector<double>> features;
+    std::vector<std::vector<double>> targets;
+    for (size_t s = 0; s < 9; ++s)
+    {
+        features.emplace_back();
+        targets.emplace_back();
+        for (size_t t = 0; t < 12; ++t)
+        {
+            double phase = 0.3 * static_cast<double>(t + s);
+            features.back().insert(features.back().end(), {std::sin(phase), 0.1 * std::cos(phase), s % 3 ? 0.1 : 0.9});
+            targets.back().push_back(s % 3 ? 0.3 : 0.8);
+        }
+    }
+    HogwildConfig config;
+    config.threads = 2;
+    config.epochs = 100;
+    config.learningRate = 0.5;
+    HogwildStats stats = HogwildTrainer(shared, config).train(features.size(),
+        [&](std::span<const size_t> shard, bool copyShard)
+        {
+            return std::make_unique<ListenerReplica>(listener, features, targets, shard, copyShard, BpttConfig{8, 2});
+        });
+    EXPECT_LT(stats.epochLoss.back(), 0.5 * stats.epochLoss.front()) << "Listener did not learn";
+}
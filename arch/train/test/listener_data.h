@@ -0,0 +1,74 @@
+#ifndef LISTENER_DATA_H
+#define LISTENER_DATA_H
+
+#include "../../model/headr/model.h"
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+/**
+ *
+ * @brief: listener features of a slowly wandering melody shared by the listener training tests, frequency,
+ *          interval and consonance per timestep
+ *
+ * @param: steps -> type: size_t, timesteps to generate
+ * @param: offset -> type: size_t, shifts the phase and the consonant beats, one per sequence of a set
+ * @return: std::vector<double> -> Listener::numFeatures values per timestep
+ *
+ */
+inline std::vector<double> makeFeatures(size_t steps, size_t offset = 0)
+{
+    std::vector<double> features;
+    features.reserve(steps * Listener::numFeatures);
+    for (size_t t = 0; t < steps; ++t)
+    {
+        double phase = 0.4 * static_cast<double>(t) + 0.7 * static_cast<double>(offset);
+        features.push_back(std::sin(phase));
+        features.push_back(0.2 * std::cos(1.3 * phase));
+        features.push_back((t + offset) % 3 == 0 ? 0.9 : 0.2);
+    }
+    return features;
+}
+
+/**
+ *
+ * @brief: count sequences of makeFeatures, sequence s offset by s
+ *
+ */
+inline std::vector<std::vector<double>> makeSequences(size_t count, size_t steps)
+{
+    std::vector<std::vector<double>> sequences;
+    for (size_t s = 0; s < count; ++s)
+    {
+        sequences.push_back(makeFeatures(steps, s));
+    }
+    return sequences;
+}
+
+/**
+ *
+ * @brief: widens Listener::numFeatures values per timestep to width, the extra values stand in for the
+ *          interval channels
+ *
+ * @param: features -> type: const std::vector<double>&, Listener::numFeatures values per timestep
+ * @param: width -> type: size_t, values per timestep of the result
+ * @return: std::vector<double> -> width values per timestep
+ *
+ */
+inline std::vector<double> widenFeatures(const std::vector<double>& features, size_t width)
+{
+    size_t plain = static_cast<size_t>(Listener::numFeatures);
+    std::vector<double> wide;
+    wide.reserve(features.size() / plain * width);
+    for (size_t t = 0; t < features.size() / plain; ++t)
+    {
+        wide.insert(wide.end(), features.begin() + t * plain, features.begin() + (t + 1) * plain);
+        for (size_t c = plain; c < width; ++c)
+        {
+            wide.push_back(0.25 * std::cos(static_cast<double>(t + c)));
+        }
+    }
+    return wide;
+}
+
+#endif
@@ -0,0 +1,139 @@
+#include "../headr/metrics.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+class MetricsTest : public ::testing::Test{};
+
+namespace
+{
+    std::vector<std::string> readLines(const std::string& path)
+    {
+        std::ifstream file(path);
+        std::vector<std::string> lines;
+        std::string line;
+        while (std::getline(file, line))
+        {
+            lines.push_back(line);
+        }
+        return lines;
+    }
+
+    size_t countContaining(const std::vector<std::string>& lines, const std::string& text)
+    {
+        size_t count = 0;
+        for (const std::string& line : lines)
+        {
+            count += line.find(text) != std::string::npos ? 1 : 0;
+        }
+        return count;
+    }
+}
+
+/**
+ * @brief: Tests for many threads pushing into one stream
+ */
+TEST_F(MetricsTest, Producers)
+{
+    // Test 1: every record of every thread reaches the file once, one JSON object per line
+    std::string path = ::testing::TempDir() + "metrics_test.jsonl";
+    MetricsConfig config;
+    config.capacity = 1 << 14;
+    {
+        MetricsStream stream(path, config);
+        std::vector<std::thread> threads;
+        for (uint32_t t = 0; t < 4; ++t)
+        {
+            threads.emplace_back([&stream, t]
+            {
+                for (size_t step = 0; step < 1000; ++step)
+                {
+                    stream.record(Metric::Loss, step, 1.0 / static_cast<double>(step + 1), t);
+                }
+            });
+        }
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+        stream.flush();
+        MetricsStats stats = stream.stats();
+        EXPECT_EQ(stats.pushed, 4000) << "Records lost on push";
+        EXPECT_EQ(stats.dropped, 0) << "Records dropped on a large ring";
+        EXPECT_EQ(stats.written, 4000) << "Flush returned before the writer caught up";
+    }
+    std::vector<std::string> lines = readLines(path);
+    ASSERT_EQ(lines.size(), 4000) << "Line count mismatch";
+    for (uint32_t t = 0; t < 4; ++t)
+    {
+        EXPECT_EQ(countContaining(lines, "\"source\":" + std::to_string(t) + ","), 1000) << "Source " << t << " lost lines";
+    }
+    EXPECT_EQ(countContaining(lines, "\"step\":999,"), 4) << "Last step missing";
+    EXPECT_EQ(lines.front().front(), '{') << "Not a JSON object";
+    EXPECT_EQ(lines.front().back(), '}') << "JSON object not closed";
+
+    // Test 2: a full ring drops records instead of blocking, the writer takes what fit
+    config.capacity = 8;
+    config.flushInterval = std::chrono::milliseconds(10000);
+    {
+        MetricsStream stream(path, config);
+        for (size_t step = 0; step < 100; ++step)
+        {
+            stream.record(Metric::GradNorm, step, 0.5);
+        }
+        stream.flush();
+        MetricsStats stats = stream.stats();
+        EXPECT_EQ(stats.pushed, 8) << "Ring took more than its capacity";
+        EXPECT_EQ(stats.dropped, 92) << "Drop count mismatch";
+        EXPECT_EQ(stats.written, 8) << "Queued records not written";
+        EXPECT_TRUE(stream.record(Metric::GradNorm, 100, 0.5)) << "Drained ring still full";
+    }
+    EXPECT_EQ(readLines(path).size(), 9) << "Records lost at shutdown";
+    std::remove(path.c_str());
+}
+
+/**
+ * @brief: Tests for sampling, filtering and the CSV output
+ */
+TEST_F(MetricsTest, SamplingAndCsv)
+{
+    // Test 1: only every 10th step and only the selected metrics are kept
+    std::string path = ::testing::TempDir() + "metrics_test.csv";
+    MetricsConfig config;
+    config.every = 10;
+    config.metrics = metricBit(Metric::Loss) | metricBit(Metric::Activation);
+    config.format = MetricsFormat::Csv;
+    {
+        MetricsStream stream(path, config);
+        EXPECT_TRUE(stream.wants(Metric::Loss, 20)) << "Sampled step rejected";
+        EXPECT_FALSE(stream.wants(Metric::Loss, 21)) << "Unsampled step accepted";
+        EXPECT_FALSE(stream.wants(Metric::Accuracy, 20)) << "Masked metric accepted";
+        for (size_t step = 0; step < 50; ++step)
+        {
+            stream.record(Metric::Loss, step, 0.25);
+            stream.record(Metric::Accuracy, step, 0.75);
+        }
+
+        // Test 2: activation records carry the layer statistics
+        std::vector<double> outputs = {-1.0, 0.0, 1.0, 2.0};
+        EXPECT_TRUE(stream.activations(50, 2, outputs)) << "Activation record rejected";
+        EXPECT_FALSE(stream.activations(51, 2, outputs)) << "Unsampled activation accepted";
+        EXPECT_EQ(stream.stats().pushed, 6) << "Sampled record count mismatch";
+    }
+    std::vector<std::string> lines = readLines(path);
+    ASSERT_EQ(lines.size(), 7) << "Header plus records expected";
+    EXPECT_EQ(lines[0], "seconds,step,source,metric,layer,value,stddev,min,max") << "CSV header mismatch";
+    EXPECT_NE(lines[1].find(",0,0,loss,-1,0.25,0,0,0"), std::string::npos) << "Loss row mismatch: " << lines[1];
+    EXPECT_NE(lines[6].find(",50,0,activation,2,0.5,1.118033988749895,-1,2"), std::string::npos)
+                        << "Activation row mismatch: " << lines[6];
+    EXPECT_EQ(countContaining(lines, "accuracy"), 0) << "Masked metric written";
+    std::remove(path.c_str());
+
+    // Test 3: bad settings are rejected
+    config.every = 0;
+    EXPECT_THROW(MetricsStream(path, config), std::invalid_argument) << "Zero sampling interval accepted";
+    EXPECT_NEAR(gradientNorm(std::vector<double>{3.0, 4.0}), 5.0, 1e-12) << "Gradient norm mismatch";
+}
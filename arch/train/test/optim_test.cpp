@@ -0,0 +1,86 @@
+#include "../headr/optim.h"
+#include <gtest/gtest.h>
+#include <cmath>
+
+class OptimTest : public ::testing::Test{};
+
+namespace
+{
+    // gradient of 0.5 * |p - target|^2
+    void quadraticGrad(ParamBuffer& buffer, double target)
+    {
+        for (size_t i = 0; i < buffer.size(); ++i)
+        {
+            buffer.grads()[i] = buffer.values()[i] - target;
+        }
+    }
+}
+
+/**
+ * @brief: Tests for the SGD momentum optimizer
+ */
+TEST_F(OptimTest, SgdMomentum)
+{
+    // Test 1: first step is plain SGD
+    ParamVec weights(1000, 1.0);
+    ParamBuffer buffer;
+    buffer.add(weights);
+    buffer.bind();
+    SgdMomentum sgd(0.1, 0.9);
+    quadraticGrad(buffer, 0.0);
+    sgd.step(buffer);
+    EXPECT_DOUBLE_EQ(weights[999], 0.9) << "SGD step mismatch";
+    EXPECT_DOUBLE_EQ(sgd.velocity()[0], 1.0) << "Velocity mismatch";
+
+    // Test 2: converges on a quadratic across block boundaries
+    for (int i = 0; i < 200; ++i)
+    {
+        quadraticGrad(buffer, 2.0);
+        sgd.step(buffer);
+    }
+    EXPECT_NEAR(weights[0], 2.0, 1e-3) << "SGD did not converge";
+    EXPECT_NEAR(weights[999], 2.0, 1e-3) << "Tail block not updated";
+    EXPECT_EQ(sgd.getStepCount(), 201) << "Step count mismatch";
+
+    // Test 3: unbound buffers are rejected
+    ParamBuffer unbound;
+    EXPECT_THROW(sgd.step(unbound), std::logic_error) << "Stepped an unbound buffer";
+}
+
+/**
+ * @brief: Tests for Adam and AdamW
+ */
+TEST_F(OptimTest, Adam)
+{
+    // Test 1: the bias corrected first step moves every parameter by lr
+    ParamVec weights = {1.0, -3.0, 0.5};
+    ParamScalar bias = 2.0;
+    ParamBuffer buffer;
+    buffer.add(weights);
+    buffer.add(bias);
+    buffer.bind();
+    Adam adam(0.01);
+    quadraticGrad(buffer, 0.0);
+    adam.step(buffer);
+    EXPECT_NEAR(weights[0], 0.99, 1e-6) << "Adam first step mismatch";
+    EXPECT_NEAR(weights[1], -2.99, 1e-6) << "Adam first step sign mismatch";
+    EXPECT_NEAR(static_cast<double>(bias), 1.99, 1e-6) << "Scalar not stepped";
+    EXPECT_NEAR(adam.firstMoment()[0], 0.1, 1e-12) << "First moment mismatch";
+
+    // Test 2: AdamW shrinks parameters with zero gradient
+    ParamVec decayed(16, 1.0);
+    ParamBuffer decayBuffer;
+    decayBuffer.add(decayed);
+    decayBuffer.bind();
+    AdamW adamw(0.1, 0.5);
+    adamw.step(decayBuffer);
+    EXPECT_DOUBLE_EQ(decayed[7], 0.95) << "Decoupled decay mismatch";
+
+    // Test 3: converges on a quadratic
+    for (int i = 0; i < 2000; ++i)
+    {
+        quadraticGrad(buffer, -1.0);
+        adam.step(buffer);
+    }
+    EXPECT_NEAR(weights[2], -1.0, 1e-2) << "Adam did not converge";
+}
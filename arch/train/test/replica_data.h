@@ -0,0 +1,42 @@
+#ifndef REPLICA_DATA_H
+#define REPLICA_DATA_H
+
+#include "../../data/headr/dataset.h"
+#include "../../data/headr/generator.h"
+#include "../../feature/headr/interval.h"
+#include <cstddef>
+#include <vector>
+
+/**
+ *
+ * @brief: classifier rows shared by the replica tests, classical openings labelled consonant, jazz ones
+ *          dissonant, the interval entropy as the one channel
+ *
+ * @param: rows -> type: size_t, rows to generate, alternating classical and jazz
+ * @param: window -> type: size_t, frequencies per row
+ * @param: seed -> type: unsigned, generator seed
+ * @return: Dataset -> window frequencies and the entropy per row
+ *
+ */
+inline Dataset makeDataset(size_t rows, size_t window, unsigned seed)
+{
+    MusicDataGenerator generator(seed);
+    Dataset data;
+    data.numFeatures = window + 1;
+    for (size_t r = 0; r < rows; ++r)
+    {
+        bool classical = r % 2 == 0;
+        std::vector<double> freqs = classical ? generator.classical(window).first : generator.jazz(window).first;
+        IntervalTracker tracker;
+        for (double freq : freqs)
+        {
+            tracker.push(freq);
+        }
+        data.features.insert(data.features.end(), freqs.begin(), freqs.end());
+        data.features.push_back(tracker.normalizedEntropy());
+        data.labels.push_back(classical ? 1.0 : 0.0);
+    }
+    return data;
+}
+
+#endif
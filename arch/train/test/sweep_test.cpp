@@ -0,0 +1,104 @@
+#include "../headr/sweep.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <set>
+
+class SweepTest : public ::testing::Test{};
+
+/**
+ * @brief: Tests for expanding a sweep spec
+ */
+TEST_F(SweepTest, Expand)
+{
+    // Test 1: plain grid is the cartesian product
+    SweepSpec spec;
+    spec.grid["width"] = {4, 8, 16};
+    spec.grid["depth"] = {1, 2};
+    std::vector<SweepPoint> points = spec.expand();
+    EXPECT_EQ(points.size(), 6) << "Grid product size mismatch";
+    std::set<std::pair<double, double>> combos;
+    for (const SweepPoint& point : points)
+    {
+        combos.insert({point.get("width"), point.get("depth")});
+    }
+    EXPECT_EQ(combos.size(), 6) << "Grid points repeated";
+
+    // Test 2: random draws stay in range and are reproducible
+    spec.randomSamples = 3;
+    spec.logRanges["lr"] = {1e-4, 1e-1};
+    spec.ranges["dropout"] = {0.0, 0.5};
+    points = spec.expand();
+    EXPECT_EQ(points.size(), 18) << "Random draws per grid point mismatch";
+    for (const SweepPoint& point : points)
+    {
+        EXPECT_GE(point.get("lr"), 1e-4) << "Log draw below range";
+        EXPECT_LE(point.get("lr"), 1e-1) << "Log draw above range";
+        EXPECT_LT(point.get("dropout"), 0.5) << "Uniform draw above range";
+    }
+    EXPECT_EQ(spec.expand()[5].get("lr"), points[5].get("lr")) << "Random draws not reproducible";
+}
+
+/**
+ * @brief: Tests for running a cross-validated sweep concurrently
+ */
+TEST_F(SweepTest, RunAndReport)
+{
+    auto data = std::make_shared<Dataset>();
+    data->numFeatures = 1;
+    for (int i = 0; i < 40; i++)
+    {
+        data->features.push_back(i);
+        data->labels.push_back(2.0 * i);
+    }
+
+    // fits label = scale * feature, validation error is smallest at scale 2
+    TrainFn train = [](const SweepPoint& point, const Dataset& set, const Fold& fold)
+    {
+        if (point.get("scale") < 0)
+        {
+            throw std::runtime_error("negative scale");
+        }
+        double error = 0.0;
+        for (size_t row : fold.validation)
+        {
+            double diff = point.get("scale") * set.row(row)[0] - set.labels[row];
+            error += diff * diff;
+        }
+        return std::map<std::string, double>{{"mse", error / fold.validation.size()}};
+    };
+
+    SweepSpec spec;
+    spec.grid["scale"] = {-1.0, 1.0, 2.0, 3.0};
+    SweepRunner runner(3, 4);
+    std::vector<TrialResult> results = runner.run(spec, data, train);
+
+    // Test 1: one result per point and fold
+    ASSERT_EQ(results.size(), 16) << "Trial count mismatch";
+
+    // Test 2: errors are captured per trial, the best point is found
+    for (const TrialResult& result : results)
+    {
+        if (result.pointId == 0)
+        {
+            EXPECT_FALSE(result.error.empty()) << "Trial error not captured";
+        }
+        if (result.pointId == 2)
+        {
+            EXPECT_DOUBLE_EQ(result.metrics.at("mse"), 0.0) << "Best point has validation error";
+        }
+    }
+
+    // Test 3: report has a row per trial plus a mean row per point
+    std::string path = ::testing::TempDir() + "sweep_report.csv";
+    SweepRunner::writeReport(path, spec.expand(), results);
+    std::ifstream file(path);
+    std::string line;
+    size_t lines = 0;
+    while (std::getline(file, line))
+    {
+        lines++;
+    }
+    EXPECT_EQ(lines, 1 + 16 + 4) << "Report row count mismatch";
+    std::remove(path.c_str());
+}
@@ -0,0 +1,128 @@
+#include "../arch/model/headr/autotune.h"
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+/**
+ *
+ * OFFLINE AUTOTUNE
+ *  builds the composite model with the serving shapes, times every layer shape over the candidate grid and
+ *  writes the winners to the per host cache, so the first serving load on this host reads them instead of
+ *  timing. Run it once per host (or after a CPU change), --retune times again over cached shapes
+ *
+ *  usage: autotune [--cache file] [--length L] [--batch B] [--threads T] [--classifier 32,16]
+ *                  [--listener 32,32] [--precision full|bf16|fp16] [--repeats N] [--retune 1]
+ *
+ *  exit code 2 on bad arguments
+ *
+ */
+
+namespace
+{
+    struct Options
+    {
+        std::string cache = "autotune.cache";
+        int length = 10;
+        size_t batch = 32;
+        size_t threads = 0;
+        size_t repeats = 20;
+        bool retune = false;
+        std::vector<int> classifierHidden = {32, 16};
+        std::vector<int> listenerHidden = {32, 32};
+        Precision precision = Precision::Full;
+    };
+
+    std::vector<int> parseSizes(const std::string& text)
+    {
+        std::vector<int> sizes;
+        std::stringstream fields(text);
+        std::string field;
+        while (std::getline(fields, field, ','))
+        {
+            sizes.push_back(std::stoi(field));
+        }
+        return sizes;
+    }
+
+    Options parseArgs(int argc, char** argv)
+    {
+        Options opts;
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            if (i + 1 >= argc)
+            {
+                throw std::invalid_argument("Missing value for " + arg);
+            }
+            std::string val = argv[++i];
+            if (arg == "--cache") opts.cache = val;
+            else if (arg == "--length") opts.length = std::stoi(val);
+            else if (arg == "--batch") opts.batch = std::stoul(val);
+            else if (arg == "--threads") opts.threads = std::stoul(val);
+            else if (arg == "--repeats") opts.repeats = std::stoul(val);
+            else if (arg == "--retune") opts.retune = val != "0";
+            else if (arg == "--classifier") opts.classifierHidden = parseSizes(val);
+            else if (arg == "--listener") opts.listenerHidden = parseSizes(val);
+            else if (arg == "--precision")
+            {
+                opts.precision = val == "bf16" ? Precision::BF16 : val == "fp16" ? Precision::FP16 : Precision::Full;
+            }
+            else throw std::invalid_argument("Unknown argument " + arg);
+        }
+        return opts;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Options opts;
+    try
+    {
+        opts = parseArgs(argc, argv);
+    } catch (const std::exception& e)
+    {
+        std::cerr << e.what() << "\n";
+        return 2;
+    }
+
+    // the same setup as serving, the shape key includes precision and pool size
+    CompositeModel model(opts.length, opts.classifierHidden, opts.listenerHidden);
+    std::unique_ptr<ThreadPool> workers = opts.threads > 0 ? std::make_unique<ThreadPool>(opts.threads) : nullptr;
+    for (auto& layer : model.getClassifier().getLayers())
+    {
+        layer->setPrecision(opts.precision);
+        layer->setParallel(workers.get());
+    }
+    for (auto& layer : model.getListener().getLayers())
+    {
+        layer->setPrecision(opts.precision);
+        layer->setParallel(workers.get());
+    }
+
+    AutotuneConfig config;
+    config.cachePath = opts.cache;
+    config.batch = opts.batch;
+    config.repeats = opts.repeats;
+    config.retune = opts.retune;
+    Autotuner tuner(config);
+    AutotuneReport report = tuner.tune(model);
+
+    std::cout << "\nhost: " << report.host << "\n";
+    for (const AutotuneEntry& entry : report.shapes)
+    {
+        std::cout << entry.shape << ": tile " << entry.tuning.batchTile << ", threads " << entry.tuning.threads
+                  << ", chunks " << entry.tuning.chunksPerThread << ", unroll " << entry.tuning.unroll;
+        if (entry.cached)
+        {
+            std::cout << " (cached)\n";
+        }
+        else
+        {
+            std::cout << ", " << entry.seconds * 1e6 << " us vs " << entry.defaultSeconds * 1e6 << " us default\n";
+        }
+    }
+    std::cout << report.cacheHits << " of " << report.shapes.size() << " shapes from " << opts.cache << ", "
+              << report.seconds << " s\n";
+    return 0;
+}
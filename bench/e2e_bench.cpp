@@ -0,0 +1,563 @@
+#include "../arch/bench/headr/bench.h"
+#include "../arch/data/headr/generator.h"
+#include "../arch/model/headr/autotune.h"
+#include "../arch/model/headr/earlyexit.h"
+#include "../arch/model/headr/model.h"
+#include "../arch/model/headr/session.h"
+#include "../arch/train/headr/distill.h"
+#include "../arch/train/headr/gradients.h"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include <iostream>
+#include <numbers>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <sys/resource.h>
+#include <unistd.h>
+
+/**
+ *
+ * END TO END BENCHMARK
+ *  builds the composite model (classifier + stacked listener), drives it with generated sequences in a
+ *  closed loop (also with the result cache), at a fixed arrival rate and as packed batches of variable length
+ *  tracks, times the early exit
+ *  classifier, a listener distilled to a quarter of the width, GRU against LSTM layer steps, streaming
+ *  sessions fed through pipes and multiplexed by the session scheduler, data parallel batch gradients
+ *  in both reduction modes and Hogwild training on one against many workers, then compares the metrics
+ *  with a stored baseline
+ *
+ *  usage: e2e_bench [--requests N] [--warmup N] [--rate R] [--length L] [--batch B] [--threads T]
+ *                   [--classifier 32,16] [--listener 32,32] [--precision full|bf16|fp16]
+ *                   [--reduction fast|deterministic] [--cache 4096] [--tune autotune.cache] [--sessions 256]
+ *                   [--baseline file.json] [--tolerance 0.1] [--write-baseline file.json]
+ *
+ *  exit code 1 when a metric regresses past the tolerance, 2 on bad arguments
+ *
+ */
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct Options
+    {
+        size_t requests = 2000;
+        size_t warmup = 200;
+        double rate = 500.0;
+        int length = 10;
+        size_t batch = 32;
+        size_t threads = 0;
+        std::vector<int> classifierHidden = {32, 16};
+        std::vector<int> listenerHidden = {32, 32};
+        Precision precision = Precision::Full;
+        ReductionMode reduction = ReductionMode::Fast;
+        size_t cache = 4096;
+        std::string tune;
+        size_t sessions = 256;
+        std::string baseline;
+        std::string writeBaseline;
+        double tolerance = 0.1;
+    };
+
+    std::vector<int> parseSizes(const std::string& text)
+    {
+        std::vector<int> sizes;
+        std::stringstream fields(text);
+        std::string field;
+        while (std::getline(fields, field, ','))
+        {
+            sizes.push_back(std::stoi(field));
+        }
+        return sizes;
+    }
+
+    Options parseArgs(int argc, char** argv)
+    {
+        Options opts;
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            if (i + 1 >= argc)
+            {
+                throw std::invalid_argument("Missing value for " + arg);
+            }
+            std::string val = argv[++i];
+            if (arg == "--requests") opts.requests = std::stoul(val);
+            else if (arg == "--warmup") opts.warmup = std::stoul(val);
+            else if (arg == "--rate") opts.rate = std::stod(val);
+            else if (arg == "--length") opts.length = std::stoi(val);
+            else if (arg == "--batch") opts.batch = std::stoul(val);
+            else if (arg == "--threads") opts.threads = std::stoul(val);
+            else if (arg == "--cache") opts.cache = std::stoul(val);
+            else if (arg == "--tune") opts.tune = val;
+            else if (arg == "--sessions") opts.sessions = std::stoul(val);
+            else if (arg == "--classifier") opts.classifierHidden = parseSizes(val);
+            else if (arg == "--listener") opts.listenerHidden = parseSizes(val);
+            else if (arg == "--baseline") opts.baseline = val;
+            else if (arg == "--write-baseline") opts.writeBaseline = val;
+            else if (arg == "--tolerance") opts.tolerance = std::stod(val);
+            else if (arg == "--precision")
+            {
+                opts.precision = val == "bf16" ? Precision::BF16 : val == "fp16" ? Precision::FP16 : Precision::Full;
+            }
+            else if (arg == "--reduction")
+            {
+                opts.reduction = val == "deterministic" ? ReductionMode::Deterministic : ReductionMode::Fast;
+            }
+            else throw std::invalid_argument("Unknown argument " + arg);
+        }
+        return opts;
+    }
+
+    void record(BenchMetrics& metrics, const std::string& prefix, const LatencyStats& stats, double seconds)
+    {
+        metrics[prefix + ".throughput_per_sec"] = static_cast<double>(stats.count) / seconds;
+        metrics[prefix + ".p50_ms"] = stats.p50 * 1e3;
+        metrics[prefix + ".p95_ms"] = stats.p95 * 1e3;
+        metrics[prefix + ".p99_ms"] = stats.p99 * 1e3;
+        metrics[prefix + ".max_ms"] = stats.max * 1e3;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Options opts;
+    try
+    {
+        opts = parseArgs(argc, argv);
+    } catch (const std::exception& e)
+    {
+        std::cerr << e.what() << "\n";
+        return 2;
+    }
+
+    setReductionMode(opts.reduction);
+    CompositeModel model(opts.length, opts.classifierHidden, opts.listenerHidden);
+    // wide layers split their nodes over the pool when --threads is given
+    std::unique_ptr<ThreadPool> workers = opts.threads > 0 ? std::make_unique<ThreadPool>(opts.threads) : nullptr;
+    for (auto& layer : model.getClassifier().getLayers())
+    {
+        layer->setPrecision(opts.precision);
+        layer->setParallel(workers.get());
+    }
+    for (auto& layer : model.getListener().getLayers())
+    {
+        layer->setPrecision(opts.precision);
+        layer->setParallel(workers.get());
+    }
+    // --tune reads the winners for this host from the cache, timing and adding the shapes it lacks
+    AutotuneReport tuned;
+    if (!opts.tune.empty())
+    {
+        AutotuneConfig tuneConfig;
+        tuneConfig.cachePath = opts.tune;
+        tuneConfig.batch = opts.batch;
+        tuned = Autotuner(tuneConfig).tune(model);
+    }
+
+    // a fixed pool of realistic sequences, half classical half jazz
+    MusicDataGenerator generator(42);
+    std::vector<std::vector<double>> pool;
+    for (int i = 0; i < 256; ++i)
+    {
+        pool.push_back(i % 2 == 0 ? generator.classical(opts.length).first : generator.jazz(opts.length).first);
+    }
+
+    ExecContext ctx;
+    volatile double sink = 0.0;
+    auto serve = [&](size_t i)
+    {
+        std::span<double> preferences = model.run(ctx, pool[i % pool.size()]);
+        sink = sink + preferences.back();
+        ctx.endBatch();
+    };
+
+    for (size_t i = 0; i < opts.warmup; ++i)
+    {
+        serve(i);
+    }
+
+    BenchMetrics metrics;
+    if (!opts.tune.empty())
+    {
+        // near zero once the cache holds every shape of this host
+        metrics["autotune.seconds"] = tuned.seconds;
+    }
+
+    // closed loop: the next request is issued as soon as the last one finished
+    std::vector<double> latencies;
+    latencies.reserve(opts.requests);
+    Clock::time_point start = Clock::now();
+    for (size_t i = 0; i < opts.requests; ++i)
+    {
+        Clock::time_point begin = Clock::now();
+        serve(i);
+        latencies.push_back(std::chrono::duration<double>(Clock::now() - begin).count());
+    }
+    double closedSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+    record(metrics, "closed", summarizeLatencies(latencies), closedSeconds);
+
+    // cached: the closed loop again with the result cache in front of the classifier, the pool repeats so
+    // every opening after the first pass is a hash lookup
+    if (opts.cache > 0)
+    {
+        ResultCacheConfig cacheConfig;
+        cacheConfig.capacity = opts.cache;
+        ResultCache cache(cacheConfig);
+        model.setResultCache(&cache);
+        latencies.clear();
+        start = Clock::now();
+        for (size_t i = 0; i < opts.requests; ++i)
+        {
+            Clock::time_point begin = Clock::now();
+            serve(i);
+            latencies.push_back(std::chrono::duration<double>(Clock::now() - begin).count());
+        }
+        double cachedSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+        record(metrics, "cached", summarizeLatencies(latencies), cachedSeconds);
+        metrics["cached.hit_rate"] = cache.stats().hitRate();
+        model.setResultCache(nullptr);
+    }
+
+    // fixed rate: latency runs from the scheduled arrival, so falling behind shows up as queueing
+    latencies.clear();
+    auto interval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / opts.rate));
+    start = Clock::now();
+    for (size_t i = 0; i < opts.requests; ++i)
+    {
+        Clock::time_point arrival = start + interval * static_cast<long>(i);
+        std::this_thread::sleep_until(arrival);
+        serve(i);
+        latencies.push_back(std::chrono::duration<double>(Clock::now() - arrival).count());
+    }
+    double fixedSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+    record(metrics, "fixed", summarizeLatencies(latencies), fixedSeconds);
+
+    // packed: tracks between 1x and 4x the classifier window, run together without padding
+    std::vector<std::vector<double>> tracks;
+    std::uniform_int_distribution<int> lengthDist(opts.length, 4 * opts.length);
+    std::mt19937 lengthGen(7);
+    for (size_t i = 0; i < std::max<size_t>(opts.batch, 1) * 8; ++i)
+    {
+        size_t len = static_cast<size_t>(lengthDist(lengthGen));
+        tracks.push_back(i % 2 == 0 ? generator.classical(len).first : generator.jazz(len).first);
+    }
+    latencies.clear();
+    size_t served = 0;
+    start = Clock::now();
+    while (served < opts.requests)
+    {
+        size_t first = served % tracks.size();
+        size_t count = std::min({opts.batch, opts.requests - served, tracks.size() - first});
+        std::vector<std::vector<double>> chunk(tracks.begin() + first, tracks.begin() + first + count);
+        Clock::time_point begin = Clock::now();
+        std::vector<std::span<double>> preferences = model.runBatch(ctx, chunk);
+        sink = sink + preferences.back().back();
+        ctx.endBatch();
+        latencies.push_back(std::chrono::duration<double>(Clock::now() - begin).count());
+        served += count;
+    }
+    double packedSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+    LatencyStats packedStats = summarizeLatencies(latencies);
+    record(metrics, "packed", packedStats, packedSeconds);
+    metrics["packed.throughput_per_sec"] = static_cast<double>(served) / packedSeconds;
+
+    // early exit: heads at a third, half and two thirds of the window, fit and calibrated on fresh tracks,
+    // evaluated on the serving pool
+    std::vector<size_t> exitSteps;
+    for (int step : {opts.length / 3, opts.length / 2, 2 * opts.length / 3})
+    {
+        if (step > 0 && (exitSteps.empty() || static_cast<size_t>(step) > exitSteps.back()))
+        {
+            exitSteps.push_back(static_cast<size_t>(step));
+        }
+    }
+    if (!exitSteps.empty())
+    {
+        std::vector<std::vector<double>> fitTracks;
+        std::vector<double> fitLabels;
+        for (size_t i = 0; i < 1024; ++i)
+        {
+            fitTracks.push_back(i % 2 == 0 ? generator.classical(opts.length).first : generator.jazz(opts.length).first);
+            fitLabels.push_back(i % 2 == 0 ? 1.0 : 0.0);
+        }
+        std::vector<std::vector<double>> fitHalf(fitTracks.begin(), fitTracks.begin() + 512);
+        std::vector<std::vector<double>> heldHalf(fitTracks.begin() + 512, fitTracks.end());
+        std::vector<double> poolLabels;
+        for (size_t i = 0; i < pool.size(); ++i)
+        {
+            poolLabels.push_back(i % 2 == 0 ? 1.0 : 0.0);
+        }
+        EarlyExitClassifier early(model.getClassifier(), exitSteps);
+        early.fit(fitHalf, std::span<const double>(fitLabels).first(512));
+        early.calibrate(heldHalf, std::span<const double>(fitLabels).subspan(512), 0.9);
+        EarlyExitReport report = early.evaluate(ctx, pool, poolLabels);
+        metrics["early_exit.mean_steps"] = report.meanSteps;
+        metrics["early_exit.accuracy"] = report.accuracy;
+        metrics["early_exit.full_accuracy"] = report.fullAccuracy;
+        metrics["early_exit.mean_us"] = report.meanSeconds * 1e6;
+        metrics["early_exit.full_mean_us"] = report.fullSeconds * 1e6;
+        for (size_t e = 0; e < report.exits.size(); ++e)
+        {
+            std::string prefix = "early_exit.step" + std::to_string(report.exits[e].step);
+            metrics[prefix + ".fraction"] = static_cast<double>(report.exits[e].taken) / static_cast<double>(pool.size());
+            metrics[prefix + ".accuracy"] = report.exits[e].accuracy();
+        }
+    }
+
+    // distill: a one layer student a quarter as wide as the listener's top layer, a few passes over the pool
+    {
+        std::vector<std::vector<double>> sequences;
+        for (const std::vector<double>& freqs : pool)
+        {
+            std::vector<double> features;
+            for (size_t t = 0; t < freqs.size(); ++t)
+            {
+                features.push_back(normalizeFrequency(freqs[t]));
+                features.push_back(t == 0 ? 0.0 : intervalOctaves(freqs[t - 1], freqs[t]));
+                features.push_back(0.5);
+            }
+            sequences.push_back(std::move(features));
+        }
+        Listener teacher(Listener::numFeatures, opts.listenerHidden);
+        Listener student(Listener::numFeatures, {std::max(1, opts.listenerHidden.back() / 4)});
+        ParamBuffer studentParams;
+        student.registerParams(studentParams);
+        studentParams.bind();
+        Adam optimizer(0.01);
+        Distiller distiller(teacher, student, studentParams, optimizer);
+        for (int epoch = 0; epoch < 5; ++epoch)
+        {
+            distiller.train(sequences);
+        }
+        DistillReport report = distiller.evaluate(sequences);
+        metrics["distill.speedup"] = report.speedup;
+        metrics["distill.agreement"] = report.agreement;
+        metrics["distill.mean_abs_diff"] = report.meanAbsDiff;
+        metrics["distill.param_ratio"] = static_cast<double>(report.teacherParams)
+                                         / static_cast<double>(report.studentParams);
+    }
+
+    // cells: one GRU and one LSTM layer as wide as the listener's top layer, stepped over batches of the
+    // top layer's fan in on the batched kernel, the GRU runs three gate matrices to the LSTM's four
+    {
+        size_t width = static_cast<size_t>(opts.listenerHidden.back());
+        size_t rows = std::max<size_t>(opts.batch, 1);
+        int fanIn = static_cast<int>(width);
+        std::mt19937 gen(17);
+        std::uniform_real_distribution<double> dis(-1.0, 1.0);
+        std::vector<double> inputs(rows * width);
+        for (double& val : inputs)
+        {
+            val = dis(gen);
+        }
+        NetworkLayer<LstmNode> lstmCells(fanIn, LstmNode(), true, nullptr, fanIn);
+        NetworkLayer<GruNode> gruCells(fanIn, GruNode(), true, nullptr, fanIn);
+        lstmCells.setPrecision(opts.precision);
+        gruCells.setPrecision(opts.precision);
+        std::vector<double> stm(rows * width, 0.0);
+        std::vector<double> ltm(rows * width, 0.0);
+        auto runCells = [&](const std::string& prefix, auto&& step)
+        {
+            std::fill(stm.begin(), stm.end(), 0.0);
+            std::fill(ltm.begin(), ltm.end(), 0.0);
+            latencies.clear();
+            start = Clock::now();
+            for (size_t i = 0; i < opts.requests; ++i)
+            {
+                Clock::time_point begin = Clock::now();
+                sink = sink + step()[0];
+                latencies.push_back(std::chrono::duration<double>(Clock::now() - begin).count());
+                ctx.endBatch();
+            }
+            double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+            record(metrics, prefix, summarizeLatencies(latencies), seconds);
+            return seconds;
+        };
+        double lstmSeconds = runCells("cell.lstm", [&] { return lstmCells.forwardBatch(ctx, inputs, rows, stm, ltm); });
+        double gruSeconds = runCells("cell.gru", [&] { return gruCells.forwardBatch(ctx, inputs, rows, stm); });
+        metrics["cell.gru_speedup"] = lstmSeconds / gruSeconds;
+    }
+
+    // sessions: live listeners fed raw PCM through pipes by one writer, a quarter second per pipe in turn,
+    // multiplexed onto the scheduler's workers, two descriptors per session so the count stays under the
+    // open file limit
+    rlimit files{};
+    size_t maxSessions = getrlimit(RLIMIT_NOFILE, &files) == 0 && files.rlim_cur != RLIM_INFINITY
+                         ? (static_cast<size_t>(files.rlim_cur) - std::min<size_t>(files.rlim_cur, 64)) / 2
+                         : opts.sessions;
+    size_t numSessions = std::min(opts.sessions, maxSessions);
+    if (numSessions > 0)
+    {
+        constexpr double sampleRate = 8000.0;
+        size_t perSecond = static_cast<size_t>(sampleRate);
+        std::vector<std::vector<float>> pcm;
+        for (size_t m = 0; m < 8; ++m)
+        {
+            std::vector<double> notes = m % 2 == 0 ? generator.classical(static_cast<size_t>(opts.length) + 2).first
+                                                   : generator.jazz(static_cast<size_t>(opts.length) + 2).first;
+            pcm.emplace_back(notes.size() * perSecond);
+            for (size_t i = 0; i < pcm.back().size(); ++i)
+            {
+                double phase = 2.0 * std::numbers::pi * notes[i / perSecond] * static_cast<double>(i) / sampleRate;
+                pcm.back()[i] = static_cast<float>(0.5 * std::sin(phase));
+            }
+        }
+        SessionConfig config;
+        config.workers = std::max<size_t>(opts.threads, 1);
+        config.maxBatch = std::max<size_t>(opts.batch, 1);
+        config.sampleRate = sampleRate;
+        SessionScheduler scheduler(model, config);
+        std::vector<int> writeEnds;
+        start = Clock::now();
+        for (size_t s = 0; s < numSessions; ++s)
+        {
+            int ends[2];
+            if (::pipe(ends) != 0)
+            {
+                break;
+            }
+            scheduler.open(ends[0]);
+            writeEnds.push_back(ends[1]);
+        }
+        std::thread writer([&]
+        {
+            std::vector<size_t> written(writeEnds.size(), 0);
+            for (bool more = true; more;)
+            {
+                more = false;
+                for (size_t s = 0; s < writeEnds.size(); ++s)
+                {
+                    const std::vector<float>& source = pcm[s % pcm.size()];
+                    size_t bytes = std::min(perSecond / 4, source.size() - written[s]) * sizeof(float);
+                    const char* data = reinterpret_cast<const char*>(source.data() + written[s]);
+                    for (size_t done = 0; done < bytes;)
+                    {
+                        ssize_t got = ::write(writeEnds[s], data + done, bytes - done);
+                        done += got > 0 ? static_cast<size_t>(got) : 0;
+                    }
+                    written[s] += bytes / sizeof(float);
+                    more = more || written[s] < source.size();
+                }
+            }
+            for (int fd : writeEnds)
+            {
+                ::close(fd);
+            }
+        });
+        scheduler.wait();
+        writer.join();
+        double sessionSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+        SessionStats stats = scheduler.stats();
+        metrics["sessions.steps_per_sec"] = static_cast<double>(stats.steps) / sessionSeconds;
+        metrics["sessions.seconds"] = sessionSeconds;
+    }
+
+    // gradients: classifier batch gradients over the pool, once per reduction mode, the gap is the price
+    // of bit identical results
+    Dataset data;
+    data.numFeatures = static_cast<size_t>(opts.length);
+    for (size_t i = 0; i < pool.size(); ++i)
+    {
+        data.features.insert(data.features.end(), pool[i].begin(), pool[i].end());
+        data.labels.push_back(i % 2 == 0 ? 1.0 : 0.0);
+    }
+    Classifier& classifier = model.getClassifier();
+    ParamBuffer shared;
+    classifier.registerParams(shared);
+    shared.bind();
+    ParallelGradients gradients(shared, workers.get(), data.size(), [&](std::span<const size_t> shard, bool copyShard)
+    {
+        return std::make_unique<ClassifierReplica>(classifier, data, shard, copyShard);
+    });
+    std::vector<size_t> order(data.size());
+    std::iota(order.begin(), order.end(), 0);
+    for (ReductionMode mode : {ReductionMode::Fast, ReductionMode::Deterministic})
+    {
+        setReductionMode(mode);
+        std::string prefix = mode == ReductionMode::Fast ? "reduce.fast" : "reduce.deterministic";
+        latencies.clear();
+        served = 0;
+        start = Clock::now();
+        while (served < opts.requests)
+        {
+            size_t first = served % order.size();
+            size_t count = std::min({std::max<size_t>(opts.batch, 1), opts.requests - served, order.size() - first});
+            Clock::time_point begin = Clock::now();
+            sink = sink + gradients.accumulate(std::span<const size_t>(order).subspan(first, count));
+            latencies.push_back(std::chrono::duration<double>(Clock::now() - begin).count());
+            served += count;
+        }
+        double reduceSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+        record(metrics, prefix, summarizeLatencies(latencies), reduceSeconds);
+        metrics[prefix + ".throughput_per_sec"] = static_cast<double>(served) / reduceSeconds;
+    }
+    setReductionMode(opts.reduction);
+
+    // hogwild: the classifier trained over the pool on one worker and on every worker (--threads or the
+    // hardware threads), refreshing the replicas before every sample and every 8th, each run from the same
+    // start. The speedups are parallel over serial samples per second
+    {
+        size_t parallel = std::max<size_t>(2, opts.threads > 0 ? opts.threads : std::thread::hardware_concurrency());
+        std::vector<double> start(shared.values().begin(), shared.values().end());
+        auto factory = [&](std::span<const size_t> shard, bool copyShard)
+        {
+            return std::make_unique<ClassifierReplica>(classifier, data, shard, copyShard);
+        };
+        auto train = [&](size_t threads, size_t refreshInterval)
+        {
+            std::copy(start.begin(), start.end(), shared.values().begin());
+            HogwildConfig config;
+            config.threads = threads;
+            config.epochs = 20;
+            config.learningRate = 0.05;
+            config.refreshInterval = refreshInterval;
+            HogwildStats stats = HogwildTrainer(shared, config).train(data.size(), factory);
+            return static_cast<double>(stats.samples) / stats.seconds;
+        };
+        double serial = train(1, 1);
+        double dense = train(parallel, 1);
+        double refreshed = train(parallel, 8);
+        std::copy(start.begin(), start.end(), shared.values().begin());
+        metrics["hogwild.serial.samples_per_sec"] = serial;
+        metrics["hogwild.parallel.samples_per_sec"] = dense;
+        metrics["hogwild.parallel_refresh8.samples_per_sec"] = refreshed;
+        metrics["hogwild.speedup"] = dense / serial;
+        metrics["hogwild.refresh8_speedup"] = refreshed / serial;
+    }
+
+    metrics["peak_rss_mb"] = static_cast<double>(peakRssBytes()) / (1024.0 * 1024.0);
+
+    std::cout << "\n";
+    for (const auto& [name, val] : metrics)
+    {
+        std::cout << name << ": " << val << "\n";
+    }
+
+    if (!opts.writeBaseline.empty())
+    {
+        writeMetricsJson(opts.writeBaseline, metrics);
+        std::cout << "baseline written to " << opts.writeBaseline << "\n";
+    }
+
+    if (!opts.baseline.empty())
+    {
+        std::vector<Regression> regressions = compareToBaseline(metrics, readMetricsJson(opts.baseline), opts.tolerance);
+        for (const Regression& reg : regressions)
+        {
+            std::cout << "REGRESSION " << reg.metric << ": " << reg.baseline << " -> " << reg.current
+                      << " (" << reg.change * 100.0 << "%)\n";
+        }
+        if (!regressions.empty())
+        {
+            return 1;
+        }
+        std::cout << "no regressions against " << opts.baseline << "\n";
+    }
+    return 0;
+}